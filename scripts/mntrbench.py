@@ -0,0 +1,356 @@
+#!/usr/bin/env python
+#
+#     MINOTAUR -- It's only 1/2 bull
+#
+#     (C)opyright 2009 - 2014 The MINOTAUR Team.
+#
+# Run Minotaur binaries on a set of instances and compare runs.
+#
+#   python mntrbench.py run -b "<binary> [options]" [-t time-limit]
+#          [-j jobs] [-o results.csv] instance.nl ... | -l instance-list
+#
+#   python mntrbench.py compare [-t time-limit] [-s shift] [-p profile.dat]
+#          run1.csv run2.csv ...
+#
+# "run" solves each instance in a separate process, upto "jobs" at a time,
+# with the given time limit. It reads the status, objective value, bound,
+# number of nodes and time from the output that every binary writes at the
+# end (writeBnbStatus() and BranchAndBound::writeStats()) and saves one line
+# per instance in a csv file.
+#
+# "compare" reads csv files of two or more runs and writes shifted geometric
+# means of time and nodes and a Dolan-More performance profile of time.
+# The profile can also be saved in a file for plotting with gnuplot.
+#
+# Works with python 2.6+ and python 3.
+
+from __future__ import print_function
+
+import csv
+import math
+import optparse
+import os
+import re
+import signal
+import subprocess
+import sys
+import threading
+import time
+
+try:
+	from multiprocessing import Pool
+except ImportError:
+	Pool = None
+
+INFTY = 1e20
+
+# Statuses in which the instance is considered solved.
+SOLVED = ["optimal", "infeasible", "unbounded", "gaplimit"]
+
+# Status strings from getSolveStatusString() in Types.cpp.
+STATUS_MAP = [
+	("Optimal solution found", "optimal"),
+	("Detected infeasibility", "infeasible"),
+	("Detected unboundedness", "unbounded"),
+	("Reached limit on gap", "gaplimit"),
+	("Reached time limit", "timelimit"),
+	("Reached iteration limit", "iterlimit"),
+	("limit on number of solutions", "sollimit"),
+	("Interrupted", "interrupted"),
+	("Not started", "notstarted"),
+]
+
+FIELDS = ["instance", "status", "solved", "ub", "lb", "nodes", "time"]
+
+RE_UB = re.compile(r"best solution value = *(\S+)")
+RE_LB = re.compile(r"best bound estimate from remaining nodes = *(\S+)")
+RE_TIME = re.compile(r"time used(?: \(s\))? = *(\S+)")
+RE_STATUS = re.compile(r"status of branch-and-bound: *(.*)$")
+RE_NODES = re.compile(r"nodes processed = *(\d+)")
+
+
+def toFloat(s):
+	try:
+		return float(s)
+	except ValueError:
+		if "inf" in s.lower():
+			return -INFTY if s.startswith("-") else INFTY
+		return INFTY
+
+
+def parseOutput(text):
+	""" Return dictionary of results read from output of a binary. """
+	res = {"status": "failed", "ub": INFTY, "lb": -INFTY, "nodes": 0,
+	       "time": -1.0}
+	for line in text.splitlines():
+		m = RE_UB.search(line)
+		if m:
+			res["ub"] = toFloat(m.group(1))
+			continue
+		m = RE_LB.search(line)
+		if m:
+			res["lb"] = toFloat(m.group(1))
+			continue
+		m = RE_TIME.search(line)
+		if m:
+			res["time"] = toFloat(m.group(1))
+			continue
+		m = RE_NODES.search(line)
+		if m:
+			# mcbnb writes one line per thread and then the total.
+			res["nodes"] = max(res["nodes"], int(m.group(1)))
+			continue
+		m = RE_STATUS.search(line)
+		if m:
+			res["status"] = "other"
+			for (s, code) in STATUS_MAP:
+				if s in m.group(1):
+					res["status"] = code
+					break
+	return res
+
+
+def runOne(args):
+	""" Solve one instance. args = (command, instance, time limit). """
+	(cmd, inst, tlimit) = args
+	full = cmd.split() + [inst, "--bnb_time_limit", str(tlimit),
+	                      "--log_level", "3"]
+	start = time.time()
+	killed = [False]
+	try:
+		p = subprocess.Popen(full, stdout=subprocess.PIPE,
+		                     stderr=subprocess.STDOUT)
+	except OSError:
+		res = parseOutput("")
+		res["instance"] = inst
+		return res
+
+	def kill():
+		killed[0] = True
+		try:
+			p.send_signal(signal.SIGKILL)
+		except OSError:
+			pass
+
+	# give the binary some time to stop and write its status.
+	timer = threading.Timer(1.5*tlimit + 10, kill)
+	timer.start()
+	out = p.communicate()[0]
+	timer.cancel()
+	if not isinstance(out, str):
+		out = out.decode("utf-8", "replace")
+
+	res = parseOutput(out)
+	res["instance"] = inst
+	if killed[0]:
+		res["status"] = "killed"
+	if res["time"] < 0:
+		res["time"] = time.time() - start
+	return res
+
+
+def writeResults(results, fname):
+	if fname == "-":
+		f = sys.stdout
+	else:
+		f = open(fname, "w")
+	w = csv.writer(f, lineterminator="\n")
+	w.writerow(FIELDS)
+	for r in results:
+		solved = 1 if r["status"] in SOLVED else 0
+		w.writerow([os.path.basename(r["instance"]), r["status"], solved,
+		            "%.10g" % r["ub"], "%.10g" % r["lb"], r["nodes"],
+		            "%.2f" % r["time"]])
+	if f is not sys.stdout:
+		f.close()
+
+
+def readResults(fname):
+	""" Return dictionary: instance -> row. """
+	rows = {}
+	f = open(fname)
+	for r in csv.DictReader(f):
+		r["solved"] = int(r["solved"])
+		r["ub"] = float(r["ub"])
+		r["lb"] = float(r["lb"])
+		r["nodes"] = int(r["nodes"])
+		r["time"] = float(r["time"])
+		rows[r["instance"]] = r
+	f.close()
+	return rows
+
+
+def cmdRun(argv):
+	parser = optparse.OptionParser("usage: %prog run -b \"<binary> [options]\""
+	                               " [-t time-limit] [-j jobs] [-o file.csv]"
+	                               " instance ... | -l list")
+	parser.add_option("-b", "--binary", dest="binary",
+	                  help="binary to run, with options in quotes")
+	parser.add_option("-t", "--timelimit", dest="tlimit", type="float",
+	                  default=60.0, help="time limit per instance (60s)")
+	parser.add_option("-j", "--jobs", dest="jobs", type="int", default=1,
+	                  help="number of instances solved at a time (1)")
+	parser.add_option("-l", "--list", dest="ilist",
+	                  help="file with one instance per line")
+	parser.add_option("-o", "--output", dest="output", default="-",
+	                  help="csv file for results (stdout)")
+	(opts, insts) = parser.parse_args(argv)
+	if not opts.binary:
+		parser.error("binary is required")
+	if opts.ilist:
+		f = open(opts.ilist)
+		for l in f:
+			l = l.split("#")[0].strip()
+			if l:
+				insts.append(l)
+		f.close()
+	if not insts:
+		parser.error("no instances given")
+
+	args = [(opts.binary, i, opts.tlimit) for i in insts]
+	if opts.jobs > 1 and Pool:
+		pool = Pool(opts.jobs)
+		results = pool.map(runOne, args, 1)
+		pool.close()
+		pool.join()
+	else:
+		results = [runOne(a) for a in args]
+	writeResults(results, opts.output)
+	nsolved = len([r for r in results if r["status"] in SOLVED])
+	print("mntrbench: solved %d of %d instances" % (nsolved, len(results)),
+	      file=sys.stderr)
+	return 0
+
+
+def sgm(vals, shift):
+	""" Shifted geometric mean. """
+	if not vals:
+		return float("nan")
+	s = 0.0
+	for v in vals:
+		s += math.log(max(v, 0.0) + shift)
+	return math.exp(s/len(vals)) - shift
+
+
+def cmdCompare(argv):
+	parser = optparse.OptionParser("usage: %prog compare [-t time-limit]"
+	                               " [-s shift] [-p profile.dat]"
+	                               " run1.csv run2.csv ...")
+	parser.add_option("-t", "--timelimit", dest="tlimit", type="float",
+	                  default=None, help="time limit (max time in runs)")
+	parser.add_option("-s", "--shift", dest="shift", type="float",
+	                  default=10.0, help="shift for time (10s)")
+	parser.add_option("-n", "--nodeshift", dest="nshift", type="float",
+	                  default=100.0, help="shift for nodes (100)")
+	parser.add_option("-m", "--mintime", dest="mintime", type="float",
+	                  default=1.0, help="times below this are rounded up (1s)")
+	parser.add_option("-p", "--profile", dest="profile",
+	                  help="write performance profile in this file")
+	(opts, files) = parser.parse_args(argv)
+	if len(files) < 2:
+		parser.error("need at least two runs")
+
+	runs = [readResults(f) for f in files]
+	names = [os.path.splitext(os.path.basename(f))[0] for f in files]
+	insts = set(runs[0].keys())
+	for r in runs[1:]:
+		insts &= set(r.keys())
+	insts = sorted(insts)
+	if not insts:
+		print("mntrbench: runs have no instances in common", file=sys.stderr)
+		return 1
+	if opts.tlimit is None:
+		opts.tlimit = max([r[i]["time"] for r in runs for i in insts])
+
+	def solved(r, i):
+		return r[i]["solved"] == 1 and r[i]["time"] <= opts.tlimit
+
+	# warn about runs that do not agree on optimal values.
+	for i in insts:
+		opt = [r[i]["ub"] for r in runs if r[i]["status"] == "optimal"]
+		if opt and max(opt) - min(opt) > 1e-4*max(1.0, abs(min(opt))):
+			print("mntrbench: warning: different optimal values for %s: %s"
+			      % (i, " ".join(["%g" % v for v in opt])), file=sys.stderr)
+
+	allsolved = [i for i in insts if all([solved(r, i) for r in runs])]
+	print("instances = %d, solved by all = %d, time limit = %g"
+	      % (len(insts), len(allsolved), opts.tlimit))
+	print()
+	w = max([len(n) for n in names] + [4])
+	print("%-*s %7s %12s %8s %12s %8s %12s %8s"
+	      % (w, "run", "solved", "sgm time", "rel", "sgm time*", "rel",
+	         "sgm nodes*", "rel"))
+	base = None
+	for (n, r) in zip(names, runs):
+		t_all = [min(r[i]["time"], opts.tlimit) if solved(r, i)
+		         else opts.tlimit for i in insts]
+		t_sol = [r[i]["time"] for i in allsolved]
+		n_sol = [r[i]["nodes"] for i in allsolved]
+		row = (len([i for i in insts if solved(r, i)]),
+		       sgm(t_all, opts.shift), sgm(t_sol, opts.shift),
+		       sgm(n_sol, opts.nshift))
+		if base is None:
+			base = row
+
+		def rel(a, b):
+			return a/b if b > 0 else float("nan")
+		print("%-*s %7d %12.2f %8.2f %12.2f %8.2f %12.1f %8.2f"
+		      % (w, n, row[0], row[1], rel(row[1], base[1]), row[2],
+		         rel(row[2], base[2]), row[3], rel(row[3], base[3])))
+	print("(* = over instances solved by all runs; rel = relative to %s)"
+	      % names[0])
+	print()
+
+	# Dolan-More performance profile of time. ratio = time/best time.
+	ratios = [[] for r in runs]
+	for i in insts:
+		t = [max(r[i]["time"], opts.mintime) if solved(r, i) else INFTY
+		     for r in runs]
+		best = min(t)
+		for k in range(len(runs)):
+			if best >= INFTY or t[k] >= INFTY:
+				ratios[k].append(INFTY)
+			else:
+				ratios[k].append(t[k]/best)
+	taus = [1, 1.25, 1.5, 2, 3, 5, 10, 20, 50, 100]
+	print("performance profile: fraction of instances solved within tau "
+	      "times the best time")
+	print("%-*s" % (w, "tau") + "".join(["%7g" % t for t in taus]))
+	for k in range(len(runs)):
+		print("%-*s" % (w, names[k]) + "".join(
+			["%7.3f" % (len([x for x in ratios[k] if x <= t])
+			            / float(len(insts))) for t in taus]))
+
+	if opts.profile:
+		writeProfile(opts.profile, names, ratios, len(insts))
+	return 0
+
+
+def writeProfile(fname, names, ratios, ninsts):
+	""" Write step functions, one block per run, log2 of tau. """
+	f = open(fname, "w")
+	f.write("# performance profile: log2(tau) fraction\n")
+	for k in range(len(names)):
+		f.write("# %s\n" % names[k])
+		vals = sorted([x for x in ratios[k] if x < INFTY])
+		frac = 0.0
+		f.write("%g %g\n" % (0.0, 0.0))
+		for (j, x) in enumerate(vals):
+			f.write("%g %g\n" % (math.log(x, 2), frac))
+			frac = (j + 1) / float(ninsts)
+			f.write("%g %g\n" % (math.log(x, 2), frac))
+		f.write("\n\n")
+	f.close()
+
+
+def main():
+	if len(sys.argv) < 2 or sys.argv[1] not in ("run", "compare"):
+		print("usage: %s run|compare [options] [--help]" % sys.argv[0])
+		return 1
+	if sys.argv[1] == "run":
+		return cmdRun(sys.argv[2:])
+	return cmdCompare(sys.argv[2:])
+
+
+if __name__ == "__main__":
+	sys.exit(main())
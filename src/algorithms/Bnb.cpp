@@ -35,6 +35,7 @@
 #include "Option.h"
 #include "PCBProcessor.h"
 #include "Presolver.h"
+#include "ProblemSnapshot.h"
 #include "ProblemSize.h"
 #include "QPEngine.h"
 #include "Problem.h"
@@ -394,7 +395,8 @@ int showInfo(EnvPtr env)
     return 1;
   }
 
-  if (options->findString("problem_file")->getValue()=="") {
+  if (options->findString("problem_file")->getValue()=="" &&
+      options->findString("read_snapshot")->getValue()=="") {
     showHelp();
     return 1;
   }
@@ -410,12 +412,14 @@ void writeSol(EnvPtr env, VarVector *orig_v,
               PresolverPtr pres, SolutionPtr sol, SolveStatus status,
               MINOTAUR_AMPL::AMPLInterface* iface)
 {
-  if (sol) {
+  // pres is NULL if the problem was loaded from a snapshot. Then the
+  // solution is of the presolved problem and no .sol file can be written.
+  if (sol && pres) {
     sol = pres->getPostSol(sol);
   }
 
-  if (env->getOptions()->findFlag("AMPL")->getValue() ||
-      true == env->getOptions()->findBool("write_sol_file")->getValue()) {
+  if (pres && (env->getOptions()->findFlag("AMPL")->getValue() ||
+      true == env->getOptions()->findBool("write_sol_file")->getValue())) {
     iface->writeSolution(sol, status);
   } else if (sol && env->getLogger()->getMaxLevel()>=LogExtraInfo) {
     sol->writePrimal(env->getLogger()->msgStream(LogExtraInfo), orig_v);
@@ -497,17 +501,28 @@ int main(int argc, char** argv)
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, oinst, &obj_sense);
-  orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
-  pres = presolve(env, oinst, iface->getNumDefs(), handlers);
-  handlers.clear();
-  if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
-    env->getLogger()->msgStream(LogInfo) << me 
-      << "status of presolve: " 
-      << getSolveStatusString(pres->getStatus()) << std::endl;
-    writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
-    writeBnbStatus(env, bab, obj_sense);
-    goto CLEANUP;
+  if (env->getOptions()->findString("read_snapshot")->getValue()!="") {
+    // skip reading and presolving.
+    ProblemSnapshot snap(env);
+    oinst = snap.readByOption(&err);
+    if (err) {
+      goto CLEANUP;
+    }
+    orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
+  } else {
+    loadProblem(env, iface, oinst, &obj_sense);
+    orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
+    pres = presolve(env, oinst, iface->getNumDefs(), handlers);
+    handlers.clear();
+    if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "status of presolve: " 
+        << getSolveStatusString(pres->getStatus()) << std::endl;
+      writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
+      writeBnbStatus(env, bab, obj_sense);
+      goto CLEANUP;
+    }
+    ProblemSnapshot(env).writeByOption(oinst);
   }
 
   if (false==env->getOptions()->findBool("solve")->getValue()) {
@@ -32,6 +32,7 @@
 #include "Option.h"
 #include "PCBProcessor.h"
 #include "Presolver.h"
+#include "ProblemSnapshot.h"
 #include "ProblemSize.h"
 #include "Problem.h"
 #include "Relaxation.h"
@@ -319,7 +320,8 @@ int showInfo(EnvPtr env)
     return 1;
   }
 
-  if (options->findString("problem_file")->getValue()=="") {
+  if (options->findString("problem_file")->getValue()=="" &&
+      options->findString("read_snapshot")->getValue()=="") {
     showHelp();
     return 1;
   }
@@ -335,12 +337,14 @@ void writeSol(EnvPtr env, VarVector *orig_v,
               PresolverPtr pres, SolutionPtr sol, SolveStatus status,
               MINOTAUR_AMPL::AMPLInterface* iface)
 {
-  if (sol) {
+  // pres is NULL if the problem was loaded from a snapshot. Then the
+  // solution is of the presolved problem and no .sol file can be written.
+  if (sol && pres) {
     sol = pres->getPostSol(sol);
   }
 
-  if (env->getOptions()->findFlag("AMPL")->getValue() ||
-      true == env->getOptions()->findBool("write_sol_file")->getValue()) {
+  if (pres && (env->getOptions()->findFlag("AMPL")->getValue() ||
+      true == env->getOptions()->findBool("write_sol_file")->getValue())) {
     iface->writeSolution(sol, status);
   } else if (sol && env->getLogger()->getMaxLevel()>=LogExtraInfo) {
     sol->writePrimal(env->getLogger()->msgStream(LogExtraInfo), orig_v);
@@ -421,22 +425,36 @@ int main(int argc, char** argv)
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, inst, &obj_sense);
+  if (env->getOptions()->findString("read_snapshot")->getValue()!="") {
+    // skip reading and presolving. The problem is reformulated again,
+    // because the snapshot does not hold the handlers of the reformulation.
+    ProblemSnapshot snap(env);
+    env->getOptions()->findBool("use_native_cgraph")->setValue(true); 
+    inst = snap.readByOption(&err);
+    if (err) {
+      goto CLEANUP;
+    }
+    inst->calculateSize();
+    orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
+  } else {
+    loadProblem(env, iface, inst, &obj_sense);
+
+    // get presolver.
+    handlers.clear();
+    orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
+    pres = createPres(env, inst, iface->getNumDefs(), handlers);
+    if (env->getOptions()->findBool("presolve")->getValue() == true) {
+      pres->solve();
+    }
+    handlers.clear();
+    ProblemSnapshot(env).writeByOption(inst);
+  }
 
   // Get the right engine.
   engine = getEngine(env);
   env->getLogger()->msgStream(LogExtraInfo) << me 
     << "engine used = " << engine->getName() << std::endl;
 
-  // get presolver.
-  handlers.clear();
-  orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
-  pres = createPres(env, inst, iface->getNumDefs(), handlers);
-  if (env->getOptions()->findBool("presolve")->getValue() == true) {
-    pres->solve();
-  }
-  handlers.clear();
-
   err = transform(env, inst, newp, handlers);
   assert(0==err);
 
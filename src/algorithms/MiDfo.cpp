@@ -16,9 +16,13 @@
 
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <fstream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 #include "BndProcessor.h"
@@ -27,6 +31,7 @@
 #include "EngineFactory.h"
 #include "Environment.h"
 #include "Function.h"
+#include "Heuristic.h"
 #include "IntVarHandler.h"
 #include "LexicoBrancher.h"
 #include "LinearFunction.h"
@@ -53,8 +58,10 @@
 #include "Solution.h"
 #include "SOS1Handler.h"
 #include "SOS2Handler.h"
+#include "SolutionPool.h"
 #include "Timer.h"
 #include "TreeManager.h"
+#include "Variable.h"
 
 #include "AMPLHessian.h"
 #include "AMPLInterface.h"
@@ -64,8 +71,71 @@ using namespace Minotaur;
 BrancherPtr createBrancher(EnvPtr env, ProblemPtr p, HandlerVector handlers,
                            EnginePtr e);
 
+// Offer earlier solutions of the master to the pool of a new
+// branch-and-bound. A solution is added only if it is still feasible, since
+// cuts may have been added after it was found.
+class IncumbentHeur : public Heuristic {
+public:
+  IncumbentHeur(ProblemPtr p, const std::vector<DoubleVector> &sols)
+    : p_(p), sols_(sols) {};
+  void solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool);
+  void writeStats(std::ostream &) const {};
+private:
+  ProblemPtr p_;
+  std::vector<DoubleVector> sols_;
+};
+
+
+void IncumbentHeur::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
+{
+  const double tol = 1e-6;
+  UInt n = p_->getNumVars();
+  VariablePtr v;
+  ConstraintPtr c;
+  const double *x;
+  double act;
+  bool feas;
+  int err;
+
+  for (std::vector<DoubleVector>::const_iterator it=sols_.begin();
+       it!=sols_.end(); ++it) {
+    if (it->size()!=n) {
+      continue;
+    }
+    x = &((*it)[0]);
+    feas = true;
+    for (UInt i=0; i<n && feas; ++i) {
+      v = p_->getVariable(i);
+      if (x[i] < v->getLb()-tol || x[i] > v->getUb()+tol ||
+          (v->getType()!=Continuous && fabs(x[i]-floor(x[i]+0.5)) > tol)) {
+        feas = false;
+      }
+    }
+    for (ConstraintConstIterator cit=p_->consBegin(); cit!=p_->consEnd() &&
+         feas; ++cit) {
+      c = *cit;
+      err = 0;
+      act = c->getActivity(x, &err);
+      if (err || act < c->getLb()-tol || act > c->getUb()+tol) {
+        feas = false;
+      }
+    }
+    if (feas) {
+      err = 0;
+      act = p_->getObjValue(x, &err);
+      if (0==err) {
+        s_pool->addSolution(x, act);
+      }
+    }
+  }
+}
+
+
+// Create a branch-and-bound for the master p. The relaxation rel is created
+// from p if it is NULL, otherwise it must already have all variables and
+// constraints of p (see updateRelaxation). It is loaded to e.
 BranchAndBound* createBab(EnvPtr env, ProblemPtr p, EnginePtr e, 
-                          HandlerVector &handlers)
+                          HandlerVector &handlers, RelaxationPtr &rel)
 {
   BranchAndBound *bab = new BranchAndBound(env, p);
   NodeProcessorPtr nproc = NodeProcessorPtr(); // NULL
@@ -73,7 +143,6 @@ BranchAndBound* createBab(EnvPtr env, ProblemPtr p, EnginePtr e,
   LinHandlerPtr l_hand = (LinHandlerPtr) new LinearHandler(env, p);
   NlPresHandlerPtr nlhand;
   NodeIncRelaxerPtr nr;
-  RelaxationPtr rel;
   BrancherPtr br;
   const std::string me("midfo main: ");
   OptionDBPtr options = env->getOptions();
@@ -117,16 +186,18 @@ BranchAndBound* createBab(EnvPtr env, ProblemPtr p, EnginePtr e,
 
   nr = (NodeIncRelaxerPtr) new NodeIncRelaxer(env, handlers);
   nr->setModFlag(false);
-  rel = (RelaxationPtr) new Relaxation(p);
-  rel->calculateSize();
-  if (options->findBool("use_native_cgraph")->getValue() ||
-      rel->isQP() || rel->isQuadratic()) {
-    rel->setNativeDer();
-  } else {
-    rel->setJacobian(p->getJacobian());
-    rel->setHessian(p->getHessian());
+  if (!rel) {
+    rel = (RelaxationPtr) new Relaxation(p);
+    rel->calculateSize();
+    if (options->findBool("use_native_cgraph")->getValue() ||
+        rel->isQP() || rel->isQuadratic()) {
+      rel->setNativeDer();
+    } else {
+      rel->setJacobian(p->getJacobian());
+      rel->setHessian(p->getHessian());
+    }
+    rel->setInitialPoint(p->getInitialPoint());
   }
-  rel->setInitialPoint(p->getInitialPoint());
   nr->setRelaxation(rel);
   nr->setEngine(e);
   bab->setNodeRelaxer(nr);
@@ -554,6 +625,27 @@ double evalFunction(std::vector<double>point) {
 }
 
 
+// Evaluate the black-box function at points[first], points[first+1], ... and
+// append the values to vals. Each evaluation may be an expensive simulation
+// and they do not depend on each other, so they are done concurrently.
+void evalFunctions(const std::vector<std::vector<double> > &points,
+                   UInt first, std::vector<double> &vals, int nthreads)
+{
+  int npts = (int) points.size() - (int) first;
+
+  if (npts <= 0) {
+    return;
+  }
+  vals.resize(points.size());
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#endif
+  for (int j=0; j<npts; ++j) {
+    vals[first+j] = evalFunction(points[first+j]);
+  }
+}
+
+
 void findCombs(UInt N, UInt K, std::vector<std::vector<UInt> >&combs)
 {
    std::vector<UInt>temp;
@@ -578,103 +670,493 @@ void findCombs(UInt N, UInt K, std::vector<std::vector<UInt> >&combs)
 }
 
 
-SolutionPtr bnbMain(int argc, char** argv, ProblemPtr &oinst, MINOTAUR_AMPL::AMPLInterface* &iface, double* lb)
+// Find the combinations of n+1 interpolation points, out of m points, that
+// include at least one of the new points first, ..., m-1. A combination is
+// the sorted list of indices. Combinations in done are skipped, the others
+// are added to done.
+void findNewCombs(UInt first, UInt m, UInt n,
+                  std::set<std::vector<UInt> > &done,
+                  std::vector<std::vector<UInt> > &combs)
 {
-  SolutionPtr msol;
-  EnvPtr env      = (EnvPtr) new Environment();
-  OptionDBPtr options;
-  //MINOTAUR_AMPL::AMPLInterface* iface = 0;
-  //ProblemPtr oinst;    // instance that needs to be solved.
-  EnginePtr engine;    // engine for solving relaxations. 
-  SolutionPtr sol, sol2;
-  JacobianPtr jPtr;
-  HessianOfLagPtr hPtr;
-  BranchAndBound * bab = 0;
+  std::vector<std::vector<UInt> > jcombs;
+
+  combs.clear();
+  // combinations whose newest point is j. j needs n older points.
+  for (UInt j=std::max(first, n); j<m; ++j) {
+    jcombs.clear();
+    findCombs(j, n, jcombs);
+    for (UInt k=0; k<jcombs.size(); ++k) {
+      if (done.insert(jcombs[k]).second) {
+        combs.push_back(jcombs[k]);
+      }
+    }
+  }
+}
+
+
+/// Cut-generating subproblem that fits a hyperplane through n+1 points.
+struct CutGenLp {
+  /// The LP, with variables coef0, ..., coef(n-1), intercept.
+  ProblemPtr p;
+
+  /// Engine for this LP. p stays loaded, the rows are changed in place.
+  EnginePtr e;
+
+  /// Linear functions to be put in the constraints fitPoints0, ...,
+  /// fitPoints(n) by the next setCutGen. They are swapped with the
+  /// functions that are in the constraints, so none is allocated again.
+  std::vector<LinearFunctionPtr> spare;
+};
+
+
+// Create the cut-generating subproblem. The constraints are filled in by
+// setCutGen for each combination.
+void createCutGen(UInt n, double etol, CutGenLp &lp)
+{
+  FunctionPtr f;
+  FunctionPtr fp;
+  double *a = new double[n+1];
+  VariableConstIterator vbeg, vend;
+  std::stringstream sstm;
+
+  lp.p = (ProblemPtr) new Problem();
+  lp.p->newObjective(f, 0, Minimize, "noObj");
+  for (UInt i=0; i<n; i++) {
+    sstm.str("");
+    sstm <<"coef"<<i;
+    lp.p->newVariable(-INFINITY, INFINITY, Continuous, sstm.str());
+  }
+  lp.p->newVariable(-INFINITY, INFINITY, Continuous, "intercept");
+
+  vbeg = lp.p->varsBegin();
+  vend = lp.p->varsEnd();
+  std::fill(a, a+n+1, 1.0);
+  lp.spare.resize(n+1);
+  for (UInt i=0; i<n+1; i++) {
+    lp.spare[i] = (LinearFunctionPtr) new LinearFunction();
+    fp = (FunctionPtr) new Function((LinearFunctionPtr)
+                                    new LinearFunction(a, vbeg, vend, etol));
+    sstm.str("");
+    sstm << "fitPoints" <<i;
+    lp.p->newConstraint(fp, 0.0, 0.0, sstm.str());
+  }
+  delete [] a;
+}
+
+
+// Change the constraints of the cut-generating subproblem to fit the points
+// of the combination comb. The changes are passed on to the engine, which
+// keeps its basis for the next solve.
+void setCutGen(CutGenLp &lp, UInt n,
+               const std::vector<std::vector<double> > &points,
+               const std::vector<double> &vals, const std::vector<UInt> &comb,
+               double etol)
+{
+  LinearFunctionPtr lf;
+  ConstraintPtr c;
+  double a;
+
+  for (UInt i=0; i<n+1; i++) {
+    c = lp.p->getConstraint(i);
+    lf = lp.spare[i];
+    lf->clearAll();
+    for (UInt j=0; j<n; j++) {
+      a = points[comb[i]][j];
+      if (fabs(a) > etol) {
+        lf->addTerm(lp.p->getVariable(j), a);
+      }
+    }
+    lf->addTerm(lp.p->getVariable(n), 1.0); //coefficient of intercept
+    lp.spare[i] = c->getLinearFunction();
+    lp.p->changeConstraint(c, lf, vals[comb[i]], vals[comb[i]]);
+  }
+}
+
+
+// Create one cut-generating subproblem for each thread and load it to its
+// engine. The engines of threads other than the first are copies of the
+// first engine. Fewer subproblems are created if the engine cannot be
+// copied.
+void initCutGens(EnvPtr env, UInt n, UInt nthreads, double etol,
+                 std::vector<CutGenLp> &lps, int &err)
+{
+  CutGenLp lp;
+
+  lps.clear();
+  for (UInt t=0; t<nthreads; ++t) {
+    createCutGen(n, etol, lp);
+    if (0==t) {
+      lp.e = getEngine(env, lp.p, err);
+      if (err) {
+        return;
+      }
+    } else {
+      lp.e = lps[0].e->emptyCopy();
+      if (!lp.e) {
+        break;
+      }
+    }
+    lp.e->load(lp.p);
+    lps.push_back(lp);
+  }
+}
+
+
+// Solve the cut-generating subproblems of all combinations concurrently,
+// each thread with its own subproblem and engine. The status and the
+// solution (coefficients and intercept) of combination k are saved in
+// status[k], status_str[k] and sols[k].
+void solveCutGens(std::vector<CutGenLp> &lps, UInt n,
+                  const std::vector<std::vector<double> > &points,
+                  const std::vector<double> &vals,
+                  const std::vector<std::vector<UInt> > &combs, double etol,
+                  std::vector<EngineStatus> &status,
+                  std::vector<std::string> &status_str,
+                  std::vector<std::vector<double> > &sols)
+{
+  int ncombs = combs.size();
+
+  status.assign(ncombs, EngineUnknownStatus);
+  status_str.assign(ncombs, "");
+  sols.assign(ncombs, std::vector<double>());
+#if USE_OPENMP
+#pragma omp parallel num_threads((int) lps.size())
+#endif
+  {
+#if USE_OPENMP
+    CutGenLp &lp = lps[omp_get_thread_num()];
+#else
+    CutGenLp &lp = lps[0];
+#endif
+    const double *b;
+
+#if USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int k=0; k<ncombs; ++k) {
+      setCutGen(lp, n, points, vals, combs[k], etol);
+      status[k] = lp.e->solve();
+      status_str[k] = lp.e->getStatusString();
+      if (ProvenOptimal==status[k] || ProvenLocalOptimal==status[k]) {
+        b = lp.e->getSolution()->getPrimal();
+        sols[k].assign(b, b+n+1);
+      }
+    }
+  }
+}
+
+
+/// Data of the master MILP that is kept from one iteration to the next.
+struct MasterMilp {
+  /// Environment, options are read only once.
+  EnvPtr env;
+
+  /// Engine for solving the relaxations, reused in every solve.
+  EnginePtr engine;
+
+  /// AMPL interface used for reading the problem and writing solutions.
+  MINOTAUR_AMPL::AMPLInterface* iface;
+
+  /// Number of times the master has been solved.
+  UInt numSolves;
+
+  /// 1 if the problem is a minimization, -1 otherwise.
+  double objSense;
+
+  /// Variables of the master problem as it was read.
+  VarVector *origV;
+
+  /// Presolver of the first solve. Needed for postsolve.
   PresolverPtr pres;
-  const std::string me("bnb main: ");
-  VarVector *orig_v=0;
-  HandlerVector handlers;
+
+  /// Relaxation solved by engine. Only the new cuts are added to it.
+  RelaxationPtr rel;
+
+  /// Solutions of the previous solve, in the presolved space, with values
+  /// for the variables of the cuts added since (see liftSol).
+  std::vector<DoubleVector> prevSols;
+};
+
+
+void freeMaster(MasterMilp &master)
+{
+  if (master.origV) {
+    delete master.origV;
+    master.origV = 0;
+  }
+  if (master.iface) {
+    delete master.iface;
+    master.iface = 0;
+  }
+  if (master.engine) {
+    master.engine->clear();
+  }
+  master.rel.reset();
+  master.pres.reset();
+  master.engine.reset();
+}
+
+
+// Bring the relaxation of an earlier solve up to date with p: undo the
+// bound changes left by the old tree and copy the variables and constraints
+// added to p since. The engine must have been cleared.
+void updateRelaxation(ProblemPtr p, RelaxationPtr rel)
+{
+  UInt nv = rel->getNumVars();
+  UInt nc = rel->getNumCons();
+  VariablePtr v;
+  ConstraintPtr c;
+  FunctionPtr f;
   int err = 0;
-  double obj_sense = 1.0;
 
-  env->startTimer(err);
-  if (err) {
-    goto CLEANUP;
+  for (UInt i=0; i<nv; ++i) {
+    v = p->getVariable(i);
+    rel->changeBound(i, v->getLb(), v->getUb());
+  }
+  for (UInt i=0; i<nc; ++i) {
+    c = p->getConstraint(i);
+    rel->changeBound(rel->getConstraint(i), c->getLb(), c->getUb());
+  }
+  if (nv==p->getNumVars() && nc==p->getNumCons()) {
+    return;
+  }
+
+  for (UInt i=nv; i<p->getNumVars(); ++i) {
+    v = p->getVariable(i);
+    rel->newVariable(v->getLb(), v->getUb(), v->getType(), v->getName());
+  }
+  for (UInt i=nc; i<p->getNumCons(); ++i) {
+    c = p->getConstraint(i);
+    f = c->getFunction()->cloneWithVars(rel->varsBegin(), &err);
+    rel->newConstraint(f, c->getLb(), c->getUb(), c->getName());
   }
+  if (rel->getInitialPoint()) {
+    rel->resetInitialPoint(rel->getNumVars()-nv);
+  }
+  rel->calculateSize();
+  if (rel->hasNativeDer()) {
+    rel->setNativeDer();
+  }
+}
 
-  setInitialOptions(env);
+
+// Read options and the problem, presolve and find an engine. This is done
+// only once. Later iterations only add cuts to oinst. Returns nonzero if the
+// master should not be solved.
+int initMaster(int argc, char** argv, ProblemPtr &oinst, MasterMilp &master)
+{
+  HandlerVector handlers;
+  const std::string me("bnb main: ");
+  int err = 0;
+
+  master.env       = (EnvPtr) new Environment();
+  master.iface     = 0;
+  master.numSolves = 0;
+  master.objSense  = 1.0;
+  master.origV     = 0;
+
+  setInitialOptions(master.env);
 
   // Important to setup AMPL Interface first as it adds several options.
-  iface = new MINOTAUR_AMPL::AMPLInterface(env, "bnb");
+  master.iface = new MINOTAUR_AMPL::AMPLInterface(master.env, "bnb");
 
   // Parse command line for options set by the user.
-  env->readOptions(argc, argv);
+  master.env->readOptions(argc, argv);
 
-  overrideOptions(env);
-  if (0!=showInfo(env)) {
-    goto CLEANUP;
+  overrideOptions(master.env);
+  if (0!=showInfo(master.env)) {
+    return 1;
   }
 
   if (!oinst) {
-    loadProblem(env, iface, oinst, &obj_sense);
+    loadProblem(master.env, master.iface, oinst, &master.objSense);
   }
 
-  orig_v = new VarVector(oinst->varsBegin(), oinst->varsEnd());
-  pres = presolve(env, oinst, iface->getNumDefs(), handlers);
-  handlers.clear();
-  if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
-    env->getLogger()->msgStream(LogInfo) << me
+  master.origV = new VarVector(oinst->varsBegin(), oinst->varsEnd());
+  master.pres = presolve(master.env, oinst, master.iface->getNumDefs(),
+                         handlers);
+  if (Finished != master.pres->getStatus() &&
+      NotStarted != master.pres->getStatus()) {
+    master.env->getLogger()->msgStream(LogInfo) << me
       << "status of presolve: "
-      << getSolveStatusString(pres->getStatus()) << std::endl;
-    writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
-    writeBnbStatus(env, bab, obj_sense);
-    goto CLEANUP;
+      << getSolveStatusString(master.pres->getStatus()) << std::endl;
+    writeSol(master.env, master.origV, master.pres, SolutionPtr(),
+             master.pres->getStatus(), master.iface);
+    writeBnbStatus(master.env, 0, master.objSense);
+    return 1;
   }
 
-  if (false==env->getOptions()->findBool("solve")->getValue()) {
-    goto CLEANUP;
+  if (false==master.env->getOptions()->findBool("solve")->getValue()) {
+    return 1;
   }
 
-  engine = getEngine(env, oinst, err);
+  master.engine = getEngine(master.env, oinst, err);
+  return err;
+}
+
+
+// Solve the master with the cuts added since the last solve. The engine and
+// the relaxation are kept, only the new cuts are added to the relaxation;
+// the branch-and-bound, which cannot be resumed, is created again. It
+// starts with the solutions of the last solve that are still feasible. The
+// returned solution is in the space of oinst (after presolve). cands gets
+// all solutions saved by the branch-and-bound, best first (see option
+// "bnb_sol_pool_size").
+SolutionPtr solveMaster(MasterMilp &master, ProblemPtr oinst, double* lb,
+                        std::vector<SolutionPtr> &cands)
+{
+  SolutionPtr msol;
+  BranchAndBound * bab = 0;
+  HandlerVector handlers;
+  UInt n = oinst->getNumVars();
+  int err = 0;
+
+  master.env->startTimer(err);
   if (err) {
-    goto CLEANUP;
+    return msol;
   }
 
-  bab = createBab(env, oinst, engine, handlers);
+  // the engine cannot add columns, it is loaded again from the updated
+  // relaxation.
+  master.engine->clear();
+  if (master.rel) {
+    updateRelaxation(oinst, master.rel);
+  }
+  bab = createBab(master.env, oinst, master.engine, handlers, master.rel);
+  if (!master.prevSols.empty()) {
+    bab->addPreRootHeur((HeurPtr) new IncumbentHeur(oinst,
+                                                    master.prevSols));
+  }
   bab->solve();
-  bab->writeStats(env->getLogger()->msgStream(LogExtraInfo));
-  engine->writeStats(env->getLogger()->msgStream(LogExtraInfo));
-  for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end(); ++it) {
-    (*it)->writeStats(env->getLogger()->msgStream(LogExtraInfo));
+  bab->writeStats(master.env->getLogger()->msgStream(LogExtraInfo));
+  master.engine->writeStats(master.env->getLogger()->
+                            msgStream(LogExtraInfo));
+  for (HandlerVector::iterator it=handlers.begin(); it!=handlers.end();
+       ++it) {
+    (*it)->writeStats(master.env->getLogger()->msgStream(LogExtraInfo));
   }
 
-  writeSol(env, orig_v, pres, bab->getSolution(), bab->getStatus(), iface);
-  writeBnbStatus(env, bab, obj_sense);
+  writeSol(master.env, master.origV, master.pres, bab->getSolution(),
+           bab->getStatus(), master.iface);
+  writeBnbStatus(master.env, bab, master.objSense);
+  ++(master.numSolves);
+
+  cands.clear();
+  master.prevSols.clear();
+  if (bab->getSolution()) {
+    SolutionPoolPtr pool = bab->getSolutionPool();
+    for (SolutionIterator it=pool->solsBegin(); it!=pool->solsEnd(); ++it) {
+      cands.push_back((SolutionPtr) new Solution(*it));
+      master.prevSols.push_back(DoubleVector((*it)->getPrimal(),
+                                             (*it)->getPrimal()+n));
+    }
+    msol = (SolutionPtr) new Solution(bab->getSolution());
+    *lb = master.objSense*bab->getUb();
+  }
 
-  msol = (SolutionPtr) new Solution(pres->getPostSol(bab->getSolution()));
-  *lb = obj_sense*bab->getUb();
+  delete bab;
+  return msol;
+}
 
-CLEANUP:
-  //if (iface) {
-    //delete iface;
-  //}
-  if (bab) {
-    delete bab;
+
+// Solve the dense n x n system a*y = r by Gaussian elimination with partial
+// pivoting. a is row-wise and is overwritten, y is returned in r. Returns
+// false if a is (nearly) singular.
+bool solveDense(UInt n, std::vector<double> &a, std::vector<double> &r)
+{
+  UInt piv;
+  double f;
+
+  for (UInt k=0; k<n; ++k) {
+    piv = k;
+    for (UInt i=k+1; i<n; ++i) {
+      if (fabs(a[i*n+k]) > fabs(a[piv*n+k])) {
+        piv = i;
+      }
+    }
+    if (fabs(a[piv*n+k]) < 1e-12) {
+      return false;
+    }
+    if (piv!=k) {
+      std::swap_ranges(a.begin()+k*n, a.begin()+(k+1)*n, a.begin()+piv*n);
+      std::swap(r[k], r[piv]);
+    }
+    for (UInt i=k+1; i<n; ++i) {
+      f = a[i*n+k]/a[k*n+k];
+      for (UInt j=k; j<n; ++j) {
+        a[i*n+j] -= f*a[k*n+j];
+      }
+      r[i] -= f*r[k];
+    }
   }
-  if (orig_v) {
-    delete orig_v;
+  for (UInt k=n; k-->0; ) {
+    for (UInt j=k+1; j<n; ++j) {
+      r[k] -= a[k*n+j]*r[j];
+    }
+    r[k] /= a[k*n+k];
   }
+  return true;
+}
 
-  //return 0;
-  return msol;
+
+// Give values to the variables of a new cut in an earlier master solution
+// x, so that x may stay feasible: lambda from the cone definitions of the
+// points of comb, w and z from the signs of lambda, eCut from its
+// definition, and eta is raised above the cut. x must have a value for
+// every variable of the master. The heuristic that offers x checks the
+// result.
+void liftSol(DoubleVector &x, UInt n, UInt xbeg, UInt eta, const double *b,
+             double bigm, double eps_lambda,
+             const std::vector<std::vector<double> > &points,
+             const std::vector<UInt> &comb,
+             const std::vector<VariablePtr> &zvar, VariablePtr ecut,
+             const std::vector<std::vector<VariablePtr> > &lambda,
+             const std::vector<std::vector<VariablePtr> > &wvar)
+{
+  std::vector<double> a(n*n), r(n);
+  double cx = 0.0, nz = 0.0;
+  bool allw;
+
+  for (UInt i=0; i<n; ++i) {
+    cx += b[i]*x[xbeg+i];
+  }
+  for (UInt p=0; p<n+1; ++p) {
+    const std::vector<double> &pp = points[comb[p]];
+    for (UInt i=0; i<n; ++i) {
+      for (UInt q=0, k=0; q<n+1; ++q) {
+        if (q!=p) {
+          a[i*n+k] = pp[i] - points[comb[q]][i];
+          ++k;
+        }
+      }
+      r[i] = x[xbeg+i] - pp[i];
+    }
+    if (!solveDense(n, a, r)) {
+      return;
+    }
+    allw = true;
+    for (UInt k=0; k<n; ++k) {
+      x[lambda[p][k]->getIndex()] = r[k];
+      if (r[k] > -eps_lambda) {
+        x[wvar[p][k]->getIndex()] = 1.0;
+      } else {
+        x[wvar[p][k]->getIndex()] = 0.0;
+        allw = false;
+      }
+    }
+    x[zvar[p]->getIndex()] = allw ? 1.0 : 0.0;
+    nz += allw ? 1.0 : 0.0;
+  }
+  x[ecut->getIndex()] = cx + bigm*nz - bigm + b[n];
+  x[eta] = std::max(x[eta], x[ecut->getIndex()]);
 }
 
 
 int main(int argc, char** argv)
 {
   EnvPtr menv      = (EnvPtr) new Environment();
+  MasterMilp master;
   //OptionDBPtr options;
-  MINOTAUR_AMPL::AMPLInterface* iface = 0;
   ProblemPtr oinst;    // instance that needs to be solved.
   //EnginePtr engine;    // engine for solving relaxations.
   SolutionPtr msol;
@@ -709,26 +1191,21 @@ int main(int argc, char** argv)
   VariableConstIterator vxbeg;
   VariablePtr v, veta;
 
-  ProblemPtr cutGen = (ProblemPtr) new Problem();       //cut generating subproblem
-  EnginePtr cutGenEngine;                               //engine for solving relaxations
-  EngineStatus engineStatus;
-  FunctionPtr f;                                        //objective function for cut-generating subproblem (null)
-  std::vector<LinearFunctionPtr> cutGenCon(n+1);        //constraint functions for cut-generating subproblem
-  std::vector<FunctionPtr> fp(n+1);                     //function pointers for constraints of cut-generating subproblem
+  std::vector<CutGenLp> cutGens;                        //cut generating subproblems, one per thread
+  std::vector<EngineStatus> cgStatus;                   //status of cut generating subproblem of each combination
+  std::vector<std::string> cgStatusStr;
+  std::vector<std::vector<double> > cgSols;             //solution of cut generating subproblem of each combination
   std::vector<LinearFunctionPtr> cuts;                  //cuts for the master problem
   std::vector<FunctionPtr> fm(n+1);                     //function pointers for cuts for master problem
-  LinearFunctionPtr lf;
+  std::vector<SolutionPtr> cands;                       //solutions of the master, best first
+  UInt nthreads = 1;
+  UInt firstNew;                                        //index of first new interpolation point
 
   std::vector<std::vector<UInt> >combs;
-  std::vector<std::vector<UInt> >combsN;
+  std::set<std::vector<UInt> >doneCombs;                //combinations already used for cuts
 
-  double **a = new double*[n+1];
-  for(i = 0; i < n+1; ++i) {
-    a[i] = new double[n+1];
-  }
-  const double *b = new double[n+1];
+  const double *b = 0;
   double *c = new double[n+1];
-  VariableConstIterator vbeg,vend;
   std::stringstream sstm;
 
   //READING THE MASTER MIP FROM .nl file (for now)
@@ -738,10 +1215,15 @@ int main(int argc, char** argv)
   //Generate initial master MIP
   //------------------------------
 
-  //Calculate initial function values (may be provided)
-  for (std::vector<std::vector<double> >::size_type j=0; j<interpPoints.size(); j++) {
-    funcVals.push_back(evalFunction(interpPoints[j]));
+  //SET UP THE MASTER ONCE, LATER ITERATIONS ONLY ADD CUTS
+  if (0!=initMaster(argc, argv, oinst, master)) {
+    shouldStop = true;
   }
+  nthreads = std::max(1, master.env->getOptions()->findInt("threads")->
+                      getValue());
+
+  //Calculate initial function values (may be provided)
+  evalFunctions(interpPoints, 0, funcVals, nthreads);
 
   minAt = std::min_element(funcVals.begin(), funcVals.end());
   //std::cout << "min element at: " << std::distance(funcVals.begin(), minAt);
@@ -755,7 +1237,7 @@ int main(int argc, char** argv)
     std::cout<<"\n ub = "<<ub;
 
     //SOLVE THE MASTER (MILP)---------------------
-    msol = bnbMain(argc, argv, oinst, iface, &lb);
+    msol = solveMaster(master, oinst, &lb, cands);
     //--------------------------------------------
     if (!msol) {
       std::cout<<"\n Master MIP NOT SOLVED..ABORTING\n";
@@ -773,15 +1255,26 @@ int main(int argc, char** argv)
       std::cout<<"\nITERATION LIMIT REACHED..\n"<<std::endl;
     } else {
  
-      //EVALUATE FUNCTION AT NEW POINT
-      mipSol = msol->getPrimal();
-      if (temp.size()) { temp.clear();}
-      i=0;
-      for (vit=oinst->varsBegin(); 
-         vit!=oinst->varsEnd(); ++vit, ++i) {
-        if (((*vit)->getName()).find("x")!= std::string::npos) {
-          temp.push_back(mipSol[i]);
-          std::cout<<(*vit)->getName() << " = " << mipSol[i]<<"\n";
+      //EVALUATE FUNCTION AT NEW POINTS, ONE FOR EACH MASTER SOLUTION
+      firstNew = interpPoints.size();
+      for (UInt s=0; s<cands.size(); ++s) {
+        mipSol = cands[s]->getPrimal();
+        if (temp.size()) { temp.clear();}
+        i=0;
+        for (vit=oinst->varsBegin(); 
+           vit!=oinst->varsEnd(); ++vit, ++i) {
+          if (((*vit)->getName()).find("x")!= std::string::npos) {
+            temp.push_back(mipSol[i]);
+            std::cout<<(*vit)->getName() << " = " << mipSol[i]<<"\n";
+          }
+        }
+        if (!temp.size()) {
+          break;
+        }
+        //Points already interpolated do not give new cuts
+        if (std::find(interpPoints.begin(), interpPoints.end(), temp)
+            == interpPoints.end()) {
+          interpPoints.push_back(temp);
         }
       }
       
@@ -797,99 +1290,41 @@ int main(int argc, char** argv)
         std::cout << "\n VARIABLES X NOT FOUND IN SOLUTION! ABORTING...\n"; 
         break;
       }
-      interpPoints.push_back(temp);
       std::cout<<"\nNEW SET OF INTERPOLATION POINTS\n";
       print2dVec(interpPoints);             
-      funcVals.push_back(evalFunction(temp));
+      evalFunctions(interpPoints, firstNew, funcVals, nthreads);
       minAt = std::min_element(funcVals.begin(), funcVals.end());
 
       //Update upper bound and best solution
       ub = *minAt;
 
-      //FIND ALL NEW CUT COMBINATIONS
+      //FIND CUT COMBINATIONS THAT USE A NEW POINT
       UInt m = interpPoints.size();
-      findCombs(m-1, n, combs);
+      findNewCombs(firstNew, m, n, doneCombs, combs);
       std::cout<<"\nNEW SET OF CUT COMBINATIONS\n";
       print2dVec(combs);
 
-      //FIND CUTS USING THE NEW POINT
-      for (UInt k=0; k<combs.size(); k++) {
-        // Create the cut generating subproblem for the first time (LP)
-        if (iter == 1 && k == 0) {
-          //Update M(i) for first iteration (iter==1)
-          //Find constraint with eta variable
-          //Find the linear function associated with each constraint
-          //for {j in 1..J} {
-            //let M[j]:=0;
-            //for {i in 1..n} {
-                  //if c[j,i]<0 then {
-                    //M[j] := M[j] + c[j,i]*lbx[i];
-                  //}
-                  //else {
-                    //M[j] := M[j] + c[j,i]*ubx[i];		 
-                  //}
-            //}
-            //M[j]:= M[j] + d[j] - lb;		 
-          //}
-
-          cutGen->newObjective(f, 0, Minimize, "noObj");
-          sstm.str("");
-          for (i=0; i<n;i++) {
-            sstm <<"coef"<<i;
-            cutGen->newVariable(-INFINITY, INFINITY, Continuous, sstm.str());
-            sstm.str("");
-          }
-          cutGen->newVariable(-INFINITY, INFINITY, Continuous, "intercept");
-
-          vbeg = cutGen->varsBegin();
-          vend = cutGen->varsEnd();
+      //SOLVE THE CUT GENERATING SUBPROBLEMS (LP) CONCURRENTLY
+      if (cutGens.empty()) {
+        initCutGens(menv, n, nthreads, etol, cutGens, merr);
+        if (merr) {
+          std::cout<<"Error in getting engine for cut-generating subproblem.\n";
+          break;
+        }
+      }
+      solveCutGens(cutGens, n, interpPoints, funcVals, combs, etol, cgStatus,
+                   cgStatusStr, cgSols);
 
+      //FIND CUTS USING THE NEW POINTS, IN THE ORDER OF COMBINATIONS
+      for (UInt k=0; k<combs.size(); k++) {
+        std::cout << "engine status = " << cgStatusStr[k] << std::endl;
+        if(cgStatus[k] == ProvenOptimal || cgStatus[k] == ProvenLocalOptimal) {
           for (i=0; i<n+1; i++) {
-            for (UInt j=0; j<n; j++) {
-              a[i][j] = interpPoints[combs[k][i]][j];
-            }
-            a[i][n] = 1;        //coefficient of intercept always 1
-            cutGenCon[i] = (LinearFunctionPtr) new LinearFunction(a[i], vbeg, vend, etol);
-            sstm << "fitPoints" <<i;
-            fp[i] = (FunctionPtr) new Function(cutGenCon[i]);
-            cutGen->newConstraint(fp[i], funcVals[combs[k][i]], funcVals[combs[k][i]], sstm.str());
-            sstm.str("");
-          }
-          
-          cutGenEngine = getEngine(menv, cutGen, merr);
-          if (merr) {
-            std::cout<<"Error in getting engine for cut-generating subproblem.\n";
-          }
-        } else {
-          cutGenEngine->clear();    
-          
-          for (i=0; i<n+1; i++) {
-            for (UInt j=0; j<n; j++) {
-              a[i][j] = interpPoints[combs[k][i]][j];
-            }
-            a[i][n] = 1;
-            lf = (LinearFunctionPtr) new LinearFunction(a[i], vbeg, vend, etol);
-            //std::cout<<"\ncon before "; cutGenCon[i]->write(std::cout);
-            cutGenCon[i]->clearAll();
-            cutGenCon[i]->add(lf);
-            //std::cout<<"\ncon after "; cutGenCon[i]->write(std::cout);
-            fp[i] = (FunctionPtr) new Function(cutGenCon[i]);
-            cutGen->changeBound(cutGen->getConstraint(i), funcVals[combs[k][i]], funcVals[combs[k][i]]);
+            std::cout << "coef" << i << "  " << cgSols[k][i] << std::endl;
           }
-        }
-
-        //cutGen->write(std::cout);
-        cutGenEngine->load(cutGen);    
-        std::cout<<"SOLVING CUT GENERATING SUBPROBLEM.." << std::endl;
-        cutGenEngine->solve();
-        engineStatus = cutGenEngine->getStatus();
-        std::cout << "engine status = " 
-                  << cutGenEngine->getStatusString() << std::endl;
-        if(engineStatus == ProvenOptimal || engineStatus == ProvenLocalOptimal) {
-          cutGenEngine->getSolution()->writePrimal(std::cout);
         
           //ADD CUTS TO MASTER PROBLEM
-          b = cutGenEngine->getSolution()->getPrimal();
+          b = &(cgSols[k][0]);
           UInt M = 0; 
           //Get iterator for x variables
           for (vit=oinst->varsBegin(); vit!=oinst->varsEnd(); ++vit) {
@@ -1054,6 +1489,14 @@ int main(int argc, char** argv)
             FunctionPtr fwLambda3 = (FunctionPtr) new Function(wLambda3);
             (oinst->newConstraint(fwLambda3, -INFINITY, 0, sstm.str()));
           } 
+
+          //LIFT THE LAST MASTER SOLUTIONS, FOR A WARM START
+          for (UInt s=0; s<master.prevSols.size(); ++s) {
+            master.prevSols[s].resize(oinst->getNumVars(), 0.0);
+            liftSol(master.prevSols[s], n, (*vxbeg)->getIndex(),
+                    veta->getIndex(), b, bigM.back(), epsLambda,
+                    interpPoints, combs[k], zvar, veCut, lambda, wvar);
+          }
           //break;
 
         } else {
@@ -1095,10 +1538,8 @@ int main(int argc, char** argv)
     //delete orig_v;
   //}
 
-  for(i = 0; i < n+1; ++i) {
-        delete [] a[i];
-  }
-  delete [] a;
+  delete [] c;
+  freeMaster(master);
 
   return 0;
 }
@@ -18,6 +18,7 @@
 #include <AMPLJacobian.h>
 #include <Environment.h>
 #include <Handler.h>
+#include <Heuristic.h>
 #include <Option.h>
 #include <Problem.h>
 #include <Engine.h>
@@ -35,12 +36,15 @@
 #include <BranchAndBound.h>
 #include <PCBProcessor.h>
 #include <Presolver.h>
+#include <ProblemSnapshot.h>
 #include <Timer.h>
 #include <LexicoBrancher.h>
 #include <Logger.h>
 #include <LinearHandler.h>
 #include <IntVarHandler.h>
 #include <Solution.h>
+#include <SolutionPool.h>
+#include <StatsRegistry.h>
 #include <TreeManager.h>
 #include <EngineFactory.h>
 #include <CxQuadHandler.h>
@@ -50,13 +54,35 @@
 
 using namespace Minotaur;
 
+BranchAndBound* createBab(EnvPtr env, ProblemPtr p, LPEnginePtr lin_e,
+                          HandlerVector &handlers, SolutionPtr inc);
 EnginePtr getNLPEngine(EnvPtr env, ProblemPtr p);
+void solveMasters(EnvPtr env, ProblemPtr p, LPEnginePtr lin_e,
+                  HandlerVector &handlers, QGHandlerPtr qg_hand,
+                  SolutionPtr *inc);
 void writeBnbStatus(EnvPtr env, BranchAndBound *bab, double obj_sense);
 void writeSol(EnvPtr env, VarVector *orig_v, PresolverPtr pres,
               SolutionPtr sol, SolveStatus status,
               MINOTAUR_AMPL::AMPLInterface* iface);
 
 
+// Add a known solution to the pool of a new branch-and-bound, so that the
+// incumbent of an earlier tree is used for pruning.
+class IncumbentHeur : public Heuristic {
+public:
+  IncumbentHeur(SolutionPtr sol) : sol_(sol) {};
+  void solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
+  {
+    if (sol_) {
+      s_pool->addSolution(sol_);
+    }
+  };
+  void writeStats(std::ostream &) const {};
+private:
+  SolutionPtr sol_;
+};
+
+
 void loadProblem(EnvPtr env, MINOTAUR_AMPL::AMPLInterface* iface,
                  ProblemPtr &oinst, double *obj_sense)
 {
@@ -161,7 +187,8 @@ int showInfo(EnvPtr env)
     return 1;
   }
 
-  if (options->findString("problem_file")->getValue()=="") {
+  if (options->findString("problem_file")->getValue()=="" &&
+      options->findString("read_snapshot")->getValue()=="") {
     showHelp();
     return 1;
   }
@@ -269,11 +296,6 @@ int main(int argc, char* argv[])
   EngineFactory *efac;
   const std::string me("qg: ");
 
-  BrancherPtr br = BrancherPtr(); // NULL
-  PCBProcessorPtr nproc;
-
-  NodeIncRelaxerPtr nr;
-
   //handlers
   HandlerVector handlers;
   IntVarHandlerPtr v_hand;
@@ -311,30 +333,43 @@ int main(int argc, char* argv[])
     goto CLEANUP;
   }
 
-  loadProblem(env, iface, inst, &obj_sense);
-
-  // Separability detection
-  sepDetection(env, inst);
-
-  // Initialize engines
-  nlp_e = getNLPEngine(env, inst); //Engine for Original problem
+  if (options->findString("read_snapshot")->getValue()!="") {
+    // skip reading, separability detection and presolving.
+    ProblemSnapshot snap(env);
+    inst = snap.readByOption(&err);
+    if (err) {
+      goto CLEANUP;
+    }
+    inst->calculateSize();
+    nlp_e = getNLPEngine(env, inst);
+    orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
+  } else {
+    loadProblem(env, iface, inst, &obj_sense);
+
+    // Separability detection
+    sepDetection(env, inst);
+
+    // Initialize engines
+    nlp_e = getNLPEngine(env, inst); //Engine for Original problem
+
+    // get presolver.
+    orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
+    pres = presolve(env, inst, iface->getNumDefs(), handlers);
+    handlers.clear();
+    if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "status of presolve: " 
+        << getSolveStatusString(pres->getStatus()) << std::endl;
+      writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
+      writeBnbStatus(env, bab, obj_sense);
+      goto CLEANUP;
+    }
+    ProblemSnapshot(env).writeByOption(inst);
+  }
 
   efac = new EngineFactory(env);
   lin_e = efac->getLPEngine();   // lp engine 
   delete efac;
-
-  // get presolver.
-  orig_v = new VarVector(inst->varsBegin(), inst->varsEnd());
-  pres = presolve(env, inst, iface->getNumDefs(), handlers);
-  handlers.clear();
-  if (Finished != pres->getStatus() && NotStarted != pres->getStatus()) {
-    env->getLogger()->msgStream(LogInfo) << me 
-      << "status of presolve: " 
-      << getSolveStatusString(pres->getStatus()) << std::endl;
-    writeSol(env, orig_v, pres, SolutionPtr(), pres->getStatus(), iface);
-    writeBnbStatus(env, bab, obj_sense);
-    goto CLEANUP;
-  }
  
    if (options->findBool("solve")->getValue()==true) {
     if (true==options->findBool("use_native_cgraph")->getValue()) {
@@ -374,40 +409,10 @@ int main(int argc, char* argv[])
         << std::endl;
     }
 
-    // Only store bound-changes of relaxation (not problem)
-    nr = (NodeIncRelaxerPtr) new NodeIncRelaxer(env, handlers);
-    nr->setModFlag(false);
-
-    nr->setEngine(lin_e);
-    nproc = (PCBProcessorPtr) new PCBProcessor(env, lin_e, handlers);
-
-    if (env->getOptions()->findString("brancher")->getValue() == "rel") {
-      ReliabilityBrancherPtr rel_br = 
-        (ReliabilityBrancherPtr) new ReliabilityBrancher(env, handlers);
-      rel_br->setEngine(lin_e);
-      nproc->setBrancher(rel_br);
-      br = rel_br;
-    } else if (env->getOptions()->findString("brancher")->getValue()
-               == "maxvio") {
-      MaxVioBrancherPtr mbr = (MaxVioBrancherPtr) 
-        new MaxVioBrancher(env, handlers);
-      nproc->setBrancher(mbr);
-      br = mbr;
-    } else if (env->getOptions()->findString("brancher")->getValue()
-               == "lex") {
-      LexicoBrancherPtr lbr = (LexicoBrancherPtr) 
-        new LexicoBrancher(env, handlers);
-      br = lbr;
+    if (true==options->findBool("qg_hybrid")->getValue()) {
+      solveMasters(env, inst, lin_e, handlers, qg_hand, &sol);
     }
-    nproc->setBrancher(br);
-    env->getLogger()->msgStream(LogExtraInfo) << me <<
-      "brancher used = " << br->getName() << std::endl;
-
-    bab = new BranchAndBound(env, inst);
-    bab->setNodeRelaxer(nr);
-    bab->setNodeProcessor(nproc);
-    bab->shouldCreateRoot(true);
-
+    bab = createBab(env, inst, lin_e, handlers, sol);
 
     // start solving
     bab->solve();
@@ -441,6 +446,55 @@ CLEANUP:
 }
 
 
+BranchAndBound* createBab(EnvPtr env, ProblemPtr p, LPEnginePtr lin_e,
+                          HandlerVector &handlers, SolutionPtr inc)
+{
+  BranchAndBound *bab = 0;
+  BrancherPtr br = BrancherPtr(); // NULL
+  PCBProcessorPtr nproc;
+  NodeIncRelaxerPtr nr;
+  const std::string me("qg: ");
+
+  // Only store bound-changes of relaxation (not problem)
+  nr = (NodeIncRelaxerPtr) new NodeIncRelaxer(env, handlers);
+  nr->setModFlag(false);
+
+  nr->setEngine(lin_e);
+  nproc = (PCBProcessorPtr) new PCBProcessor(env, lin_e, handlers);
+
+  if (env->getOptions()->findString("brancher")->getValue() == "rel") {
+    ReliabilityBrancherPtr rel_br = 
+      (ReliabilityBrancherPtr) new ReliabilityBrancher(env, handlers);
+    rel_br->setEngine(lin_e);
+    nproc->setBrancher(rel_br);
+    br = rel_br;
+  } else if (env->getOptions()->findString("brancher")->getValue()
+             == "maxvio") {
+    MaxVioBrancherPtr mbr = (MaxVioBrancherPtr) 
+      new MaxVioBrancher(env, handlers);
+    nproc->setBrancher(mbr);
+    br = mbr;
+  } else if (env->getOptions()->findString("brancher")->getValue()
+             == "lex") {
+    LexicoBrancherPtr lbr = (LexicoBrancherPtr) 
+      new LexicoBrancher(env, handlers);
+    br = lbr;
+  }
+  nproc->setBrancher(br);
+  env->getLogger()->msgStream(LogExtraInfo) << me <<
+    "brancher used = " << br->getName() << std::endl;
+
+  bab = new BranchAndBound(env, p);
+  bab->setNodeRelaxer(nr);
+  bab->setNodeProcessor(nproc);
+  bab->shouldCreateRoot(true);
+  if (inc) {
+    bab->addPreRootHeur((HeurPtr) new IncumbentHeur(inc));
+  }
+  return bab;
+}
+
+
 EnginePtr getNLPEngine(EnvPtr env, ProblemPtr p)
 {
   EngineFactory *efac = new EngineFactory(env);
@@ -476,6 +530,75 @@ EnginePtr getNLPEngine(EnvPtr env, ProblemPtr p)
 }
 
 
+// Multi-tree QG: solve master MILPs with the linearizations found so far
+// and solve an NLP at the optimal solution of each. Stop when a master
+// cannot improve the incumbent, or when an LP solve takes more than
+// qg_hybrid_ratio times an NLP solve, because then the many LPs of the
+// masters cost more than the NLPs saved by not solving them in a single
+// tree. The linearizations stay in the pool of qg_hand and the incumbent
+// is returned in inc, so that both are used in the single tree solved
+// after this.
+void solveMasters(EnvPtr env, ProblemPtr p, LPEnginePtr lin_e,
+                  HandlerVector &handlers, QGHandlerPtr qg_hand,
+                  SolutionPtr *inc)
+{
+  OptionDBPtr options = env->getOptions();
+  StatTimer *lp_t = env->getStats()->timer("engine.solve");
+  StatTimer *nlp_t = env->getStats()->timer("qg.nlp_solve");
+  int max_rounds = options->findInt("qg_hybrid_rounds")->getValue();
+  double ratio = options->findDouble("qg_hybrid_ratio")->getValue();
+  SolutionPoolPtr pool = (SolutionPoolPtr) new SolutionPool(env, p, 1);
+  BranchAndBound *bab;
+  ConstSolutionPtr msol;
+  SeparationStatus status;
+  bool sol_found;
+  long lp_calls;
+  double lp_secs, lp_avg, nlp_avg;
+  const std::string me("qg: ");
+
+  qg_hand->setMasterMode(true);
+  for (int r=0; r<max_rounds; ++r) {
+    bab = createBab(env, p, lin_e, handlers, pool->getBestSolution());
+    lp_calls = lp_t->calls();
+    lp_secs = lp_t->seconds();
+    bab->solve();
+    lp_calls = lp_t->calls() - lp_calls;
+    lp_secs = lp_t->seconds() - lp_secs;
+
+    msol = bab->getSolution();
+    status = SepaPrune;
+    if (SolvedOptimal==bab->getStatus() && msol && 
+        msol->getObjValue() < pool->getBestSolutionValue()) {
+      qg_hand->cutMasterSol(msol, pool, &sol_found, &status);
+    }
+    // the tree is finished, so its best value, not getLb(), is the bound.
+    env->getLogger()->msgStream(LogInfo) << me << "master " << r 
+      << ": lb = " << bab->getUb() << ", ub = " 
+      << pool->getBestSolutionValue() << ", lp solves = " << lp_calls
+      << ", cuts in pool = " << qg_hand->getNumPoolCuts() << std::endl;
+    delete bab;
+    // The relaxation of this master lives on in the handlers. Detach it
+    // from lin_e, or freeing it later clears the engine of the next tree.
+    lin_e->clear();
+    if (SepaResolve!=status) {
+      // optimal, infeasible or the master did not finish.
+      break;
+    }
+
+    lp_avg = (lp_calls>0) ? lp_secs/lp_calls : 0.0;
+    nlp_avg = (nlp_t->calls()>0) ? nlp_t->seconds()/nlp_t->calls() : 0.0;
+    if (lp_avg > ratio*nlp_avg) {
+      env->getLogger()->msgStream(LogInfo) << me 
+        << "switching to single tree, time per lp solve = " << lp_avg
+        << ", time per nlp solve = " << nlp_avg << std::endl;
+      break;
+    }
+  }
+  qg_hand->setMasterMode(false);
+  *inc = pool->getBestSolution();
+}
+
+
 void writeBnbStatus(EnvPtr env, BranchAndBound *bab, double obj_sense)
 {
 
@@ -518,12 +641,14 @@ void writeSol(EnvPtr env, VarVector *orig_v,
               PresolverPtr pres, SolutionPtr sol, SolveStatus status,
               MINOTAUR_AMPL::AMPLInterface* iface)
 {
-  if (sol) {
+  // pres is NULL if the problem was loaded from a snapshot. Then the
+  // solution is of the presolved problem and no .sol file can be written.
+  if (sol && pres) {
     sol = pres->getPostSol(sol);
   }
 
-  if (env->getOptions()->findFlag("AMPL")->getValue() ||
-      true == env->getOptions()->findBool("write_sol_file")->getValue()) {
+  if (pres && (env->getOptions()->findFlag("AMPL")->getValue() ||
+      true == env->getOptions()->findBool("write_sol_file")->getValue())) {
     iface->writeSolution(sol, status);
   } else if (sol && env->getLogger()->getMaxLevel()>=LogExtraInfo) {
     sol->writePrimal(env->getLogger()->msgStream(LogExtraInfo), orig_v);
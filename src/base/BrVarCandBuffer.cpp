@@ -0,0 +1,106 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file BrVarCandBuffer.cpp
+ * \brief Define the class BrVarCandBuffer for collecting candidates for
+ * branching on variables in flat arrays.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include "MinotaurConfig.h"
+#include "BrVarCand.h"
+#include "BrVarCandBuffer.h"
+
+using namespace Minotaur;
+
+
+BrVarCandBuffer::BrVarCandBuffer()
+  : accumulate_(false),
+    curHandler_(0),
+    sorted_(true)
+{
+}
+
+
+BrVarCandBuffer::~BrVarCandBuffer()
+{
+  clear();
+}
+
+
+UInt BrVarCandBuffer::add(UInt i, double ddist, double udist)
+{
+  int k = find(i);
+  if (k>-1) {
+    if (accumulate_) {
+      dDist_[k] += ddist;
+      uDist_[k] += udist;
+    }
+    return k;
+  }
+  if (i>=pos_.size()) {
+    pos_.resize(i+1, -1);
+  }
+  if (!index_.empty() && index_.back()>i) {
+    sorted_ = false;
+  }
+  pos_[i] = index_.size();
+  index_.push_back(i);
+  dDist_.push_back(ddist);
+  uDist_.push_back(udist);
+  score_.push_back(0.0);
+  handler_.push_back(curHandler_);
+  cands_.push_back(BrVarCandPtr());
+  return pos_[i];
+}
+
+
+UInt BrVarCandBuffer::add(BrVarCandPtr cand)
+{
+  UInt n = index_.size();
+  UInt k = add(cand->getPCostIndex(), cand->getDDist(), cand->getUDist());
+  if (k==n) {
+    cands_[k] = cand;
+  } else if (cands_[k]) {
+    cands_[k]->setDist(dDist_[k], uDist_[k]);
+  }
+  return k;
+}
+
+
+void BrVarCandBuffer::clear()
+{
+  for (UIntVector::const_iterator it=index_.begin(); it!=index_.end();
+       ++it) {
+    pos_[*it] = -1;
+  }
+  index_.clear();
+  dDist_.clear();
+  uDist_.clear();
+  score_.clear();
+  handler_.clear();
+  cands_.clear();
+  sorted_ = true;
+}
+
+
+int BrVarCandBuffer::find(UInt i) const
+{
+  return (i<pos_.size()) ? pos_[i] : -1;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
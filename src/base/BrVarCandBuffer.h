@@ -0,0 +1,156 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file BrVarCandBuffer.h
+ * \brief Declare the class BrVarCandBuffer for collecting candidates for
+ * branching on variables in flat arrays.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#ifndef MINOTAURBRVARCANDBUFFER_H
+#define MINOTAURBRVARCANDBUFFER_H
+
+#include "Types.h"
+
+namespace Minotaur {
+
+/**
+ * \brief A reusable buffer of candidates for branching on variables.
+ *
+ * A candidate is stored as the index of its variable, the distances from
+ * the down and up branches, a score and the position of the handler that
+ * added it. A brancher owns one buffer and clears it at every node; the
+ * arrays keep their capacity, so that no memory is allocated once they are
+ * large enough. A BrVarCand object is stored for a candidate only if the
+ * handler created one or the brancher asks for it, e.g. for strong branching
+ * or for the branch that is finally created.
+ */
+class BrVarCandBuffer {
+public:
+  /// Constructor.
+  BrVarCandBuffer();
+
+  /// Destroy.
+  ~BrVarCandBuffer();
+
+  /**
+   * \brief Add a candidate for branching on variable with index i.
+   *
+   * If the variable already has a candidate in the buffer, then the
+   * distances are added to it if accumulate mode is on, otherwise the call
+   * has no effect.
+   * \param[in] i Index of the variable.
+   * \param[in] ddist Distance from the down branch.
+   * \param[in] udist Distance from the up branch.
+   * \return Position of the candidate of variable i in the buffer.
+   */
+  UInt add(UInt i, double ddist, double udist);
+
+  /**
+   * \brief Add a candidate object created by a handler. Same as
+   * add(UInt, double, double) except that the object is stored too if
+   * the variable is new.
+   */
+  UInt add(BrVarCandPtr cand);
+
+  /// Remove all candidates. Capacity is retained.
+  void clear();
+
+  /**
+   * \brief Find a candidate.
+   *
+   * \param[in] i Index of the variable.
+   * \return Position of the candidate of variable i, or -1 if there is none.
+   */
+  int find(UInt i) const;
+
+  /// Return the candidate object at position k; NULL if none is stored.
+  BrVarCandPtr getCand(UInt k) const { return cands_[k]; };
+
+  /// Return distance from the down branch of candidate at position k.
+  double getDDist(UInt k) const { return dDist_[k]; };
+
+  /// Return the position of handler that added candidate at position k.
+  UInt getHandler(UInt k) const { return handler_[k]; };
+
+  /// Return the variable index of candidate at position k.
+  UInt getIndex(UInt k) const { return index_[k]; };
+
+  /// Return the score of candidate at position k.
+  double getScore(UInt k) const { return score_[k]; };
+
+  /// Return distance from the up branch of candidate at position k.
+  double getUDist(UInt k) const { return uDist_[k]; };
+
+  /**
+   * \brief Return true if candidates are in increasing order of variable
+   * indices, which is the case when they are added in that order.
+   */
+  bool isSorted() const { return sorted_; };
+
+  /**
+   * \brief Switch accumulate mode. When on, distances of a variable added
+   * more than once are summed up.
+   */
+  void setAccumulate(bool val) { accumulate_ = val; };
+
+  /// Store candidate object for candidate at position k.
+  void setCand(UInt k, BrVarCandPtr cand) { cands_[k] = cand; };
+
+  /// Set the position of handler that adds candidates from now on.
+  void setHandler(UInt h) { curHandler_ = h; };
+
+  /// Set the score of candidate at position k.
+  void setScore(UInt k, double score) { score_[k] = score; };
+
+  /// Return the number of candidates in the buffer.
+  UInt size() const { return index_.size(); };
+
+private:
+  /// True if distances of repeated candidates are summed up.
+  bool accumulate_;
+
+  /// Candidate objects, NULL for candidates added by index.
+  std::vector<BrVarCandPtr> cands_;
+
+  /// Position of handler used by add().
+  UInt curHandler_;
+
+  /// Distances from the down branch.
+  DoubleVector dDist_;
+
+  /// Position of handler that added each candidate.
+  UIntVector handler_;
+
+  /// Variable indices of candidates.
+  UIntVector index_;
+
+  /// pos_[i] is the position of candidate of variable i, or -1.
+  std::vector<int> pos_;
+
+  /// Scores of candidates, set by the brancher.
+  DoubleVector score_;
+
+  /// True if index_ is sorted in increasing order.
+  bool sorted_;
+
+  /// Distances from the up branch.
+  DoubleVector uDist_;
+};
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -28,7 +28,9 @@ Branch::Branch()
 : pMods_(0),
   rMods_(0),
   activity_(INFINITY),
-  brCand_(BrCandPtr()) // NULL
+  brCand_(BrCandPtr()), // NULL
+  lb_(-INFINITY),
+  ws_(WarmStartPtr()) // NULL
 {
 
 }
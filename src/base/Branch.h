@@ -20,8 +20,10 @@ namespace Minotaur {
 
 class   BrCand;
 class   Modification;
+class   WarmStart;
 typedef boost::shared_ptr <BrCand> BrCandPtr;
 typedef boost::shared_ptr <Modification> ModificationPtr;
+typedef boost::shared_ptr <WarmStart> WarmStartPtr;
 
 /**
  * \brief Base class for storing branching modifications.
@@ -121,6 +123,32 @@ public:
   /// Return the branching candidate that was used to create this branch.
   BrCandPtr getBrCand() {return brCand_;};
 
+  /**
+   * \brief Return a lower bound on the objective value of the child
+   * created by this branch, e.g. from strong branching. -INFINITY if none
+   * is known.
+   */
+  double getLb() const {return lb_;};
+
+  /**
+   * \brief Return the warm-start information for solving the child, e.g.
+   * from strong branching. NULL if none.
+   */
+  WarmStartPtr getWarmStart() const {return ws_;};
+
+  /**
+   * \brief Set lower bound on the objective value of the child.
+   * \param[in] value The new lower bound.
+   */
+  void setLb(double value) {lb_ = value;};
+
+  /**
+   * \brief Set the warm-start information for solving the child. A copy of
+   * the pointer is saved, not of the warm-start itself.
+   * \param[in] ws The warm-start information.
+   */
+  void setWarmStart(WarmStartPtr ws) {ws_ = ws;};
+
   /// Write the branch to 'out'
   void write(std::ostream &out) const;
 
@@ -156,6 +184,12 @@ protected:
 
   /// Branching candidate that is used to create this branch. 
   BrCandPtr brCand_;
+
+  /// Lower bound on the objective value of the child.
+  double lb_;
+
+  /// Warm-start information for the child, NULL if not known.
+  WarmStartPtr ws_;
 };   
 }
 
@@ -24,9 +24,11 @@
 #include "NodeRelaxer.h"
 #include "Option.h"
 #include "Problem.h"
+#include "Profiler.h"
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
 #include "TreeManager.h"
 
@@ -126,6 +128,12 @@ SolutionPtr BranchAndBound::getSolution()
 }
 
 
+SolutionPoolPtr BranchAndBound::getSolutionPool()
+{
+  return solPool_;
+}
+
+
 SolveStatus BranchAndBound::getStatus()
 {
   return status_;
@@ -158,6 +166,7 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
   bool prune = *should_prune;
   Branches branches;
   WarmStartPtr ws;
+  Profiler *prof = env_ ? env_->getProfiler() : 0;
 #if SPEW
   logger_->msgStream(LogDebug) << me_ << "creating root node" << 
     std::endl;
@@ -165,6 +174,7 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
   tm_->insertRoot(current_node);
 
   if (options_->createRoot == true) {
+    ProfZone pz(prof, "relax");
     rel = nodeRlxr_->createRootRelaxation(current_node, prune);
     rel->setProblem(problem_);
   } else {
@@ -179,7 +189,10 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
     std::endl;
 #endif
   
-    nodePrcssr_->processRootNode(current_node, rel, solPool_);
+    {
+      ProfZone pz(prof, "process root");
+      nodePrcssr_->processRootNode(current_node, rel, solPool_);
+    }
     ++stats_->nodesProc;
     if (nodePrcssr_->foundNewSolution()) {
       tm_->setUb(solPool_->getBestSolutionValue());
@@ -200,7 +213,10 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
     ws = nodePrcssr_->getWarmStart();
     tm_->removeActiveNode(current_node);
     *should_dive = tm_->shouldDive();
-    new_node = tm_->branch(branches, current_node, ws);
+    {
+      ProfZone pz(prof, "branch");
+      new_node = tm_->branch(branches, current_node, ws);
+    }
     assert((*should_dive && new_node) || (!(*should_dive) && !new_node));
     if (!(*should_dive)) {
       nodeRlxr_->reset(current_node, false);
@@ -218,6 +234,21 @@ NodePtr BranchAndBound::processRoot_(bool *should_prune, bool *should_dive)
 }
 
 
+void BranchAndBound::publishStats_(double lb)
+{
+  StatsRegistry *reg = env_ ? env_->getStats() : 0;
+  if (reg) {
+    reg->counter("bnb.nodes_processed")->set(stats_->nodesProc);
+    reg->counter("bnb.nodes_created")->set(tm_->getSize());
+    reg->counter("bnb.nodes_active")->set(tm_->getActiveNodes());
+    reg->setValue("bnb.lb", lb);
+    reg->setValue("bnb.ub", tm_->getUb());
+    reg->setValue("bnb.gap_percent", tm_->getPerGap());
+    reg->setValue("bnb.time", timer_->query());
+  }
+}
+
+
 void BranchAndBound::setLogLevel(LogLevel level) 
 {
   logger_->setMaxLevel(level);
@@ -305,7 +336,7 @@ void BranchAndBound::showStatus_(bool current_uncounted)
   }
   if (timer_->query()-stats_->updateTime > options_->logInterval) {
     double lb = tm_->updateLb();
-    logger_->msgStream(LogInfo) 
+    MINOTAUR_LOG(logger_, LogInfo)
       << me_ 
       << std::fixed
       << std::setprecision(1)  << "time = "            << timer_->query()
@@ -317,6 +348,10 @@ void BranchAndBound::showStatus_(bool current_uncounted)
       << std::endl;
     stats_->updateTime = timer_->query();
   }
+  if (env_ && env_->getStats()->isDue()) {
+    publishStats_(tm_->updateLb());
+    env_->getStats()->dump();
+  }
 }
 
 
@@ -330,6 +365,8 @@ void BranchAndBound::solve()
   WarmStartPtr ws;
   RelaxationPtr rel = RelaxationPtr();
   bool should_stop = false;
+  Profiler *prof = env_ ? env_->getProfiler() : 0;
+  ProfZone pz_bnb(prof, "branch-and-bound");
 
   // initialize timer
   timer_->start();
@@ -349,11 +386,14 @@ void BranchAndBound::solve()
   stats_ = new BabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+                                                env_->getOptions()->
+                                                findInt("bnb_sol_pool_size")
+                                                ->getValue());
 
   // call heuristics before the root, if needed 
   for (HeurVector::iterator it=preHeurs_.begin(); it!=preHeurs_.end(); ++it) {
+    ProfZone pz(prof, "heuristic");
     (*it)->solve(current_node, rel, solPool_);
   }
   tm_->setUb(solPool_->getBestSolutionValue());
@@ -398,9 +438,15 @@ void BranchAndBound::solve()
 #endif
 
     should_dive = false;
-    rel = nodeRlxr_->createNodeRelaxation(current_node, dived_prev, 
-                                          should_prune);
-    nodePrcssr_->process(current_node, rel, solPool_);
+    {
+      ProfZone pz(prof, "relax");
+      rel = nodeRlxr_->createNodeRelaxation(current_node, dived_prev, 
+                                            should_prune);
+    }
+    {
+      ProfZone pz(prof, "process");
+      nodePrcssr_->process(current_node, rel, solPool_);
+    }
 
     ++stats_->nodesProc;
 #if SPEW
@@ -438,7 +484,10 @@ void BranchAndBound::solve()
       }
       should_dive = tm_->shouldDive();
     
-      new_node = tm_->branch(branches, current_node, ws);
+      {
+        ProfZone pz(prof, "branch");
+        new_node = tm_->branch(branches, current_node, ws);
+      }
       assert((should_dive && new_node) || (!should_dive && !new_node));
       if (should_dive) {
         dived_prev = true;
@@ -483,6 +532,7 @@ void BranchAndBound::solve()
   logger_->msgStream(LogInfo) << me_ << "stopping branch-and-bound"
     << std::endl;
   stats_->timeUsed = timer_->query();
+  publishStats_(tm_->getLb());
   timer_->stop();
 }
 
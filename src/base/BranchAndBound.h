@@ -87,6 +87,13 @@ namespace Minotaur {
      */
     SolutionPtr getSolution();
 
+    /**
+     * \brief Return the pool of solutions from the last solve. It holds up
+     * to "bnb_sol_pool_size" distinct solutions, best first. NULL before the
+     * first solve.
+     */
+    SolutionPoolPtr getSolutionPool();
+
     /// Return the final status.
     SolveStatus getStatus();
 
@@ -213,6 +220,14 @@ namespace Minotaur {
     /// Return True if a node can be pruned.
     bool shouldPrune_(NodePtr node);
 
+    /**
+     * \brief Copy the statistics of branch-and-bound into the statistics
+     * registry of the environment.
+     *
+     * \param [in] lb The current lower bound of the tree.
+     */
+    void publishStats_(double lb);
+
     /**
      * \brief Check whether the branch-and-bound can stop because of time
      * limit, or node limit or if solved?
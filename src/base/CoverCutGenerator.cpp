@@ -38,11 +38,16 @@ using namespace Minotaur;
 
 # define DEBUG_LEVEL -1
 
-CoverCutGenerator::CoverCutGenerator() {}
+CoverCutGenerator::CoverCutGenerator()
+  : stats_(0),
+    numCalls_(0)
+{
+}
 
 // Currently unused, probably removed later.
 CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
-// : stats_(0)
+  : stats_(0),
+    numCalls_(0)
 {
   // Check if initialization is successful.
   //bool successinit = false;
@@ -53,7 +58,8 @@ CoverCutGenerator::CoverCutGenerator(ProblemPtr , SolutionPtr , EnvPtr )
 }
 
 CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env)
-// : stats_(0)
+  : stats_(0),
+    numCalls_(0)
 {
   //ProblemPtr p;
   //p = rel;
@@ -65,6 +71,18 @@ CoverCutGenerator::CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, En
   }
 }
 
+CoverCutGenerator::CoverCutGenerator(EnvPtr env)
+  : env_(env),
+    numCons_(0),
+    stats_(0),
+    numCalls_(0)
+{
+  intTol_ = env_->getOptions()->findDouble("int_tol")->getValue();
+  objtol_ = 1e-6;
+  stats_ = new CovCutGenStats();
+  initStats();
+}
+
 CoverCutGenerator::~CoverCutGenerator()
 {
   // deallocate heap.
@@ -82,7 +100,9 @@ bool CoverCutGenerator::initialize(RelaxationPtr p, ConstSolutionPtr s, EnvPtr e
   // Objective value change tolerance.
   objtol_ = 1e-6;
   // If no cut generation occured this will return 0s for each statistics.
-  stats_ = new CovCutGenStats();
+  if (0 == stats_) {
+    stats_ = new CovCutGenStats();
+  }
   initStats();
   numCons_ = 0;
   // We cannot take a copy of these objects, since there is no copy constructor.
@@ -137,6 +157,10 @@ void CoverCutGenerator::initStats()
   stats_->gns = 0;
   stats_->singlectwo = 0;
   stats_->basic = 0;
+  stats_->totalcuts = 0;
+  stats_->noviol = 0;
+  stats_->noinitcov = 0;
+  stats_->time = 0.0;
 }
 
 void CoverCutGenerator::generateKnapList()
@@ -181,6 +205,125 @@ void CoverCutGenerator::generateAllCuts()
   }
 }
 
+void CoverCutGenerator::separate(RelaxationPtr rel, ConstSolutionPtr sol)
+{
+  const double * x = sol->getPrimal();
+  VariableConstIterator it;
+  ConstVariablePtr var;
+  VariableType type;
+  ConstraintIterator begin;
+  UInt index;
+  double value;
+
+  if (rel != p_) {
+    p_ = rel;
+    knapsackListPtr_.reset();
+  }
+  s_ = sol;
+  numCons_ = 0;
+  cutVec_.clear();
+  violatedCuts_.clear();
+  violList_.clear();
+  cutmap.clear();
+  initStats();
+  updateKnaps_();
+
+  // x restricted to a knapsack without fractional variables is a point of
+  // the knapsack set, so no cover cut from that knapsack is violated.
+  ++numCalls_;
+  knapCands_.clear();
+  for (it=p_->varsBegin(); it!=p_->varsEnd(); ++it) {
+    var = *it;
+    type = var->getType();
+    index = var->getIndex();
+    if ((type != Binary && type != Integer) || index >= varKnaps_.size()) {
+      continue;
+    }
+    value = x[index];
+    if (fabs(value - floor(value + 0.5)) <= intTol_) {
+      continue;
+    }
+    for (UIntVector::const_iterator k=varKnaps_[index].begin();
+         k!=varKnaps_[index].end(); ++k) {
+      if (knapMark_[*k] != numCalls_) {
+        knapMark_[*k] = numCalls_;
+        knapCands_.push_back(*k);
+      }
+    }
+  }
+
+  // Use the knapsacks in the order of the list, as generateAllCuts does.
+  std::sort(knapCands_.begin(), knapCands_.end());
+  begin = knapsackListPtr_->getListBegin();
+  for (UInt i=0; i<knapCands_.size(); ++i) {
+    numCons_ += 1;
+    generateCuts(*(begin + knapCands_[i]));
+  }
+}
+
+void CoverCutGenerator::updateKnaps_()
+{
+  ConstraintIterator begin;
+  ConstraintIterator itcons;
+  ConstraintPtr cons;
+  LinearFunctionPtr lf;
+  VariableGroupConstIterator it;
+  UInt k, index;
+  bool use;
+
+  if (knapsackListPtr_) {
+    // A knapsack whose constraint was changed may not be a knapsack
+    // anymore, and positions in the list change if constraints are
+    // deleted. Both are rare, so generate the list again.
+    begin = knapsackListPtr_->getListBegin();
+    for (k=0; k<knapLf_.size(); ++k) {
+      cons = *(begin + k);
+      if (cons->getLinearFunction() != knapLf_[k] ||
+          cons->getUb() != knapUb_[k]) {
+        knapsackListPtr_.reset();
+        break;
+      }
+    }
+  }
+  if (knapsackListPtr_ &&
+      p_->getNumConsDels() != knapsackListPtr_->getNumConsDels()) {
+    knapsackListPtr_.reset();
+  }
+
+  if (!knapsackListPtr_) {
+    generateKnapList();
+    knapUse_.clear();
+    knapLf_.clear();
+    knapUb_.clear();
+    knapMark_.clear();
+    varKnaps_.clear();
+  } else {
+    knapsackListPtr_->updateList();
+  }
+
+  // Save information of the knapsacks added to the list.
+  begin = knapsackListPtr_->getListBegin();
+  for (k=knapLf_.size(); k<knapsackListPtr_->getNumKnaps(); ++k) {
+    itcons = begin + k;
+    cons = *itcons;
+    lf = cons->getLinearFunction();
+    use = (false == GUB(itcons) && hasCover(itcons));
+    knapUse_.push_back(use ? 1 : 0);
+    knapLf_.push_back(lf);
+    knapUb_.push_back(cons->getUb());
+    knapMark_.push_back(0);
+    if (use) {
+      for (it=lf->termsBegin(); it!=lf->termsEnd(); ++it) {
+        index = it->first->getIndex();
+        if (index >= varKnaps_.size()) {
+          varKnaps_.resize(p_->getNumVars());
+        }
+        varKnaps_[index].push_back(k);
+      }
+    }
+  }
+}
+
 // Check if it is a GUB. If it is a GUB, we do not generate any cover cuts
 // by using it. May be we should eliminate such constraints as well.
 // x_1 + x_2 + x_3 <= 5
@@ -648,6 +791,10 @@ void CoverCutGenerator::cBar(const ConstCoverSetPtr cover,
 
 /* This function prepares the problem data for lifting problem solver.
    It updates the rhs of lifting problem, rhs of lifting inequality, 
+   The lifting problems of one inequality differ only by the items appended
+   to them, so the lifting problem is solved by dynamic programming over
+   the integer objective values, and the table is extended for the new
+   items instead of solving a knapsack problem from scratch.
  */
 double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
                                const ConstCoverSetPtr constraint,
@@ -659,74 +806,17 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
   // Increment number of knapsacks solved.
   stats_->knaps += 1;
 
-  // Number of variables.
-  UInt n = obj->size();
-  // Objective functions coefficients.
-  double * c = new double[n];
-  CoverSetConstIterator it;
-  CoverSetConstIterator begin = obj->begin();
-  CoverSetConstIterator end   = obj->end();
-  UInt i = 0;
-  for (it=begin; it!=end; ++it) {
-    c[i] = it->second;
-    i += 1;
-  }
-  
-  // Constraint Coefficients.
-  double * a = new double[n];
-  CoverSetConstIterator itCoef;
-  CoverSetConstIterator beginCoef = constraint->begin();
-  CoverSetConstIterator endCoef   = constraint->end();
-  i = 0;
-  for (itCoef=beginCoef; itCoef!=endCoef; ++itCoef) {
-    a[i] = itCoef->second;
-    i += 1;
-  }
-  
-  // First I have to order variables suitable for knapsack solver!!!.
-  double * temp = new double[n];
-  for(i = 0; i < n; ++i) {
-    if (a[i] != 0) {
-      temp[i] = c[i]/a[i];
-    } else {
-      temp[i] = 0;
-    }
-  }
- 
-  std::vector<id> ordered;
-  for (i = 0; i < n; ++i) {
-    ordered.push_back(id(i,temp[i]));
-  }
-  // order the vector
-  // This can be made more efficient.
-  CompareIntDouble compare;
-  sort(ordered.begin(), ordered.end(), compare);
-  double * tempa = new double[n];
-  double * tempc = new double[n];
-
-  for (i = 0; i<n; ++i) {
-    // The index of variable in initial a and c vectors.
-    int index = ordered[i].first;
-    tempa[i] = a[index];
-    tempc[i] = c[index];
-  }
-  // Now, we do not need a and c since we sopied them into tempa and tempc.
-  delete [] a;
-  delete [] c;
-  a = tempa;
-  c = tempc;
+  // Bring the dynamic programming table up to this lifting problem.
+  liftProb_(obj, constraint);
 
   // Solution.
   double gamma = 0.0;
 
-  // Solution vector.
-  int * x = new int[n];
-
   // Rhs value of constraint (b-a_i) where a_i is the variable to lift up.
   if (uplift == true) {
     double b = initialb - variable->second;
-    // Solve binary knapsack solver.
-    binaryKnapsackSolver(n,b,c,a,gamma,x);    
+    // Solve the lifting problem.
+    gamma = liftMax_(b);
     // Alpha is obtained.
     double alpha = rhs-gamma;   
     // No need to update rhs of inequality for up-ifting.
@@ -736,12 +826,6 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
       printLiftProb(obj,constraint,variable,rhs,initialb,uplift,b,gamma,alpha);
     }
 
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
- 
     return alpha;
 
   } else {
@@ -749,8 +833,8 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
 
     // Rhs value of constraint b.
     double  b = initialb + variable->second;
-    // Solve binary knapsack solver.
-    binaryKnapsackSolver(n,b,c,a,gamma,x);
+    // Solve the lifting problem.
+    gamma = liftMax_(b);
     // ksi is obtained.
     double ksi = gamma-rhs;
     // Update rhs of inequality.
@@ -762,17 +846,71 @@ double CoverCutGenerator::lift(const ConstCoverSetPtr obj,
     // Update initial bound of constraint.
     initialb += variable->second;
     
-    // Clean-up, deallocate memory.
-    delete [] tempa;
-    delete [] tempc;
-    delete [] temp;
-    delete [] x;
-  
     return ksi;
   
   } 
 }
 
+void CoverCutGenerator::liftProb_(const ConstCoverSetPtr obj,
+                                  const ConstCoverSetPtr consknap)
+{
+  CoverSetConstIterator itobj = obj->begin();
+  CoverSetConstIterator itcons = consknap->begin();
+  bool reuse = (false == liftW_.empty() && obj->size() >= liftC_.size());
+
+  // Check if the items of the table are the first items of this problem.
+  for (UInt i=0; reuse && i<liftC_.size(); ++i, ++itobj, ++itcons) {
+    if (itobj->second != liftC_[i] || itcons->second != liftA_[i]) {
+      reuse = false;
+    }
+  }
+
+  // Start again if the table is not for a part of this problem.
+  if (false == reuse) {
+    liftC_.clear();
+    liftA_.clear();
+    liftW_.assign(1, 0.0);
+    itobj = obj->begin();
+    itcons = consknap->begin();
+  }
+  for (; itobj!=obj->end(); ++itobj, ++itcons) {
+    addLiftItem_(itobj->second, itcons->second);
+  }
+}
+
+void CoverCutGenerator::addLiftItem_(double c, double a)
+{
+  // Objective coefficients of lifting problems are integers: they are 1
+  // for the cover and lifted coefficients for the others.
+  UInt ci = (c > 0.5) ? (UInt) floor(c + 0.5) : 0;
+  UInt v;
+
+  liftC_.push_back(c);
+  liftA_.push_back(a);
+  if (ci == 0) {
+    return;
+  }
+  liftW_.resize(liftW_.size() + ci, numeric_limits<double>::infinity());
+  for (v=liftW_.size()-1; v>=ci; --v) {
+    if (liftW_[v-ci] + a < liftW_[v]) {
+      liftW_[v] = liftW_[v-ci] + a;
+    }
+  }
+}
+
+double CoverCutGenerator::liftMax_(double b) const
+{
+  // Same tolerance as in binaryKnapsackSolver.
+  double bhat = b + 0.000001;
+
+  for (UInt v=liftW_.size()-1; v>0; --v) {
+    if (liftW_[v] <= bhat) {
+      return v;
+    }
+  }
+  return 0.0;
+}
+
 // Simple lifted cover cut
 void CoverCutGenerator::simple(const ConstCoverSetPtr cover,
                                const ConstCoverSetPtr cbar,
@@ -1353,15 +1491,16 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
 {
   // Set the solution as a vector of zeros. // change this to memset.
   memset(x, 0, (n)*sizeof(int));
-  // Current solution vector.
-  UInt * xhat = new UInt[n+1];
-  // Set the solution as a vector of zeros.
-  memset(xhat,0,(n+1)*sizeof(int));
+  // Current solution vector. Scratch arrays are kept for the next call.
+  knapXhat_.assign(n+1, 0);
+  UInt * xhat = &knapXhat_[0];
   UInt j = 0;
  
   // set up: adding extra elements
-  double * cIn = new double[n+2];
-  double * aIn = new double[n+2];
+  knapCIn_.resize(n+2);
+  knapAIn_.resize(n+2);
+  double * cIn = &knapCIn_[0];
+  double * aIn = &knapAIn_[0];
   UInt ii = 0;
   for (ii=1; ii<n+1; ii++) {
     cIn[ii]=c[ii-1];
@@ -1438,11 +1577,6 @@ UInt CoverCutGenerator::binaryKnapsackSolver(UInt n, double b,
     }
     // "if (no such i exists) return;"
     if (i==0) {
-      // clean up, deallocate memory.
-      delete [] cIn;
-      delete [] aIn;
-      delete [] xhat;
-
       return 1;
     }
     bhat += aIn[i];
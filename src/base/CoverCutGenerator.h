@@ -95,6 +95,10 @@ namespace Minotaur {
     // Constructor that uses a relaxation and a solution given.
     CoverCutGenerator(RelaxationPtr rel, ConstSolutionPtr sol, EnvPtr env);
 
+    // Constructor for a generator that is kept across nodes. Cuts are
+    // generated by calling separate().
+    CoverCutGenerator(EnvPtr env);
+
     // Destructor
     ~CoverCutGenerator();
 
@@ -176,6 +180,16 @@ namespace Minotaur {
     // Generates all the cover cuts from all knapsack constraints.
     void generateAllCuts();
 
+    /**
+     * Generates the cover cuts for the solution sol of relaxation rel. The
+     * knapsack list is kept from the earlier calls and only the constraints
+     * added since then are checked. Only the knapsacks that have a
+     * fractional variable in sol are used, since no cut from the other
+     * knapsacks can be violated. The lists of cuts and the statistics are
+     * those of this call only.
+     */
+    void separate(RelaxationPtr rel, ConstSolutionPtr sol);
+
     // Generate cover partitions C1, C2 and Cbar according to Gu, Nemhauser,
     // Savelsbergh.
     void coverPartitionGNS(const ConstConstraintPtr cons,
@@ -369,6 +383,63 @@ namespace Minotaur {
 
     // Output file name
     string  outfile_;
+
+    // 1 if the knapsack at the same position in the knapsack list can give
+    // a cover cut, i.e. it is not a GUB and it has a cover, 0 otherwise.
+    UIntVector knapUse_;
+
+    // Linear function of each knapsack when it was added to the list.
+    std::vector<LinearFunctionPtr> knapLf_;
+
+    // Rhs of each knapsack when it was added to the list.
+    DoubleVector knapUb_;
+
+    // Positions of the knapsacks in which each variable appears, by index
+    // of variable. Only knapsacks with knapUse_ 1 are included.
+    std::vector<UIntVector> varKnaps_;
+
+    // Value of numCalls_ when a knapsack was last found to have a
+    // fractional variable.
+    UIntVector knapMark_;
+
+    // Positions of the knapsacks used in the current call of separate().
+    UIntVector knapCands_;
+
+    // Number of calls to separate().
+    UInt numCalls_;
+
+    // Objective coefficients of the items of the lifting problem for which
+    // liftW_ is computed.
+    DoubleVector liftC_;
+
+    // Constraint coefficients of the items in liftC_.
+    DoubleVector liftA_;
+
+    // Least weight of a subset of the items in liftC_ whose objective value
+    // is exactly v, for v = 0, 1, ..., sum of liftC_.
+    DoubleVector liftW_;
+
+    // Scratch arrays of binaryKnapsackSolver.
+    DoubleVector knapCIn_;
+    DoubleVector knapAIn_;
+    UIntVector knapXhat_;
+
+    // Add an item with integer objective coefficient c and weight a to the
+    // lifting problem in liftW_.
+    void addLiftItem_(double c, double a);
+
+    // Update liftW_ for the lifting problem with objective obj and
+    // constraint consknap. Items of an earlier problem are reused if they
+    // are the first items of this problem.
+    void liftProb_(const ConstCoverSetPtr obj,
+                   const ConstCoverSetPtr consknap);
+
+    // Optimal value of the lifting problem in liftW_ when the rhs is b.
+    double liftMax_(double b) const;
+
+    // Update the knapsack list and the information saved for each knapsack
+    // after constraints are added to p_.
+    void updateKnaps_();
   };
 }
 
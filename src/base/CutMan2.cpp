@@ -28,6 +28,7 @@
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
 #include "Types.h"
 #include "Variable.h"
@@ -45,6 +46,10 @@ CutMan2::CutMan2()
     MaxInactiveInRel_(10000),
     PoolSize_(200),
     CtThrsh_(0),
+    addedStat_(0),
+    deletedStat_(0),
+    poolToRelStat_(0),
+    relToPoolStat_(0),
     ctMngrtime_(0),
     PrntCntThrsh_(0),
     numCuts_(0)
@@ -69,6 +74,10 @@ CutMan2::CutMan2(EnvPtr env, ProblemPtr p)
     absTol_(5e-2),
     MaxInactiveInRel_(100),
     PoolSize_(70),
+    addedStat_(0),
+    deletedStat_(0),
+    poolToRelStat_(0),
+    relToPoolStat_(0),
     ctMngrtime_(0),
     PrntCntThrsh_(0)
 {
@@ -334,7 +343,30 @@ void CutMan2::NodeIsProcessed(NodePtr node)
   ctmngrInfo_.PoolToRel = stats_->numPoolToRel;
   ctmngrInfo_.RelAve = (double)stats_->RelSize/stats_->callNums;
   ctmngrInfo_.PoolAve = (double)stats_->PoolSize/stats_->callNums;
+  publishStats_();
+}
+
 
+void CutMan2::publishStats_()
+{
+  StatsRegistry *reg = env_ ? env_->getStats() : 0;
+  if (reg && reg->isOn()) {
+    // called at every node, so look up the names only once.
+    if (!addedStat_) {
+      addedStat_ = reg->counter("cutman.cuts_added");
+      deletedStat_ = reg->counter("cutman.cuts_deleted");
+      poolToRelStat_ = reg->counter("cutman.pool_to_rel");
+      relToPoolStat_ = reg->counter("cutman.rel_to_pool");
+    }
+    addedStat_->set(stats_->numAddedCuts);
+    deletedStat_->set(stats_->numDeletedCuts);
+    poolToRelStat_->set(stats_->numPoolToRel);
+    relToPoolStat_->set(stats_->numRelToPool);
+    // values are set under the registry's lock, as dump() may read them.
+    reg->setValue("cutman.rel_size", rel_.size());
+    reg->setValue("cutman.pool_size", pool_.size());
+    reg->setValue("cutman.time", ctMngrtime_);
+  }
 }
 
 void CutMan2::write(std::ostream &out) const {
@@ -22,6 +22,7 @@ namespace Minotaur {
   class Constraint;
 
   class Node;
+  class StatCounter;
   class Timer;
   typedef boost::shared_ptr<Constraint> ConstraintPtr;
   typedef boost::shared_ptr<Node> NodePtr;
@@ -151,6 +152,12 @@ namespace Minotaur {
     /// Adding cut to the cut pool
     void addToPool_(CutPtr cut);
 
+    /**
+     * \brief Copy the statistics into the statistics registry of the
+     * environment, if it is written to a file.
+     */
+    void publishStats_();
+
     /// Absolute tolerance
     double absTol_;
 
@@ -168,6 +175,13 @@ namespace Minotaur {
 
     CutStat *stats_;
 
+    /// Counters in the statistics registry, NULL until publishStats_() is
+    /// first called with the registry on.
+    StatCounter *addedStat_;
+    StatCounter *deletedStat_;
+    StatCounter *poolToRelStat_;
+    StatCounter *relToPoolStat_;
+
     Timer *timer_;
 
     /// Total time spent in cut manager
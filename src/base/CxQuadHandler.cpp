@@ -113,6 +113,27 @@ void CxQuadHandler::relax_(RelaxationPtr rel, bool *)
       }
     }
   }
+  mcVars_.clear();
+  mcIneqs_.clear();
+  mcCoef_.clear();
+  mcLf_.clear();
+  for (McCormickSetIter it=mcCons_.begin(); it!=mcCons_.end(); ++it) {
+    ConstraintPtr c[4] = {(*it)->getC0(), (*it)->getC1(), (*it)->getC2(),
+                          (*it)->getC3()};
+    mcVars_.push_back((*it)->getX0());
+    mcVars_.push_back((*it)->getX1());
+    mcVars_.push_back((*it)->getAux());
+    for (UInt i=0; i<4; ++i) {
+      mcIneqs_.push_back(c[i]);
+      mcCoef_.resize(mcCoef_.size()+3, 0.0);
+      mcLf_.push_back(LinearFunctionPtr());
+      if (c[i]) {
+        readMcCoef_(mcIneqs_.size()-1);
+      }
+    }
+  }
+  mcBnds_.resize(4*mcCons_.size());
+  mcUp_.reserve(mcIneqs_.size());
   //rel->write(std::cout);
   return;
 }
@@ -907,31 +928,83 @@ bool CxQuadHandler::presolveNode(RelaxationPtr rel, NodePtr, SolutionPoolPtr,
 
     } 
 
-    if (mcc->getSense() == McCormick::LT || mcc->getSense() == McCormick::EQ) {
-      lf = getMcLf_(x0, x0->getLb(), x0->getUb(), x1, x1->getLb(), x1->getUb(), 
-          y, r, 0);
-      lmod = (LinConModPtr) new LinConMod(mcc->getC0(), lf, -INFINITY, r);
-      lmod->applyToProblem(rel);
+  }
+  upMcCons_(rel);
+  return false;
+}
 
-      lf = getMcLf_(x0, x0->getLb(), x0->getUb(), x1, x1->getLb(), x1->getUb(), 
-          y, r, 1);
-      lmod = (LinConModPtr) new LinConMod(mcc->getC1(), lf, -INFINITY, r);
-      lmod->applyToProblem(rel);
-    }
 
-    if (mcc->getSense() == McCormick::GT || mcc->getSense() == McCormick::EQ) {
-      lf = getMcLf_(x0, x0->getLb(), x0->getUb(), x1, x1->getLb(), x1->getUb(), 
-          y, r, 2);
-      lmod = (LinConModPtr) new LinConMod(mcc->getC2(), lf, -INFINITY, r);
-      lmod->applyToProblem(rel);
+void CxQuadHandler::readMcCoef_(UInt k)
+{
+  ConstraintPtr con = mcIneqs_[k];
+  LinearFunctionPtr lf = con->getLinearFunction();
+  UInt t = k/4;
+
+  mcCoef_[3*k]   = lf->getWeight(mcVars_[3*t]);
+  mcCoef_[3*k+1] = lf->getWeight(mcVars_[3*t+1]);
+  mcCoef_[3*k+2] = con->getUb();
+  mcLf_[k] = lf;
+}
 
-      lf = getMcLf_(x0, x0->getLb(), x0->getUb(), x1, x1->getLb(), x1->getUb(), 
-          y, r, 3);
-      lmod = (LinConModPtr) new LinConMod(mcc->getC3(), lf, -INFINITY, r);
-      lmod->applyToProblem(rel);
+
+void CxQuadHandler::upMcCons_(RelaxationPtr rel)
+{
+  const UInt n = mcVars_.size()/3;
+  LinConModPtr lmod;
+  LinearFunctionPtr lf;
+  double *b, *c;
+  double a[12];
+  double l0, u0, l1, u1;
+  double r;
+  UInt k, t;
+
+  for (t=0; t<n; ++t) {
+    b = &mcBnds_[4*t];
+    b[0] = mcVars_[3*t]->getLb();
+    b[1] = mcVars_[3*t]->getUb();
+    b[2] = mcVars_[3*t+1]->getLb();
+    b[3] = mcVars_[3*t+1]->getUb();
+    for (k=4*t; k<4*t+4; ++k) {
+      if (mcIneqs_[k] && mcIneqs_[k]->getLinearFunction() != mcLf_[k]) {
+        readMcCoef_(k);
+      }
     }
   }
-  return false;
+
+  mcUp_.clear();
+  for (t=0; t<n; ++t) {
+    b = &mcBnds_[4*t];
+    c = &mcCoef_[12*t];
+    l0 = b[0];
+    u0 = b[1];
+    l1 = b[2];
+    u1 = b[3];
+    // coefficients of x0, x1 and the rhs, as in getMcLf_().
+    a[0] = l1;  a[1]  = l0;  a[2]  = l0*l1;
+    a[3] = u1;  a[4]  = u0;  a[5]  = u0*u1;
+    a[6] = -u1; a[7]  = -l0; a[8]  = -l0*u1;
+    a[9] = -l1; a[10] = -u0; a[11] = -u0*l1;
+    for (k=0; k<12; k+=3) {
+      if (mcIneqs_[4*t+k/3] &&
+          (c[k]!=a[k] || c[k+1]!=a[k+1] || c[k+2]!=a[k+2])) {
+        mcUp_.push_back(4*t+k/3);
+        c[k]   = a[k];
+        c[k+1] = a[k+1];
+        c[k+2] = a[k+2];
+      }
+    }
+  }
+
+  for (UIntVector::const_iterator it=mcUp_.begin(); it!=mcUp_.end(); ++it) {
+    k = *it;
+    t = k/4;
+    b = &mcBnds_[4*t];
+    lf = getMcLf_(mcVars_[3*t], b[0], b[1], mcVars_[3*t+1], b[2], b[3],
+                  mcVars_[3*t+2], r, k%4);
+    lmod = (LinConModPtr) new LinConMod(mcIneqs_[k], lf, -INFINITY, r);
+    lmod->applyToProblem(rel);
+    mcLf_[k] = lf;
+  }
 }
 
 
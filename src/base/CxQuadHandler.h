@@ -190,6 +190,31 @@ protected:
    */
   McCormickSet mcCons_;
 
+  /**
+   * Variables x0, x1 and y of each term in mcCons_, three per term. This
+   * and the next arrays are filled in relax_ and used in upMcCons_ to
+   * update all McCormick inequalities in one pass.
+   */
+  VarVector mcVars_;
+
+  /// The four inequalities of each term, NULL if the sense does not need it.
+  ConstraintVector mcIneqs_;
+
+  /// Coefficients of x0 and x1 and the rhs of each inequality in mcIneqs_.
+  DoubleVector mcCoef_;
+
+  /**
+   * Linear function of each inequality in mcIneqs_ when mcCoef_ was saved.
+   * If the constraint has another one, the coefficients are read again.
+   */
+  std::vector<LinearFunctionPtr> mcLf_;
+
+  /// Bounds l0, u0, l1, u1 of each term at the current node.
+  DoubleVector mcBnds_;
+
+  /// Inequalities in mcIneqs_ that must be changed at the current node.
+  UIntVector mcUp_;
+
   /**
    * Variables that occur in bilinear terms and also concave square terms. 
    * These do not include auxiliary variables that are added in relaxation.
@@ -253,6 +278,17 @@ protected:
                              VariablePtr x1, double lb1, double ub1, VariablePtr y, 
                              double &rhs, UInt i);
 
+  /// Read coefficients of inequality k of mcIneqs_ into mcCoef_.
+  void readMcCoef_(UInt k);
+
+  /**
+   * Change the McCormick inequalities whose coefficients differ from those
+   * given by the current bounds. The new coefficients of all terms are
+   * computed together, and only the changed inequalities are sent to the
+   * relaxation.
+   */
+  void upMcCons_(RelaxationPtr rel);
+
   void binToLin_();
   void binToLinFun_(FunctionPtr f, LinearFunctionPtr lf2);
 
@@ -12,6 +12,7 @@
  */
 
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
@@ -56,7 +57,13 @@ CxUnivarConstraintData::CxUnivarConstraintData(double eTol,
   rov_(VariablePtr()),
   sense_(sense),
   secCon_(ConstraintPtr()),
-  linCons_(ConstraintVector())
+  linCons_(ConstraintVector()),
+  secLb_(INFINITY),
+  secUb_(-INFINITY),
+  linLb_(INFINITY),
+  linUb_(-INFINITY),
+  cacheN_(0),
+  cacheNext_(0)
 {
 
 }
@@ -71,39 +78,95 @@ void CxUnivarConstraintData::initRelax(RelaxationPtr rel, DoubleVector& tmpX,
   riv_ = rel->getVariable(iv_->getIndex());
   rov_ = rel->getVariable(ov_->getIndex());
 
-  // This isn't used
-  ModVector mods;
-
   // Add secant
   if (sense_ == 'E' || sense_ == 'L') {
-    addSecant(rel, riv_, rov_, con_->getFunction(), tmpX, true, mods);
+    addSecant(rel, tmpX, grad, true);
   }
 
   // Add linearizations 
   // TODO: Make strategy a parameter
   if (sense_ == 'E' || sense_ == 'G') {
-    addLin(rel, iv_, ov_, con_->getFunction(), tmpX, grad, true, mods); 
+    addLin(rel, tmpX, grad, true); 
   }
 
 }
 
 /// Update the current relaxation based on current variable bounds
 void CxUnivarConstraintData::updateRelax(RelaxationPtr  rel , DoubleVector&
-                                         tmpX , DoubleVector& grad,
-					 ModVector &mods) 
+                                         tmpX , DoubleVector& grad) 
 {
   // Add secant
   if (sense_ == 'E' || sense_ == 'L') {
-    addSecant(rel, riv_, rov_, con_->getFunction(), tmpX, false, mods);
+    addSecant(rel, tmpX, grad, false);
   }
 
   // Add linearizations 
   // TODO: Make strategy a parameter
   if (sense_ == 'E' || sense_ == 'G') {
-    addLin(rel, riv_, rov_, con_->getFunction(), tmpX, grad, false, mods); 
+    addLin(rel, tmpX, grad, false); 
+  }
+}
+
+
+void CxUnivarConstraintData::changeLin_(RelaxationPtr rel, ConstraintPtr c,
+                                        LinearFunctionPtr &lf, double a,
+                                        double lb, double ub)
+{
+  LinearFunctionPtr old = c->getLinearFunction();
+
+  lf->incTerm(riv_, a - lf->getWeight(riv_));
+  rel->changeConstraint(c, lf, lb, ub); 
+  lf = old;
+}
+
+
+void CxUnivarConstraintData::evalAt_(double x, DoubleVector &tmpX,
+                                     DoubleVector &grad, double *fx,
+                                     double *dfx, int *error)
+{
+  FunctionPtr fn = con_->getFunction();
+  UInt ix = iv_->getIndex();
+
+  for (UInt i=0; i<cacheN_; ++i) {
+    if (cacheX_[i] == x) {
+      *fx = cacheF_[i];
+      *dfx = cacheDf_[i];
+      *error = 0;
+      return;
+    }
+  }
+
+  tmpX[ix] = x;
+  *error = 0;
+  *fx = fn->eval(tmpX, error);
+  if (0==*error) {
+    fn->evalGradient(&tmpX[0], &grad[0], error);
+  }
+  *dfx = grad[ix];
+#if defined(DEBUG_CXUNIVARHANDLER2)
+  std::cout << "x = " << x << " f(x) = " << *fx << " f'(x) = " << *dfx
+            << std::endl;
+#endif
+
+  // evalGradient adds to grad, so zero it again, but only where fn can
+  // have changed it.
+  tmpX[ix] = 0.0;
+  for (VarSetConstIterator it=fn->varsBegin(); it!=fn->varsEnd(); ++it) {
+    grad[(*it)->getIndex()] = 0.0;
+  }
+
+  if (0==*error) {
+    cacheX_[cacheNext_] = x;
+    cacheF_[cacheNext_] = *fx;
+    cacheDf_[cacheNext_] = *dfx;
+    cacheNext_ = (cacheNext_+1) % nCache_;
+    if (cacheN_ < nCache_) {
+      ++cacheN_;
+    }
   }
 }
 
+
 double CxUnivarConstraintData::getViol(const DoubleVector &x)
 {
   int error;
@@ -194,185 +257,181 @@ void CxUnivarHandler::relaxNodeInc(NodePtr , RelaxationPtr rel, bool *is_inf)
   //  FALSE -- If you don't branch on a variable, you still need to update the relaxation from
   //  this node
 
-  ModVector mods;
   CxUnivarConstraintIterator dit;   
   for (dit = cons_data_.begin(); dit != cons_data_.end(); ++dit) {
-    (*dit)->updateRelax(rel, tmpX_, grad_, mods);
-  }
-
-  ModificationConstIterator it;
-  for (it = mods.begin(); it != mods.end(); ++it) {
-    assert(!"add Mod correctly here.");
-    // node->addPMod(*it);
+    (*dit)->updateRelax(rel, tmpX_, grad_);
   }
 
  *is_inf = false;
 }
 
-void CxUnivarConstraintData::addLin(RelaxationPtr rel, ConstVariablePtr riv,
-				    ConstVariablePtr rov, FunctionPtr fn,
-                                    DoubleVector& tmpX, DoubleVector& grad,
-                                    bool init, ModVector &mods)
+void CxUnivarConstraintData::addLin(RelaxationPtr rel, DoubleVector& tmpX,
+                                    DoubleVector& grad, bool init)
 {
  
-  int error;
-  ConstraintPtr cons; 
-  double xlb = riv->getLb();
-  double xub = riv->getUb();
-  double fxlbval=0, fxubval=0, dfxlbval=0, dfxubval=0;
-  double tmpxval, fxval, dfxval; 
+  int error[3];
+  double xlb = riv_->getLb();
+  double xub = riv_->getUb();
+  bool lbinf = (xlb <= -0.9*INFINITY);
+  bool ubinf = (xub >= 0.9*INFINITY);
+  double xvals[3], fvals[3], dfvals[3];
+  bool change[3];
+  double tmpxval, w, sec, lin;
   LinearFunctionPtr lf; 
   FunctionPtr f;
 
-  // More sophisticated strategies hopefully could be obtained by simply
-  // changing this array 
-  int npts = 3;
-  double xvals[] = {xlb, xub, (xub-xlb)/2.0};
+  if (!init && xlb == linLb_ && xub == linUb_) {
+    return;
+  }
+  linLb_ = xlb;
+  linUb_ = xub;
 
 #if defined(DEBUG_CXUNIVARHANDLER)
-  std::cout << "Adding linearizations.  rix id: " << riv->getId() 
-	    << " rix index: " << riv->getIndex() << " rov id: " << rov->getId() 
-	    << " rov index: " << rov->getIndex()
+  std::cout << "Adding linearizations.  rix id: " << riv_->getId() 
+	    << " rix index: " << riv_->getIndex() << " rov id: "
+            << rov_->getId() << " rov index: " << rov_->getIndex()
 	    << " xlb: " << xlb << " xub: " << xub << std::endl;
 #endif
-  
-  for (int i = 0; i < npts; i++) {
 
-    // Zero out tmpX and grad each time, or else bad things happen
-    for (UInt j = 0; j < tmpX.size(); ++j) {
-      tmpX[j] = 0.0;
-      grad[j] = 0.0;
+  // Linearizations at the bounds. An infinite bound is replaced by a finite
+  // point when the relaxation is created, and otherwise the old
+  // linearization is kept.
+  xvals[0] = lbinf ? (ubinf ? 0.0 : std::min(xub, 0.0)) : xlb;
+  xvals[1] = ubinf ? (lbinf ? 0.0 : std::max(xlb, 0.0)) : xub;
+  change[0] = init || (!lbinf && xvals[0] != linPt_[0]);
+  change[1] = init || (!ubinf && xvals[1] != linPt_[1]);
+  for (int i = 0; i < 2; ++i) {
+    evalAt_(xvals[i], tmpX, grad, fvals+i, dfvals+i, error+i);
+  }
+
+  // Third linearization point taken to be where first two intersect:
+  // x3 = (f'(xub)*xub - f'(xlb)*xlb + f(xlb) - f(xub))/(f'(xub) - f'(xlb))
+  // Unless this would put it too close to one of the end points. f lies
+  // below the secant on [xlb, xub], so the gap between the secant and the
+  // first two at x3 bounds their error. The third is changed only if this
+  // gap is more than the tolerance.
+  xvals[2] = 0.5*(xvals[0] + xvals[1]);
+  change[2] = init;
+  if (!lbinf && !ubinf && 0 == error[0] && 0 == error[1] &&
+      (dfvals[1] - dfvals[0] > 0.0001 || dfvals[1] - dfvals[0] < -0.0001)) {
+    w = xub - xlb;
+    tmpxval = (dfvals[1]*xub - dfvals[0]*xlb + fvals[0] - fvals[1])/
+              (dfvals[1] - dfvals[0]);
+    if (tmpxval < xlb + w*0.05) {
+      xvals[2] = xlb + w*0.05;
     }
-    
-    if (i == 2) {
-      // Third linearization point taken to be where first two intersect:
-      // x3 = (f'(xub)*xub - f'(xlb)*xlb + f(xlb) - f(xub))/(f'(xub) - f'(xlb))
-      // Unless this would put it too close to one of the end points
-      if (dfxubval - dfxlbval > 0.0001 || dfxubval - dfxlbval < -0.0001) {
-        tmpxval = (dfxubval*xub - dfxlbval*xlb + fxlbval - fxubval)/
-                  (dfxubval - dfxlbval);
-        if (tmpxval < xlb + (xub-xlb)*0.05) {
-          xvals[2] = xlb + (xub-xlb)*0.05;
-        }
-        else if (tmpxval > xub - (xub-xlb)*0.05) {
-          xvals[2] = xub - (xub-xlb)*0.05;
-        }
-        else {
-          xvals[2] = tmpxval;
-        }
-      }
+    else if (tmpxval > xub - w*0.05) {
+      xvals[2] = xub - w*0.05;
     }
-    tmpX[riv->getIndex()] = xvals[i];
-    error = 0;
-    fxval =  fn->eval(tmpX, &error);
-    fn->evalGradient(&tmpX[0], &grad[0], &error);
-#if defined(DEBUG_CXUNIVARHANDLER2)
-    for (UInt j = 0; j < tmpX.size(); ++j) {
-      std::cout << "x[" << j << "] = " << tmpX[j] << " dfdx[" << j << "] = "
-                << grad[j] << std::endl;
+    else {
+      xvals[2] = tmpxval;
     }
-#endif
-    dfxval = grad[riv->getIndex()];
-    if (i == 0) {
-       fxlbval = fxval;
-       dfxlbval = dfxval; 
+    sec = fvals[0] + (fvals[1] - fvals[0])*(xvals[2] - xlb)/w;
+    lin = std::max(fvals[0] + dfvals[0]*(xvals[2] - xlb),
+                   fvals[1] + dfvals[1]*(xvals[2] - xub));
+    change[2] = init || (sec - lin > eTol_ && xvals[2] != linPt_[2]);
+  }
+  if (change[2]) {
+    evalAt_(xvals[2], tmpX, grad, fvals+2, dfvals+2, error+2);
+  }
+
+  if (init) {
+    linCons_.clear();
+  }
+  for (int i = 0; i < 3; i++) {
+    if (!change[i] || (!init && error[i])) {
+      continue;
     }
-    else if (i == 1) {
-       fxubval = fxval;
-       dfxubval = dfxval; 
+    if (error[i]) {
+      dfvals[i] = 0.0;
+      fvals[i] = -INFINITY;
+      xvals[i] = INFINITY;
     }
     // linearization:  rov >= f(xval) + f'(xval)(riv - xval) 
     //                 rov - f'(xval)*riv >= f(xval) - f'(xval)*xval
-    lf = (LinearFunctionPtr) new LinearFunction();
-    lf->addTerm(rov, 1.0);
-    lf->addTerm(riv, -dfxval);
     if (init) {
-        f = (FunctionPtr) new Function(lf);
-    	cons = rel->newConstraint(f, fxval - dfxval*xvals[i], INFINITY);
-	linCons_.push_back(cons);
+      lf = (LinearFunctionPtr) new LinearFunction();
+      lf->addTerm(rov_, 1.0);
+      lf->addTerm(riv_, -dfvals[i]);
+      linLf_[i] = lf->clone();
+      f = (FunctionPtr) new Function(lf);
+      linCons_.push_back(rel->newConstraint(f, error[i] ? -INFINITY :
+                                            fvals[i] - dfvals[i]*xvals[i],
+                                            INFINITY));
     }
     else {
 #if defined(DEBUG_CXUNIVARHANDLER)
-       std::cout << "Will change 'linearization  ' constraint to have "
-                 << "linear function: ";
-       lf->write(std::cout);  
-       std::cout << std::endl;
+      std::cout << "Will change 'linearization  ' constraint " << i
+                << " to point " << xvals[i] << std::endl;
 #endif
-
-       rel->changeConstraint(linCons_[i], lf, fxval - dfxval*xvals[i], INFINITY); 
-       LinConModPtr lcmod = (LinConModPtr) new LinConMod(linCons_[i], lf, 
-                                                         fxval -
-                                                         dfxval*xvals[i],
-                                                         INFINITY); 
-       mods.push_back(lcmod);
+      changeLin_(rel, linCons_[i], linLf_[i], -dfvals[i],
+                 fvals[i] - dfvals[i]*xvals[i], INFINITY);
     }
+    linPt_[i] = xvals[i];
   }
-  tmpX[riv->getIndex()] = 0.0;
-  grad[riv->getIndex()] = 0.0;
-
 }
 
 
-void CxUnivarConstraintData::addSecant(RelaxationPtr rel,
-                                       ConstVariablePtr riv,
-                                       ConstVariablePtr rov,
-                                       FunctionPtr fn, DoubleVector& tmpX,
-                                       bool init, ModVector &mods) 
+void CxUnivarConstraintData::addSecant(RelaxationPtr rel, DoubleVector& tmpX,
+                                       DoubleVector& grad, bool init) 
 {
 
-  int error;
-  double xlb, xub, fxlb, fxub, m, intercept;
+  int error = 0;
+  double xlb, xub, fxlb, fxub, dfx, m, intercept;
   LinearFunctionPtr lf; 
   FunctionPtr f;
 
   // First add the secant inequalities based on variable bounds
-  xlb = riv->getLb();
-  xub = riv->getUb();
+  xlb = riv_->getLb();
+  xub = riv_->getUb();
+  if (!init && xlb == secLb_ && xub == secUb_) {
+    return;
+  }
+  secLb_ = xlb;
+  secUb_ = xub;
 	
 #if defined(DEBUG_CXUNIVARHANDLER)
-  std::cout << "Adding secant on variable rix index: " << riv->getIndex() 
-	    << " rov index: " << rov->getIndex()
+  std::cout << "Adding secant on variable rix index: " << riv_->getIndex() 
+	    << " rov index: " << rov_->getIndex()
 	    << " xlb: " << xlb << " xub: " << xub << std::endl;
 #endif 
-  // no secant if unbounded either way
+  // no secant if unbounded either way, but keep the constraint so that it
+  // can be changed when the bounds are finite.
+  m = 0.0;
+  intercept = INFINITY;
   if (xlb <= -0.9*INFINITY || xub >= 0.9*INFINITY) {
-    std::cout << "Cannot add secant -- bound is infinite" << std::endl;
-    return;
-  }
-
-  // TODO: Check the error value!
-  tmpX[riv->getIndex()] = xlb;
-  fxlb =  fn->eval(tmpX, &error);
-  tmpX[riv->getIndex()] = xub;
-  fxub =  fn->eval(tmpX, &error);
-  tmpX[riv->getIndex()] = 0.0;
-
-  // TODO: check/remedy numerical issues in this division
-  if (xub - xlb > 10e-7) {
-    m = (fxub - fxlb)/(xub - xlb);
-  }
-  else {
-    m = 0.0;
+    if (init) {
+      std::cout << "Cannot add secant -- bound is infinite" << std::endl;
+    }
+  } else {
+    evalAt_(xlb, tmpX, grad, &fxlb, &dfx, &error);
+    if (0 == error) {
+      evalAt_(xub, tmpX, grad, &fxub, &dfx, &error);
+    }
+    if (0 == error) {
+      // TODO: check/remedy numerical issues in this division
+      if (xub - xlb > 10e-7) {
+        m = (fxub - fxlb)/(xub - xlb);
+      }
+      intercept = fxlb - m*xlb;
+    } else {
+      // try again at the next update.
+      secLb_ = INFINITY;
+    }
   }
 
-  intercept = fxlb - m*xlb;
-  lf = (LinearFunctionPtr) new LinearFunction();
-  lf->addTerm(rov, 1.0);
-  lf->addTerm(riv, -m);
-
   // rovar <= m*rivar + intercept 
   if (init) {
-     f = (FunctionPtr) new Function(lf);
-     secCon_ = rel->newConstraint(f, -INFINITY, intercept);
+    lf = (LinearFunctionPtr) new LinearFunction();
+    lf->addTerm(rov_, 1.0);
+    lf->addTerm(riv_, -m);
+    secLf_ = lf->clone();
+    f = (FunctionPtr) new Function(lf);
+    secCon_ = rel->newConstraint(f, -INFINITY, intercept);
   }
   else {
-    rel->changeConstraint(secCon_, lf, -INFINITY, intercept);
-    LinConModPtr lcmod = (LinConModPtr) new LinConMod(secCon_, lf, -INFINITY,
-                                                      intercept);
-    mods.push_back(lcmod);
+    changeLin_(rel, secCon_, secLf_, -m, -INFINITY, intercept);
   }
-
-  
 }
 
  
@@ -72,34 +72,85 @@ namespace Minotaur {
     /// Array of linearization constraints in the relaxation
     ConstraintVector linCons_;
 
+    /// Bounds of the input variable when the secant was last updated.
+    double secLb_, secUb_;
+
+    /// Bounds of the input variable when linearizations were last updated.
+    double linLb_, linUb_;
+
+    /// Points of the linearizations in linCons_.
+    double linPt_[3];
+
+    /**
+     * Linear functions that are not in secCon_ and linCons_. A constraint
+     * is changed by filling its spare function and swapping the two, so
+     * that no function is created at a node. Engines need the old function
+     * while changing a constraint, so it cannot be changed in place.
+     */
+    LinearFunctionPtr secLf_;
+    LinearFunctionPtr linLf_[3];
+
+    /// Number of points whose function values are saved.
+    static const UInt nCache_ = 8;
+
+    /// Points where the function was evaluated last.
+    double cacheX_[nCache_];
+
+    /// Function values at cacheX_.
+    double cacheF_[nCache_];
+
+    /// Derivatives at cacheX_.
+    double cacheDf_[nCache_];
+
+    /// Number of saved points.
+    UInt cacheN_;
+
+    /// Position where the next point is saved.
+    UInt cacheNext_;
+
+    /**
+     * Change the coefficient of riv_ and the bounds of a constraint of the
+     * relaxation, using the spare function lf. lf is then the old function
+     * of c.
+     */
+    void changeLin_(RelaxationPtr rel, ConstraintPtr c, LinearFunctionPtr &lf,
+                    double a, double lb, double ub);
+
+    /**
+     * Value and derivative of the function at point x of the input variable,
+     * from the saved points if possible. tmpX and grad must be zero and are
+     * zero again on return.
+     */
+    void evalAt_(double x, DoubleVector &tmpX, DoubleVector &grad,
+                 double *fx, double *dfx, int *error);
+
   public:
 
     /// Creates initial relaxations   
     void initRelax(RelaxationPtr rel, DoubleVector& tmpX, DoubleVector& grad);
 
-    /// Update the current relaxation based on current variable bounds
-    void updateRelax(RelaxationPtr rel, DoubleVector& tmpX, DoubleVector& grad,
-                     ModVector &mods);
+    /**
+     * Update the current relaxation based on current variable bounds. Does
+     * nothing if the bounds have not changed since the last update.
+     */
+    void updateRelax(RelaxationPtr rel, DoubleVector& tmpX, DoubleVector& grad);
 
     bool isFeasible(const double* x);
 
     double getViol(const std::vector< double > & x);
 
-    // Creates and adds the secant inequality defined by current constraint to
-    // the relaxation
-    // Returns the constraint that was added, which may be null if it was not
-    // possible to add a constraint (e.g., due to an infinite bound)
-    void addSecant(RelaxationPtr rel, ConstVariablePtr iv,
-                   ConstVariablePtr ov, FunctionPtr fn, DoubleVector& tmpX,
-                   bool init, ModVector &mods);
-
-    // Creates and adds linearization inequalities to approximate the lower
-    // envelope of the convex function
-    // Returns a vector of constraints that were added
-    void addLin(RelaxationPtr rel, ConstVariablePtr iv,
-                ConstVariablePtr ov, FunctionPtr fn,
-                DoubleVector& tmpX, DoubleVector& grad, bool init,
-                ModVector &mods);
+    // Creates the secant inequality of the current bounds, or changes it if
+    // init is false. No secant is added if a bound is infinite.
+    void addSecant(RelaxationPtr rel, DoubleVector& tmpX, DoubleVector& grad,
+                   bool init);
+
+    // Creates linearization inequalities to approximate the lower envelope
+    // of the convex function at the bounds and where the two meet, or
+    // changes them if init is false. The middle one is changed only if the
+    // gap between the secant and the other two exceeds the tolerance; a
+    // linearization is valid everywhere, so an old one can be kept.
+    void addLin(RelaxationPtr rel, DoubleVector& tmpX, DoubleVector& grad,
+                bool init);
 
     ConstraintPtr getOriginalCon() const { return con_; }
     ConstraintPtr getSecantCon() const { return secCon_; }
@@ -20,6 +20,8 @@
 #include "Environment.h"
 #include "Logger.h"
 #include "Option.h"
+#include "Profiler.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
 #include "Version.h"
 
@@ -31,6 +33,8 @@ Environment::Environment()
 {
   logger_     = (LoggerPtr) new Logger();
   options_    = (OptionDBPtr) new OptionDB();
+  prof_       = new Profiler();
+  stats_      = new StatsRegistry();
   timerFac_   = new TimerFactory();
   timer_      = timerFac_->getTimer();
   createDefaultOptions_();
@@ -39,6 +43,22 @@ Environment::Environment()
 
 Environment::~Environment()
 {
+  if (prof_->isOn()) {
+    std::string fname = options_->findString("profile_file")->getValue();
+    if (0!=prof_->writeTrace(fname)) {
+      logger_->errStream() << me_ << "cannot write profile to file "
+        << fname << std::endl;
+    }
+    if (logger_->isOn(LogExtraInfo)) {
+      prof_->writeStats(logger_->msgStream(LogExtraInfo));
+    }
+  }
+  delete prof_;
+  if (0!=stats_->dump()) {
+    logger_->errStream() << me_ << "cannot write statistics to file "
+      << options_->findString("stats_file")->getValue() << std::endl;
+  }
+  delete stats_;
   delete timer_;
   delete timerFac_;
 }
@@ -85,6 +105,11 @@ void Environment::createDefaultOptions_()
       "Should presolve be used: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("rc_fix", 
+      "Should bounds be tightened by reduced costs in LP nodes: <0/1>", true,
+      false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("separability",
       "Should separability be used: <0/1>", true, false);
   options_->insert(b_option);
@@ -184,6 +209,11 @@ void Environment::createDefaultOptions_()
       true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("qg_hybrid",
+      "Solve master MILPs (multi-tree) in qg before switching to a single tree: <0/1>",
+      true, false);
+  options_->insert(b_option);
+
   b_option = (BoolOptionPtr) new Option<bool>("expand_poly", 
       "Fully expand and save polynomials in objective and constraints: <0/1>",
       true, false);
@@ -210,6 +240,10 @@ void Environment::createDefaultOptions_()
       "Write solution files: <0/1>", true, false);
   options_->insert(b_option);
 
+  b_option = (BoolOptionPtr) new Option<bool>("log_thread_buffers", 
+      "If true, parallel algorithms buffer messages of each thread and prefix them with thread, node and time: <0/1>", true, false);
+  options_->insert(b_option);
+
   // reset, so that we don't accidently add it again.
   b_option.reset();
 
@@ -225,6 +259,11 @@ void Environment::createDefaultOptions_()
       1000000000);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("bnb_sol_pool_size", 
+      "Number of distinct best solutions saved in branch-and-bound: >0",
+      true, 1);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("pres_freq", 
       "Frequency of node-presolves in branch-and-bound", true, 5);
   options_->insert(i_option);
@@ -273,6 +312,11 @@ void Environment::createDefaultOptions_()
   i_option = (IntOptionPtr) new Option<int>("heur_log_level", 
       "Verbosity of Multi Start Heuristic: 0-6", true, LogInfo);
   options_->insert(i_option);
+
+  i_option = (IntOptionPtr) new Option<int>("msheur_round_size",
+      "Number of NLPs multi-start heuristic solves between updates of its "
+      "starting points: >=1", true, 4);
+  options_->insert(i_option);
   
   // Serdar added these options for MultilinearTermsHandler class
   i_option = (IntOptionPtr) new Option<int>("ml_max_group_size",
@@ -288,6 +332,11 @@ void Environment::createDefaultOptions_()
       "Verbosity of presolver: 0-6", true, LogInfo);
   options_->insert(i_option);
 
+  i_option = (IntOptionPtr) new Option<int>("qg_hybrid_rounds",
+      "Maximum number of master MILPs solved when qg_hybrid is on: >=0",
+      true, 10);
+  options_->insert(i_option);
+
   i_option = (IntOptionPtr) new Option<int>("separability_log_level",
       "Verbosity of separability detection: 0-6", true, LogInfo);
   options_->insert(i_option);
@@ -371,6 +420,16 @@ void Environment::createDefaultOptions_()
       true, 0.0);
   options_->insert(d_option);
 
+  d_option = (DoubleOptionPtr) new Option<double>("qg_hybrid_ratio",
+      "Switch to a single tree when time of an LP solve is above this fraction of time of an NLP solve: >=0",
+      true, 0.1);
+  options_->insert(d_option);
+
+  d_option = (DoubleOptionPtr) new Option<double>("stats_dump_interval", 
+      "Seconds between writing statistics to stats_file. 0 means only at the end",
+      true, 0.0);
+  options_->insert(d_option);
+
   d_option.reset();
  
   // string options
@@ -409,11 +468,26 @@ void Environment::createDefaultOptions_()
       true, "");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("profile_file", 
+      "File name for writing time spent in zones of code (Chrome trace format)",
+      true, "");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("qp_engine", 
       "Engine for solving QP relaxations: bqpd, None", 
       true, "bqpd");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("read_snapshot", 
+      "Load presolved problem from this snapshot instead of problem_file",
+      true, "");
+  options_->insert(s_option);
+
+  s_option = (StringOptionPtr) new Option<std::string>("stats_file", 
+      "File name for writing statistics of all components (JSON format)",
+      true, "");
+  options_->insert(s_option);
+
   s_option = (StringOptionPtr) new Option<std::string>("tb_rule",
       "Tie breaking rule for node selection in branch-and-bound: twoChild, FIFO", true, "");
   options_->insert(s_option);
@@ -426,6 +500,10 @@ void Environment::createDefaultOptions_()
       "File name for storing tree information for Vbctool", true, "");
   options_->insert(s_option);
 
+  s_option = (StringOptionPtr) new Option<std::string>("write_snapshot", 
+      "File name for saving the presolved problem as a snapshot", true, "");
+  options_->insert(s_option);
+
   s_option.reset();
 }
 
@@ -566,6 +644,18 @@ OptionDBPtr Environment::getOptions()
 }
 
 
+Profiler* Environment::getProfiler()
+{
+  return prof_;
+}
+
+
+StatsRegistry* Environment::getStats()
+{
+  return stats_;
+}
+
+
 double Environment::getTime(int &err)
 {
   if (timer_) {
@@ -735,6 +825,18 @@ void Environment::readOptions(int argc, char **argv)
   // display all the new options set.
   logger_->msgStream(LogInfo) << ostr.str();
 
+  // start profiling if asked.
+  if (false==options_->findString("profile_file")->getValue().empty()) {
+    prof_->enable(true);
+  }
+
+  // write statistics if asked.
+  if (false==options_->findString("stats_file")->getValue().empty()) {
+    stats_->setDumpFile(options_->findString("stats_file")->getValue(),
+                        options_->findDouble("stats_dump_interval")
+                        ->getValue());
+  }
+
   if (num_p>1) {
     logger_->msgStream(LogInfo) << me_ 
       << "more than one filename given as input."
@@ -18,6 +18,8 @@
 namespace Minotaur {
 
   class Interrupt;
+  class Profiler;
+  class StatsRegistry;
   class Timer;
   class TimerFactory;
 
@@ -46,6 +48,24 @@ namespace Minotaur {
       /// Get the options database.
       OptionDBPtr getOptions();
 
+      /**
+       * \brief Get the profiler shared by the whole environment.
+       *
+       * The profiler is enabled by readOptions() if option "profile_file"
+       * is set. Otherwise it is disabled and zones cost only one check. The
+       * profile is written to the file when the environment is destroyed.
+       */
+      Profiler* getProfiler();
+
+      /**
+       * \brief Get the statistics registry shared by the whole environment.
+       *
+       * Components of all threads update their statistics here. If option
+       * "stats_file" is set, the registry is written to that file every
+       * "stats_dump_interval" seconds and when the environment is destroyed.
+       */
+      StatsRegistry* getStats();
+
       /**
        * Get the time from the 'global timer' i.e. the total time consumed so
        * far.
@@ -100,6 +120,12 @@ namespace Minotaur {
       /// The options database
       OptionDBPtr options_;
 
+      /// Profiler for zones of code.
+      Profiler *prof_;
+
+      /// Statistics of all components.
+      StatsRegistry *stats_;
+
       /// The global timer
       Timer *timer_;
 
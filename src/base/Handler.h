@@ -19,6 +19,7 @@
 
 namespace Minotaur {
 
+  class   BrVarCandBuffer;
   class   CutManager;
   class   Node;
   class   Relaxation;
@@ -113,6 +114,26 @@ namespace Minotaur {
                                         BrCandVector &gencands,
                                         bool &is_inf) = 0;
 
+    /**
+     * \brief Append candidates for branching on variables to a buffer.
+     *
+     * Handlers whose candidates are all variable dichotomies may implement
+     * this function so that a brancher can collect their candidates
+     * without creating a BrVarCand for each one. The default does nothing
+     * and returns false, in which case the brancher calls
+     * getBranchingCandidates() instead.
+     * \param[in] rel Relaxation being solved at current node.
+     * \param[in] x Solution of the relaxation.
+     * \param[out] cands The buffer to which candidates must be added.
+     * \param[out] is_inf true if the handler finds that the problem 
+     * is infeasible and the node can be pruned.
+     * \return true if the candidates were added to the buffer.
+     */
+    virtual bool appendBranchingCandidates(RelaxationPtr ,
+                                           const DoubleVector &,
+                                           BrVarCandBuffer &, bool &)
+    {return false;};
+
     /**
      * \brief Get the modifcation that creates a given (up or down) branch.
      *
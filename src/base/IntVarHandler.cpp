@@ -16,6 +16,7 @@
 
 #include "MinotaurConfig.h"
 #include "BrVarCand.h"
+#include "BrVarCandBuffer.h"
 #include "Branch.h"
 #include "Environment.h"
 #include "IntVarHandler.h"
@@ -87,6 +88,29 @@ bool IntVarHandler::isFeasible(ConstSolutionPtr sol, RelaxationPtr relaxation,
 }
 
 
+bool IntVarHandler::appendBranchingCandidates(RelaxationPtr rel,
+                                              const DoubleVector &x,
+                                              BrVarCandBuffer &cands,
+                                              bool &is_inf)
+{
+  VariablePtr v;
+  VariableType v_type;
+  UInt index;
+
+  for (VariableConstIterator it=rel->varsBegin(); it!=rel->varsEnd(); ++it) {
+    v = *it;
+    v_type = v->getType();
+    index = v->getIndex();
+    if ((v_type==Binary || v_type==Integer) && 
+        fabs(floor(x[index]+0.5) - x[index]) > intTol_) {
+      cands.add(index, x[index]-floor(x[index]), ceil(x[index])-x[index]);
+    } 
+  }
+  is_inf = false;
+  return true;
+}
+
+
 void IntVarHandler::getBranchingCandidates(RelaxationPtr rel, 
                                            const DoubleVector &x,
                                            ModVector &, BrVarCandSet &cands,
@@ -47,6 +47,10 @@ public:
                               BrVarCandSet &cands, BrCandVector &gencands,
                               bool &is_inf);
 
+  // base class method
+  bool appendBranchingCandidates(RelaxationPtr rel, const DoubleVector &x,
+                                 BrVarCandBuffer &cands, bool &is_inf);
+
   // Implement Handler::getBrMod().
   ModificationPtr getBrMod(BrCandPtr cand, DoubleVector &x, 
                            RelaxationPtr rel, BranchDirection dir);
@@ -56,7 +56,7 @@ KnapCovHandler::KnapCovHandler(EnvPtr env, ProblemPtr minlp)
   stats_->singlectwo = 0;
   stats_->time  = 0.0;
   stats_->cutdel = 0;
-  
+  cover_ = (CoverCutGeneratorPtr) new CoverCutGenerator(env_);
 }
 
 KnapCovHandler::~KnapCovHandler()
@@ -117,9 +117,9 @@ void KnapCovHandler::separate(ConstSolutionPtr sol, NodePtr,
     // We do another check in CoverCutGneerator for integrality, may be we
     // should eliminate it and use the one above.
     // Generate cover cuts from current relaxation.
-    CoverCutGeneratorPtr cover = (CoverCutGeneratorPtr) new CoverCutGenerator(rel,sol, env_);
+    cover_->separate(rel, sol);
     // Add cuts to the relaxation by using cut manager.
-    CutVector violatedcuts = cover->getViolatedCutList();
+    CutVector violatedcuts = cover_->getViolatedCutList();
     CutIterator itc;
     CutIterator beginc = violatedcuts.begin();
     CutIterator endc   = violatedcuts.end();
@@ -134,7 +134,7 @@ void KnapCovHandler::separate(ConstSolutionPtr sol, NodePtr,
     }
     
     // Update statistics by using return from cover cut generator.
-    ConstCovCutGenStatsPtr covstats = cover->getStats();
+    ConstCovCutGenStatsPtr covstats = cover_->getStats();
     // Later put the code below to updateStats function.
     stats_->knaps += covstats->knaps;
     stats_->cuts += covstats->cuts;
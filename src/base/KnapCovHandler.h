@@ -153,6 +153,13 @@ private:
   /// Tolerance for checking integrality.
   double intTol_;
 
+  /**
+   * Generator of cover cuts. It is kept across nodes, so that the
+   * knapsack constraints are found only when constraints are added to the
+   * relaxation.
+   */
+  CoverCutGeneratorPtr cover_;
+
   /// For log:
   static const std::string me_;
 };
@@ -10,6 +10,8 @@
  * \author Serdar Yildiz, Argonne National Laboratory
  */
 
+#include <cassert>
+
 #include "KnapsackList.h"
 #include "Constraint.h"
 #include "LinearFunction.h"
@@ -96,6 +98,7 @@ void KnapsackList::generateList()
    */
   FunctionType funType;
   numConsChecked_ = 0;
+  numConsDels_ = p_->getNumConsDels();
   for (ConstraintConstIterator it=begin; it!=end; ++it) {
     numConsChecked_ += 1;
     funType = (*it)->getFunctionType();
@@ -105,6 +108,31 @@ void KnapsackList::generateList()
   }
 }
 
+bool KnapsackList::updateList()
+{
+  UInt numknaps = list_->size();
+  ConstraintConstIterator it;
+
+  // Deleted constraints may be in the list, and positions of the others
+  // changed. The problem may have as many constraints as before if more
+  // were appended after the deletion.
+  if (p_->getNumConsDels() != numConsDels_) {
+    list_->clear();
+    generateList();
+    return true;
+  }
+  assert(p_->getNumCons() >= numConsChecked_);
+  // Constraints are only appended, so the ones checked before are the
+  // first numConsChecked_.
+  for (it=p_->consBegin()+numConsChecked_; it!=p_->consEnd(); ++it) {
+    numConsChecked_ += 1;
+    if ((*it)->getFunctionType() == Linear) {
+      evalConstraint(it);
+    }
+  }
+  return (list_->size() != numknaps);
+}
+
 
 // Local Variables: 
 // mode: c++ 
@@ -36,6 +36,12 @@ public:
   // Generates the list of knapsack constraints.
   void generateList();
 
+  // Adds the knapsack constraints among the constraints appended to the
+  // problem since the list was generated. If any constraint was deleted
+  // from the problem since then, the list is generated again. Returns true
+  // if the list changed.
+  bool updateList();
+
   // Evaluate a constraint and decide to add it to the list.
   void evalConstraint(ConstraintConstIterator it);
 
@@ -47,6 +53,10 @@ public:
   
   // Get number of constrainst checked for linear or not.
   UInt getNumConsChecked() const {return numConsChecked_;}
+
+  // Get the count of constraint deletions of the problem when the list was
+  // last generated. See Problem::getNumConsDels().
+  UInt getNumConsDels() const {return numConsDels_;}
   
   // Get an iterator for the beginning of knapsack list.
   ConstraintIterator getListBegin() {return list_->begin();}
@@ -62,6 +72,8 @@ private:
   ConstraintVectorPtr list_;
   // Number of constraints checked.
   UInt numConsChecked_;
+  // Problem::getNumConsDels() when the list was last generated.
+  UInt numConsDels_;
 };
 
 }
@@ -693,6 +693,10 @@ bool LGCIGenerator::liftingGNS(const ConstCoverSetPtr cone,
     printIneq(cone, initialbknap, Cons, "Initial knapsack constraint");
   }
 
+  // Build the lifting problem once; each lift below only updates it.
+  initLiftProb(cone, fset, ctwo, rset, guborigcoeffs, initialbknap,
+               initialbgub);
+
   bool liftup = true;
   // We are going to uplift variables in set F.
   if (fset->size() >= 1) {
@@ -757,7 +761,7 @@ void LGCIGenerator::liftSet(CoverSetPtr obj,
       // Lift the variables one by one in the given order.
       for (it=begin; it!=end; ++it) {
         // Lift the variable.
-        alpha = lift(obj, origgubs, consknap, gubcons, it, rhs, initialbknap, initialbgub, liftup);
+        alpha = lift(origgubs, gubcons, it, rhs, initialbknap, initialbgub, liftup);
         
         if (DEBUG_LEVEL >= 9) {
           output_.open(outfile_.c_str(), std::ios_base::app);
@@ -775,30 +779,9 @@ void LGCIGenerator::liftSet(CoverSetPtr obj,
         coverineq->push_back(*newobjvar);
         // Update knapsack problem constraint.
         consknap->push_back(*it);
-
-        // Update GUB constraints.
-        // Iterator for GUB constraints.
-        std::vector<CoverSetPtr>::iterator itgub;
-        std::vector<CoverSetPtr>::iterator begingub = origgubs->begin();
-        std::vector<CoverSetPtr>::iterator endgub   = origgubs->end();
-        // Iterate thorugh all GUB constraints.
-        UInt index = 0;
-        for (itgub=begingub; itgub!=endgub; ++itgub) {
-          // Iterators for elements of GUB.
-          CoverSetIterator itel;
-          CoverSetIterator beginel = (*itgub)->begin();
-          CoverSetIterator endel   = (*itgub)->end();
-          // Iterate through elements of GUB.
-          for (itel=beginel; itel!=endel; ++itel) {
-            // If initially element is included in GUB, then add it again.
-            if (itel->first == it->first) {
-              VariableValuePair newvar = VariableValuePair(*it);
-              newvar.second = 1.0; 
-              (*gubcons)[index]->push_back(newvar);
-            }
-          }
-          index += 1;
-        }
+        // The knapsack and GUB rows of the lifting problem already contain
+        // the variable, only its bound and objective coefficient change.
+        addLiftVar(it->first, alpha);
 
         if (DEBUG_LEVEL >= 9) {
           output_.close();
@@ -1041,9 +1024,80 @@ VariablePtr LGCIGenerator::addVar(VariablePtr var, OrigLiftVarsPtr varmap,
   
 }
 
-double LGCIGenerator::lift(CoverSetPtr obj,
-                           boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
-                           CoverSetPtr consknap,
+void LGCIGenerator::initLiftProb(const ConstCoverSetPtr cone,
+                                 const ConstCoverSetPtr fset,
+                                 const ConstCoverSetPtr ctwo,
+                                 const ConstCoverSetPtr rset,
+                                 boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
+                                 double bknap,
+                                 double * bgubs)
+{
+  const ConstCoverSetPtr sets[4] = {cone, fset, ctwo, rset};
+  LinearFunctionPtr lfknap = (LinearFunctionPtr) new LinearFunction();
+  CoverSetConstIterator it;
+
+  lpengine_->clear();
+  liftProb_ = (ProblemPtr) new Problem();
+  liftVars_ = (OrigLiftVarsPtr) new OrigLiftVars();
+  liftObj_  = (LinearFunctionPtr) new LinearFunction();
+  liftGubs_.clear();
+
+  // Columns are created in lifting order. Only C1 is free initially, the
+  // rest is fixed to zero until lifted.
+  for (UInt i=0; i<4; ++i) {
+    for (it=sets[i]->begin(); it!=sets[i]->end(); ++it) {
+      VariablePtr liftvar = addVar(it->first, liftVars_, liftProb_);
+      if (it->second != 0) {
+        lfknap->addTerm(liftvar, it->second);
+      }
+      if (0==i) {
+        // Coefficients of C1 in the cover inequality are ones.
+        liftObj_->addTerm(liftvar, -1.0);
+      } else {
+        liftProb_->changeBound(liftvar, Upper, 0.0);
+      }
+    }
+  }
+  liftKnap_ = liftProb_->newConstraint((FunctionPtr) new Function(lfknap),
+                                       0.0, bknap);
+
+  // A GUB row has every variable of the lifting problem included in it.
+  UInt index = 0;
+  for (std::vector<CoverSetPtr>::iterator itgub=origgubs->begin();
+       itgub!=origgubs->end(); ++itgub, ++index) {
+    LinearFunctionPtr lfgub = (LinearFunctionPtr) new LinearFunction();
+    for (it=(*itgub)->begin(); it!=(*itgub)->end(); ++it) {
+      OrigLiftVars::iterator itmap = liftVars_->find(it->first);
+      if (itmap!=liftVars_->end()) {
+        lfgub->addTerm(itmap->second, 1.0);
+      }
+    }
+    liftGubs_.push_back(liftProb_->newConstraint((FunctionPtr)
+                                                 new Function(lfgub),
+                                                 0.0, bgubs[index]));
+  }
+
+  // Maximize the cover inequality, in minimization form.
+  liftProb_->newObjective((FunctionPtr) new Function(liftObj_->clone()), 0.0,
+                          Minimize);
+  liftProb_->prepareForSolve();
+  lpengine_->load(liftProb_);
+}
+
+
+void LGCIGenerator::addLiftVar(VariablePtr var, double alpha)
+{
+  VariablePtr liftvar = liftVars_->find(var)->second;
+
+  liftProb_->changeBound(liftvar, Upper, 1.0);
+  if (alpha != 0) {
+    liftObj_->addTerm(liftvar, -alpha);
+    liftProb_->changeObj((FunctionPtr) new Function(liftObj_->clone()), 0.0);
+  }
+}
+
+
+double LGCIGenerator::lift(boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
                            boost::shared_ptr<std::vector<CoverSetPtr> > gubcons,
                            const CoverSetConstIterator variable,
                            double & rhs,
@@ -1061,12 +1115,6 @@ double LGCIGenerator::lift(CoverSetPtr obj,
     output_.close();
   }
 
-  // Create lifting problem.
-  ProblemPtr liftprob = (ProblemPtr) new Problem();
-  // Clean the lp engine before use.
-  lpengine_->clear();
-  OrigLiftVarsPtr varmap = (OrigLiftVarsPtr) new OrigLiftVars();
-
   double knapb = 0.0;
   // Uplift specific adjustment.
   if (liftup == true) {
@@ -1127,27 +1175,24 @@ double LGCIGenerator::lift(CoverSetPtr obj,
     bgub = copybgub;
   }
 
-  // Define problem.
-  addCons(obj, consknap, knapb, gubcons, bgub, varmap, liftprob); 
-
-  // Prepare for solve    
-  liftprob->prepareForSolve();
+  // Update rhs of the loaded lifting problem.
+  liftProb_->changeBound(liftKnap_, Upper, knapb);
+  for (UInt i=0; i<liftGubs_.size(); ++i) {
+    liftProb_->changeBound(liftGubs_[i], Upper, bgub[i]);
+  }
 
   // write problem.
   if (DEBUG_LEVEL >= 9) {
     output_.open(outfile_.c_str(), std::ios_base::app);
-    liftprob->write(output_);
+    liftProb_->write(output_);
     output_.close();
   }
 
-  // Load the problem to solver.
-  lpengine_->load(liftprob);
-  
-  // Solve problem.
+  // Solve problem, warm started from the previous lift.
   lpengine_->solve();
 
   // Solution of lifting problem is obtained.
-  double gamma = roundHeur(liftprob);
+  double gamma = roundHeur(liftProb_);
   
   double alpha = 0.0;
   double ksi   = 0.0;
@@ -259,9 +259,7 @@ public:
                bool liftup);
 
   // Lift the current variable.
-  double lift(CoverSetPtr obj,
-              boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
-            CoverSetPtr consknap,
+  double lift(boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
             boost::shared_ptr<std::vector<CoverSetPtr> > gubcons,
             const CoverSetConstIterator variable,
             double & rhs,
@@ -295,6 +293,22 @@ public:
                ProblemPtr liftprob);
 
   VariablePtr addVar(VariablePtr var, OrigLiftVarsPtr varmap, ProblemPtr liftprob);
+
+  /**
+   * Build the lifting problem once for all variables of C1, F, C2 and R and
+   * load it to the LP engine. Variables that are not lifted yet have upper
+   * bound zero, so later lifting steps only change bounds and objective.
+   */
+  void initLiftProb(const ConstCoverSetPtr cone,
+                    const ConstCoverSetPtr fset,
+                    const ConstCoverSetPtr ctwo,
+                    const ConstCoverSetPtr rset,
+                    boost::shared_ptr<std::vector<CoverSetPtr> > origgubs,
+                    double bknap,
+                    double * bgubs);
+
+  // Free the lifted variable in the lifting problem with coefficient alpha.
+  void addLiftVar(VariablePtr var, double alpha);
   
 
   double roundHeur(ProblemPtr prob);
@@ -336,6 +350,16 @@ private:
   string outfile_;
   // LP solver.
   LPEnginePtr lpengine_;
+  // Lifting problem loaded to lpengine_, reused by all lifts of a cover.
+  ProblemPtr liftProb_;
+  // Map from original variables to the variables of liftProb_.
+  OrigLiftVarsPtr liftVars_;
+  // Objective of liftProb_ in minimization form.
+  LinearFunctionPtr liftObj_;
+  // Knapsack constraint of liftProb_.
+  ConstraintPtr liftKnap_;
+  // GUB constraints of liftProb_.
+  std::vector<ConstraintPtr> liftGubs_;
 
 };
   
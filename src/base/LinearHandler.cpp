@@ -33,6 +33,7 @@
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
 #include "LinearHandler.h"
 #include "VarBoundMod.h"
@@ -285,6 +286,7 @@ SolveStatus LinearHandler::presolve(PreModQ *pre_mods, bool *changed0)
 
   pStats_->time += timer->query();
   delete timer;
+  publishPreStats_();
   return Finished;
 }
 
@@ -1532,6 +1534,7 @@ void LinearHandler::simplePresolve(ProblemPtr p, SolutionPoolPtr spool,
   pStats_->timeN += timer->query();
 
   delete timer;
+  publishPreStats_();
 }
 
 
@@ -1613,6 +1616,26 @@ bool LinearHandler::treatDupRows_(ConstraintPtr c1, ConstraintPtr c2,
 }
 
 
+void LinearHandler::publishPreStats_()
+{
+  StatsRegistry *reg = env_ ? env_->getStats() : 0;
+  if (reg && reg->isOn()) {
+    reg->counter("linear.pres_iters")->set(pStats_->iters);
+    reg->counter("linear.vars_deleted")->set(pStats_->varDel);
+    reg->counter("linear.cons_deleted")->set(pStats_->conDel);
+    reg->counter("linear.vars_to_binary")->set(pStats_->var2Bin);
+    reg->counter("linear.vars_to_integer")->set(pStats_->var2Int);
+    reg->counter("linear.var_bounds_tightened")->set(pStats_->vBnd);
+    reg->counter("linear.con_bounds_tightened")->set(pStats_->cBnd);
+    reg->counter("linear.coeffs_improved")->set(pStats_->cImp);
+    reg->counter("linear.binaries_relaxed")->set(pStats_->bImpl);
+    reg->counter("linear.node_mods")->set(pStats_->nMods);
+    reg->setValue("linear.pres_time", pStats_->time);
+    reg->setValue("linear.node_pres_time", pStats_->timeN);
+  }
+}
+
+
 void LinearHandler::writePreStats(std::ostream &out) const
 {
   out << me_ << "Statistics for presolve by Linear Handler:"        << std::endl
@@ -222,6 +222,12 @@ protected:
   SolveStatus linBndTighten_(ProblemPtr p, bool apply_to_prob, 
                       ConstraintPtr c_ptr, bool *changed, ModQ *mods, UInt *nintmods);
 
+  /**
+   * \brief Copy the presolve statistics into the statistics registry of the
+   * environment, if it is written to a file.
+   */
+  void publishPreStats_();
+
   void purgeVars_(PreModQ *pre_mods);
 
   /**
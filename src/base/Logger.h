@@ -48,6 +48,9 @@ namespace Minotaur {
       /// Get the maxLevel
       inline LogLevel getMaxLevel() const { return maxLevel_; }
 
+      /// Return true if messages of this level are written.
+      inline bool isOn(LogLevel level) const { return level <= maxLevel_; }
+
       /// Get the stream where one can write messages.
       virtual std::ostream& msgStream(LogLevel level) const;
 
@@ -82,6 +85,15 @@ namespace Minotaur {
   typedef boost::shared_ptr<const Logger> ConstLoggerPtr;
 }
 
+/**
+ * Write a message only if its level is on. Unlike msgStream(), the
+ * arguments after the macro are not evaluated or formatted when the level
+ * is off:
+ *   MINOTAUR_LOG(logger_, LogDebug) << me_ << "x = " << x->getName();
+ */
+#define MINOTAUR_LOG(logger, level) \
+  if (!(logger)->isOn(level)) {} else (logger)->msgStream(level)
+
 #endif
 
 // Local Variables: 
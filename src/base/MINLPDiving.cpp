@@ -12,8 +12,12 @@
  * Implements the class MINLPDiving.
  */
 
+#include <algorithm>
 #include <cmath> // for INFINITY
 #include <iomanip>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 #include "Constraint.h"
@@ -42,14 +46,19 @@ const std::string MINLPDiving::me_ = "MINLP Diving Heuristic: ";
 MINLPDiving::MINLPDiving(EnvPtr env, ProblemPtr p, EnginePtr e)
 : e_(e), 
   env_(env), 
+  gapLimit_(0.0),
   gradientObj_(NULL),
   intTol_(1e-5),
   lh_(0),
+  lb_(-INFINITY),
+  master_(0),
   maxNLP_(100),
   maxSol_(2), 
   nSelector_(4),
   p_(p), 
+  stop_(false),
   stats_(NULL), 
+  numThreads_(1),
   timer_(env_->getNewTimer())
 {
   for (UInt i=0; i<p_->getNumVars(); ++i) {
@@ -61,6 +70,9 @@ MINLPDiving::MINLPDiving(EnvPtr env, ProblemPtr p, EnginePtr e)
 
   logger_ = (LoggerPtr) new Logger((LogLevel) env_->getOptions()->
       findInt("heur_log_level")->getValue());
+  numThreads_ = std::max(1, env_->getOptions()->findInt("threads")->
+                         getValue());
+  gapLimit_ = env_->getOptions()->findDouble("obj_gap_percent")->getValue();
 
   //DivingheurStats stats_
   stats_                    = new DivingheurStats();
@@ -94,6 +106,7 @@ MINLPDiving::~MINLPDiving()
     delete lh_;
   }
   lastNodeMods_.clear();
+  diveMods_.clear();
 }
 
 
@@ -133,11 +146,96 @@ void MINLPDiving::backtrack_(UInt n_moded)
     temp_varmod = temp.top();
     temp_varmod->applyToProblem(p_);
     mods_.push(temp_varmod);
+    diveMods_.push_back(temp_varmod);
     temp.pop();
   }
 }
 
 
+bool MINLPDiving::diveParallel_(const double *root_x, int num_method,
+                                SolutionPoolPtr s_pool)
+{
+  UInt n = p_->getNumVars();
+  double *root_copy = new double[numThreads_*n];
+  std::vector<MINLPDiving *> divers;
+  MINLPDiving *diver;
+  ProblemPtr p;
+  EnginePtr e;
+
+  // each thread dives on its own copy of the problem with its own engine.
+  for (UInt t=0; t<numThreads_; ++t) {
+    e = e_->emptyCopy();
+    if (!e) {
+      break;
+    }
+    p = p_->clone();
+    p->prepareForSolve();
+    diver = new MINLPDiving(env_, p, e);
+    diver->master_ = this;
+    diver->lh_ = new LinearHandler(env_, p);
+    diver->avgDual_ = avgDual_;
+    diver->stats_->numLocal = stats_->numLocal;
+    diver->stats_->best_obj_value = stats_->best_obj_value;
+    e->clear();
+    e->load(p);
+    e->setIterationLimit(200);
+    diver->timer_->start();
+    divers.push_back(diver);
+  }
+  if (divers.size() < numThreads_) {
+    for (UInt t=0; t<divers.size(); ++t) {
+      delete divers[t];
+    }
+    delete [] root_copy;
+    return false;
+  }
+  logger_->msgStream(LogInfo) << me_ << "diving with " << numThreads_
+    << " threads" << std::endl;
+
+  stop_ = false;
+#if USE_OPENMP
+#pragma omp parallel for num_threads(numThreads_) schedule(dynamic)
+#endif
+  for (int i=0; i<num_method; ++i) {
+#if USE_OPENMP
+    UInt t = omp_get_thread_num();
+#else
+    UInt t = 0;
+#endif
+    MINLPDiving *d = divers[t];
+    double *x = root_copy + t*n;
+    double t0;
+
+    if (d->shouldStop_(s_pool)) {
+      continue;
+    }
+    t0 = d->timer_->query();
+    std::copy(root_x, root_x + n, x);
+    d->implementDive_(i, x, s_pool);
+    d->undoDive_();
+    d->stats_->time[i/8] += d->timer_->query() - t0;
+  }
+
+  // NLP and solution totals are counted by the divers in stats_ directly.
+  for (UInt t=0; t<numThreads_; ++t) {
+    diver = divers[t];
+    for (UInt i=0; i<nSelector_; ++i) {
+      stats_->numNLPs[i]    += diver->stats_->numNLPs[i];
+      stats_->time[i]       += diver->stats_->time[i];
+      stats_->iterations[i] += diver->stats_->iterations[i];
+      stats_->numInfeas[i]  += diver->stats_->numInfeas[i];
+      stats_->errors[i]     += diver->stats_->errors[i];
+      stats_->numSol[i]     += diver->stats_->numSol[i];
+    }
+    stats_->best_obj_value = std::min(stats_->best_obj_value,
+                                      diver->stats_->best_obj_value);
+    delete diver;
+  }
+  delete [] root_copy;
+  return true;
+}
+
+
 UInt MINLPDiving::FracBounds_(UInt numfrac, const double* x, 
                               Direction d, Order o)
 {
@@ -319,10 +417,18 @@ void MINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_pool)
 
   lastNodeMods_.clear();
   n_moded  = (this->*f)(numfrac, x, d, o);
-  while (stats_->totalNLPs < maxNLP_) {
+  diveMods_.insert(diveMods_.end(), lastNodeMods_.begin(),
+                   lastNodeMods_.end());
+  while (!shouldStop_(s_pool)) {
     status = e_->solve();
     ++(stats_->numNLPs[i/8]);
     ++(stats_->totalNLPs);
+    if (master_) {
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+      ++(master_->stats_->totalNLPs);
+    }
     if (EngineError == status) {
       e_->clear();  // reset the starting point
       e_->load(p_);
@@ -332,6 +438,11 @@ void MINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_pool)
         || status == ProvenFailedCQFeas || status == FailedFeas) {
       sol = e_->getSolution();
       ++(stats_->numLocal);
+      if (master_) {
+        // solutions found by other threads.
+        stats_->best_obj_value = std::min(stats_->best_obj_value,
+                                          s_pool->getBestSolutionValue());
+      }
       if (stats_->best_obj_value - 1e-6 < sol->getObjValue()) {
 #if SPEW
         logger_->msgStream(LogDebug) << me_ 
@@ -353,11 +464,19 @@ void MINLPDiving::implementDive_(int i, const double* x, SolutionPoolPtr s_pool)
         s_pool->addSolution(sol);
         ++(stats_->numSol[i/8]);
         ++(stats_->totalSol);
+        if (master_) {
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+          ++(master_->stats_->totalSol);
+        }
         return;
       } else {
         // dive further down by rounding variable in current solution "x"
         lastNodeMods_.clear();
         n_moded = (this->*f)(numfrac, x, d, o);
+        diveMods_.insert(diveMods_.end(), lastNodeMods_.begin(),
+                         lastNodeMods_.end());
         backtrack = 0;
       }
     } else if (0 < backtrack) {
@@ -565,15 +684,6 @@ UInt MINLPDiving::ReducedCost_(UInt numfrac, const double* x,
 }
 
 
-void MINLPDiving::restoreBounds_(double* LB_copy, double* UB_copy, UInt vars)
-{
-  for (UInt i=0; i<vars; ++i, ++LB_copy, ++UB_copy) {
-    p_->changeBound(i, Lower, *LB_copy);
-    p_->changeBound(i, Upper, *UB_copy);
-  }
-}
-
-
 double MINLPDiving::rounding_(double value, Direction d)
 {
   switch (d) {
@@ -601,17 +711,6 @@ double MINLPDiving::rounding_(double value, Direction d)
 }
 
 
-void MINLPDiving::saveBounds_(double* LB_copy, double* UB_copy, UInt vars)
-{
-  VariablePtr variable;
-  for (UInt i=0; i<vars; ++i, ++LB_copy, ++UB_copy) {
-    variable = p_->getVariable(i);
-    *LB_copy = variable->getLb();
-    *UB_copy = variable->getUb();
-  }
-}
-
-
 MINLPDiving::FuncPtr MINLPDiving::selectHeur_(int i, Direction &d, Order &o)
 {
   switch (i%4) {
@@ -679,6 +778,48 @@ bool MINLPDiving::shouldDive_()
 }
 
 
+bool MINLPDiving::shouldStop_(SolutionPoolPtr s_pool)
+{
+  UInt nlps, nsols;
+  bool stop;
+  double ub, gap;
+
+  if (!master_) {
+    return (stats_->totalNLPs >= maxNLP_);
+  }
+
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  stop = master_->stop_;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  nlps = master_->stats_->totalNLPs;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  nsols = master_->stats_->totalSol;
+  if (stop || nlps >= maxNLP_ || nsols >= maxSol_) {
+    return true;
+  }
+
+  // gap is computed in the same way as in the tree manager.
+  ub = s_pool->getBestSolutionValue();
+  if (ub < INFINITY && master_->lb_ > -INFINITY) {
+    gap = (ub - master_->lb_)/(fabs(ub)+1e-6)*100.0;
+    if (gap <= master_->gapLimit_) {
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+      master_->stop_ = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+
 void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 {
   ConstSolutionPtr sol;
@@ -689,8 +830,6 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
   UInt numvars           = p_->getNumVars();
   double* root_x;
   double* root_copy;
-  double* LB_copy;
-  double* UB_copy;
   logger_->msgStream(LogInfo) << me_ << "Starting" << std::endl;
   timer_->start();
   if (!shouldDive_()) {
@@ -700,8 +839,6 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
   }
   root_x             = new double[numvars];
   root_copy          = new double[numvars];
-  LB_copy            = new double[numvars];
-  UB_copy            = new double[numvars];
   e_->clear();
   e_->load(p_);
   e_->setIterationLimit(7000); // try to run for a loooong time.
@@ -712,6 +849,9 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
   std::copy(x, x + numvars, root_x);
   updateAvgDual_(sol);
   e_->setIterationLimit(200);
+  if (status == ProvenOptimal || status == ProvenLocalOptimal) {
+    lb_ = sol->getObjValue();
+  }
   if (status == ProvenLocalInfeasible) {
     logger_->msgStream(LogInfo) << me_ << "Root Infeasible" << std::endl;
   } else if (isFrac_(root_x) == 0) {
@@ -719,9 +859,11 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
     logger_->msgStream(LogInfo) << me_ << "solution value is " 
       << stats_->best_obj_value << std::endl;
     s_pool->addSolution(sol);
+  } else if (numThreads_ > 1 &&
+             diveParallel_(root_x, num_method, s_pool)) {
+    // all methods were tried in threads.
   } else {
     lh_ = new LinearHandler(env_, p_);
-    saveBounds_(LB_copy, UB_copy, numvars);
     // loop over the methods starts here
     for (int i=0; i<num_method && stats_->totalSol < maxSol_; ++i) {
       logger_->msgStream(LogDebug) << me_<< "diving method "
@@ -729,11 +871,7 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
       std::copy(root_x, root_x + numvars, root_copy); 
       x = root_copy;
       implementDive_(i, x, s_pool);
-      restoreBounds_(LB_copy, UB_copy, numvars);
-      // clear the stack of modification for this heuristic method
-      while (!mods_.empty()) {
-          mods_.pop();
-      }
+      undoDive_();
       if ((i+1)%8 == 0) {
         stats_->time[i/8]  = timer_->query();
         timer_->stop();
@@ -746,12 +884,6 @@ void MINLPDiving::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
   if (root_x){
     delete [] root_x;
   }
-  if (LB_copy){
-    delete [] LB_copy;
-  }
-  if (UB_copy){
-    delete [] UB_copy;
-  }
   if (root_copy){
     delete [] root_copy;
   }
@@ -792,6 +924,21 @@ void MINLPDiving::sort_(UInt left, UInt right)
 }
 
 
+void MINLPDiving::undoDive_()
+{
+  for (ModVector::reverse_iterator it=diveMods_.rbegin();
+       it!=diveMods_.rend(); ++it) {
+    (*it)->undoToProblem(p_);
+  }
+  diveMods_.clear();
+  lastNodeMods_.clear();
+  // clear the stack of modification for this heuristic method
+  while (!mods_.empty()) {
+    mods_.pop();
+  }
+}
+
+
 void MINLPDiving::updateAvgDual_(ConstSolutionPtr sol)
 {
   DoubleVector::iterator it;
@@ -78,6 +78,13 @@
     * by solving the Relaxed NLP using an NLP engine. The engine is 
     * called once initially to generate a solution  which is rounded 
     * and used for diving. 
+    *
+    * If the option "threads" is more than one and the engine can be copied,
+    * the diving methods are run concurrently. Each thread dives on its own
+    * copy of the problem with its own engine, and solutions are shared
+    * through the solution pool. All threads stop as soon as the limit on
+    * NLPs or solutions is reached, or an incumbent closes the gap (option
+    * "obj_gap_percent") with respect to the root relaxation.
     */
 
    class MINLPDiving : public Heuristic {
@@ -103,12 +110,22 @@
      /// which is to be used to reduced cost diving
      DoubleVector avgDual_;
 
+     /**
+      * All modifications made to the problem in the current dive, including
+      * those from presolve, in the order they were applied. Undone in reverse
+      * order to restore the problem after the dive.
+      */
+     ModVector diveMods_;
+
      /// Engine being used to solve the problem
      EnginePtr e_;
 
      /// Environment
      EnvPtr env_;
 
+     /// Gap (in percent) below which parallel dives stop.
+     double gapLimit_;
+
      /// Gradient of objective function for vector length diving
      double* gradientObj_;
 
@@ -126,6 +143,16 @@
      /// Logger
      LoggerPtr logger_;
 
+     /// Lower bound from the root relaxation, used for the gap.
+     double lb_;
+
+     /**
+      * The heuristic that started this one in a thread of the parallel
+      * mode. It holds the NLP and solution counts of all threads. NULL if
+      * this heuristic is not run in a thread.
+      */
+     MINLPDiving *master_;
+
      /// Maximum number of NLPs allowed for diving heuristic
      UInt maxNLP_;
 
@@ -144,12 +171,18 @@
      /// Problem to be solved
      ProblemPtr p_;
 
+     /// True if all threads of the parallel mode should stop diving.
+     bool stop_;
+
      /// Violated variable fraction part list
      DoubleVector score_;
 
      /// Statistics for the heuristic
      DivingheurStats *stats_;
 
+     /// Number of threads used for diving.
+     UInt numThreads_;
+
      /// Timer for this heuristic
      Timer* timer_;
 
@@ -170,6 +203,19 @@
       */
      void backtrack_(UInt n_flipped);
 
+     /**
+      * \brief Run the diving methods concurrently.
+      *
+      * \param[in] root_x Primal solution of the root relaxation.
+      * \param[in] num_method Number of diving methods.
+      * \param[in] s_pool Pointer to the solution pool.
+      *
+      * \return false if the engine could not be copied and nothing was
+      * done, true otherwise.
+      */
+     bool diveParallel_(const double *root_x, int num_method,
+                        SolutionPoolPtr s_pool);
+
      /** 
       * \brief Fractional selection method for fractional variable
       * 
@@ -239,15 +285,6 @@
      UInt ReducedCost_(UInt numfrac, const double* x, 
                        Direction d, Order o);
 
-     /**
-      * \brief Restore the bounds for the problem
-      *
-      * \param[in] LB_copy Pointer to saved bounds
-      * \param[in] UB_copt Pointer to saved bounds
-      * \param[in] vars Number of variables in the problem
-      */
-     void restoreBounds_(double* LB_copy, double* UB_copy, UInt vars);
-
      /**
       * \brief Rounding a value in a given direction
       *
@@ -258,15 +295,6 @@
       */
      double rounding_(double value, Direction d);
 
-     /** 
-      * \brief Save bounds of the problem
-      *
-      * \param[in] LB_copy Pointer to bounds, space has to be allocated
-      * \param[in] UB_copt Pointer to bounds, space has to be allocated
-      * \param[in] vars Number of variables in the problem
-      */
-     void saveBounds_(double* LB_copy, double* UB_copy, UInt vars);
-
      /**
       * \brief Select the method, ordering and direction.
       *
@@ -288,6 +316,17 @@
       */
      bool shouldDive_();
 
+     /**
+      * \brief Check if a dive should stop.
+      *
+      * \param[in] s_pool Pointer to the solution pool.
+      *
+      * \return true if the limit on NLPs is reached. In the parallel mode,
+      * also true if the limit on solutions is reached or the best solution
+      * in the pool closes the gap.
+      */
+     bool shouldStop_(SolutionPoolPtr s_pool);
+
      /** 
       * \brief Sort the score
       * 
@@ -299,6 +338,13 @@
       */
      void sort_(UInt left, UInt right);
 
+     /**
+      * \brief Undo all modifications of the current dive.
+      *
+      * Only the bounds that were changed in the dive are restored.
+      */
+     void undoDive_();
+
      /**
       * \brief Update the average of dual multiplier
       * 
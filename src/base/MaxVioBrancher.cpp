@@ -17,6 +17,7 @@
 #include "Branch.h"
 #include "BrCand.h"
 #include "BrVarCand.h"
+#include "BrVarCandBuffer.h"
 #include "Environment.h"
 #include "Handler.h"
 #include "Logger.h"
@@ -45,6 +46,7 @@ MaxVioBrancher::MaxVioBrancher(EnvPtr env, HandlerVector & handlers)
   stats_ = new MaxVioBrStats();
   stats_->calls = 0;
   stats_->time = 0.0;
+  cands_.setAccumulate(true);
 }
 
 
@@ -111,26 +113,29 @@ void MaxVioBrancher::findCandidates_(ModVector &mods, bool &should_prune)
 {
   BrVarCandSet cands2;    // Temporary set.
   BrCandVector gencands2; // Temporary set.
-  BrCandPtr br_can;
-  std::pair<BrVarCandIter, bool> ret;
+  UInt hpos = 0;
 
   should_prune = false;
   cands_.clear();
   gencands_.clear();
-  for (HandlerIterator h = handlers_.begin(); h != handlers_.end(); ++h) {
-    // ask each handler to give some candidates
+  for (HandlerIterator h = handlers_.begin(); h != handlers_.end();
+       ++h, ++hpos) {
+    // ask each handler to give some candidates. Distances of a variable
+    // that is a candidate of several handlers are added up in cands_.
+    cands_.setHandler(hpos);
+    if ((*h)->appendBranchingCandidates(rel_, x_, cands_, should_prune)) {
+      if (should_prune) {
+        break;
+      }
+      continue;
+    }
     (*h)->getBranchingCandidates(rel_, x_, mods, cands2, gencands2, should_prune);
     if (should_prune) {
       break;
     }
     for (BrVarCandIter it = cands2.begin(); it != cands2.end(); ++it) {
       (*it)->setHandler(*h);
-      ret = cands_.insert(*it);
-      if (false == ret.second) { // already exists.
-        br_can = *(ret.first);
-        br_can->setDist((*it)->getDDist()+br_can->getDDist(),
-                        (*it)->getDDist()+br_can->getUDist());
-      }
+      cands_.add(*it);
     }
     for (BrCandVIter it = gencands2.begin(); it != gencands2.end(); ++it) {
       (*it)->setHandler(*h);
@@ -142,10 +147,11 @@ void MaxVioBrancher::findCandidates_(ModVector &mods, bool &should_prune)
 
 #if SPEW
   logger_->msgStream(LogDebug) << me_ << "candidates: " << std::endl;
-  for (BrVarCandIter it=cands_.begin(); it!=cands_.end(); ++it) {
+  for (UInt k=0; k<cands_.size(); ++k) {
     logger_->msgStream(LogDebug)
-        << std::setprecision(6) << (*it)->getName() << "\t" 
-        << (*it)->getDDist() << "\t" << (*it)->getUDist()
+        << std::setprecision(6)
+        << rel_->getVariable(cands_.getIndex(k))->getName() << "\t" 
+        << cands_.getDDist(k) << "\t" << cands_.getUDist(k)
         << std::endl;
   }
 #endif
@@ -160,17 +166,40 @@ BrCandPtr MaxVioBrancher::findBestCandidate_()
   double cand_score;
   double lmin = 0.8;
   double lmax = 0.2;
-
-  for (BrVarCandIter it = cands_.begin(); it != cands_.end(); ++it) {
-    cand_score = lmin*std::min((*it)->getDDist(),(*it)->getUDist()) + 
-                 lmax*std::max((*it)->getDDist(),(*it)->getUDist());
-    if (VarOrig==(*it)->getVar()->getSrcType()) {
+  double d, u;
+  int best_k = -1;
+  UInt i;
+  BrVarCandPtr vcand;
+
+  for (UInt k=0; k<cands_.size(); ++k) {
+    d = cands_.getDDist(k);
+    u = cands_.getUDist(k);
+    cand_score = lmin*std::min(d, u) + lmax*std::max(d, u);
+    if (VarOrig==rel_->getVariable(cands_.getIndex(k))->getSrcType()) {
       cand_score = 0.1*cand_score;
     } 
-    if (cand_score > best_score) {
+    // candidates are in the order handlers added them. Ties go to the
+    // variable with the smallest index, as in a BrVarCandSet.
+    if (cand_score > best_score ||
+        (best_k > -1 && cand_score == best_score &&
+         cands_.getIndex(k) < cands_.getIndex(best_k))) {
       best_score = cand_score;
-      best_cand = (*it);
+      best_k = k;
+    }
+  }
+
+  // create the object only for the best candidate on a variable.
+  if (best_k>-1) {
+    vcand = cands_.getCand(best_k);
+    if (!vcand) {
+      i = cands_.getIndex(best_k);
+      vcand = (BrVarCandPtr) new BrVarCand(rel_->getVariable(i), i,
+                                           cands_.getDDist(best_k),
+                                           cands_.getUDist(best_k));
+      vcand->setHandler(handlers_[cands_.getHandler(best_k)]);
+      cands_.setCand(best_k, vcand);
     }
+    best_cand = vcand;
   }
 
   for (BrCandVIter it = gencands_.begin(); it != gencands_.end(); ++it) {
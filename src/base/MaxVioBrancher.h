@@ -15,6 +15,7 @@
 #define MINOTAURMAXVIOBRANCHER_H
 
 #include "Brancher.h"
+#include "BrVarCandBuffer.h"
 
 namespace Minotaur {
 
@@ -50,8 +51,8 @@ namespace Minotaur {
       std::string getName() const;
 
     private:
-      /// Set of candidates (variables for branching).
-      BrVarCandSet cands_; 
+      /// Candidates for branching on variables, reused at all nodes.
+      BrVarCandBuffer cands_; 
 
       /// Vector of candidates (general candidates for branching).
       BrCandVector gencands_;
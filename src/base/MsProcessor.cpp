@@ -9,7 +9,10 @@
  * \brief Implement simple multi-start node-processor for branch-and-bound
  * \author Prashant Palkar, IIT Bombay
  */
+#include <algorithm>
 #include <cmath> // for INFINITY
+#include <cstdlib>
+#include <ctime>
 #if USE_OPENMP
 #include <omp.h>
 #endif
@@ -41,11 +44,15 @@ const std::string MsProcessor::me_ = "MsProcessor: ";
   engine_(EnginePtr()),
   engineStatus_(EngineUnknownStatus),
   numSolutions_(0),
+  numRestarts_(0),
+  numThreads_(1),
   relaxation_(RelaxationPtr()),
+  schemeId_(1),
   ws_(WarmStartPtr())
 {
   handlers_.clear();
   logger_ = (LoggerPtr) new Logger(LogInfo);
+  seeds_.push_back(time(NULL));
   stats_.inf = 0;
   stats_.opt = 0;
   stats_.prob = 0;
@@ -71,6 +78,15 @@ MsProcessor::MsProcessor (EnvPtr env, EnginePtr engine,
   numRestarts_ = env->getOptions()->findInt("msbnb_restarts")->getValue();
   numThreads_ = env->getOptions()->findInt("threads")->getValue();
   schemeId_ = env->getOptions()->findInt("msbnb_scheme_id")->getValue();
+
+  // one random number generator for each thread.
+  int seed = env->getOptions()->findInt("rand_seed")->getValue();
+  if (seed <= 0) {
+    seed = time(NULL);
+  }
+  for (UInt i=0; i<std::max(numThreads_, (UInt) 1); ++i) {
+    seeds_.push_back(seed+i);
+  }
   stats_.bra = 0;
   stats_.inf = 0;
   stats_.opt = 0;
@@ -133,6 +149,18 @@ bool MsProcessor::isFeasible_(NodePtr node, ConstSolutionPtr sol,
   return is_feas;
 }
 
+double MsProcessor::rand01_(int threadId)
+{
+  return rand_r(&seeds_[threadId % seeds_.size()])/(double)(RAND_MAX);
+}
+
+
+int MsProcessor::randInt_(int threadId, int K)
+{
+  return rand_r(&seeds_[threadId % seeds_.size()]) % K;
+}
+
+
 double MsProcessor::InnerProduct(double b[], double c[], UInt n)
 {
   double dotProd = 0;
@@ -164,7 +192,6 @@ double * MsProcessor::getBoxCorner(UInt n, RelaxationPtr rel1, int threadId,
                                    int K)
 {
   double* cornerPoint = new double[n];
-  srand(time(NULL));
   double lb, ub, lbdbVar, ubdbVar, largestInterval = -INFINITY;
   
   int dbVar = -1;     //index of a doubly bounded variable
@@ -193,25 +220,25 @@ double * MsProcessor::getBoxCorner(UInt n, RelaxationPtr rel1, int threadId,
         ub = rel1->getVariable(j)->getUb();
         if (lb > -INFINITY) {
           if (ub < INFINITY) {
-            if (rand()/2 == 0) {
+            if (rand01_(threadId) < 0.5) {
               cornerPoint[j] = lb;
             } else {
               cornerPoint[j] = ub;
             }
           } else {
-            cornerPoint[j] = lb + rand()%K;
+            cornerPoint[j] = lb + randInt_(threadId, K);
           }
         } else {
           if (ub < INFINITY) {
-            cornerPoint[j] = ub - rand()%K;
+            cornerPoint[j] = ub - randInt_(threadId, K);
           } else {
-            cornerPoint[j] = rand()%K;
+            cornerPoint[j] = randInt_(threadId, K);
           }
         }
       } else {
         lb = lbdbVar + (threadId)*width;
         ub = lb + width;
-        if (rand()/2 == 0) {
+        if (rand01_(threadId) < 0.5) {
           cornerPoint[dbVar] = lb;
         } else {
           cornerPoint[dbVar] = ub;
@@ -219,7 +246,8 @@ double * MsProcessor::getBoxCorner(UInt n, RelaxationPtr rel1, int threadId,
       }
     }
   } else {
-    cornerPoint = getStartPointScheme1(n, rel1);
+    delete[] cornerPoint;
+    cornerPoint = getStartPointScheme1(n, rel1, threadId);
   }
   return cornerPoint;
 }
@@ -230,7 +258,6 @@ double * MsProcessor::getFarBoxCorner(UInt n, RelaxationPtr rel1,
 {
 
   double* cornerPoint = new double[n];
-  srand(time(NULL));
   double lb, ub, lbdbVar, ubdbVar, largestInterval = -INFINITY;
   int dbVar = -1;
   for(UInt k = 0; k < n; k++) {
@@ -258,25 +285,25 @@ double * MsProcessor::getFarBoxCorner(UInt n, RelaxationPtr rel1,
         ub = rel1->getVariable(j)->getUb();
         if (lb > -INFINITY) {
           if (ub < INFINITY) {
-            if (abs(ub - prevOpt[j]) > abs(prevOpt[j] - lb)) {
+            if (fabs(ub - prevOpt[j]) > fabs(prevOpt[j] - lb)) {
               cornerPoint[j] = ub;
             } else {
               cornerPoint[j] = lb;
             }
           } else {
-            cornerPoint[j] = lb + rand()%K;
+            cornerPoint[j] = lb + randInt_(threadId, K);
           }
         } else {
           if (ub < INFINITY) {
-            cornerPoint[j] = ub - rand()%K;
+            cornerPoint[j] = ub - randInt_(threadId, K);
           } else {
-            cornerPoint[j] = rand()%K;
+            cornerPoint[j] = randInt_(threadId, K);
           }
         }
       } else {
         lb = lbdbVar + (threadId)*width;
         ub = lb + width;
-        if (abs(ub - prevOpt[j]) > abs(prevOpt[j] - lb)) {
+        if (fabs(ub - prevOpt[j]) > fabs(prevOpt[j] - lb)) {
           cornerPoint[j] = ub;
         } else {
           cornerPoint[j] = lb;
@@ -284,15 +311,16 @@ double * MsProcessor::getFarBoxCorner(UInt n, RelaxationPtr rel1,
       }
     }
   } else {
-    cornerPoint = getStartPointScheme1(n, rel1);
+    delete[] cornerPoint;
+    cornerPoint = getStartPointScheme1(n, rel1, threadId);
   }
   return cornerPoint;
 }
 
-double * MsProcessor::getStartPointScheme1(UInt n, RelaxationPtr rel1)
+double * MsProcessor::getStartPointScheme1(UInt n, RelaxationPtr rel1,
+                                          int threadId)
 {
   double* initPoint = new double[n];
-  srand(time(NULL));
   double lb, ub;
   for(UInt k = 0; k < n; k++) {
     lb = rel1->getVariable(k)->getLb();
@@ -300,15 +328,15 @@ double * MsProcessor::getStartPointScheme1(UInt n, RelaxationPtr rel1)
 
     if (lb > -INFINITY) {
       if (ub < INFINITY) {
-        initPoint[k] = lb + ((double)(rand())/(double)(RAND_MAX))*(ub-lb);
+        initPoint[k] = lb + rand01_(threadId)*(ub-lb);
       } else {
-        initPoint[k] = lb + rand()%1000;
+        initPoint[k] = lb + randInt_(threadId, 1000);
       }	
     } else {
       if (ub < INFINITY) {
-        initPoint[k] = ub - rand()%1000;
+        initPoint[k] = ub - randInt_(threadId, 1000);
       } else {
-        initPoint[k] = rand()%1000;
+        initPoint[k] = randInt_(threadId, 1000);
       }
     }
   }
@@ -321,7 +349,6 @@ double* MsProcessor::getStartPointScheme2(UInt n, RelaxationPtr rel1,
                                         double* prevStartPoint)
 {
   double* initPoint = new double[n];
-  srand(time(NULL));
   double lb, ub, lbdbVar, ubdbVar, norm, largestInterval = -INFINITY;
   double *a = new double [n];
   int dbVar = -1;
@@ -354,15 +381,15 @@ double* MsProcessor::getStartPointScheme2(UInt n, RelaxationPtr rel1,
 
           if (lb > -INFINITY) {
             if (ub < INFINITY) {
-              initPoint[j] = lb + ((double)(rand())/(double)(RAND_MAX))*(ub-lb);
+              initPoint[j] = lb + rand01_(threadId)*(ub-lb);
             } else {
-              initPoint[j] = lb + rand()%1000;
+              initPoint[j] = lb + randInt_(threadId, 1000);
             }	
           } else {
             if (ub < INFINITY) {
-              initPoint[j] = ub - rand()%1000;
+              initPoint[j] = ub - randInt_(threadId, 1000);
             } else {
-              initPoint[j] = rand()%1000;
+              initPoint[j] = randInt_(threadId, 1000);
             }
           }
         }
@@ -370,14 +397,14 @@ double* MsProcessor::getStartPointScheme2(UInt n, RelaxationPtr rel1,
       //generating (dbVar)th coordinate within thread specific bound
       lb = lbdbVar + (threadId)*width;
       ub = lb + width;
-      initPoint[dbVar] = lb + ((double)(rand())/(double)(RAND_MAX))*(ub-lb);
+      initPoint[dbVar] = lb + rand01_(threadId)*(ub-lb);
       return initPoint;
     } 
     //else if there exists a previous starting point:
     //generate a random point outside a ball
     else {
       for (UInt i = 0; i < n; ++i) {
-        a[i] = ((double)rand())/((double)(RAND_MAX));
+        a[i] = rand01_(threadId);
       }
       norm = ENorm(a,n);
       for (UInt i = 0; i < n; ++i) {
@@ -399,13 +426,14 @@ double* MsProcessor::getStartPointScheme2(UInt n, RelaxationPtr rel1,
   } else {
     //for singly bounded and unbdd variables
     if (numSols == 0) {
-      initPoint = getStartPointScheme1(n, rel1);
+      delete[] initPoint;
+      initPoint = getStartPointScheme1(n, rel1, threadId);
       delete[] a;
       return initPoint;
     } else {
       //generate a random point outside the radius
       for (UInt i = 0; i < n; ++i) {
-        a[i] = ((double)rand())/((double)(RAND_MAX));        
+        a[i] = rand01_(threadId);        
       }
       norm = ENorm(a,n);
       for (UInt i = 0; i < n; ++i) {
@@ -432,7 +460,6 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
                                            double cosThrshldAngle)
 {
   double* initPoint = new double[n];
-  srand(time(NULL));
   double lb, ub, lbdbVar, ubdbVar, norm, largestInterval = -INFINITY;
   double* a = new double [n];        //random direction
   double* prevDir = new double [n]; //prev iter. direction
@@ -465,15 +492,15 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
 
           if (lb > -INFINITY) {
             if (ub < INFINITY) {
-              initPoint[j] = lb + ((double)(rand())/(double)(RAND_MAX))*(ub-lb);
+              initPoint[j] = lb + rand01_(threadId)*(ub-lb);
             } else {
-              initPoint[j] = lb + rand()%1000;
+              initPoint[j] = lb + randInt_(threadId, 1000);
             }	
           } else {
             if (ub < INFINITY) {
-              initPoint[j] = ub - rand()%1000;
+              initPoint[j] = ub - randInt_(threadId, 1000);
             } else {
-              initPoint[j] = rand()%1000;
+              initPoint[j] = randInt_(threadId, 1000);
             }
           }
         }
@@ -481,7 +508,7 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
       //generating (dbVar)th coordinate within thread specific bound
       lb = lbdbVar + (threadId)*width;
       ub = lb + width;
-      initPoint[dbVar] = lb + ((double)(rand())/(double)(RAND_MAX))*(ub-lb);
+      initPoint[dbVar] = lb + rand01_(threadId)*(ub-lb);
       delete[] a;
       delete[] prevDir;
       return initPoint;
@@ -490,7 +517,7 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
     //generate a random point outside the radius in conjugate direction
       while(cosAngle < cosThrshldAngle) {
         for (UInt i = 0; i < n; ++i) {
-          a[i] = ((double)rand())/((double)(RAND_MAX));        
+          a[i] = rand01_(threadId);        
         }
         //find the angle between the two directions
         for (UInt i = 0; i < n; ++i) {
@@ -518,7 +545,8 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
   } else {
     //for singly bounded and unbdd variables
     if (numSols == 0) {
-      initPoint = getStartPointScheme1(n, rel1);
+      delete[] initPoint;
+      initPoint = getStartPointScheme1(n, rel1, threadId);
       delete[] a;
       delete[] prevDir;
       return initPoint;
@@ -526,7 +554,7 @@ double * MsProcessor::getStartPointScheme4(UInt n, RelaxationPtr rel1,
       //generate a random point outside the radius
       while(cosAngle < cosThrshldAngle) {
         for (UInt i = 0; i < n; ++i) {
-          a[i] = ((double)rand())/((double)(RAND_MAX));        
+          a[i] = rand01_(threadId);        
         }
         //find the angle between the two directions
         for (UInt i = 0; i < n; ++i) {
@@ -558,7 +586,6 @@ double * MsProcessor::getStartPointScheme5 (UInt n, RelaxationPtr rel1,
                                             double lambda)
 {
   double* initPoint = new double[n];
-  srand(time(NULL));
   double lb, ub, lbdbVar = -INFINITY, ubdbVar = INFINITY;
   double width = 0, norm, largestInterval = -INFINITY;
   double* newDir = new double [n];     //random direction
@@ -613,7 +640,7 @@ double * MsProcessor::getStartPointScheme5 (UInt n, RelaxationPtr rel1,
   //take a convex combination of this point and farboxcorner as the start
   //point and bring it within variable bounds
   if (lambda == -1) {
-    lambda = ((double)rand())/((double)(RAND_MAX));
+    lambda = rand01_(threadId);
   }
   for (UInt i = 0; i < n; i++) {
     if ((int)i == dbVar) {
@@ -626,6 +653,7 @@ double * MsProcessor::getStartPointScheme5 (UInt n, RelaxationPtr rel1,
     initPoint[i] = std::max(std::min(tempCorner[i]+(1-lambda)*
                                       (farCorner[i]-tempCorner[i]), ub), lb);
   }
+  delete[] farCorner;
   delete[] newDir;
   delete[] tempCorner;
   return initPoint;
@@ -681,18 +709,13 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
   EngineStatus* eStatus = new EngineStatus[numThreads_];
   int* solCount = new int[numThreads_]; //#solutions obtained at each thread
 
-  ConstSolutionPtr bestsolthd;          //thread-best solution
   ConstSolutionPtr bestsol ;            //best solution among all threads
 
-  double threadBestVal = INFINITY, bestVal = INFINITY;
-  double *startPoint = NULL;
-  double *prevStartPoint = NULL;
-  double *prevOpt = NULL;
+  double bestVal = INFINITY;
   double radScal = 1.5;                 //factor for scaling radius
   double cosThrshldAngle = sqrt(3)/2;   //threshold angle set to 30 degree
   int K = 1000;                         //upper bound for rand. no. generated
   double lambda = -1;                   //value for taking convex combination
-  double prevSolVal = INFINITY;         //previous solution value
 
 #if USE_OPENMP
 #pragma omp parallel for   
@@ -710,6 +733,8 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
   while (true) {			           
     ++iter;
     should_resolve = false;
+    bestVal = INFINITY;
+    bestsol.reset();
 
 #if SPEW
     logger_->msgStream(LogDebug) << me_ << "iteration " << iter << std::endl;
@@ -720,7 +745,14 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
 #pragma omp parallel for 
 #endif
     for(UInt i = 0; i < numThreads_; i++) {
+      // everything that changes with restarts is private to the thread.
       ConstSolutionPtr sol1;
+      ConstSolutionPtr bestsolthd;        //thread-best solution
+      double threadBestVal = INFINITY;
+      double *startPoint = NULL;
+      double *prevStartPoint = NULL;
+      double *prevOpt = NULL;
+      double prevSolVal = INFINITY;       //previous solution value
       double radius = 0.8;                //initial radius of region
 
       for(UInt j = 0; j < 1 + numRestarts_; j++) {
@@ -729,7 +761,7 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
         switch(schemeId_) {
         case 1:
           //Scheme 1: generate random points within variable bounds
-          startPoint = getStartPointScheme1(numVars, relCopy[i]);
+          startPoint = getStartPointScheme1(numVars, relCopy[i], i);
           break;
 
         case 2:
@@ -781,7 +813,7 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
           //box corner point from the optimal
           if (solCount[i] > 1) {
             if (sol1->getObjValue() == prevSolVal) {
-              startPoint = getStartPointScheme1(numVars, relCopy[i]);
+              startPoint = getStartPointScheme1(numVars, relCopy[i], i);
             } else {
               startPoint = getStartPointScheme5(numVars, relCopy[i], i,
                                                   radius, prevStartPoint,
@@ -798,7 +830,7 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
           break;
 
         default:
-          startPoint = getStartPointScheme1(numVars,relCopy[i]);
+          startPoint = getStartPointScheme1(numVars, relCopy[i], i);
           break;
         }          
 
@@ -834,8 +866,10 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
             <<"Unknown status" << std::endl;
         }
 #endif
+        delete[] prevStartPoint;
         prevStartPoint = startPoint;
       }
+      delete[] prevStartPoint;
 #if USE_OPENMP
 #pragma omp critical
 #endif
@@ -914,7 +948,6 @@ void MsProcessor::process(NodePtr node, RelaxationPtr rel,
   delete[] eCopy;
   delete[] eStatus;
   delete[] solCount;
-  delete[] startPoint;
   //delete prevStartPoint;
   //delete prevOpt;
   return;
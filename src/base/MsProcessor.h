@@ -75,8 +75,12 @@ namespace Minotaur {
                             int threadid, double* prev_opt, int K);
 
 
-    // Generate a random starting point within variable bounds (for relaxations)
-    double* getStartPointScheme1(UInt n, RelaxationPtr rel1);
+    /**
+     * Generate a random starting point within variable bounds (for
+     * relaxations), using the random numbers of thread threadid.
+     */
+    double* getStartPointScheme1(UInt n, RelaxationPtr rel1,
+                                 int threadid=0);
 
     /**
      * Generate a (re)starting point preferably within variable bounds outside a
@@ -182,6 +186,12 @@ namespace Minotaur {
     /// Scheme id for generating initial point
     UInt schemeId_;
 
+    /**
+     * Seed of the random number generator of each thread. Starting points
+     * are generated concurrently, so rand() cannot be used.
+     */
+    std::vector<unsigned int> seeds_;
+
 /// Statistics
     MBPStats stats_;
 
@@ -197,6 +207,12 @@ namespace Minotaur {
     virtual bool isFeasible_(NodePtr node, ConstSolutionPtr sol, 
                              SolutionPoolPtr s_pool, bool &should_prune);
 
+    /// Return a random number in [0,1] from the generator of a thread.
+    double rand01_(int threadId);
+
+    /// Return a random integer in [0,K) from the generator of a thread.
+    int randInt_(int threadId, int K);
+
     /// Solve the relaxation.
     virtual void solveRelaxation_();
 
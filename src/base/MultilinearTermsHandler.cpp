@@ -1123,56 +1123,89 @@ void
 Hypergraph::adjustEdgeWeightsBetween(const VariablePtr v, const SetOfVars &g, 
                                      bool phaseOne)
 {
-  AdjListType::const_iterator pos = adjList_.find(v);
-  assert(pos != adjList_.end());
-
-  std::list<SetOfVars> e_list = pos->second;
-  for(std::list<SetOfVars>::const_iterator e_it = pos->second.begin(); e_it != pos->second.end(); ++e_it) {
-    SetOfVars new_e;
-    new_e.insert(e_it->begin(), e_it->end());
-    new_e.erase(v);
-    if (std::includes(g.begin(), g.end(), new_e.begin(), new_e.end())) {
+  int vi = vertexIndex_(v);
+  assert(vi >= 0);
+
+  markGroup_(g, true);
+  for (UInt k = incStart_[vi]; k < incStart_[vi+1]; ++k) {
+    UInt e = incEdges_[k];
+    bool in_g = true;
+    // Is e - {v} a subset of g?
+    for (UIntVector::const_iterator it = edges_[e].begin();
+         it != edges_[e].end(); ++it) {
+      if ((int) *it != vi && !mark_[*it]) {
+        in_g = false;
+        break;
+      }
+    }
+    if (in_g) {
       if (phaseOne) {
-        setWeight(*e_it, 0);
+        setWeight_(e, 0);
       }
       else {
-        double w = getWeight(*e_it);
-        setWeight(*e_it, w/2.0);        
+        setWeight_(e, weights_[e]/2.0);
       }
     }
   }
+  markGroup_(g, false);
+}
+
+
+UInt
+Hypergraph::bucket_(const UIntVector &vs) const
+{
+  // FNV-1a
+  UInt h = 2166136261U;
+  for (UIntVector::const_iterator it = vs.begin(); it != vs.end(); ++it) {
+    h ^= *it;
+    h *= 16777619U;
+  }
+  return h & (buckets_.size()-1);
 }
 
 
 void 
 Hypergraph::create(std::map<ConstVariablePtr, SetOfVars > const &terms)
 {
-
-  // Add the vertices
   std::map<ConstVariablePtr, SetOfVars >::const_iterator terms_it;
+  SetOfVars vset;
+  std::vector<UIntVector> sorted_edges;
+  std::vector<std::pair<UIntVector *, UInt> > order;
+  UInt max_ix = 0;
+  UInt nb = 1;
+  const LinearFunctionPtr obj = problem_->getObjective()->getLinearFunction();
+
+  // Add the vertices, numbered in the order of their pointers
   for(terms_it = terms.begin(); terms_it != terms.end(); ++terms_it) {
-    SetOfVars const &jt = terms_it->second;
-    for(SetOfVars::iterator it = jt.begin(); it != jt.end(); ++it) {
-      V_.insert(*it);
-    }
+    vset.insert(terms_it->second.begin(), terms_it->second.end());
+  }
+  verts_.assign(vset.begin(), vset.end());
+  for (UInt i = 0; i < verts_.size(); ++i) {
+    max_ix = std::max(max_ix, verts_[i]->getIndex());
+  }
+  vIdx_.assign(max_ix+1, -1);
+  for (UInt i = 0; i < verts_.size(); ++i) {
+    vIdx_[verts_[i]->getIndex()] = i;
   }
 
-  // Add empty lists for the hyperedges
-  for(SetOfVars::iterator v_it = V_.begin(); v_it != V_.end(); ++v_it) {
-    std::list<SetOfVars> e_list;
-    adjList_.insert(make_pair(*v_it, e_list));
+  while (nb < 2*terms.size()) {
+    nb *= 2;
   }
+  buckets_.assign(nb, UIntVector());
+  edges_.clear();
+  weights_.clear();
 
-  // Now add the edges
+  // Now add the edges. A term with the same variables as an earlier term
+  // keeps the weight of the earlier one.
   for(terms_it = terms.begin(); terms_it != terms.end(); ++terms_it) {
     SetOfVars const &jt = terms_it->second;
-    E_.insert(jt);
-    // Put it in the adjacency lists
+    UIntVector vs;
+    vs.reserve(jt.size());
     for (SetOfVars::const_iterator it = jt.begin(); it != jt.end(); ++it) {
-      AdjListType::iterator pos = adjList_.find(*it);
-      assert(pos != adjList_.end());
-      std::list<SetOfVars> &e_list = pos->second;
-      e_list.push_back(jt);
+      vs.push_back(vIdx_[(*it)->getIndex()]);
+    }
+    if (findEdge_(vs) >= 0) {
+      continue;
     }
     
     // Determine weight
@@ -1190,69 +1223,216 @@ Hypergraph::create(std::map<ConstVariablePtr, SetOfVars > const &terms)
     }
 
     // Add objective weight
-    const LinearFunctionPtr obj = problem_->getObjective()->getLinearFunction();
     if (obj != 0) {
       double w = obj->getWeight(zvar);
       zweight += fabs(w);
     }
 
-    weights_.insert(make_pair(jt, zweight));
-    originalWeights_.insert(make_pair(jt, zweight));
+    buckets_[bucket_(vs)].push_back(edges_.size());
+    edges_.push_back(vs);
+    weights_.push_back(zweight);
+  }
+
+  // Number the edges in lexicographic order.
+  for (UInt e = 0; e < edges_.size(); ++e) {
+    order.push_back(std::make_pair(&(edges_[e]), e));
+  }
+  std::sort(order.begin(), order.end(), CompareEdges());
+  sorted_edges.resize(edges_.size());
+  originalWeights_.resize(edges_.size());
+  buckets_.assign(nb, UIntVector());
+  singles_.clear();
+  for (UInt e = 0; e < order.size(); ++e) {
+    sorted_edges[e].swap(*(order[e].first));
+    originalWeights_[e] = weights_[order[e].second];
+    buckets_[bucket_(sorted_edges[e])].push_back(e);
+    if (1 == sorted_edges[e].size()) {
+      singles_.push_back(e);
+    }
+  }
+  edges_.swap(sorted_edges);
+  weights_ = originalWeights_;
+
+  // Incidence in CSR form
+  incStart_.assign(verts_.size()+1, 0);
+  for (UInt e = 0; e < edges_.size(); ++e) {
+    for (UIntVector::const_iterator it = edges_[e].begin();
+         it != edges_[e].end(); ++it) {
+      ++incStart_[*it+1];
+    }
+  }
+  for (UInt i = 0; i < verts_.size(); ++i) {
+    incStart_[i+1] += incStart_[i];
   }
+  incEdges_.resize(incStart_.back());
+  {
+    UIntVector pos(incStart_.begin(), incStart_.end()-1);
+    for (UInt e = 0; e < edges_.size(); ++e) {
+      for (UIntVector::const_iterator it = edges_[e].begin();
+           it != edges_[e].end(); ++it) {
+        incEdges_[pos[*it]++] = e;
+      }
+    }
+  }
+
+  mark_.assign(verts_.size(), false);
+  score_.assign(verts_.size(), 0.0);
+  rebuildHeap_();
 }
 
-SetOfVars 
-Hypergraph::heaviestEdge(bool &positiveWeight) const
+
+UInt
+Hypergraph::edgeIndex_(const SetOfVars &e) const
 {
-  positiveWeight = false;
-  SetOfVarsDoubleMap::const_iterator max_pos;
-  double maxWeight = 0.0;
-  for (SetOfVarsDoubleMap::const_iterator it = weights_.begin(); it != weights_.end(); ++it) {
-    double w = it->second;
-    if (w > maxWeight) {
-      positiveWeight = true;
-      max_pos = it;
-      maxWeight = w;
+  UIntVector vs;
+  int ix = -1;
+
+  vs.reserve(e.size());
+  for (SetOfVars::const_iterator it = e.begin(); it != e.end(); ++it) {
+    int vi = vertexIndex_(*it);
+    if (vi < 0) {
+      break;
+    }
+    vs.push_back(vi);
+  }
+  if (vs.size() == e.size()) {
+    ix = findEdge_(vs);
+  }
+  assert(ix >= 0);
+  return (UInt) ix;
+}
+
+
+SetOfVars
+Hypergraph::edgeVars_(UInt e) const
+{
+  SetOfVars vars;
+  for (UIntVector::const_iterator it = edges_[e].begin();
+       it != edges_[e].end(); ++it) {
+    vars.insert(verts_[*it]);
+  }
+  return vars;
+}
+
+
+int
+Hypergraph::findEdge_(const UIntVector &vs) const
+{
+  const UIntVector &b = buckets_[bucket_(vs)];
+  for (UIntVector::const_iterator it = b.begin(); it != b.end(); ++it) {
+    if (edges_[*it] == vs) {
+      return *it;
     }
   }
+  return -1;
+}
+
+
+SetOfVars 
+Hypergraph::heaviestEdge(bool &positiveWeight) const
+{
   SetOfVars e;
+
+  // Discard entries whose weight has changed since they were added.
+  while (!heap_.empty() && (heap_.front().first != weights_[-heap_.front().second]
+                            || heap_.front().first <= 0.0)) {
+    std::pop_heap(heap_.begin(), heap_.end());
+    heap_.pop_back();
+  }
+  positiveWeight = !heap_.empty();
   if (positiveWeight) {
-    e.insert(max_pos->first.begin(), max_pos->first.end());
+    e = edgeVars_(-heap_.front().second);
   }
   return e;
 }
 
+
 VariablePtr
 Hypergraph::heaviestIncidentVertex(const SetOfVars &g)
 {
-
   VariablePtr bestv;
+  UIntVector touched;
   double max_weight = 0.0;
-
-  for(AdjListType::const_iterator it = adjList_.begin(); it != adjList_.end(); ++it) {
-    VariablePtr v = it->first;    
-    if (g.find(v) != g.end()) continue; // Skip it if in g
-
-    double weight = 0.0;
-    for (ListOfSetOfVars::const_iterator e_it = it->second.begin(); e_it != it->second.end(); ++e_it) {
-      SetOfVars new_e;
-      new_e.insert(e_it->begin(), e_it->end());
-      new_e.erase(v);
-      if (std::includes(g.begin(), g.end(), new_e.begin(), new_e.end())) {
-        // This vertex is incident on the group with this edge
-        weight += getWeight(*e_it);
+  int best = -1;
+
+  // An edge is incident on g with vertex v (not in g) if all its other
+  // vertices are in g. Only edges that meet g, and edges with one vertex,
+  // can be incident.
+  markGroup_(g, true);
+  for (SetOfVars::const_iterator g_it = g.begin(); g_it != g.end(); ++g_it) {
+    int u = vertexIndex_(*g_it);
+    if (u < 0) {
+      continue;
+    }
+    for (UInt k = incStart_[u]; k < incStart_[u+1]; ++k) {
+      UInt e = incEdges_[k];
+      int first_in = -1;
+      int outside = -1;
+      UInt n_outside = 0;
+      if (weights_[e] <= 0.0) {
+        continue;
+      }
+      for (UIntVector::const_iterator it = edges_[e].begin();
+           it != edges_[e].end(); ++it) {
+        if (mark_[*it]) {
+          if (first_in < 0) {
+            first_in = *it;
+          }
+        } else {
+          outside = *it;
+          ++n_outside;
+        }
+      }
+      // count each edge once, from its first vertex in g.
+      if (1 == n_outside && first_in == u) {
+        if (0.0 == score_[outside]) {
+          touched.push_back(outside);
+        }
+        score_[outside] += weights_[e];
       }
     }
-
-    if (weight > max_weight) {
-      max_weight = weight;
-      bestv = v;
-    }    
   }
-  
+  for (UIntVector::const_iterator it = singles_.begin(); it != singles_.end();
+       ++it) {
+    UInt v = edges_[*it][0];
+    if (!mark_[v] && weights_[*it] > 0.0) {
+      if (0.0 == score_[v]) {
+        touched.push_back(v);
+      }
+      score_[v] += weights_[*it];
+    }
+  }
+  markGroup_(g, false);
+
+  // Ties go to the first vertex.
+  for (UIntVector::const_iterator it = touched.begin(); it != touched.end();
+       ++it) {
+    if (score_[*it] > max_weight ||
+        (score_[*it] == max_weight && best > (int) *it)) {
+      max_weight = score_[*it];
+      best = *it;
+    }
+    score_[*it] = 0.0;
+  }
+  if (best >= 0) {
+    bestv = verts_[best];
+  }
   return bestv;
 }
 
+
+void
+Hypergraph::markGroup_(const SetOfVars &g, bool val)
+{
+  for (SetOfVars::const_iterator it = g.begin(); it != g.end(); ++it) {
+    int vi = vertexIndex_(*it);
+    if (vi >= 0) {
+      mark_[vi] = val;
+    }
+  }
+}
+
+
 VariablePtr
 Hypergraph::maxWeightedDegreeVertex(bool &positiveWeight) const
 {
@@ -1260,83 +1440,87 @@ Hypergraph::maxWeightedDegreeVertex(bool &positiveWeight) const
   double max_deg = 0.0;
   positiveWeight = false;
 
-  for(SetOfVars::iterator it = V_.begin(); it != V_.end(); ++it) {
-    double w = weightedDegree(*it);    
+  for (UInt i = 0; i < verts_.size(); ++i) {
+    double w = 0.0;
+    for (UInt k = incStart_[i]; k < incStart_[i+1]; ++k) {
+      w += weights_[incEdges_[k]];
+    }
     if (w > max_deg) {
       max_deg = w;
       positiveWeight = true;
-      heavyV = *it;
+      heavyV = verts_[i];
     }
   }      
   return heavyV;
 }
 
+
 SetOfVars 
 Hypergraph::randomEdge(bool &positiveWeight)
 {
   positiveWeight = false;
-  SetOfSetOfVars::iterator first_it = E_.begin();  
-  int rix = (int) (drand48()*E_.size());
-  std::advance(first_it, rix);
+  if (edges_.empty()) {
+    return SetOfVars();
+  }
 
-  SetOfSetOfVars::iterator e_it = first_it;
+  UInt first = (UInt) (drand48()*edges_.size());
+  UInt e = first;
   do {
-    const SetOfVars &e = *e_it;
-
-    double w = getWeight(e);
-
-    if (w > 0.0) {
+    if (weights_[e] > 0.0) {
       positiveWeight = true;
     }
-
-    if (!positiveWeight) {
-      e_it++;      
-      if (e_it == E_.end()) e_it = E_.begin();
+    else {
+      e = (e+1) % edges_.size();
     }
-    
-  } while (!positiveWeight && e_it != first_it);
+  } while (!positiveWeight && e != first);
   
-  return (*e_it);
+  return edgeVars_(e);
+}
+
+
+void
+Hypergraph::rebuildHeap_()
+{
+  heap_.clear();
+  for (UInt e = 0; e < weights_.size(); ++e) {
+    if (weights_[e] > 0.0) {
+      heap_.push_back(std::make_pair(weights_[e], -((int) e)));
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end());
 }
 
+
 void 
 Hypergraph::resetWeights()
 {
-
-  for(SetOfVarsDoubleMap::iterator it = originalWeights_.begin(); it != originalWeights_.end(); ++it) {
-    weights_[it->first] = it->second;    
-  }
+  weights_ = originalWeights_;
+  rebuildHeap_();
 
 #if defined(DEBUG_MULTILINEARTERMS_HANDLER)
-  int ix = 0;
-  for(SetOfVarsDoubleMap::iterator it = originalWeights_.begin(); it != originalWeights_.end(); ++it) {
-    std::cout << "Resetting weight of edge " << (ix++) << " to: " << it->second << std::endl;
+  for (UInt e = 0; e < originalWeights_.size(); ++e) {
+    std::cout << "Resetting weight of edge " << e << " to: "
+              << originalWeights_[e] << std::endl;
   }
 #endif
 }
 
 
-
 double Hypergraph::getWeight(const SetOfVars &e) 
 {
-#if DEBUG
-  // Just check that it exists (debugging)
-  SetOfVarsDoubleMap::const_iterator pos = weights_.find(e);
-  assert(pos != weights_.end());
-#endif
-
-  return weights_[e];
-
+  return weights_[edgeIndex_(e)];
 }
 
+
 Hypergraph::ListOfSetOfVars
 Hypergraph::incidentEdges(ConstVariablePtr v) const
 {
-
   ListOfSetOfVars edges;
-  AdjListType::const_iterator pos = adjList_.find(v);
-  if (pos != adjList_.end()) {
-    edges = pos->second;
+  int vi = vertexIndex_(v);
+  if (vi >= 0) {
+    for (UInt k = incStart_[vi]; k < incStart_[vi+1]; ++k) {
+      edges.push_back(edgeVars_(incEdges_[k]));
+    }
   }          
   return edges;
 }
@@ -1344,14 +1528,7 @@ Hypergraph::incidentEdges(ConstVariablePtr v) const
 
 void Hypergraph::setWeight(const SetOfVars &e, double w)
 {
-#if DEBUG
-  // Just check that it exists (debugging)
-  SetOfVarsDoubleMap::iterator pos = weights_.find(e);
-  assert(pos != weights_.end());
-#endif
-
-  if (w < 0.0001) weights_[e] = 0.0;
-  else weights_[e] = w;
+  setWeight_(edgeIndex_(e), w);
 
 #if defined(DEBUG_MULTILINEARTERMS_HANDLER)
   std::cout << "Setting weight of edge: " << std::endl;
@@ -1360,37 +1537,58 @@ void Hypergraph::setWeight(const SetOfVars &e, double w)
   }
   std::cout << "to " << w << std::endl;
 #endif  
+}
 
+
+void Hypergraph::setWeight_(UInt e, double w)
+{
+  if (w < 0.0001) {
+    weights_[e] = 0.0;
+  }
+  else {
+    weights_[e] = w;
+    heap_.push_back(std::make_pair(w, -((int) e)));
+    std::push_heap(heap_.begin(), heap_.end());
+  }
 }
 
+
+int Hypergraph::vertexIndex_(ConstVariablePtr v) const
+{
+  UInt ix = v->getIndex();
+  if (ix < vIdx_.size() && vIdx_[ix] >= 0 && verts_[vIdx_[ix]] == v) {
+    return vIdx_[ix];
+  }
+  return -1;
+}
+
+
 double Hypergraph::weightedDegree(ConstVariablePtr v) const
 {
   double val = 0.0;
-  AdjListType::const_iterator pos = adjList_.find(v);
-
-  if (pos != adjList_.end()) {
-    std::list<SetOfVars> e_list = pos->second;
-    for(std::list<SetOfVars>::const_iterator e_it = e_list.begin(); e_it != e_list.end(); ++e_it) {
-      SetOfVarsDoubleMap::const_iterator it = weights_.find(*e_it);
-      assert(it != weights_.end());
-      val += it->second;
+  int vi = vertexIndex_(v);
+
+  if (vi >= 0) {
+    for (UInt k = incStart_[vi]; k < incStart_[vi+1]; ++k) {
+      val += weights_[incEdges_[k]];
     }
   }
   return val;
 }
 
+
 void
 Hypergraph::write(std::ostream &out) const
 {
-  for(AdjListType::const_iterator it = adjList_.begin(); it != adjList_.end(); ++it) {
-    ConstVariablePtr v = it->first;
-    std::cout << "Vertex: ";
-    v->write(out);
-    std::list<SetOfVars> e_list = it->second;    
-    for(std::list<SetOfVars>::const_iterator e_it = e_list.begin(); e_it != e_list.end(); ++e_it) {
-      std::cout << " has edge: " << std::endl;    
-      for(SetOfVars::const_iterator v_it = e_it->begin(); v_it != e_it->end(); ++v_it) {
-        (*v_it)->write(out);
+  for (UInt i = 0; i < verts_.size(); ++i) {
+    out << "Vertex: ";
+    verts_[i]->write(out);
+    for (UInt k = incStart_[i]; k < incStart_[i+1]; ++k) {
+      const UIntVector &e = edges_[incEdges_[k]];
+      out << " has edge: " << std::endl;    
+      for (UIntVector::const_iterator v_it = e.begin(); v_it != e.end();
+           ++v_it) {
+        verts_[*v_it]->write(out);
       }
     }
   }    
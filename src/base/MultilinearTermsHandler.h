@@ -13,6 +13,7 @@
 #define MINOTAURMULTILINEARTERMSHANDLER_H
 
 #include <algorithm>
+#include <string>
 
 #include "Handler.h"
 #include "LPEngine.h"
@@ -28,28 +29,22 @@ typedef std::set<ConstVariablePtr> SetOfVars;
 typedef std::set<SetOfVars> SetOfSetOfVars;
 
 
-/*
- * This class is needed to store information about term cover
- *  It is not a horribly efficient implementation, as I didn't even bother
- *  to make an adjacency list (yet)
+/**
+ * \brief Hypergraph of multilinear terms, used for finding a term cover.
+ *
+ * Each variable of a term is a vertex and each term is an edge. Vertices
+ * and edges are stored by integer indices: vertices are numbered in the
+ * order of their pointers and edges in the lexicographic order of their
+ * vertices, which is the order of std::set<SetOfVars>. The edges are kept in
+ * a hash table keyed on their sorted vertex indices, and the edges incident
+ * on each vertex in compressed-row (CSR) form. The heaviest edge is found
+ * from a heap. The methods that take a SetOfVars look up the edge or group
+ * by hashing, so that the term cover heuristics run in time close to linear
+ * in the size of the hypergraph.
  */
-
 class Hypergraph {
-
-public:
-
-class CompareSetsOfVars
-{
 public:
-  bool operator()(const SetOfVars &lhs, const SetOfVars &rhs ) const
-    {
-      return lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
-    }
-};
-  
-  typedef std::map<SetOfVars, double, CompareSetsOfVars> SetOfVarsDoubleMap;
   typedef std::list<SetOfVars> ListOfSetOfVars;
-  typedef std::map<ConstVariablePtr, ListOfSetOfVars> AdjListType;
   
 public:
   Hypergraph(ConstProblemPtr p) : problem_(p) {} ;
@@ -64,8 +59,8 @@ public:
   ListOfSetOfVars incidentEdges(ConstVariablePtr v) const;
 
   VariablePtr maxWeightedDegreeVertex(bool &maxWeightPositive) const;
-  int numEdges() const { return E_.size(); }
-  int numVertices() const { return V_.size(); }
+  int numEdges() const { return edges_.size(); }
+  int numVertices() const { return verts_.size(); }
 
   SetOfVars randomEdge(bool &maxWeightPositive);
   void resetWeights();
@@ -74,16 +69,84 @@ public:
   void write(std::ostream &out) const;
 
 private:
+  /// (weight, -edge index), so that ties go to the first edge.
+  typedef std::pair<double, int> WeightEdgePair;
+
+  /// Compare edges by their vertices, for sorting pointers to edges.
+  class CompareEdges {
+  public:
+    bool operator()(const std::pair<UIntVector *, UInt> &lhs,
+                    const std::pair<UIntVector *, UInt> &rhs) const
+    {
+      return *(lhs.first) < *(rhs.first);
+    }
+  };
+
+  /// Index in buckets_ for a sorted list of vertices.
+  UInt bucket_(const UIntVector &vs) const;
+
+  /// Index of the edge with the given vertices, -1 if there is none.
+  int findEdge_(const UIntVector &vs) const;
+
+  /// Index of the edge e. e must be an edge.
+  UInt edgeIndex_(const SetOfVars &e) const;
+
+  /// Convert an edge to the set of its variables.
+  SetOfVars edgeVars_(UInt e) const;
+
+  /// Set the marks of the vertices of g to val. Variables that are not
+  /// vertices are skipped.
+  void markGroup_(const SetOfVars &g, bool val);
+
+  /// Rebuild the heap from the current weights.
+  void rebuildHeap_();
+
+  /// Set the weight of edge e.
+  void setWeight_(UInt e, double w);
+
+  /// Index of the vertex of variable v, -1 if v is not a vertex.
+  int vertexIndex_(ConstVariablePtr v) const;
 
   ConstProblemPtr problem_;
 
-  SetOfVars V_;
-  AdjListType adjList_;
+  /// Buckets of the hash table of edges. Each has the indices of edges.
+  std::vector<UIntVector> buckets_;
 
-  SetOfSetOfVars E_;
-  SetOfVarsDoubleMap weights_;
-  SetOfVarsDoubleMap originalWeights_;
-  
+  /// Vertices of each edge, in increasing order.
+  std::vector<UIntVector> edges_;
+
+  /// Edges with one vertex, which are incident on every group.
+  UIntVector singles_;
+
+  /// Heap of edges by weight. Entries whose weight is not current are
+  /// skipped.
+  mutable std::vector<WeightEdgePair> heap_;
+
+  /// Edges incident on vertex i are incEdges_[incStart_[i]], ...,
+  /// incEdges_[incStart_[i+1]-1].
+  UIntVector incEdges_;
+
+  /// See incEdges_.
+  UIntVector incStart_;
+
+  /// Marks of vertices in a group. Work space.
+  std::vector<bool> mark_;
+
+  /// Weights of edges as created.
+  DoubleVector originalWeights_;
+
+  /// Score of each vertex in heaviestIncidentVertex. Work space.
+  DoubleVector score_;
+
+  /// Vertex of each variable, by the index of the variable. -1 if the
+  /// variable is not a vertex.
+  std::vector<int> vIdx_;
+
+  /// Variables of the vertices, in the order of their pointers.
+  std::vector<ConstVariablePtr> verts_;
+
+  /// Current weights of edges.
+  DoubleVector weights_;
 };
 
 
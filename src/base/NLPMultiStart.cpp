@@ -13,6 +13,9 @@
 #include <cmath> // for INFINITY
 
 #include "MinotaurConfig.h"
+#if USE_OPENMP
+#include <omp.h>
+#endif
 #include "Engine.h"
 #include "Variable.h"
 #include "Environment.h"
@@ -21,6 +24,9 @@
 #include "Node.h"
 #include "Operations.h"
 #include "Option.h"
+#include "Constraint.h"
+#include "Objective.h"
+#include "Solution.h"
 #include "SolutionPool.h"
 #include "Timer.h"
 #include <iomanip>
@@ -35,10 +41,13 @@ const std::string NLPMultiStart::me_ = "NLP Multi-Start Heuristic: ";
 NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
 : e_(e),
   env_(env),
+  maxNLPs_(10),
+  numCands_(4),
   p_(p)
 {
   VariablePtr variable;
   UInt n      = p_->getNumVars();
+  int seed    = env_->getOptions()->findInt("rand_seed")->getValue();
   distBound_  = 0.0;
   for (UInt i=0; i<n; ++i) {
     variable = p_->getVariable(i);
@@ -47,7 +56,16 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
   distBound_ = (distBound_ >= INFINITY) ? 10.0*sqrt(n) : sqrt(distBound_);
   logger_ = (LoggerPtr) new Logger((LogLevel) env_->getOptions()->
                                    findInt("heur_log_level")->getValue());
-  random_                   = new double[n];  
+  numThreads_ = std::max(1, env_->getOptions()->findInt("threads")->
+                         getValue());
+  roundSize_ = std::max(1, env_->getOptions()->
+                        findInt("msheur_round_size")->getValue());
+
+  // the heuristic is reproducible unless a seed is given.
+  if (seed <= 0) {
+    seed = 1;
+  }
+  seed_ = seed;
 
   // statistics
   stats_.numNLPs           = 0;
@@ -62,12 +80,12 @@ NLPMultiStart::NLPMultiStart(EnvPtr env, ProblemPtr p, EnginePtr e)
 
 
 NLPMultiStart::~NLPMultiStart(){
-  delete [] random_;
 }
 
 
 void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
-                                      UInt n)
+                                      UInt n, double *dir,
+                                      unsigned int *seed)
 {
   double dist;
   VariablePtr variable;
@@ -75,11 +93,11 @@ void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
   VariableConstIterator v_iter;
 
   for (UInt i=0; i<n; ++i) {
-    random_[i] = rand()/double(RAND_MAX) - 0.5;
+    dir[i] = rand_r(seed)/double(RAND_MAX) - 0.5;
   }
-  norm = sqrt(InnerProduct(random_, random_, n)); 
+  norm = sqrt(InnerProduct(dir, dir, n)); 
   for (UInt i=0; i<n; ++i) {
-    random_[i] /= norm;
+    dir[i] /= norm;
   }
 
 #if SPEW
@@ -94,14 +112,13 @@ void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
   dist *= rho;
 
   for (v_iter=p_->varsBegin(); v_iter!=p_->varsEnd(); ++v_iter, 
-      ++a, ++b, ++random_) {
+      ++a, ++b, ++dir) {
     variable = *v_iter;
     // find a point in a random direction outside the ball
     // centered around x* with radius = ||x*-x||
-    *a = std::max(std::min(*b + (*random_) * dist, 
+    *a = std::max(std::min(*b + (*dir) * dist, 
           variable->getUb()), variable->getLb());
   }
-  random_ -= n;
 
 #if SPEW
   logger_->msgStream(LogDebug2)
@@ -112,88 +129,233 @@ void NLPMultiStart::constructInitial_(double* a, const double* b, double rho,
 }
 
 
+bool NLPMultiStart::isFeasible_(EngineStatus status)
+{
+  return (ProvenOptimal==status || ProvenLocalOptimal==status ||
+          FailedFeas==status || ProvenFailedCQFeas==status);
+}
+
+
+double NLPMultiStart::merit_(const double *x)
+{
+  const double wt = 1e3; // weight of violation
+  ConstraintPtr c;
+  VariablePtr v;
+  double act, viol = 0.0, obj = 0.0;
+  int err = 0;
+
+  if (p_->getObjective()) {
+    obj = p_->getObjective()->eval(x, &err);
+    if (err) {
+      return INFINITY;
+    }
+  }
+  for (ConstraintConstIterator it=p_->consBegin(); it!=p_->consEnd(); ++it) {
+    c = *it;
+    act = c->getActivity(x, &err);
+    if (err) {
+      return INFINITY;
+    }
+    viol += std::max(0.0, c->getLb()-act) + std::max(0.0, act-c->getUb());
+  }
+  for (VariableConstIterator it=p_->varsBegin(); it!=p_->varsEnd(); ++it) {
+    v = *it;
+    act = x[v->getIndex()];
+    viol += std::max(0.0, v->getLb()-act) + std::max(0.0, act-v->getUb());
+  }
+  return obj + wt*viol;
+}
+
+
+void NLPMultiStart::randomPoint_(double *a, bool corner, unsigned int *seed)
+{
+  VariablePtr v;
+  double lb, ub, r;
+
+  for (VariableConstIterator it=p_->varsBegin(); it!=p_->varsEnd();
+       ++it, ++a) {
+    v = *it;
+    lb = v->getLb();
+    ub = v->getUb();
+    r = rand_r(seed)/double(RAND_MAX);
+    if (lb > -INFINITY && ub < INFINITY) {
+      if (corner) {
+        *a = (r < 0.5) ? lb : ub;
+      } else {
+        *a = lb + r*(ub-lb);
+      }
+    } else if (lb > -INFINITY) {
+      *a = lb + r*distBound_;
+    } else if (ub < INFINITY) {
+      *a = ub - r*distBound_;
+    } else {
+      *a = (r-0.5)*distBound_;
+    }
+  }
+}
+
+
 void NLPMultiStart::solve(NodePtr, RelaxationPtr, SolutionPoolPtr s_pool)
 {
-  ConstSolutionPtr sol; 
-  EngineStatus status;
-  UInt heur_bound                = 10; // no. of times the heuristic should run
   UInt unchanged_obj_count_limit =  3;
+  UInt round_size                = std::min(roundSize_, maxNLPs_);
+  UInt nstarts                   =  0;
   double obj_tol                 = 1e-6; 
   double rho_initial             = 1.1;// amplification factor
   double rho                     = rho_initial;
   Timer *timer                   = env_->getNewTimer();
   UInt n                         = p_->getNumVars();
+  // threads beyond the number of starts in a round would have no work.
+  UInt nthreads                  = std::min(numThreads_, round_size);
+  bool have_feasible             = false;
   double* prev_feasible          = new double[n];
-  double* initial_point          = new double[n];
-
-  // start at a random point.
-  for (UInt i=0; i<n; ++i){
-    initial_point[i] = rand()/double (RAND_MAX);
-  }
+  double* cands                  = new double[round_size*numCands_*n];
+  double* dirs                   = new double[round_size*n];
+  double* starts                 = new double[round_size*n];
+  std::vector<ProblemPtr> probs(nthreads);
+  std::vector<EnginePtr> engines(nthreads);
+  std::vector<EngineStatus> status(round_size);
+  std::vector<ConstSolutionPtr> sols(round_size);
+  std::vector<UInt> best(round_size);
 
-  srand(1);
   timer->start();
   e_->clear();
   e_->load(p_);
-  for (UInt i=0, unchanged_obj_count=0; i < heur_bound &&
-       unchanged_obj_count < unchanged_obj_count_limit; ++i) {
-    // XXX: ashu to bring this out of the loop.
-    p_->setInitialPoint(initial_point);
-    status = e_->solve();
-    ++(stats_.numNLPs);
-    sol = e_->getSolution();
-    if (sol->getObjValue() < stats_.bestObjValue - obj_tol) {
-      stats_.bestObjValue = sol->getObjValue();
-      rho = rho_initial;
-      unchanged_obj_count = 0;
-      s_pool->addSolution(sol);
-      constructInitial_(initial_point, sol->getPrimal(), rho, n);
-      std::copy(sol->getPrimal(), sol->getPrimal() + n, prev_feasible); 
-      ++(stats_.numImprove);
+  probs[0] = p_;
+  engines[0] = e_;
+  for (UInt t=1; t<nthreads; ++t) {
+    engines[t] = e_->emptyCopy();
+    if (!engines[t]) {
+      // engine cannot be copied. solve one NLP at a time.
+      for (UInt u=1; u<t; ++u) {
+        engines[u]->clear();
+      }
+      nthreads = 1;
+      break;
+    }
+    probs[t] = p_->clone();
+    probs[t]->prepareForSolve();
+    engines[t]->clear();
+    engines[t]->load(probs[t]);
+  }
+
+  for (UInt i=0, unchanged_obj_count=0; i < maxNLPs_ &&
+       unchanged_obj_count < unchanged_obj_count_limit; i += nstarts) {
+    nstarts = std::min(round_size, maxNLPs_-i);
+
+    // generate candidates. Each start uses its own random numbers.
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads)
+#endif
+    for (UInt k=0; k<nstarts; ++k) {
+      unsigned int seed = seed_ + stats_.numNLPs + k;
+      for (UInt c=0; c<numCands_; ++c) {
+        double *a = cands + (k*numCands_+c)*n;
+        if (have_feasible) {
+          std::copy(starts+k*n, starts+(k+1)*n, a);
+          constructInitial_(a, prev_feasible, rho*(1.0+0.1*c), n,
+                            dirs+k*n, &seed);
+        } else {
+          randomPoint_(a, 1==c%2, &seed);
+        }
+      }
+    }
+
+    // screen the candidates. Functions are not evaluated concurrently.
+    for (UInt k=0; k<nstarts; ++k) {
+      double m, best_m = INFINITY;
+      best[k] = k*numCands_;
+      for (UInt c=0; c<numCands_; ++c) {
+        m = merit_(cands + (k*numCands_+c)*n);
+        if (m < best_m) {
+          best_m = m;
+          best[k] = k*numCands_+c;
+        }
+      }
+    }
+
+    // solve from the best candidates, each thread with its own engine.
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#endif
+    for (UInt k=0; k<nstarts; ++k) {
+#if USE_OPENMP
+      UInt t = omp_get_thread_num();
+#else
+      UInt t = 0;
+#endif
+      std::copy(cands+best[k]*n, cands+(best[k]+1)*n, starts+k*n);
+      probs[t]->setInitialPoint(starts+k*n);
+      status[k] = engines[t]->solve();
+      sols[k] = (ConstSolutionPtr) new Solution(engines[t]->getSolution());
+      // share with other threads and heuristics right away.
+      if (isFeasible_(status[k]) &&
+          sols[k]->getObjValue() < s_pool->getBestSolutionValue() - obj_tol) {
+        s_pool->addSolution(sols[k]);
+      }
+    }
+
+    // update in the order of starts, so that results are reproducible.
+    for (UInt k=0; k<nstarts; ++k) {
+      ConstSolutionPtr sol = sols[k];
+      ++(stats_.numNLPs);
+      if (isFeasible_(status[k]) &&
+          sol->getObjValue() < stats_.bestObjValue - obj_tol) {
+        stats_.bestObjValue = sol->getObjValue();
+        rho = rho_initial;
+        unchanged_obj_count = 0;
+        std::copy(sol->getPrimal(), sol->getPrimal() + n, prev_feasible); 
+        have_feasible = true;
+        ++(stats_.numImprove);
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ << "Better solution " 
-        << stats_.bestObjValue << std::endl;
+        logger_->msgStream(LogDebug) << me_ << "Better solution " 
+          << stats_.bestObjValue << std::endl;
 #endif
-    } else if ((ProvenInfeasible==status || ProvenLocalInfeasible==status ||
-        ProvenObjectiveCutOff==status || ProvenFailedCQInfeas==status || 
-        FailedInfeas==status) || ((FailedFeas==status || 
-        ProvenFailedCQFeas==status || ProvenLocalOptimal==status) && 
-        stats_.bestObjValue <= sol->getObjValue() + obj_tol)) {
-      rho *= 1.07;
-      ++unchanged_obj_count;
-      // use previously found feasible solution
-      constructInitial_(initial_point, prev_feasible, rho, n);
-      ++(stats_.numInfeas);
+      } else if ((ProvenInfeasible==status[k] ||
+                  ProvenLocalInfeasible==status[k] ||
+                  ProvenObjectiveCutOff==status[k] ||
+                  ProvenFailedCQInfeas==status[k] ||
+                  FailedInfeas==status[k]) ||
+                 ((FailedFeas==status[k] || ProvenFailedCQFeas==status[k] ||
+                   ProvenLocalOptimal==status[k]) && 
+                  stats_.bestObjValue <= sol->getObjValue() + obj_tol)) {
+        rho *= 1.07;
+        ++unchanged_obj_count;
+        ++(stats_.numInfeas);
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ 
-        << "Engine status = " << status << std::endl
-        << me_
-        << "Optimal solution no better than best known " << sol->getObjValue()  
-        << std::endl;
+        logger_->msgStream(LogDebug) << me_ 
+          << "Engine status = " << status[k] << std::endl
+          << me_
+          << "Optimal solution no better than best known "
+          << sol->getObjValue() << std::endl;
 #endif
-    } else if (status == ProvenUnbounded) { 
-      rho *= 0.9;
-      ++unchanged_obj_count;
-      ++(stats_.numBadstatus);
-      // use previously found feasible solution
-      constructInitial_(initial_point, prev_feasible, rho, n);       
+      } else if (status[k] == ProvenUnbounded) { 
+        rho *= 0.9;
+        ++unchanged_obj_count;
+        ++(stats_.numBadstatus);
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ << "Unbounded." << std::endl;
+        logger_->msgStream(LogDebug) << me_ << "Unbounded." << std::endl;
 #endif
-    } else { 
+      } else { 
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ << "Solution found is not optimal" 
-        << " solution value = " <<  sol->getObjValue() << std::endl; 
+        logger_->msgStream(LogDebug) << me_ << "Solution found is not optimal" 
+          << " solution value = " <<  sol->getObjValue() << std::endl; 
 #endif
+      }
     }
+    ++(stats_.iterations);
     stats_.time = timer->query();
   }
+
+  for (UInt t=1; t<nthreads; ++t) {
+    engines[t]->clear();
+  }
   if (timer) {
     delete timer;
   }
-  if (initial_point) {
-    delete [] initial_point;
-  }
+  delete [] cands;
+  delete [] dirs;
+  delete [] starts;
   if (prev_feasible) {
     delete [] prev_feasible;
   }
@@ -209,7 +371,7 @@ void NLPMultiStart::writeStats(std::ostream &out) const
     << me_ << " number of Improvements in objective   = " 
     << stats_.numImprove << std::endl
     << me_ << " number of Bad status(unbounded etc)   = " 
-    << stats_.numNLPs << std::endl
+    << stats_.numBadstatus << std::endl
     << me_ << " total time taken                      = " 
     << stats_.time << std::endl
     << me_ << " number of iterations                  = " 
@@ -44,6 +44,21 @@ namespace Minotaur {
    * A Heuristic used to find solutions for continuous NLPs by solving the
    * NLP using NLP engine. The engine is called multiple times from different
    * strategically constructed starting points.
+   *
+   * The NLPs are solved in rounds of roundSize_ starts (option
+   * msheur_round_size). The k-th start overall seeds its own random number
+   * generator with seed_+k and generates numCands_ candidate points: random
+   * points and box corners until a feasible solution is found, points
+   * outside a ball around the best solution after that. The candidates are
+   * screened serially by a merit function (objective plus weighted
+   * constraint violation), and the best one is the starting point of the
+   * NLP. The NLPs of a round are solved concurrently, by at most
+   * min(threads, roundSize_) threads, on copies of the problem and engine.
+   * The best point and the radius of the ball are updated after each round,
+   * in the order of the starts. Since neither the seeds nor the rounds
+   * depend on the number of threads, every thread count solves the same
+   * NLPs from the same points. Solutions are shared through the solution
+   * pool.
    */
   class NLPMultiStart : public Heuristic {
     
@@ -78,12 +93,27 @@ namespace Minotaur {
 
       /// Logger.
       LoggerPtr logger_;
+
+      /// Maximum number of NLPs solved in one call to solve().
+      UInt maxNLPs_;
+
+      /// Number of candidate points screened for each NLP solve.
+      UInt numCands_;
+
+      /// Number of threads allowed (option threads).
+      UInt numThreads_;
      
       /// Problem that is being solved.
       ProblemPtr p_;
 
-      /// random search direction 
-      double *random_;
+      /**
+       * Number of NLPs solved between two updates of the best point and the
+       * radius. At most this many threads are used.
+       */
+      UInt roundSize_;
+
+      /// Seed of random numbers. The k-th NLP start uses seed_+k.
+      unsigned int seed_;
 
       /// Statistics for Multistart heuristic
       MSHeurStats stats_;
@@ -99,9 +129,26 @@ namespace Minotaur {
        * \param[in] Pointb Current optimal solution
        * \param[in] rho The amplification factor
        * \param]in] vars Number of variables
+       * \param[in] dir Array of size vars for the random direction.
+       * \param[in] seed Seed of the random number generator to be used.
+       */
+      void constructInitial_(double* a, const double* b, double rho,
+                             UInt vars, double *dir, unsigned int *seed);
+
+      /// Return true if the engine status means that a solution is feasible.
+      bool isFeasible_(EngineStatus status);
+
+      /**
+       * \brief Return objective value plus weighted violation of constraints
+       * and bounds at a point, INFINITY if functions cannot be evaluated.
+       */
+      double merit_(const double *x);
+
+      /**
+       * \brief Construct a random point in the variable bounds. If corner is
+       * true, bounded variables are set to one of their bounds.
        */
-      void constructInitial_(double* a, const double* b, double rho, UInt vars);
-      
+      void randomPoint_(double *a, bool corner, unsigned int *seed);
   };
 
   typedef boost::shared_ptr<NLPMultiStart> NLPMSPtr;
@@ -9,6 +9,7 @@
  * \brief Define base class Node Processor.
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
+#include <algorithm>
 #include <cmath> // for INFINITY
 
 #include "MinotaurConfig.h"
@@ -23,8 +24,13 @@
 #include "Node.h"
 #include "Option.h"
 #include "Modification.h"
+#include "Profiler.h"
 #include "Relaxation.h"
+#include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
+#include "Variable.h"
+#include "VarBoundMod.h"
 
 using namespace Minotaur;
 
@@ -38,8 +44,14 @@ PCBProcessor::PCBProcessor (EnvPtr env, EnginePtr engine, HandlerVector handlers
   : contOnErr_(false),
     cutMan_(0),
     numSolutions_(0),
+    eTol_(1e-6),
     oATol_(1e-5),
-    oRTol_(1e-5)
+    oRTol_(1e-5),
+    prof_(env->getProfiler()),
+    rcFixStat_(env->getStats()->counter("pcbproc.rc_fixes")),
+    rootObj_(-INFINITY),
+    solveHist_(env->getStats()->histogram("engine.solve_time")),
+    solveTimer_(env->getStats()->timer("engine.solve"))
 {
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
   engine_ = engine;
@@ -48,11 +60,13 @@ PCBProcessor::PCBProcessor (EnvPtr env, EnginePtr engine, HandlerVector handlers
                                    findInt("node_processor_log_level")->
                                    getValue());
   presFreq_ = env->getOptions()-> findInt("pres_freq")->getValue();
+  rcFix_ = env->getOptions()->findBool("rc_fix")->getValue();
   stats_.bra = 0;
   stats_.inf = 0;
   stats_.opt = 0;
   stats_.prob = 0;
   stats_.proc = 0;
+  stats_.rcfix = 0;
   stats_.ub = 0;
 }
 
@@ -136,7 +150,11 @@ bool PCBProcessor::presolveNode_(NodePtr node, SolutionPoolPtr s_pool)
     ++it;
     for (HandlerIterator h = handlers_.begin(); h != handlers_.end() 
          && false==is_inf; ++h) {
-      is_inf = (*h)->presolveNode(relaxation_, node, s_pool, p_mods, r_mods);
+      {
+        ProfZone pz(prof_, "presolve node");
+        is_inf = (*h)->presolveNode(relaxation_, node, s_pool, p_mods,
+                                    r_mods);
+      }
       for (ModificationConstIterator m_iter=p_mods.begin();
            m_iter!=p_mods.end(); ++m_iter) {
         node->addPMod(*m_iter);
@@ -275,6 +293,7 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
     if (iter == 1 && !node->getParent()) {
       // in root, in first iteration, run a heuristic. XXX: better management.
       for (HeurVector::iterator it=heurs_.begin(); it!=heurs_.end(); ++it) {
+        ProfZone pz(prof_, "heuristic");
         (*it)->solve(node, rel, s_pool);
       }
     }
@@ -282,7 +301,12 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
 
     // the node can not be pruned because of infeasibility or high cost.
     // continue processing.
-    tightenBounds_();
+    tightenBounds_(node, sol, s_pool, &should_prune, &should_resolve);
+    if (should_prune) {
+      break;
+    } else if (should_resolve) {
+      continue;
+    }
     separate_(sol, node, s_pool, &sep_status);
 
 //    relaxation_->write(std::cout);
@@ -297,8 +321,11 @@ void PCBProcessor::process(NodePtr node, RelaxationPtr rel,
     } else {
       // save warm start information before branching. This step is expensive.
       ws_ = engine_->getWarmStartCopy();
-      branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
-                                          br_status, mods);
+      {
+        ProfZone pz(prof_, "find branches");
+        branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
+                                            br_status, mods);
+      }
       if (br_status==PrunedByBrancher) {
 
         should_prune = true;
@@ -353,6 +380,7 @@ void PCBProcessor::separate_(ConstSolutionPtr sol, NodePtr node,
   *status = SepaContinue;
   sol_found = false;
   for (h = handlers_.begin(); h != handlers_.end(); ++h) {
+    ProfZone pz(prof_, "separate");
     (*h)->separate(sol, node, relaxation_, cutMan_, s_pool, &sol_found, &st);
     if (st == SepaPrune) {
       *status = SepaPrune;
@@ -486,7 +514,11 @@ bool PCBProcessor::shouldPrune_(NodePtr node, double solval,
 void PCBProcessor::solveRelaxation_() 
 {
   engineStatus_ = EngineError;
-  engine_->solve();
+  {
+    ProfZone pz(prof_, "engine solve");
+    StatTimerScope st(solveTimer_, solveHist_);
+    engine_->solve();
+  }
   engineStatus_ = engine_->getStatus();
 #if SPEW
   logger_->msgStream(LogDebug2) <<  "lp processor: solving relaxation" 
@@ -497,9 +529,108 @@ void PCBProcessor::solveRelaxation_()
 }
 
 
-void PCBProcessor::tightenBounds_() 
+void PCBProcessor::tightenBounds_(NodePtr node, ConstSolutionPtr sol,
+                                  SolutionPoolPtr s_pool, bool *should_prune,
+                                  bool *should_resolve) 
 {
+  const double *x = sol->getPrimal();
+  const double *d = sol->getDualOfVars();
+  const double cutoff = std::min(cutOff_, s_pool->getBestSolutionValue());
+  const double obj = sol->getObjValue();
+  const bool is_root = !node->getParent();
+  VariablePtr v;
+  VarBoundModPtr mod;
+  ModVector mods;
+  double lb, ub, nlb, nub;
+  UInt i;
+
+  *should_prune = false;
+  *should_resolve = false;
+  if (false==rcFix_ || !d || !x || false==relaxation_->isLinear()) {
+    return;
+  }
+
+  if (is_root) {
+    // save for use in other nodes. Overwritten after each resolve of the
+    // root, because cuts make the later LPs tighter.
+    rootObj_ = obj;
+    rootRc_.assign(relaxation_->getNumVars(), 0.0);
+    rootX_.assign(x, x+relaxation_->getNumVars());
+    for (VariableConstIterator it=relaxation_->varsBegin();
+         it!=relaxation_->varsEnd(); ++it) {
+      v = *it;
+      i = v->getIndex();
+      if ((d[i] > eTol_ && x[i] < v->getLb()+eTol_) ||
+          (d[i] < -eTol_ && x[i] > v->getUb()-eTol_)) {
+        rootRc_[i] = d[i];
+      }
+    }
+  }
 
+  if (cutoff >= INFINITY) {
+    return;
+  }
+
+  for (VariableConstIterator it=relaxation_->varsBegin();
+       it!=relaxation_->varsEnd(); ++it) {
+    v = *it;
+    if (v->getType()!=Binary && v->getType()!=Integer) {
+      continue;
+    }
+    i = v->getIndex();
+    lb = v->getLb();
+    ub = v->getUb();
+    if (ub-lb < eTol_) {
+      continue;
+    }
+    nlb = lb;
+    nub = ub;
+    if (d[i] > eTol_ && x[i] < lb+eTol_) {
+      nub = std::min(nub, floor(lb + (cutoff-obj)/d[i] + eTol_));
+    } else if (d[i] < -eTol_ && x[i] > ub-eTol_) {
+      nlb = std::max(nlb, ceil(ub + (cutoff-obj)/d[i] - eTol_));
+    }
+    if (!is_root && i<rootRc_.size()) {
+      if (rootRc_[i] > 0.0) {
+        nub = std::min(nub, floor(rootX_[i] + (cutoff-rootObj_)/rootRc_[i]
+                                  + eTol_));
+      } else if (rootRc_[i] < 0.0) {
+        nlb = std::max(nlb, ceil(rootX_[i] + (cutoff-rootObj_)/rootRc_[i]
+                                 - eTol_));
+      }
+    }
+    if (nub < lb-eTol_ || nlb > ub+eTol_ || nlb > nub+eTol_) {
+      // root reduced costs show that no better solution is in this node.
+      node->setStatus(NodeHitUb);
+      ++stats_.ub;
+      *should_prune = true;
+      return;
+    }
+    if (nub < ub-eTol_) {
+      mod = (VarBoundModPtr) new VarBoundMod(v, Upper, nub);
+      mods.push_back(mod);
+    }
+    if (nlb > lb+eTol_) {
+      mod = (VarBoundModPtr) new VarBoundMod(v, Lower, nlb);
+      mods.push_back(mod);
+    }
+    // bounds from the node LP never cut off x, but those from the root may.
+    if (x[i] > nub+eTol_ || x[i] < nlb-eTol_) {
+      *should_resolve = true;
+    }
+  }
+
+  for (ModificationConstIterator it=mods.begin(); it!=mods.end(); ++it) {
+    node->addRMod(*it);
+    (*it)->applyToProblem(relaxation_);
+  }
+  stats_.rcfix += mods.size();
+  rcFixStat_->add(mods.size());
+#if SPEW
+  logger_->msgStream(LogDebug2) << me_ << "reduced-cost fixing tightened "
+                                << mods.size() << " bounds in node "
+                                << node->getId() << std::endl;
+#endif
 }
 
 
@@ -511,6 +642,7 @@ void PCBProcessor::writeStats(std::ostream &out) const
       << me_ << "nodes optimal       = " << stats_.opt << std::endl 
       << me_ << "nodes hit ub        = " << stats_.ub << std::endl 
       << me_ << "nodes with problems = " << stats_.prob << std::endl 
+      << me_ << "bounds fixed by rc  = " << stats_.rcfix << std::endl 
       ;
 }
 
@@ -20,6 +20,10 @@ namespace Minotaur {
 
   class CutManager;
   class Problem;
+  class Profiler;
+  class StatCounter;
+  class StatHistogram;
+  class StatTimer;
   typedef boost::shared_ptr<const Problem> ConstProblemPtr;
 
   struct NodeStats {
@@ -28,6 +32,7 @@ namespace Minotaur {
     UInt opt;    /// Number of times relaxation gave optimal feasible solution
     UInt prob;   /// Number of times problem ocurred in solving
     UInt proc;   /// Number of nodes processed
+    UInt rcfix;  /// Number of bounds tightened by reduced-cost fixing
     UInt ub;     /// Number of nodes pruned because of bound
   };
 
@@ -119,6 +124,9 @@ namespace Minotaur {
       /// How many new solutions were found by the processor.
       UInt numSolutions_;
 
+      /// Tolerance for rounding bounds of integer variables.
+      double eTol_;
+
       /// Absolute tolerance for pruning a node on basis of bounds.
       double oATol_;
 
@@ -128,9 +136,38 @@ namespace Minotaur {
       /// Pointer to original problem
       ConstProblemPtr problem_;
 
+      /// Profiler of the environment, NULL if not available.
+      Profiler *prof_;
+
+      /// If true, bounds of integer variables are tightened using reduced
+      /// costs of the LP relaxation and the incumbent value.
+      bool rcFix_;
+
+      /// Counter of bounds tightened by reduced-cost fixing.
+      StatCounter *rcFixStat_;
+
       /// Relaxation that is processed by this processor.
       RelaxationPtr relaxation_;
 
+      /// Objective value of the last LP solved at the root node.
+      double rootObj_;
+
+      /**
+       * Reduced costs of variables in the last LP solved at the root node.
+       * Zero for a variable that was not at a bound. Empty if the root has
+       * not been processed.
+       */
+      DoubleVector rootRc_;
+
+      /// Values of variables in the last LP solved at the root node.
+      DoubleVector rootX_;
+
+      /// Histogram of times of solving relaxations, NULL if not available.
+      StatHistogram *solveHist_;
+
+      /// Timer of solving relaxations, NULL if not available.
+      StatTimer *solveTimer_;
+
       /// Statistics
       NodeStats stats_;
 
@@ -171,8 +208,29 @@ namespace Minotaur {
       void separate_(ConstSolutionPtr sol, NodePtr node, SolutionPoolPtr s_pool, 
                      SeparationStatus *status);
 
-      // Implement NodeProcessor::tightenBounds_()
-      virtual void tightenBounds_(); 
+      /**
+       * \brief Tighten bounds of integer variables by reduced-cost fixing.
+       *
+       * If x_j is at its lower bound l_j in the LP solution with value z and
+       * its reduced cost d_j is positive, then no solution better than the
+       * cutoff c can have x_j > l_j + (c-z)/d_j. Similarly for variables at
+       * upper bound. The same argument with the reduced costs saved at the
+       * root node gives bounds valid in the whole tree, which become tighter
+       * as better solutions are found. The new bounds are added to the node
+       * as modifications of the relaxation. The LP solution remains optimal,
+       * unless a bound from the root cuts it off. Only used when the
+       * relaxation is linear.
+       * \param[in] node The node being processed.
+       * \param[in] sol Solution of the relaxation of the node.
+       * \param[in] s_pool Solution pool, used to get the incumbent value.
+       * \param[out] should_prune True if the bounds from the root show that
+       * the node can be pruned.
+       * \param[out] should_resolve True if the relaxation must be resolved
+       * because the new bounds cut off the solution.
+       */
+      virtual void tightenBounds_(NodePtr node, ConstSolutionPtr sol,
+                                  SolutionPoolPtr s_pool, bool *should_prune,
+                                  bool *should_resolve); 
 
   };
 
@@ -23,8 +23,10 @@
 #include "Node.h"
 #include "Option.h"
 #include "Modification.h"
+#include "Profiler.h"
 #include "Relaxation.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 
 using namespace Minotaur;
 
@@ -38,7 +40,10 @@ ParBndProcessor::ParBndProcessor()
     engine_(EnginePtr()),
     engineStatus_(EngineUnknownStatus),
     numSolutions_(0),
+    prof_(0),
     relaxation_(RelaxationPtr()),
+    solveHist_(0),
+    solveTimer_(0),
     ws_(WarmStartPtr())
 {
   handlers_.clear();
@@ -57,7 +62,10 @@ ParBndProcessor::ParBndProcessor (EnvPtr env, EnginePtr engine,
     engine_(engine),
     engineStatus_(EngineUnknownStatus),
     numSolutions_(0),
+    prof_(env->getProfiler()),
     relaxation_(RelaxationPtr()),
+    solveHist_(env->getStats()->histogram("engine.solve_time")),
+    solveTimer_(env->getStats()->timer("engine.solve")),
     ws_(WarmStartPtr())
 {
   cutOff_ = env->getOptions()->findDouble("obj_cut_off")->getValue();
@@ -220,8 +228,11 @@ void ParBndProcessor::process(NodePtr node, RelaxationPtr rel,
 
     //save warm start information before branching. This step is expensive.
     ws_ = engine_->getWarmStartCopy();
-    branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
-                                        br_status, mods);
+    {
+      ProfZone pz(prof_, "find branches");
+      branches_ = brancher_->findBranches(relaxation_, node, sol, s_pool, 
+                                          br_status, mods);
+    }
     if (br_status==PrunedByBrancher) {
 
       should_prune = true;
@@ -361,7 +372,11 @@ bool ParBndProcessor::shouldPrune_(NodePtr node, double solval,
 void ParBndProcessor::solveRelaxation_() 
 {
   engineStatus_ = EngineError;
-  engine_->solve();
+  {
+    ProfZone pz(prof_, "engine solve");
+    StatTimerScope st(solveTimer_, solveHist_);
+    engine_->solve();
+  }
   engineStatus_ = engine_->getStatus();
 #if SPEW
   logger_->msgStream(LogDebug2) << me_ << "solving relaxation" << std::endl
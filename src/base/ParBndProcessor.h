@@ -19,6 +19,9 @@ namespace Minotaur {
 
   class Engine;
   class Problem;
+  class Profiler;
+  class StatHistogram;
+  class StatTimer;
   class Solution;
   typedef boost::shared_ptr<Engine> EnginePtr;
   typedef boost::shared_ptr<const Problem> ConstProblemPtr;
@@ -110,9 +113,18 @@ namespace Minotaur {
     /// How many new solutions were found by the processor.
     UInt numSolutions_;
 
+    /// Profiler of the environment, NULL if not available.
+    Profiler *prof_;
+
     /// Relaxation that is processed by this processor.
     RelaxationPtr relaxation_;
 
+    /// Histogram of times of solving relaxations, NULL if not available.
+    StatHistogram *solveHist_;
+
+    /// Timer of solving relaxations, NULL if not available.
+    StatTimer *solveTimer_;
+
     /// Statistics
     ParBPStats stats_;
 
@@ -34,6 +34,8 @@
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
+#include "ThreadLogger.h"
 #include "Timer.h"
 #include "Branch.h"
 #include "BrCand.h"
@@ -76,7 +78,11 @@ ParBranchAndBound::ParBranchAndBound(EnvPtr env, ProblemPtr p)
 
   tm_ = (ParTreeManagerPtr) new ParTreeManager(env);
   options_ = (ParBabOptionsPtr) new ParBabOptions(env);
-  logger_ = (LoggerPtr) new Logger(options_->logLevel);
+  if (env->getOptions()->findBool("log_thread_buffers")->getValue()) {
+    logger_ = (LoggerPtr) new ThreadLogger(options_->logLevel);
+  } else {
+    logger_ = (LoggerPtr) new Logger(options_->logLevel);
+  }
 }
 
 
@@ -349,6 +355,21 @@ readSerialOutput(const char* myFile)
 }
 
 
+void ParBranchAndBound::publishStats_(double lb)
+{
+  StatsRegistry *reg = env_ ? env_->getStats() : 0;
+  if (reg) {
+    reg->counter("bnb.nodes_processed")->set(stats_->nodesProc);
+    reg->counter("bnb.nodes_created")->set(tm_->getSize());
+    reg->counter("bnb.nodes_active")->set(tm_->getActiveNodes());
+    reg->setValue("bnb.lb", lb);
+    reg->setValue("bnb.ub", tm_->getUb());
+    reg->setValue("bnb.gap_percent", tm_->getPerGapPar(lb));
+    reg->setValue("bnb.time", timer_->query());
+  }
+}
+
+
 void ParBranchAndBound::setLogLevel(LogLevel level) 
 {
   logger_->setMaxLevel(level);
@@ -460,7 +481,7 @@ void ParBranchAndBound::showStatus_(bool current_uncounted)
   }
   if (timer_->query()-stats_->updateTime > options_->logInterval) {
     double lb = tm_->updateLb();
-    logger_->msgStream(LogInfo) 
+    MINOTAUR_LOG(logger_, LogInfo)
       << me_ 
       << std::fixed
       << std::setprecision(1)  << "time = "            << timer_->query()
@@ -480,7 +501,7 @@ void ParBranchAndBound::showParStatus_(UInt off, double treeLb,
 {
   if (timer_->query()-stats_->updateTime > options_->logInterval) {
     //double lb = tm_->updateLb();
-    logger_->msgStream(LogInfo) 
+    MINOTAUR_LOG(logger_, LogInfo)
       << me_ 
       << std::fixed
       //<< std::setprecision(1)  << "time = "            << timer_->query()
@@ -493,6 +514,10 @@ void ParBranchAndBound::showParStatus_(UInt off, double treeLb,
       << std::endl;
     stats_->updateTime = timer_->query();
   }
+  if (env_ && env_->getStats()->isDue()) {
+    publishStats_(treeLb);
+    env_->getStats()->dump();
+  }
 }
 
 
@@ -545,6 +570,8 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   UInt *nodeCountTh = new UInt[numThreads];
   bool iterMode = env_->getOptions()->findBool("mcbnb_iter_mode")->getValue();
   UInt iterCount = 1;
+  ThreadLoggerPtr tlogger = boost::dynamic_pointer_cast <ThreadLogger>
+    (logger_);
 #if 0
   UInt timeCount = 0;
 #endif
@@ -591,8 +618,10 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   stats_ = new ParBabStats();
 
   // initialize solution pool
-  // TODO: use user options to set the pool size. For now it is 1.
-  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_, 1);
+  solPool_ = (SolutionPoolPtr) new SolutionPool(env_, problem_,
+                                                env_->getOptions()->
+                                                findInt("bnb_sol_pool_size")
+                                                ->getValue());
 
   // call heuristics before the root, if needed 
   for (HeurVector::iterator it=preHeurs_.begin(); it!=preHeurs_.end(); ++it) {
@@ -667,6 +696,9 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
             }
           }
           if(current_node[i]) { 
+            if (tlogger) {
+              tlogger->setNode(current_node[i]->getId());
+            }
 #if SPEW
             logger_->msgStream(LogDebug1) << me_ << "processing node "
               << current_node[i]->getId() << std::endl
@@ -939,6 +971,9 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   std::vector<std::vector<double> > finalParOutput = mapSerialOutput(serialOutput, parallelOutput);
   print2dvec(finalParOutput);
 #endif
+  if (tlogger) {
+    tlogger->flush();
+  }
   logger_->msgStream(LogInfo) << me_ << "stopping branch-and-bound"
     << std::endl
     << me_ << "nodes processed = " << stats_->nodesProc << std::endl
@@ -949,6 +984,7 @@ void ParBranchAndBound::parsolve(ParNodeIncRelaxerPtr parNodeRlxr[],
   }
 
   stats_->timeUsed = timer_->query();
+  publishStats_(tm_->getLb());
   timer_->stop();
 
   delete[] should_dive;
@@ -43,6 +43,7 @@ Problem::Problem()
   nextCId_(0),
   nextSId_(0),
   nextVId_(0),
+  numConsDels_(0),
   numDCons_(0),
   numDVars_(0),
   obj_(ObjectivePtr()), 
@@ -643,6 +644,7 @@ void Problem::delMarkedCons()
     cons_ = copycons;
     consModed_ = true;
     numDCons_ = 0;
+    ++numConsDels_;
   }
 }
 
@@ -195,6 +195,16 @@ namespace Minotaur {
     /// Return the number of constraints.
     virtual UInt getNumCons() const { return cons_.size(); }
 
+    /**
+     * \brief Return the number of calls to delMarkedCons() that removed
+     * constraints.
+     *
+     * Constraints after a deleted one move to lower positions. A class that
+     * remembers positions of constraints can save this count and check it
+     * before using them again.
+     */
+    virtual UInt getNumConsDels() const { return numConsDels_; }
+
     /// Return the number of constraints marked for deletion.
     virtual UInt getNumDCons() const { return numDCons_; }
 
@@ -618,6 +628,9 @@ namespace Minotaur {
     /// ID of the next variable.
     UInt nextVId_;
 
+    /// Number of calls to delMarkedCons() that removed constraints.
+    UInt numConsDels_;
+
     /// Number of constraints marked for deletion
     UInt numDCons_;
 
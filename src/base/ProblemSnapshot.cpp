@@ -0,0 +1,737 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file ProblemSnapshot.cpp
+ * \brief Define the ProblemSnapshot class for saving a Problem to a binary
+ * file and loading it back.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stack>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Problem.h"
+#include "ProblemSnapshot.h"
+#include "QuadraticFunction.h"
+#include "SOS.h"
+#include "Timer.h"
+#include "Variable.h"
+
+using namespace Minotaur;
+
+const std::string ProblemSnapshot::me_ = "ProblemSnapshot: ";
+
+//
+// Layout of a snapshot file. All numbers are saved in the byte order of the
+// machine that wrote the file.
+//
+// header:  magic (8 bytes), version, byte-order mark, #vars, #cons, #objs,
+//          #sos (uint32 each), offsets of the 7 sections below and the size
+//          of the file (uint64 each).
+// vars:    lb, ub (double), type, source type, name (uint32) per variable.
+// cons:    lb, ub (double), name (uint32), function (uint64) per constraint.
+//          Records are of fixed size, so constraints can be found directly.
+// obj:     sense (uint32), constant (double), name (uint32), function
+//          (uint64).
+// sos:     type, priority, number of variables, name (uint32), followed by
+//          (variable (uint32), weight (double)) pairs.
+// ini:     initial point, #vars doubles. Empty if the problem has none.
+// funcs:   functions. Offsets of functions are from the start of this
+//          section. Each function is: #linear terms, (var, coef) pairs,
+//          #quadratic terms, (var, var, coef) triplets, #nodes in graph,
+//          nodes. Each node is: opcode, #children, var (uint32), value
+//          (double) and indices of children (uint32 each).
+// strings: names, each ending with '\0'. Names are saved as positions in
+//          this section.
+//
+
+namespace {
+const char snapMagic[8] = {'M', 'N', 'T', 'R', 'S', 'N', 'A', 'P'};
+const uint32_t snapVersion = 1;
+const uint32_t snapByteOrder = 0x01020304;
+const size_t snapHeaderSize = 8 + 6*sizeof(uint32_t) + 8*sizeof(uint64_t);
+
+template <class T> void put(std::string &buf, T v)
+{
+  buf.append((const char *) &v, sizeof(T));
+}
+
+template <class T> void putAt(std::string &buf, size_t pos, T v)
+{
+  memcpy(&buf[pos], &v, sizeof(T));
+}
+
+// Copy a value from the mapped file. Values are not aligned, so we can not
+// dereference pointers into the file.
+template <class T> T get(const char *base, size_t len, uint64_t *off,
+                         int *err)
+{
+  T v = T();
+  if (*off+sizeof(T) > len) {
+    *err = 1;
+  } else {
+    memcpy(&v, base + *off, sizeof(T));
+    *off += sizeof(T);
+  }
+  return v;
+}
+
+// Children of a node in the order in which CGraph::newNode() expects them.
+void nodeChildren(const CNode *node, std::vector<const CNode *> &ch)
+{
+  ch.clear();
+  if (node->getListL()) {
+    for (CNode **c=node->getListL(); *c; ++c) {
+      ch.push_back(*c);
+    }
+  } else {
+    if (node->getL()) {
+      ch.push_back(node->getL());
+    }
+    if (node->getR()) {
+      ch.push_back(node->getR());
+    }
+  }
+}
+}
+
+
+ProblemSnapshot::ProblemSnapshot(EnvPtr env)
+  : base_(0),
+    env_(env),
+    len_(0),
+    nCons_(0),
+    nObjs_(0),
+    nSOS_(0),
+    nVars_(0)
+{
+  logger_ = env->getLogger();
+  memset(offs_, 0, sizeof(offs_));
+}
+
+
+ProblemSnapshot::~ProblemSnapshot()
+{
+  close();
+}
+
+
+void ProblemSnapshot::close()
+{
+  if (base_) {
+    munmap((void *) base_, len_);
+    base_ = 0;
+    len_ = 0;
+  }
+  p_.reset();
+  nCons_ = nObjs_ = nSOS_ = nVars_ = 0;
+}
+
+
+UInt ProblemSnapshot::getNumCons() const
+{
+  return nCons_;
+}
+
+
+UInt ProblemSnapshot::getNumVars() const
+{
+  return nVars_;
+}
+
+
+ProblemPtr ProblemSnapshot::getProblem(int *err)
+{
+  ProblemPtr p;
+  FunctionPtr f;
+  VarVector vars;
+  DoubleVector wts;
+  double lb, ub, cb;
+  uint32_t vtype, stype, name, sense, stp, pri, n;
+  uint64_t off, foff;
+
+  *err = 0;
+  if (p_) {
+    return p_;
+  } else if (!base_) {
+    logger_->errStream() << me_ << "no snapshot is open." << std::endl;
+    *err = 1;
+    return p_;
+  }
+
+  p = (ProblemPtr) new Problem();
+  off = offs_[0];
+  for (UInt i=0; i<nVars_ && 0==*err; ++i) {
+    lb = get<double>(base_, len_, &off, err);
+    ub = get<double>(base_, len_, &off, err);
+    vtype = get<uint32_t>(base_, len_, &off, err);
+    stype = get<uint32_t>(base_, len_, &off, err);
+    name = get<uint32_t>(base_, len_, &off, err);
+    if (0==*err) {
+      p->newVariable(lb, ub, (VariableType) vtype, readString_(name, err),
+                     (VarSrcType) stype);
+    }
+  }
+
+  off = offs_[1];
+  for (UInt i=0; i<nCons_ && 0==*err; ++i) {
+    lb = get<double>(base_, len_, &off, err);
+    ub = get<double>(base_, len_, &off, err);
+    name = get<uint32_t>(base_, len_, &off, err);
+    foff = get<uint64_t>(base_, len_, &off, err);
+    if (0==*err) {
+      f = readFunction_(offs_[5]+foff, p, err);
+    }
+    if (0==*err) {
+      p->newConstraint(f, lb, ub, readString_(name, err));
+    }
+  }
+
+  off = offs_[2];
+  if (nObjs_>0 && 0==*err) {
+    sense = get<uint32_t>(base_, len_, &off, err);
+    cb = get<double>(base_, len_, &off, err);
+    name = get<uint32_t>(base_, len_, &off, err);
+    foff = get<uint64_t>(base_, len_, &off, err);
+    if (0==*err) {
+      f = readFunction_(offs_[5]+foff, p, err);
+    }
+    if (0==*err) {
+      p->newObjective(f, cb, (ObjectiveType) sense, readString_(name, err));
+    }
+  }
+
+  off = offs_[3];
+  for (UInt i=0; i<nSOS_ && 0==*err; ++i) {
+    stp = get<uint32_t>(base_, len_, &off, err);
+    pri = get<uint32_t>(base_, len_, &off, err);
+    n = get<uint32_t>(base_, len_, &off, err);
+    name = get<uint32_t>(base_, len_, &off, err);
+    vars.clear();
+    wts.clear();
+    for (UInt j=0; j<n && 0==*err; ++j) {
+      vtype = get<uint32_t>(base_, len_, &off, err);
+      wts.push_back(get<double>(base_, len_, &off, err));
+      if (vtype>=nVars_) {
+        *err = 1;
+      } else {
+        vars.push_back(p->getVariable(vtype));
+      }
+    }
+    if (0==*err && n>0) {
+      p->newSOS(n, (SOSType) stp, &wts[0], vars, (int) pri,
+                readString_(name, err));
+    }
+  }
+
+  if (offs_[5]>offs_[4] && 0==*err) {
+    if (offs_[4]+nVars_*sizeof(double)>len_) {
+      *err = 1;
+    } else {
+      double *x = new double[nVars_];
+      memcpy(x, base_+offs_[4], nVars_*sizeof(double));
+      p->setInitialPoint(x);
+      delete [] x;
+    }
+  }
+
+  if (*err) {
+    logger_->errStream() << me_ << "snapshot is corrupt." << std::endl;
+    p->clear();
+    return p_;
+  }
+  p_ = p;
+  return p_;
+}
+
+
+int ProblemSnapshot::open(std::string fname)
+{
+  struct stat st;
+  int fd;
+  int err = 0;
+  uint64_t off = 8;
+  void *addr;
+
+  close();
+  fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd<0) {
+    logger_->errStream() << me_ << "can not open file " << fname
+                         << std::endl;
+    return 1;
+  }
+  if (0!=fstat(fd, &st) || (size_t) st.st_size < snapHeaderSize) {
+    logger_->errStream() << me_ << fname << " is not a snapshot."
+                         << std::endl;
+    ::close(fd);
+    return 1;
+  }
+  addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (MAP_FAILED==addr) {
+    logger_->errStream() << me_ << "can not map file " << fname
+                         << std::endl;
+    return 1;
+  }
+  base_ = (const char *) addr;
+  len_ = st.st_size;
+
+  if (0!=memcmp(base_, snapMagic, 8)) {
+    logger_->errStream() << me_ << fname << " is not a snapshot."
+                         << std::endl;
+    close();
+    return 1;
+  }
+  if (get<uint32_t>(base_, len_, &off, &err) != snapVersion) {
+    logger_->errStream() << me_ << "version of snapshot " << fname
+                         << " is not supported." << std::endl;
+    close();
+    return 1;
+  }
+  if (get<uint32_t>(base_, len_, &off, &err) != snapByteOrder) {
+    logger_->errStream() << me_ << "snapshot " << fname << " was written "
+                         << "on a machine with different byte order."
+                         << std::endl;
+    close();
+    return 1;
+  }
+  nVars_ = get<uint32_t>(base_, len_, &off, &err);
+  nCons_ = get<uint32_t>(base_, len_, &off, &err);
+  nObjs_ = get<uint32_t>(base_, len_, &off, &err);
+  nSOS_  = get<uint32_t>(base_, len_, &off, &err);
+  for (UInt i=0; i<8; ++i) {
+    offs_[i] = get<uint64_t>(base_, len_, &off, &err);
+  }
+  if (err || offs_[7]!=len_) {
+    logger_->errStream() << me_ << "snapshot " << fname << " is truncated."
+                         << std::endl;
+    close();
+    return 1;
+  }
+  logger_->msgStream(LogDebug) << me_ << "opened " << fname << ": "
+                               << nVars_ << " variables, " << nCons_
+                               << " constraints." << std::endl;
+  return 0;
+}
+
+
+ProblemPtr ProblemSnapshot::readByOption(int *err)
+{
+  std::string fname = env_->getOptions()->findString("read_snapshot")->
+    getValue();
+  ProblemPtr p = ProblemPtr(); // NULL
+  Timer *timer;
+
+  *err = 0;
+  if (fname=="") {
+    return p;
+  }
+  timer = env_->getNewTimer();
+  timer->start();
+  *err = open(fname);
+  if (0==*err) {
+    p = getProblem(err);
+    if (*err) {
+      p.reset();
+    }
+  }
+  close();
+  if (p) {
+    logger_->msgStream(LogInfo) << me_ << "time used in loading snapshot "
+                                << fname << " = " << std::fixed
+                                << std::setprecision(2) << timer->query()
+                                << std::endl;
+  }
+  delete timer;
+  return p;
+}
+
+
+FunctionPtr ProblemSnapshot::readFunction_(uint64_t off, ProblemPtr p,
+                                           int *err)
+{
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
+  CGraphPtr cg;
+  uint32_t n, i, j;
+  double a;
+
+  n = get<uint32_t>(base_, len_, &off, err);
+  if (n>0) {
+    lf = (LinearFunctionPtr) new LinearFunction();
+  }
+  for (UInt k=0; k<n && 0==*err; ++k) {
+    i = get<uint32_t>(base_, len_, &off, err);
+    a = get<double>(base_, len_, &off, err);
+    if (i>=nVars_) {
+      *err = 1;
+    } else {
+      lf->addTerm(p->getVariable(i), a);
+    }
+  }
+
+  n = get<uint32_t>(base_, len_, &off, err);
+  if (n>0) {
+    qf = (QuadraticFunctionPtr) new QuadraticFunction();
+  }
+  for (UInt k=0; k<n && 0==*err; ++k) {
+    i = get<uint32_t>(base_, len_, &off, err);
+    j = get<uint32_t>(base_, len_, &off, err);
+    a = get<double>(base_, len_, &off, err);
+    if (i>=nVars_ || j>=nVars_) {
+      *err = 1;
+    } else {
+      qf->addTerm(p->getVariable(i), p->getVariable(j), a);
+    }
+  }
+
+  n = get<uint32_t>(base_, len_, &off, err);
+  if (n>0 && 0==*err) {
+    cg = readGraph_(&off, n, p, err);
+  }
+  if (*err) {
+    return FunctionPtr();
+  }
+  return (FunctionPtr) new Function(lf, qf, cg);
+}
+
+
+CGraphPtr ProblemSnapshot::readGraph_(uint64_t *off, UInt nnodes,
+                                      ProblemPtr p, int *err)
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  std::vector<CNode *> nodes(nnodes, (CNode *) 0);
+  std::vector<CNode *> ch;
+  uint32_t op, nch, v, c;
+  double val;
+
+  for (UInt i=0; i<nnodes && 0==*err; ++i) {
+    op = get<uint32_t>(base_, len_, off, err);
+    nch = get<uint32_t>(base_, len_, off, err);
+    v = get<uint32_t>(base_, len_, off, err);
+    val = get<double>(base_, len_, off, err);
+    ch.clear();
+    for (UInt j=0; j<nch && 0==*err; ++j) {
+      c = get<uint32_t>(base_, len_, off, err);
+      if (c>=i) {
+        // children must come before parents.
+        *err = 1;
+      } else {
+        ch.push_back(nodes[c]);
+      }
+    }
+    if (*err) {
+      break;
+    }
+    if (0==nch) {
+      if (OpVar==(OpCode) op && v<nVars_) {
+        nodes[i] = cg->newNode(p->getVariable(v));
+      } else if (OpNum==(OpCode) op) {
+        nodes[i] = cg->newNode(val);
+      } else if (OpInt==(OpCode) op) {
+        nodes[i] = cg->newNode((int) val);
+      } else {
+        *err = 1;
+      }
+    } else if (nch>2 || OpSumList==(OpCode) op) {
+      nodes[i] = cg->newNode((OpCode) op, &ch[0], nch);
+    } else {
+      nodes[i] = cg->newNode((OpCode) op, ch[0], (2==nch) ? ch[1] : 0);
+    }
+  }
+  if (*err) {
+    return CGraphPtr();
+  }
+  cg->setOut(nodes[nnodes-1]);
+  cg->finalize();
+  return cg;
+}
+
+
+std::string ProblemSnapshot::readString_(UInt i, int *err)
+{
+  const char *s = base_+offs_[6]+i;
+  const char *e;
+  if (offs_[6]+i >= len_) {
+    *err = 1;
+    return "";
+  }
+  e = (const char *) memchr(s, '\0', len_-(offs_[6]+i));
+  if (!e) {
+    *err = 1;
+    return "";
+  }
+  return std::string(s, e);
+}
+
+
+int ProblemSnapshot::write(ConstProblemPtr p, std::string fname)
+{
+  std::string head, vars, cons, obj, sos, ini, funcs, strs;
+  ConstraintPtr c;
+  ObjectivePtr o = p->getObjective();
+  VariablePtr v;
+  SOSPtr s;
+  const double *w;
+  uint64_t off;
+  UInt nsos = 0;
+  int err = 0;
+  FILE *fp;
+
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    v = *it;
+    put<double>(vars, v->getLb());
+    put<double>(vars, v->getUb());
+    put<uint32_t>(vars, v->getType());
+    put<uint32_t>(vars, v->getSrcType());
+    put<uint32_t>(vars, writeString_(v->getName(), strs));
+  }
+
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd() && 0==err;
+       ++it) {
+    c = *it;
+    put<double>(cons, c->getLb());
+    put<double>(cons, c->getUb());
+    put<uint32_t>(cons, writeString_(c->getName(), strs));
+    put<uint64_t>(cons, funcs.size());
+    err = writeFunction_(c->getFunction(), funcs);
+  }
+
+  if (o && 0==err) {
+    put<uint32_t>(obj, o->getObjectiveType());
+    put<double>(obj, o->getConstant());
+    put<uint32_t>(obj, writeString_(o->getName(), strs));
+    put<uint64_t>(obj, funcs.size());
+    err = writeFunction_(o->getFunction(), funcs);
+  }
+
+  for (int t=0; t<2; ++t) {
+    SOSConstIterator beg = (0==t) ? p->sos1Begin() : p->sos2Begin();
+    SOSConstIterator end = (0==t) ? p->sos1End() : p->sos2End();
+    for (SOSConstIterator it=beg; it!=end; ++it, ++nsos) {
+      s = *it;
+      w = s->getWeights();
+      put<uint32_t>(sos, s->getType());
+      put<uint32_t>(sos, s->getPriority());
+      put<uint32_t>(sos, s->getNz());
+      put<uint32_t>(sos, writeString_(s->getName(), strs));
+      for (VariableConstIterator vit=s->varsBegin(); vit!=s->varsEnd();
+           ++vit, ++w) {
+        put<uint32_t>(sos, (*vit)->getIndex());
+        put<double>(sos, *w);
+      }
+    }
+  }
+
+  if (p->getInitialPoint()) {
+    ini.append((const char *) p->getInitialPoint(),
+               p->getNumVars()*sizeof(double));
+  }
+
+  if (err) {
+    logger_->errStream() << me_ << "problem has a nonlinear function that "
+                         << "can not be saved." << std::endl;
+    return err;
+  }
+
+  head.append(snapMagic, 8);
+  put<uint32_t>(head, snapVersion);
+  put<uint32_t>(head, snapByteOrder);
+  put<uint32_t>(head, p->getNumVars());
+  put<uint32_t>(head, p->getNumCons());
+  put<uint32_t>(head, o ? 1 : 0);
+  put<uint32_t>(head, nsos);
+  off = snapHeaderSize;
+  put<uint64_t>(head, off);
+  off += vars.size();
+  put<uint64_t>(head, off);
+  off += cons.size();
+  put<uint64_t>(head, off);
+  off += obj.size();
+  put<uint64_t>(head, off);
+  off += sos.size();
+  put<uint64_t>(head, off);
+  off += ini.size();
+  put<uint64_t>(head, off);
+  off += funcs.size();
+  put<uint64_t>(head, off);
+  off += strs.size();
+  put<uint64_t>(head, off);
+  assert(head.size()==snapHeaderSize);
+
+  fp = fopen(fname.c_str(), "wb");
+  if (!fp) {
+    logger_->errStream() << me_ << "can not open file " << fname
+                         << " for writing." << std::endl;
+    return 1;
+  }
+  head += vars;
+  head += cons;
+  head += obj;
+  head += sos;
+  head += ini;
+  if (fwrite(head.data(), 1, head.size(), fp)!=head.size() ||
+      fwrite(funcs.data(), 1, funcs.size(), fp)!=funcs.size() ||
+      fwrite(strs.data(), 1, strs.size(), fp)!=strs.size()) {
+    logger_->errStream() << me_ << "error writing " << fname << std::endl;
+    err = 1;
+  }
+  fclose(fp);
+  logger_->msgStream(LogDebug) << me_ << "wrote " << off << " bytes to "
+                               << fname << std::endl;
+  return err;
+}
+
+
+int ProblemSnapshot::writeByOption(ConstProblemPtr p)
+{
+  std::string fname = env_->getOptions()->findString("write_snapshot")->
+    getValue();
+
+  if (fname=="") {
+    return 0;
+  }
+  return write(p, fname);
+}
+
+
+int ProblemSnapshot::writeFunction_(ConstFunctionPtr f, std::string &buf)
+{
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
+  NonlinearFunctionPtr nlf;
+  CGraphPtr cg;
+
+  if (f) {
+    lf = f->getLinearFunction();
+    qf = f->getQuadraticFunction();
+    nlf = f->getNonlinearFunction();
+  }
+  if (nlf) {
+    cg = boost::dynamic_pointer_cast <CGraph> (nlf);
+    if (!cg) {
+      return 1;
+    }
+  }
+
+  put<uint32_t>(buf, lf ? lf->getNumTerms() : 0);
+  if (lf) {
+    for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
+         ++it) {
+      put<uint32_t>(buf, it->first->getIndex());
+      put<double>(buf, it->second);
+    }
+  }
+
+  put<uint32_t>(buf, qf ? qf->getNumTerms() : 0);
+  if (qf) {
+    for (VariablePairGroupConstIterator it=qf->begin(); it!=qf->end();
+         ++it) {
+      put<uint32_t>(buf, it->first.first->getIndex());
+      put<uint32_t>(buf, it->first.second->getIndex());
+      put<double>(buf, it->second);
+    }
+  }
+
+  if (cg && cg->getOut()) {
+    return writeGraph_(cg.get(), buf);
+  }
+  put<uint32_t>(buf, 0);
+  return 0;
+}
+
+
+int ProblemSnapshot::writeGraph_(const CGraph *cg, std::string &buf)
+{
+  std::map<const CNode *, uint32_t> ids;
+  std::stack<const CNode *> st;
+  std::vector<const CNode *> ch;
+  const CNode *node;
+  size_t npos = buf.size();
+  uint32_t nnodes = 0;
+  bool ready;
+
+  put<uint32_t>(buf, 0); // number of nodes, filled later.
+
+  // Depth-first search from the output node. A node is saved only after
+  // all its children are saved.
+  st.push(cg->getOut());
+  while (!st.empty()) {
+    node = st.top();
+    if (ids.find(node)!=ids.end()) {
+      st.pop();
+      continue;
+    }
+    nodeChildren(node, ch);
+    ready = true;
+    for (std::vector<const CNode *>::reverse_iterator it=ch.rbegin();
+         it!=ch.rend(); ++it) {
+      if (ids.find(*it)==ids.end()) {
+        st.push(*it);
+        ready = false;
+      }
+    }
+    if (false==ready) {
+      continue;
+    }
+    st.pop();
+    put<uint32_t>(buf, node->getOp());
+    put<uint32_t>(buf, ch.size());
+    put<uint32_t>(buf, (OpVar==node->getOp()) ? node->getV()->getIndex() : 0);
+    put<double>(buf, (OpNum==node->getOp() || OpInt==node->getOp()) ?
+                node->getVal() : 0.0);
+    for (std::vector<const CNode *>::iterator it=ch.begin(); it!=ch.end();
+         ++it) {
+      put<uint32_t>(buf, ids[*it]);
+    }
+    ids[node] = nnodes;
+    ++nnodes;
+  }
+  putAt<uint32_t>(buf, npos, nnodes);
+  return 0;
+}
+
+
+UInt ProblemSnapshot::writeString_(std::string s, std::string &buf)
+{
+  UInt pos = buf.size();
+  buf += s;
+  buf.push_back('\0');
+  return pos;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
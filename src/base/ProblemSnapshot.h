@@ -0,0 +1,173 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file ProblemSnapshot.h
+ * \brief Declare the ProblemSnapshot class for saving a Problem to a binary
+ * file and loading it back.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#ifndef MINOTAURPROBLEMSNAPSHOT_H
+#define MINOTAURPROBLEMSNAPSHOT_H
+
+#include <stdint.h>
+#include <string>
+
+#include "Types.h"
+
+namespace Minotaur {
+class CGraph;
+class CNode;
+typedef boost::shared_ptr<CGraph> CGraphPtr;
+
+/**
+ * \brief Save a problem in a binary file and load it back without parsing.
+ *
+ * A snapshot stores variables, constraints, the objective, SOS constraints
+ * and the initial point of a problem, e.g. one obtained after presolving and
+ * reformulating an instance. Linear and quadratic functions are saved as
+ * lists of terms and nonlinear functions (only CGraphs) as an array of nodes
+ * in which children always come before parents.
+ *
+ * The file does not contain any pointers: all references are indices of
+ * variables or nodes, or offsets from the start of the file. A snapshot is
+ * opened with mmap() and only its header is checked at that time. All
+ * objects of the Problem are created together when getProblem() is called
+ * for the first time. The file is versioned and a file written on a machine
+ * with a different byte order is rejected.
+ *
+ * The solver binaries save the presolved problem in the file named by the
+ * option write_snapshot, and load it from the file named by read_snapshot
+ * instead of reading and presolving an instance, see readByOption() and
+ * writeByOption().
+ */
+class ProblemSnapshot {
+public:
+  /// Constructor.
+  ProblemSnapshot(EnvPtr env);
+
+  /// Destroy. Unmaps the file if it is open.
+  ~ProblemSnapshot();
+
+  /// Unmap the file opened by open().
+  void close();
+
+  /// Number of constraints in the opened snapshot.
+  UInt getNumCons() const;
+
+  /// Number of variables in the opened snapshot.
+  UInt getNumVars() const;
+
+  /**
+   * \brief Create the problem from the opened snapshot.
+   *
+   * The problem is created only once; the same pointer is returned in
+   * subsequent calls.
+   * \param[out] err Set to nonzero if the file is corrupt or not open.
+   */
+  ProblemPtr getProblem(int *err);
+
+  /**
+   * \brief Map a snapshot file in memory and check its header.
+   *
+   * \param[in] fname Name of the file.
+   * \return 0 if successful, nonzero otherwise.
+   */
+  int open(std::string fname);
+
+  /**
+   * \brief Load the problem from the snapshot named by the option
+   * read_snapshot.
+   *
+   * The file is unmapped before returning.
+   * \param[out] err Set to nonzero if the file can not be loaded.
+   * \return The problem. NULL if the option is empty or on error.
+   */
+  ProblemPtr readByOption(int *err);
+
+  /**
+   * \brief Save a problem in a file.
+   *
+   * \param[in] p The problem. Its nonlinear functions must be CGraphs.
+   * \param[in] fname Name of the file. It is overwritten if it exists.
+   * \return 0 if successful, nonzero otherwise.
+   */
+  int write(ConstProblemPtr p, std::string fname);
+
+  /**
+   * \brief Save a problem in the file named by the option write_snapshot.
+   *
+   * \param[in] p The problem.
+   * \return 0 if successful or if the option is empty, nonzero otherwise.
+   */
+  int writeByOption(ConstProblemPtr p);
+
+private:
+  /// Start of the mapped file.
+  const char *base_;
+
+  /// Environment.
+  EnvPtr env_;
+
+  /// Size of the mapped file in bytes.
+  size_t len_;
+
+  /// Log manager.
+  LoggerPtr logger_;
+
+  /// For logging.
+  static const std::string me_;
+
+  /// Number of constraints in the snapshot.
+  UInt nCons_;
+
+  /// Number of objectives in the snapshot (0 or 1).
+  UInt nObjs_;
+
+  /// Number of SOS constraints in the snapshot.
+  UInt nSOS_;
+
+  /// Number of variables in the snapshot.
+  UInt nVars_;
+
+  /// Offsets of sections, in the order they are saved in the header.
+  uint64_t offs_[8];
+
+  /// The problem created from the snapshot, NULL if not created yet.
+  ProblemPtr p_;
+
+  /// Create the function saved at offset off. NULL on error.
+  FunctionPtr readFunction_(uint64_t off, ProblemPtr p, int *err);
+
+  /// Create the graph whose nodes start at offset off.
+  CGraphPtr readGraph_(uint64_t *off, UInt nnodes, ProblemPtr p, int *err);
+
+  /// Return the string saved at position i of the string section.
+  std::string readString_(UInt i, int *err);
+
+  /// Append a function to buf. Return nonzero if it can not be saved.
+  int writeFunction_(ConstFunctionPtr f, std::string &buf);
+
+  /// Append a graph to buf in children-first order.
+  int writeGraph_(const CGraph *cg, std::string &buf);
+
+  /// Append the string s to buf and return its position.
+  UInt writeString_(std::string s, std::string &buf);
+};
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,241 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file Profiler.cpp
+ * \brief Define the Profiler class for measuring time spent in nested
+ * zones of code.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <time.h>
+
+#include "MinotaurConfig.h"
+#include "Profiler.h"
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace Minotaur;
+
+
+Profiler::Profiler()
+  : maxEvents_(0),
+    on_(false),
+    t0_(0.0)
+{
+}
+
+
+Profiler::~Profiler()
+{
+  clear_();
+}
+
+
+void Profiler::clear_()
+{
+  for (UInt i=0; i<threads_.size(); ++i) {
+    delete threads_[i];
+  }
+  threads_.clear();
+}
+
+
+void Profiler::enable(bool on, UInt max_events)
+{
+  int nthreads = 1;
+  Zone root;
+
+  on_ = on;
+  if (false==on) {
+    return;
+  }
+  clear_();
+#if USE_OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  maxEvents_ = max_events;
+  root.name = "total";
+  root.parent = 0;
+  root.calls = 0;
+  root.total = 0.0;
+  for (int i=0; i<nthreads; ++i) {
+    threads_.push_back(new ThreadData());
+    threads_.back()->zones.push_back(root);
+    threads_.back()->stack.push_back(0);
+    threads_.back()->starts.push_back(now_());
+  }
+  t0_ = now_();
+}
+
+
+void Profiler::endZone()
+{
+  ThreadData *td = getThread_();
+  double t;
+  UInt z;
+
+  if (!td || td->stack.size()<2) {
+    return;
+  }
+  t = now_();
+  z = td->stack.back();
+  td->zones[z].total += t - td->starts.back();
+  ++(td->zones[z].calls);
+  if (td->events.size() < maxEvents_) {
+    Event e;
+    e.name = td->zones[z].name;
+    e.start = td->starts.back();
+    e.dur = t - e.start;
+    td->events.push_back(e);
+  }
+  td->stack.pop_back();
+  td->starts.pop_back();
+}
+
+
+Profiler::ThreadData* Profiler::getThread_()
+{
+  int tid = 0;
+#if USE_OPENMP
+  tid = omp_get_thread_num();
+#endif
+  if (tid < (int) threads_.size()) {
+    return threads_[tid];
+  }
+  // more threads than we expected.
+  return 0;
+}
+
+
+double Profiler::now_()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+void Profiler::startZone(const char *name)
+{
+  ThreadData *td = getThread_();
+  UInt p, z;
+  std::vector<UInt>::const_iterator it;
+
+  if (!td) {
+    return;
+  }
+  p = td->stack.back();
+  z = 0;
+  // a zone usually has only a few children. Names are compared by address
+  // first because they are literals.
+  for (it=td->zones[p].child.begin(); it!=td->zones[p].child.end(); ++it) {
+    if (td->zones[*it].name==name || 0==strcmp(td->zones[*it].name, name)) {
+      z = *it;
+      break;
+    }
+  }
+  if (0==z) {
+    Zone zone;
+    zone.name = name;
+    zone.parent = p;
+    zone.calls = 0;
+    zone.total = 0.0;
+    z = td->zones.size();
+    td->zones.push_back(zone);
+    td->zones[p].child.push_back(z);
+  }
+  td->stack.push_back(z);
+  td->starts.push_back(now_());
+}
+
+
+void Profiler::writeStats(std::ostream &out) const
+{
+  for (UInt i=0; i<threads_.size(); ++i) {
+    const ThreadData *td = threads_[i];
+    if (td->zones.size()<2) {
+      continue;
+    }
+    out << "Profile of thread " << i << ":" << std::endl
+        << std::setw(40) << std::left << "zone" << std::right
+        << std::setw(12) << "calls" << std::setw(14) << "time (s)"
+        << std::endl;
+    for (std::vector<UInt>::const_iterator it=td->zones[0].child.begin();
+         it!=td->zones[0].child.end(); ++it) {
+      writeZone_(out, td, *it, 0);
+    }
+  }
+}
+
+
+int Profiler::writeTrace(std::string fname) const
+{
+  std::ofstream out(fname.c_str());
+  char buf[64];
+  bool first = true;
+
+  if (!out.is_open()) {
+    return 1;
+  }
+  out << "{\"traceEvents\":[" << std::endl;
+  for (UInt i=0; i<threads_.size(); ++i) {
+    const ThreadData *td = threads_[i];
+    for (std::vector<Event>::const_iterator it=td->events.begin();
+         it!=td->events.end(); ++it) {
+      if (!first) {
+        out << "," << std::endl;
+      }
+      first = false;
+      // zone names are literals in the code, no escaping needed.
+      out << "{\"name\":\"" << it->name << "\",\"ph\":\"X\",";
+      snprintf(buf, sizeof(buf), "\"ts\":%.3f,\"dur\":%.3f,",
+               (it->start - t0_)*1e6, it->dur*1e6);
+      out << buf << "\"pid\":0,\"tid\":" << i << "}";
+    }
+  }
+  out << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  out.close();
+  return out.fail() ? 1 : 0;
+}
+
+
+void Profiler::writeZone_(std::ostream &out, const ThreadData *td, UInt z,
+                          UInt depth) const
+{
+  const Zone &zone = td->zones[z];
+  std::string name(2*depth, ' ');
+
+  name += zone.name;
+  out << std::setw(40) << std::left << name << std::right
+      << std::setw(12) << zone.calls
+      << std::setw(14) << std::fixed << std::setprecision(4) << zone.total
+      << std::endl;
+  out.unsetf(std::ios_base::floatfield);
+  for (std::vector<UInt>::const_iterator it=zone.child.begin();
+       it!=zone.child.end(); ++it) {
+    writeZone_(out, td, *it, depth+1);
+  }
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
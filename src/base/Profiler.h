@@ -0,0 +1,181 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file Profiler.h
+ * \brief Declare the Profiler class for measuring time spent in nested
+ * zones of code.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#ifndef MINOTAURPROFILER_H
+#define MINOTAURPROFILER_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Types.h"
+
+namespace Minotaur {
+
+/**
+ * The Profiler measures the time spent in named zones of code, e.g. "relax"
+ * or "engine solve". Zones are opened and closed by ProfZone objects and
+ * may be nested: time is accumulated in a tree in which the children of a
+ * zone are the zones opened while it was open. Each thread has its own
+ * tree and its own stack of open zones, so no locks are needed while
+ * profiling. Time is measured with a monotonic wall clock.
+ *
+ * Besides the totals, every closed zone is saved as an event (upto a
+ * limit) so that a trace can be written in the Chrome trace-event format.
+ * The trace can be viewed in chrome://tracing, Perfetto or converted to a
+ * flamegraph.
+ *
+ * A disabled profiler does nothing: a ProfZone only checks one flag.
+ */
+class Profiler {
+public:
+  /// Default constructor. The profiler is disabled.
+  Profiler();
+
+  /// Destroy.
+  ~Profiler();
+
+  /**
+   * \brief Enable or disable profiling. Call from a serial region only.
+   *
+   * \param[in] on True to enable.
+   * \param[in] max_events Maximum number of events saved by each thread
+   * for the trace. Totals are accumulated even after the limit is reached.
+   */
+  void enable(bool on, UInt max_events=1000000);
+
+  /// Close the last zone opened by the calling thread.
+  void endZone();
+
+  /// Return true if profiling is on.
+  bool isOn() const { return on_; }
+
+  /// Open a zone in the calling thread. name must be a string literal.
+  void startZone(const char *name);
+
+  /**
+   * \brief Write the events in Chrome trace-event format (JSON).
+   *
+   * \param[in] fname Name of the file.
+   * \return 0 if successful, nonzero otherwise.
+   */
+  int writeTrace(std::string fname) const;
+
+  /// Write the tree of zones with total time and number of calls.
+  void writeStats(std::ostream &out) const;
+
+private:
+  /// A node in the tree of zones.
+  struct Zone {
+    const char *name;          ///< Name of the zone.
+    UInt parent;               ///< Index of the parent zone.
+    UInt calls;                ///< Number of times the zone was closed.
+    double total;              ///< Total time in seconds.
+    std::vector<UInt> child;   ///< Indices of child zones.
+  };
+
+  /// A closed zone, saved for the trace.
+  struct Event {
+    const char *name;  ///< Name of the zone.
+    double start;      ///< Time when the zone was opened.
+    double dur;        ///< Duration.
+  };
+
+  /// Data of one thread. The root of the tree is zones[0].
+  struct ThreadData {
+    std::vector<Zone> zones;     ///< Tree of zones.
+    std::vector<UInt> stack;     ///< Open zones.
+    std::vector<double> starts;  ///< Start times of open zones.
+    std::vector<Event> events;   ///< Closed zones for the trace.
+  };
+
+  /// Maximum number of events saved by each thread.
+  UInt maxEvents_;
+
+  /// True if profiling is on.
+  bool on_;
+
+  /// Time when profiling was enabled.
+  double t0_;
+
+  /// Data of each thread.
+  std::vector<ThreadData *> threads_;
+
+  /// Free data of all threads.
+  void clear_();
+
+  /// Return data of the calling thread, NULL if there is none.
+  ThreadData* getThread_();
+
+  /// Return the current time in seconds of the monotonic clock.
+  static double now_();
+
+  /// Write a zone and its children, indented by depth.
+  void writeZone_(std::ostream &out, const ThreadData *td, UInt z,
+                  UInt depth) const;
+};
+
+
+/**
+ * A ProfZone opens a zone of the profiler when it is created and closes it
+ * when it goes out of scope:
+ * \code
+ *   {
+ *     ProfZone pz(prof_, "engine solve");
+ *     engine_->solve();
+ *   }
+ * \endcode
+ * The profiler pointer may be NULL.
+ */
+class ProfZone {
+public:
+  /// Open the zone if prof is not NULL and is on.
+  ProfZone(Profiler *prof, const char *name)
+    : prof_((prof && prof->isOn()) ? prof : 0)
+  {
+    if (prof_) {
+      prof_->startZone(name);
+    }
+  }
+
+  /// Close the zone.
+  ~ProfZone()
+  {
+    if (prof_) {
+      prof_->endZone();
+    }
+  }
+
+private:
+  /// The profiler, NULL if profiling is off.
+  Profiler *prof_;
+
+  /// Copy constructor is not allowed.
+  ProfZone(const ProfZone &);
+
+  /// Copy by assignment is not allowed.
+  ProfZone & operator = (const ProfZone &);
+};
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
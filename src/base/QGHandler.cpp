@@ -13,13 +13,18 @@
  */
 
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "MinotaurConfig.h"
 
+#include "CGraph.h"
 #include "CNode.h"
 #include "Constraint.h"
 #include "Engine.h"
@@ -36,6 +41,7 @@
 #include "Relaxation.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "VarBoundMod.h"
 #include "Variable.h"
 #include "QuadraticFunction.h"
@@ -58,12 +64,16 @@ QGHandler::QGHandler()
   nlpStatus_(EngineUnknownStatus),
   nlpWs_(WarmStartPtr()),
   numCuts_(0),
+  numThreads_(1),
+  parOA_(false),
   objVar_(VariablePtr()),
   oNl_(false),
   rel_(RelaxationPtr()),
   solAbsTol_(1e-5),
   solRelTol_(1e-5),
-  stats_(0)
+  stats_(0),
+  master_(false),
+  nlpTimer_(0)
 {
   logger_ = (LoggerPtr) new Logger(LogDebug2);
 }
@@ -78,14 +88,22 @@ QGHandler::QGHandler(EnvPtr env, ProblemPtr minlp, EnginePtr nlpe)
   nlpStatus_(EngineUnknownStatus),
   nlpWs_(WarmStartPtr()),
   numCuts_(0),
+  numThreads_(1),
+  parOA_(false),
   objVar_(VariablePtr()),
   oNl_(false),
   rel_(RelaxationPtr()),
   solAbsTol_(1e-5),
-  solRelTol_(1e-5)
+  solRelTol_(1e-5),
+  master_(false),
+  nlpTimer_(env->getStats()->timer("qg.nlp_solve"))
 {
   logger_ = (LoggerPtr) new Logger((LogLevel)env->getOptions()->
                                    findInt("handler_log_level")->getValue());
+#if USE_OPENMP
+  numThreads_ = std::max(1, env->getOptions()->findInt("threads")->
+                         getValue());
+#endif
 
   stats_   = new QGStats();
   stats_->nlpS = 0;
@@ -105,6 +123,14 @@ QGHandler::~QGHandler()
   nlpe_.reset();
 }
 
+ConstraintPtr QGHandler::addCut_(FunctionPtr f, double lb, double ub,
+                                std::string name)
+{
+  ConstraintPtr c = rel_->newConstraint(f, lb, ub, name);
+  cutPool_.push_back(c);
+  return c;
+}
+
 void QGHandler::addInitLinearX_(const double *x)
 { 
   ConstraintPtr con, newcon;
@@ -124,8 +150,8 @@ void QGHandler::addInitLinearX_(const double *x)
       linearAt_(f, act, x, &c, &lf);
       f2 = (FunctionPtr) new Function(lf);
       if (con->getUb() < INFINITY) {
-        newcon = rel_->newConstraint(f2, -INFINITY, con->getUb()-c,
-                                     "lnrztn_cut");
+        newcon = addCut_(f2, -INFINITY, con->getUb()-c,
+                         "lnrztn_cut");
         ++(stats_->cuts);
 #if SPEW
         logger_->msgStream(LogDebug) << me_ << "initial constr. cut: ";
@@ -134,7 +160,7 @@ void QGHandler::addInitLinearX_(const double *x)
       }
 
       if (con->getLb() > -INFINITY) {
-        newcon = rel_->newConstraint(f2, con->getLb()-c, INFINITY, "lnrztn_cut");
+        newcon = addCut_(f2, con->getLb()-c, INFINITY, "lnrztn_cut");
         ++(stats_->cuts);  
 
 #if SPEW
@@ -156,7 +182,7 @@ void QGHandler::addInitLinearX_(const double *x)
       linearAt_(f, act, x, &c, &lf);
       lf->addTerm(objVar_, -1.0);
       f2 = (FunctionPtr) new Function(lf);
-      newcon = rel_->newConstraint(f2, -INFINITY, -1.0*c, "objlnrztn_cut");
+      newcon = addCut_(f2, -INFINITY, -1.0*c, "objlnrztn_cut");
       ++(stats_->cuts);
 #if SPEW
       logger_->msgStream(LogDebug) << me_ << "initial obj cut: " << std::endl
@@ -257,6 +283,14 @@ void QGHandler::cutIntSol_(ConstSolutionPtr sol, SolutionPoolPtr s_pool,
   }
 }
 
+void QGHandler::cutMasterSol(ConstSolutionPtr sol, SolutionPoolPtr s_pool,
+                             bool *sol_found, SeparationStatus *status)
+{
+  *sol_found = false;
+  *status = SepaContinue;
+  cutIntSol_(sol, s_pool, sol_found, status);
+}
+
 void QGHandler::fixInts_(const double *x)
 {
   VariablePtr v;
@@ -324,6 +358,9 @@ bool QGHandler::isFeasible(ConstSolutionPtr sol, RelaxationPtr rel,
   int error=0;
 
   rel_ = rel;
+  if (true==master_) {
+    return true;
+  }
 
   for (CCIter it=nlCons_.begin(); it!=nlCons_.end(); ++it) { 
     c = *it;
@@ -381,26 +418,43 @@ bool QGHandler::isFeasible(ConstSolutionPtr sol, RelaxationPtr rel,
 void QGHandler::linearAt_(FunctionPtr f, double fval, const double *x, 
                           double *c, LinearFunctionPtr *lf)
 {
-
-  int n = rel_->getNumVars();
-  double *a = new double[n];
-  VariableConstIterator vbeg = rel_->varsBegin();
-  VariableConstIterator vend = rel_->varsEnd();
   int error=0;
 
-  std::fill(a, a+n, 0.);
-  f->evalGradient(x, a, &error);
-  if(error==0){
-    *lf = (LinearFunctionPtr) new LinearFunction(a, vbeg, vend, linCoeffTol_); 
-    *c  = fval - InnerProduct(x, a, numvars_);
-    delete [] a;
-  }	else {
+  resizeGrads_(1);
+  linearAt_(f, fval, x, grads_[0], c, lf, &error);
+  if (error!=0) {
     logger_->msgStream(LogError) << me_ <<" Gradient not defined at this point "
       <<  std::endl;
   }
 }
 
 
+void QGHandler::linearAt_(FunctionPtr f, double fval, const double *x,
+                          DoubleVector &grad, double *c,
+                          LinearFunctionPtr *lf, int *error)
+{
+  VarSetConstIterator vbeg = f->varsBegin();
+  VarSetConstIterator vend = f->varsEnd();
+  UInt j;
+
+  // the gradient is zero outside the variables of f.
+  *error = 0;
+  f->evalGradient(x, &grad[0], error);
+  if (*error==0) {
+    *lf = (LinearFunctionPtr) new LinearFunction(linCoeffTol_);
+    *c  = fval;
+    for (VarSetConstIterator it=vbeg; it!=vend; ++it) {
+      j = (*it)->getIndex();
+      (*lf)->addTerm(rel_->getVariable(j), grad[j]);
+      *c -= x[j]*grad[j];
+    }
+  }
+  for (VarSetConstIterator it=vbeg; it!=vend; ++it) {
+    grad[(*it)->getIndex()] = 0.0;
+  }
+}
+
+
 void QGHandler::linearizeObj_(RelaxationPtr rel)
 {
   ObjectivePtr o;
@@ -427,9 +481,72 @@ void QGHandler::linearizeObj_(RelaxationPtr rel)
   }
 }
 
+void QGHandler::oaCon_(UInt i, const double *x, const double *inf_x,
+                       DoubleVector &grad)
+{
+  ConstraintPtr con = nlCons_[i];
+  double act, nlpact, vio, lpvio, c;
+  LinearFunctionPtr lf;
+  int error=0;
+
+  oaSide_[i] = 0;
+  oaLf_[i].reset();
+  act = con->getActivity(x, &error);
+  if (error==0) {
+    nlpact = con->getActivity(inf_x, &error);
+  }
+  if (error!=0) {
+    oaSide_[i] = -1;
+    return;
+  }
+
+  if (con->getUb() < INFINITY) {
+    vio = std::max(nlpact-con->getUb(), 0.0);
+
+    if (vio>solAbsTol_ && vio > (fabs(con->getUb())*solRelTol_) ) {
+      linearAt_(con->getFunction(), act, x, grad, &c, &lf, &error);
+      if (error!=0) {
+        oaSide_[i] = -2;
+        return;
+      }
+      lpvio = std::max(lf->eval(inf_x)-con->getUb()+c, 0.0);
+
+      if (lpvio>1e-4 && lpvio > (fabs(con->getUb()-c)*solRelTol_) ) {
+        oaSide_[i] = 1;
+        oaLf_[i] = lf;
+        oaC_[i] = c;
+        return;
+      }
+    }
+  }
+
+  if (con->getLb() > -INFINITY) {
+    vio = std::max(con->getLb()-nlpact, 0.0);
+
+    if (vio>solAbsTol_ && vio > (fabs(con->getLb())*solRelTol_) ) {
+      linearAt_(con->getFunction(), act, x, grad, &c, &lf, &error);
+      if (error!=0) {
+        oaSide_[i] = -2;
+        return;
+      }
+      lpvio = std::max(con->getLb()-c-lf->eval(inf_x), 0.0);
+
+      if (lpvio>1e-4 && lpvio >(fabs(con->getLb()-c)*solRelTol_)) {
+        oaSide_[i] = 2;
+        oaLf_[i] = lf;
+        oaC_[i] = c;
+      }
+    }
+  }
+}
+
+
 int QGHandler::OAFromPoint_(const double *x, const double *inf_x,
                             SeparationStatus *status)
 {
+  const UInt ncons = nlCons_.size();
+  const UInt nthreads = parOA_ ?
+    std::max((UInt) 1, std::min(numThreads_, ncons)) : 1;
   double act=-INFINITY, nlpact = -INFINITY;
   ConstraintPtr con, newcon;
   double c;
@@ -442,70 +559,55 @@ int QGHandler::OAFromPoint_(const double *x, const double *inf_x,
 
   *status=SepaContinue;
 
-
-  for (CCIter it=nlCons_.begin(); it!=nlCons_.end(); ++it) {
-    con = *it; 
-    f = con->getFunction();
-    act = con->getActivity(x, &error); 
-    nlpact =  con->getActivity(inf_x, &error);
-
-    if(error==0){
-      if(con->getUb() < INFINITY) {
-        vio = std::max(nlpact-con->getUb(), 0.0);
-
-        if (vio>solAbsTol_ && vio > (fabs(con->getUb())*solRelTol_) ) {
-          linearAt_(f, act, x, &c, &lf);
-
-          lpvio = std::max(lf->eval(inf_x)-con->getUb()+c, 0.0);
-
-          if (lpvio>1e-4 && lpvio > (fabs(con->getUb()-c)*solRelTol_) ) {
-            f2 = (FunctionPtr) new Function(lf);
-            newcon = rel_->newConstraint(f2, -INFINITY, con->getUb()-c,
-                                         "lnrztn_cut");
-            ++(stats_->cuts);
-            ++num_cuts;
-            *status = SepaResolve;
-#if SPEW
-            logger_->msgStream(LogDebug) << me_ <<" OA cut: " << std::endl
-              << std::setprecision(9);
-            newcon->write(logger_->msgStream(LogDebug));
+  // Each constraint has its own function, so different threads never
+  // evaluate the same graph. Functions that are not reentrant are
+  // evaluated by one thread, see parOA_.
+  resizeGrads_(nthreads);
+  oaLf_.resize(ncons);
+  oaC_.resize(ncons);
+  oaSide_.resize(ncons);
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 8)
 #endif
-          } else{
-#if SPEW
-            logger_->msgStream(LogDebug) << me_ <<" no OA cut added " << std::endl;
+  for (int i=0; i<(int) ncons; ++i) {
+#if USE_OPENMP
+    oaCon_(i, x, inf_x, grads_[omp_get_thread_num()]);
+#else
+    oaCon_(i, x, inf_x, grads_[0]);
 #endif
-          }
-        }
-      }
-
-      if(con->getLb() > -INFINITY) {
-        vio = std::max(con->getLb()-nlpact, 0.0);
-
-        if (vio>solAbsTol_ && vio > (fabs(con->getLb())*solRelTol_) ) {
-          linearAt_(f, act, x, &c, &lf);
-          lpvio = std::max(con->getLb()-c-lf->eval(inf_x), 0.0);
-
-          if (lpvio>1e-4 && lpvio >(fabs(con->getLb()-c)*solRelTol_)) {
-            f2 = (FunctionPtr) new Function(lf);
+  }
 
-            newcon = rel_->newConstraint(f2, con->getLb()-c, INFINITY,
-                                         "lnrztn_cut");
-            ++(stats_->cuts);
-            ++num_cuts; 
-            *status = SepaResolve;
-#if SPEW
-            logger_->msgStream(LogDebug) << me_ << "OA cut: " << std::endl
-              << std::setprecision(9);
-            newcon->write(logger_->msgStream(LogDebug));
-#endif
-          }
-        }
-      }
-    }	else {
+  // cuts are added in the order of constraints, so the relaxation does not
+  // depend on the number of threads.
+  for (UInt i=0; i<ncons; ++i) {
+    con = nlCons_[i];
+    if (oaSide_[i]==-1) {
       logger_->msgStream(LogError) << me_ << "Constraint not defined at"
         << " at least one of the points: "<<  std::endl;
+    } else if (oaSide_[i]==-2) {
+      logger_->msgStream(LogError) << me_ <<" Gradient not defined at this point "
+        <<  std::endl;
+    } else if (oaSide_[i]>0) {
+      f2 = (FunctionPtr) new Function(oaLf_[i]);
+      if (oaSide_[i]==1) {
+        newcon = addCut_(f2, -INFINITY, con->getUb()-oaC_[i],
+                         "lnrztn_cut");
+      } else {
+        newcon = addCut_(f2, con->getLb()-oaC_[i], INFINITY,
+                         "lnrztn_cut");
+      }
+      oaLf_[i].reset();
+      ++(stats_->cuts);
+      ++num_cuts;
+      *status = SepaResolve;
+#if SPEW
+      logger_->msgStream(LogDebug) << me_ <<" OA cut: " << std::endl
+        << std::setprecision(9);
+      newcon->write(logger_->msgStream(LogDebug));
+#endif
     }
   }
+
   o = minlp_->getObjective();
   if (oNl_ && o) {
     f = o->getFunction();
@@ -523,7 +625,7 @@ int QGHandler::OAFromPoint_(const double *x, const double *inf_x,
         if (lpvio>1e-4 && lpvio >(fabs(relobj_+c)*solRelTol_)) {
           lf->addTerm(objVar_, -1.0);
           f2 = (FunctionPtr) new Function(lf);
-          newcon = rel_->newConstraint(f2, -INFINITY, -1.0*c, "objlnrztn_cut"); 
+          newcon = addCut_(f2, -INFINITY, -1.0*c, "objlnrztn_cut"); 
           ++(stats_->cuts);
           ++num_cuts;
           *status = SepaResolve;
@@ -575,8 +677,8 @@ int QGHandler::OAFromPointInf_(const double *x, const double *inf_x,
         lpact = f2->eval(inf_x, &error);
         if (lpact - con->getUb() + c > solAbsTol_ && 
             lpact - con->getUb() + c >(fabs(con->getUb()-c)*solRelTol_)) {
-          newcon = rel_->newConstraint(f2, -INFINITY, con->getUb()-c,
-                                       "lnrztn_cut");
+          newcon = addCut_(f2, -INFINITY, con->getUb()-c,
+                           "lnrztn_cut");
           ++(stats_->cuts);
           ++ncuts;
           *status = SepaResolve;
@@ -594,8 +696,8 @@ int QGHandler::OAFromPointInf_(const double *x, const double *inf_x,
         lpact = f2->eval(inf_x, &error);
         if (lpact - con->getLb() + c < -solAbsTol_  || 
             lpact - con->getLb() + c <-(fabs(con->getLb()-c)*solRelTol_)) {
-          newcon = rel_->newConstraint(f2, con->getLb()-c, INFINITY,
-                                       "lnrztn_cut");
+          newcon = addCut_(f2, con->getLb()-c, INFINITY,
+                           "lnrztn_cut");
           ++(stats_->cuts);
           ++ncuts; 
           *status = SepaResolve;
@@ -637,12 +739,45 @@ void QGHandler::relaxNodeInc(NodePtr , RelaxationPtr , bool *)
   //Does nothing
 }
 
+void QGHandler::relaxPool_(RelaxationPtr rel)
+{
+  ConstraintPtr c;
+  LinearFunctionPtr lf;
+  FunctionPtr f;
+
+  for (UInt i=0; i<cutPool_.size(); ++i) {
+    c = cutPool_[i];
+    // variables of the relaxation, including objVar_, have the same
+    // indices in every relaxation of minlp_.
+    lf = c->getLinearFunction()->cloneWithVars(rel->varsBegin());
+    f = (FunctionPtr) new Function(lf);
+    cutPool_[i] = rel->newConstraint(f, c->getLb(), c->getUb(),
+                                     c->getName());
+  }
+}
+
+void QGHandler::resizeGrads_(UInt nthreads)
+{
+  UInt n = minlp_->getNumVars();
+
+  if (grads_.size() < nthreads) {
+    grads_.resize(nthreads);
+  }
+  for (UInt t=0; t<nthreads; ++t) {
+    if (grads_[t].size() != n) {
+      grads_[t].assign(n, 0.0);
+    }
+  }
+}
+
+
 void QGHandler::relax_(RelaxationPtr rel, bool *is_inf)
 {
   ConstraintPtr c;
   rel_ = rel;
   linearizeObj_(rel);
   numvars_ = minlp_->getNumVars();
+  nlCons_.clear();
   for (ConstraintConstIterator it=minlp_->consBegin(); it!=minlp_->consEnd(); 
        ++it) {
 
@@ -653,13 +788,29 @@ void QGHandler::relax_(RelaxationPtr rel, bool *is_inf)
     }
   }
 
+  // nonlinear functions from AMPL share one ASL structure and cannot be
+  // evaluated concurrently. Only native graphs can.
+  parOA_ = true;
+  for (CCIter it=nlCons_.begin(); it!=nlCons_.end(); ++it) {
+    NonlinearFunctionPtr nlf = (*it)->getFunction()->getNonlinearFunction();
+    if (nlf && !boost::dynamic_pointer_cast<CGraph>(nlf)) {
+      parOA_ = false;
+      break;
+    }
+  }
+
 #if SPEW
   logger_->msgStream(LogDebug) << me_ << "Number of nonlinear constraints "
     " = " << nlCons_.size() << std::endl;
   logger_->msgStream(LogDebug) << me_ << "Nonlinear solver used = "
     " = " << nlpe_->getName() << std::endl;
 #endif
-  initLinear_(is_inf);
+  if (cutPool_.empty()) {
+    initLinear_(is_inf);
+  } else {
+    // the NLP relaxation was solved for an earlier tree.
+    relaxPool_(rel);
+  }
 
 #if SPEW
   logger_->msgStream(LogDebug2) << me_ << "Initial relaxation:" 
@@ -709,6 +860,7 @@ void QGHandler::separate(ConstSolutionPtr sol, NodePtr , RelaxationPtr rel,
 
 void QGHandler::solveNLP_()
 {
+  StatTimerScope st(nlpTimer_);
   nlpStatus_ = nlpe_->solve();
   ++(stats_->nlpS);
 }
@@ -749,7 +901,13 @@ void QGHandler::writeStats(std::ostream &out) const
     << me_ << "number of nlps solved       = " << stats_->nlpS << std::endl
     << me_ << "number of infeasible nlps   = " << stats_->nlpI << std::endl
     << me_ << "number of feasible nlps     = " << stats_->nlpF << std::endl
-    << me_ << "number of cuts added        = " << stats_->cuts << std::endl;
+    << me_ << "number of cuts added        = " << stats_->cuts << std::endl
+    << me_ << "number of cuts in pool      = " << cutPool_.size()
+    << std::endl;
+  if (nlpTimer_) {
+    out << me_ << "time in solving nlps       = " << nlpTimer_->seconds()
+      << std::endl;
+  }
 }
 
 std::string QGHandler::getName() const
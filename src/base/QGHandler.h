@@ -23,6 +23,7 @@
 
 namespace Minotaur {
 
+class StatTimer;
 class WarmStart;
 typedef boost::shared_ptr<WarmStart> WarmStartPtr;
 
@@ -88,6 +89,39 @@ private:
 
   UInt numCuts_;
 
+  /// Number of threads used to find linearizations in OAFromPoint_.
+  UInt numThreads_;
+
+  /**
+   * True if the functions of all constraints in nlCons_ can be evaluated
+   * concurrently, i.e., they are linear, quadratic or native CGraphs.
+   * OAFromPoint_ uses one thread otherwise. Set in relax_.
+   */
+  bool parOA_;
+
+  /**
+   * Gradient buffer of each thread. Only the entries of the variables of
+   * one function are nonzero at a time, and they are reset after use.
+   */
+  std::vector<DoubleVector> grads_;
+
+  /**
+   * Linearization of each constraint in nlCons_ found in the last call to
+   * OAFromPoint_. Null if the constraint gives no cut.
+   */
+  std::vector<LinearFunctionPtr> oaLf_;
+
+  /// Constant term of each linearization in oaLf_.
+  DoubleVector oaC_;
+
+  /**
+   * Result for each constraint in nlCons_ in the last call to
+   * OAFromPoint_: 0 if there is no cut, 1 for a cut on the upper bound, 2
+   * for a cut on the lower bound, -1 if the constraint and -2 if its
+   * gradient could not be evaluated.
+   */
+  std::vector<int> oaSide_;
+
 	int numvars_;
 
   /**
@@ -126,6 +160,23 @@ private:
   /// Statistics.
   QGStats *stats_;
 
+  /**
+   * True if the relaxation is solved as a master MILP: an integer solution
+   * of the relaxation is then accepted without solving an NLP. See
+   * setMasterMode().
+   */
+  bool master_;
+
+  /**
+   * All linearizations added to the relaxation so far. They are added
+   * again when a new relaxation is created, so that the cuts of one tree
+   * are not lost in the next one.
+   */
+  std::vector<ConstraintPtr> cutPool_;
+
+  /// Time spent in solving NLPs. Also shown in the stats registry.
+  StatTimer *nlpTimer_;
+
 
   
 public:
@@ -180,6 +231,21 @@ public:
   /// Does nothing.
   void postsolveGetX(const double *, UInt, DoubleVector *) {};
 
+  /**
+   * \brief Solve the NLP at an integer solution of the master MILP.
+   *
+   * The integer variables are fixed to their values in sol and the NLP is
+   * solved. If it gives a better solution, it is added to s_pool and
+   * sol_found is set to true. Linearizations that cut off sol are added
+   * to the relaxation and to the pool of cuts. status is SepaPrune if
+   * sol is not cut off, i.e. the MILP value matches the NLP value.
+   */
+  void cutMasterSol(ConstSolutionPtr sol, SolutionPoolPtr s_pool,
+                    bool *sol_found, SeparationStatus *status);
+
+  /// Number of linearizations saved in the pool of cuts.
+  UInt getNumPoolCuts() const {return cutPool_.size();};
+
   // Base class method. calls relax_().
   void relaxInitFull(RelaxationPtr rel, bool *is_inf);
 
@@ -197,11 +263,28 @@ public:
   void separate(ConstSolutionPtr sol, NodePtr node, RelaxationPtr rel, 
                 CutManager *cutman, SolutionPoolPtr s_pool, bool *sol_found,
                 SeparationStatus *status);
+
+  /**
+   * \brief Treat the relaxation as a master MILP.
+   *
+   * When true, isFeasible() accepts every solution of the relaxation and
+   * no NLPs are solved in the tree, so that the branch-and-bound finds an
+   * optimal solution of the MILP with the linearizations found so far.
+   * The caller then calls cutMasterSol() to add more linearizations.
+   */
+  void setMasterMode(bool master) {master_ = master;};
  
   // Show statistics.
   void writeStats(std::ostream &out) const;
 
 private:
+  /**
+   * Add the constraint lb <= f <= ub to the relaxation and save it in the
+   * pool of cuts.
+   */
+  ConstraintPtr addCut_(FunctionPtr f, double lb, double ub,
+                        std::string name);
+
 	/**
    * Find the linearization of nonlinear functions at point x* and add
    * them to the relaxation only (not to the lp engine)
@@ -235,13 +318,36 @@ private:
 	void linearAt_(FunctionPtr f, double fval, const double *x, 
                  double *c, LinearFunctionPtr *lf);
 
+  /**
+   * Same as above, but use the buffer grad, which must be zero and of
+   * size of number of variables in minlp_. It is zero again on return.
+   * Only reads f, x and the relaxation, and so can be called by
+   * different threads for different functions.
+   */
+  void linearAt_(FunctionPtr f, double fval, const double *x,
+                 DoubleVector &grad, double *c, LinearFunctionPtr *lf,
+                 int *error);
+
   /** 
    * When the objective function is nonlinear, we need to replace it with
    * a single variable.
    */
   void linearizeObj_(RelaxationPtr rel);
 
-	/// Add all linearizations at point x that violate inf_x.
+  /**
+   * Find the linearization of the i-th constraint in nlCons_ at point x if
+   * it cuts off inf_x, and save it in oaLf_, oaC_ and oaSide_. Does not
+   * change the relaxation, and so can be called by different threads for
+   * different constraints.
+   */
+  void oaCon_(UInt i, const double *x, const double *inf_x,
+              DoubleVector &grad);
+
+  /**
+   * Add all linearizations at point x that violate inf_x. Linearizations
+   * of the constraints are found in parallel, and are added to the
+   * relaxation in the order of nlCons_.
+   */
   int OAFromPoint_(const double *x, const double *inf_x,
                              SeparationStatus *status);
 
@@ -254,6 +360,15 @@ private:
    */
   void relax_(RelaxationPtr rel, bool *is_inf);
 
+  /**
+   * Add the cuts in the pool to a new relaxation rel, and save the new
+   * constraints in the pool instead.
+   */
+  void relaxPool_(RelaxationPtr rel);
+
+  /// Allocate a zero gradient buffer for each of nthreads threads.
+  void resizeGrads_(UInt nthreads);
+
   /// Solve the nlp.
   void solveNLP_();
 
@@ -669,13 +669,8 @@ bool QuadHandler::presolveNode(RelaxationPtr rel, NodePtr, SolutionPoolPtr,
     }
   }
 
-  for (LinSqrMapIter it=x2Funs_.begin(); it != x2Funs_.end(); ++it) {
-    upSqCon_(it->second->oeCon, rel->getRelaxationVar(it->first),
-             rel->getRelaxationVar(it->second->y), rel, r_mods);
-  }
-  for (LinBilSetIter it=x0x1Funs_.begin(); it != x0x1Funs_.end(); ++it) {
-    upBilCon_(*it, rel, r_mods);
-  }
+  upSqCons_(rel, r_mods);
+  upBilCons_(rel, r_mods);
 
   if (modRel_) {
     pStats_.nMods += r_mods.size();
@@ -833,7 +828,10 @@ void QuadHandler::relax_(RelaxationPtr rel, bool *)
   ConstraintPtr c;
   ConstraintVector cons(4);
 
-
+  sqTerms_.clear();
+  sqVars_.clear();
+  sqCoef_.clear();
+  sqLf_.clear();
   for (LinSqrMapIter it=x2Funs_.begin(); it != x2Funs_.end(); ++it) {
     x0 = rel->getRelaxationVar(it->second->x);
     y  = rel->getRelaxationVar(it->second->y);
@@ -841,8 +839,19 @@ void QuadHandler::relax_(RelaxationPtr rel, bool *)
 
     f = (FunctionPtr) new Function(lf);
     it->second->oeCon = rel->newConstraint(f, -INFINITY, rhs);
+    sqTerms_.push_back(it->second);
+    sqVars_.push_back(x0);
+    sqVars_.push_back(y);
+    sqCoef_.push_back(lf->getWeight(x0));
+    sqCoef_.push_back(rhs);
+    sqLf_.push_back(lf);
   }
 
+  bilTerms_.clear();
+  bilVars_.clear();
+  bilCons_.clear();
+  bilCoef_.clear();
+  bilLf_.clear();
   for (LinBilSetIter it=x0x1Funs_.begin(); it!=x0x1Funs_.end(); ++it) {
     x0 = rel->getRelaxationVar((*it)->getX0());
     x1 = rel->getRelaxationVar((*it)->getX1());
@@ -852,9 +861,20 @@ void QuadHandler::relax_(RelaxationPtr rel, bool *)
                         x1, x1->getLb(), x1->getUb(), y, i, rhs);
       f = (FunctionPtr) new Function(lf);
       cons[i] = rel->newConstraint(f, -INFINITY, rhs);
+      bilCons_.push_back(cons[i]);
+      bilCoef_.push_back(lf->getWeight(x0));
+      bilCoef_.push_back(lf->getWeight(x1));
+      bilCoef_.push_back(rhs);
+      bilLf_.push_back(lf);
     }
     (*it)->setCons(cons[0], cons[1], cons[2], cons[3]);
+    bilTerms_.push_back(*it);
+    bilVars_.push_back(x0);
+    bilVars_.push_back(x1);
+    bilVars_.push_back(y);
   }
+  bilBnds_.resize(4*bilTerms_.size());
+  bilUp_.reserve(bilCons_.size());
 
   assert(0 == rel->checkConVars());
 
@@ -1040,103 +1060,137 @@ int QuadHandler::updatePBounds_(VariablePtr v, double lb, double ub,
 }
 
 
-void QuadHandler::upBilCon_(LinBil* lx0x1, RelaxationPtr rel, ModVector
-                            &r_mods)
+void QuadHandler::readBilCoef_(UInt k)
 {
-  LinModsPtr   lmods;
+  ConstraintPtr con = bilCons_[k];
+  LinearFunctionPtr lf = con->getLinearFunction();
+  UInt t = k/4;
+
+  bilCoef_[3*k]   = lf->getWeight(bilVars_[3*t]);
+  bilCoef_[3*k+1] = lf->getWeight(bilVars_[3*t+1]);
+  bilCoef_[3*k+2] = con->getUb();
+  bilLf_[k] = lf;
+}
+
+
+void QuadHandler::upBilCons_(RelaxationPtr rel, ModVector &r_mods)
+{
+  const UInt n = bilTerms_.size();
   LinConModPtr lmod;
   LinearFunctionPtr lf;
-  VariablePtr y  = rel->getRelaxationVar(lx0x1->getY());
-  VariablePtr x0 = rel->getRelaxationVar(lx0x1->getX0());
-  VariablePtr x1 = rel->getRelaxationVar(lx0x1->getX1());
-  double l0 = x0->getLb();
-  double u0 = x0->getUb();
-  double l1 = x1->getLb();
-  double u1 = x1->getUb();
-  double a0, a1;
+  double *b, *c;
+  double l0, u0, l1, u1;
   double rhs;
   double eps = aTol_/10.0;
-  ConstraintPtr con;
-
-  // all constraints in the relaxation are of (<= rhs) type.
-  // y >= l1x0 + l0x1 - l1l0: binding at (l0, l1), (l0, u1), (u0, l1)
-  con = lx0x1->getC0();
-  lf = con->getLinearFunction();
-  a0 = lf->getWeight(x0);
-  a1 = lf->getWeight(x1);
-  if (a0*l0 + a1*l1 - l0*l1 < con->getUb() - eps ||
-      a0*l0 + a1*u1 - l0*u1 < con->getUb() - eps || 
-      a0*u0 + a1*l1 - u0*l1 < con->getUb() - eps) {
-    lf = getNewBilLf_(x0, l0, u0, x1, l1, u1, y, 0, rhs);
-    lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
-    lmod->applyToProblem(rel);
-    r_mods.push_back(lmod);
+  UInt k, t;
+
+  // gather the bounds, and read again the coefficients of constraints that
+  // were changed elsewhere.
+  for (t=0; t<n; ++t) {
+    b = &bilBnds_[4*t];
+    b[0] = bilVars_[3*t]->getLb();
+    b[1] = bilVars_[3*t]->getUb();
+    b[2] = bilVars_[3*t+1]->getLb();
+    b[3] = bilVars_[3*t+1]->getUb();
+    for (k=4*t; k<4*t+4; ++k) {
+      if (bilCons_[k]->getLinearFunction() != bilLf_[k]) {
+        readBilCoef_(k);
+      }
+    }
   }
 
-  // y >= u1x0 + u0x1 - u1u0: binding at (l0, u1), (u0, l1), (u0, u1)
-  con = lx0x1->getC1();
-  lf = con->getLinearFunction();
-  a0 = lf->getWeight(x0);
-  a1 = lf->getWeight(x1);
-  if (a0*l0 + a1*u1 - l0*u1 < con->getUb() - eps ||
-      a0*u0 + a1*l1 - u0*l1 < con->getUb() - eps || 
-      a0*u0 + a1*u1 - u0*u1 < con->getUb() - eps) {
-    lf = getNewBilLf_(x0, l0, u0, x1, l1, u1, y, 1, rhs);
-    lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
-    lmod->applyToProblem(rel);
-    r_mods.push_back(lmod);
-  }
+  // all constraints in the relaxation are of (<= rhs) type, and the
+  // coefficient of y is -1 in the first two and 1 in the other two.
+  bilUp_.clear();
+  for (t=0; t<n; ++t) {
+    b = &bilBnds_[4*t];
+    c = &bilCoef_[12*t];
+    l0 = b[0];
+    u0 = b[1];
+    l1 = b[2];
+    u1 = b[3];
+
+    // y >= l1x0 + l0x1 - l1l0: binding at (l0, l1), (l0, u1), (u0, l1)
+    if (c[0]*l0 + c[1]*l1 - l0*l1 < c[2] - eps ||
+        c[0]*l0 + c[1]*u1 - l0*u1 < c[2] - eps || 
+        c[0]*u0 + c[1]*l1 - u0*l1 < c[2] - eps) {
+      bilUp_.push_back(4*t);
+    }
 
+    // y >= u1x0 + u0x1 - u1u0: binding at (l0, u1), (u0, l1), (u0, u1)
+    if (c[3]*l0 + c[4]*u1 - l0*u1 < c[5] - eps ||
+        c[3]*u0 + c[4]*l1 - u0*l1 < c[5] - eps || 
+        c[3]*u0 + c[4]*u1 - u0*u1 < c[5] - eps) {
+      bilUp_.push_back(4*t+1);
+    }
 
-  // y <= u1x0 + l0x1 - l0u1: binding at (l0, l1), (l0, u1), (u0, u1)
-  con = lx0x1->getC2();
-  lf = con->getLinearFunction();
-  a0 = lf->getWeight(x0);
-  a1 = lf->getWeight(x1);
-  if (a0*l0 + a1*l1 + l0*l1 < con->getUb() - eps ||
-      a0*l0 + a1*u1 + l0*u1 < con->getUb() - eps || 
-      a0*u0 + a1*u1 + u0*u1 < con->getUb() - eps) {
-    lf = getNewBilLf_(x0, l0, u0, x1, l1, u1, y, 2, rhs);
-    lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
-    lmod->applyToProblem(rel);
-    r_mods.push_back(lmod);
+    // y <= u1x0 + l0x1 - l0u1: binding at (l0, l1), (l0, u1), (u0, u1)
+    if (c[6]*l0 + c[7]*l1 + l0*l1 < c[8] - eps ||
+        c[6]*l0 + c[7]*u1 + l0*u1 < c[8] - eps || 
+        c[6]*u0 + c[7]*u1 + u0*u1 < c[8] - eps) {
+      bilUp_.push_back(4*t+2);
+    }
+
+    // y <= l1x0 + u0x1 - u0l1: binding at (l0, l1), (u0, l1), (u0, u1)
+    if (c[9]*l0 + c[10]*l1 + l0*l1 < c[11] - eps ||
+        c[9]*u0 + c[10]*l1 + u0*l1 < c[11] - eps || 
+        c[9]*u0 + c[10]*u1 + u0*u1 < c[11] - eps) {
+      bilUp_.push_back(4*t+3);
+    }
   }
 
-  // y <= l1x0 + u0x1 - u0l1: binding at (l0, l1), (u0, l1), (u0, u1)
-  con = lx0x1->getC3();
-  lf = con->getLinearFunction();
-  a0 = lf->getWeight(x0);
-  a1 = lf->getWeight(x1);
-  if (a0*l0 + a1*l1 + l0*l1 < con->getUb() - eps ||
-      a0*u0 + a1*l1 + u0*l1 < con->getUb() - eps || 
-      a0*u0 + a1*u1 + u0*u1 < con->getUb() - eps) {
-    lf = getNewBilLf_(x0, l0, u0, x1, l1, u1, y, 3, rhs);
-    lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
+  for (UIntVector::const_iterator it=bilUp_.begin(); it!=bilUp_.end();
+       ++it) {
+    k = *it;
+    t = k/4;
+    b = &bilBnds_[4*t];
+    lf = getNewBilLf_(bilVars_[3*t], b[0], b[1], bilVars_[3*t+1], b[2], b[3],
+                      bilVars_[3*t+2], k%4, rhs);
+    lmod = (LinConModPtr) new LinConMod(bilCons_[k], lf, -INFINITY, rhs);
     lmod->applyToProblem(rel);
     r_mods.push_back(lmod);
+    readBilCoef_(k);
   }
 }
 
 
-void QuadHandler::upSqCon_(ConstraintPtr con, VariablePtr x, VariablePtr y, 
-                           RelaxationPtr rel, ModVector &r_mods)
+void QuadHandler::upSqCons_(RelaxationPtr rel, ModVector &r_mods)
 {
-  LinearFunctionPtr lf = con->getLinearFunction();
-  double a_x = lf->getWeight(x);
-  double lb = x->getLb();
-  double ub = x->getUb();
+  const UInt n = sqTerms_.size();
   LinConModPtr lmod;
+  LinearFunctionPtr lf;
+  ConstraintPtr con;
+  VariablePtr x;
+  double *c;
+  double lb, ub;
   double rhs;
   double eps = aTol_/10.0;
 
-  assert(fabs(lf->getWeight(y) - 1.0) <= 1e-8);
-  // y - (lb+ub)x <= -ub*lb
-  if ((lb*lb + a_x*lb < con->getUb() - eps) ||
-      (ub*ub + a_x*ub < con->getUb() - eps)) {
-    lf = getNewSqLf_(x, y, x->getLb(), x->getUb(), rhs);
-    lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
-    lmod->applyToProblem(rel);
-    r_mods.push_back(lmod);
+  for (UInt t=0; t<n; ++t) {
+    con = sqTerms_[t]->oeCon;
+    x = sqVars_[2*t];
+    c = &sqCoef_[2*t];
+    lf = con->getLinearFunction();
+    if (lf != sqLf_[t]) {
+      assert(fabs(lf->getWeight(sqVars_[2*t+1]) - 1.0) <= 1e-8);
+      c[0] = lf->getWeight(x);
+      c[1] = con->getUb();
+      sqLf_[t] = lf;
+    }
+
+    // y - (lb+ub)x <= -ub*lb
+    lb = x->getLb();
+    ub = x->getUb();
+    if ((lb*lb + c[0]*lb < c[1] - eps) ||
+        (ub*ub + c[0]*ub < c[1] - eps)) {
+      lf = getNewSqLf_(x, sqVars_[2*t+1], lb, ub, rhs);
+      lmod = (LinConModPtr) new LinConMod(con, lf, -INFINITY, rhs);
+      lmod->applyToProblem(rel);
+      r_mods.push_back(lmod);
+      c[0] = lf->getWeight(x);
+      c[1] = rhs;
+      sqLf_[t] = lf;
+    }
   }
 }
 
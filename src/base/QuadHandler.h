@@ -167,6 +167,50 @@ private:
    */
   LinSqrMap x2Funs_;
 
+  /**
+   * \brief Bilinear terms of x0x1Funs_ in the order of the flat arrays
+   * below. The arrays are filled in relax_ and are used by upBilCons_ to
+   * update all McCormick inequalities in one pass.
+   */
+  std::vector<LinBil*> bilTerms_;
+
+  /// Variables x0, x1 and y in the relaxation, three for each bilinear term.
+  VarVector bilVars_;
+
+  /// The four McCormick inequalities of each bilinear term.
+  ConstraintVector bilCons_;
+
+  /// Bounds l0, u0, l1, u1 of each bilinear term at the current node.
+  DoubleVector bilBnds_;
+
+  /**
+   * \brief Coefficients of x0 and x1 and the rhs of each inequality in
+   * bilCons_, three for each inequality.
+   */
+  DoubleVector bilCoef_;
+
+  /**
+   * \brief Linear function of each inequality in bilCons_ when bilCoef_ was
+   * saved. If the constraint has another one, e.g. after a modification is
+   * undone, the coefficients are read again.
+   */
+  std::vector<LinearFunctionPtr> bilLf_;
+
+  /// Inequalities in bilCons_ that must be updated at the current node.
+  UIntVector bilUp_;
+
+  /// Square terms of x2Funs_ in the order of the flat arrays below.
+  LinSqrVec sqTerms_;
+
+  /// Variables x and y in the relaxation, two for each square term.
+  VarVector sqVars_;
+
+  /// Coefficient of x and rhs of the overestimator, two for each term.
+  DoubleVector sqCoef_;
+
+  /// Linear function of the overestimator when sqCoef_ was saved.
+  std::vector<LinearFunctionPtr> sqLf_;
+
   /**
    * \brief Add a gradient-based linearization inequality.
    * \param[in] x       The variable x in (y = x^2)
@@ -334,17 +378,25 @@ private:
                      bool mod_rel, bool *changed, ModVector &p_mods,
                      ModVector &r_mods);
 
+  /**
+   * \brief Read the coefficients of an inequality in bilCons_ from the
+   * relaxation into bilCoef_.
+   * \param[in] k Position of the inequality in bilCons_.
+   */
+  void readBilCoef_(UInt k);
+
   /**
    * \brief Update linear relaxation of the bilinear constraints after some
    * bounds have changed. The function checks whether each of the four
    * constraints are binding at the required extreme points of the box. If
-   * not, the constraints are updated.
-   * \param[in] lx0x1 The bilinear term
-   * \param[in] rel The relaxation which contains the four linear constraints
+   * not, the constraints are updated. The check is done for all terms
+   * together on bilBnds_ and bilCoef_, and only the constraints that fail
+   * it are changed in the relaxation.
+   * \param[in] rel The relaxation which contains the linear constraints
    * \param[in] r_mods A vector into which the modifications are appended so
    * that they can be reverted at a later time.
    */
-  void upBilCon_(LinBil* lx0x1, RelaxationPtr rel, ModVector &r_mods);
+  void upBilCons_(RelaxationPtr rel, ModVector &r_mods);
 
 
   /**
@@ -352,15 +404,11 @@ private:
    * some bounds have changed. The function checks whether the upper bounding
    * constraint is binding at the required extreme points of the box. If not,
    * the constraint is updated.
-   * \param[in] con The linear constraint that can be updated
-   * \param[in] x The variable x. 
-   * \param[in] y The variable y. 
-   * \param[in] rel The relaxation which contains the linear constraint
+   * \param[in] rel The relaxation which contains the linear constraints
    * \param[in] r_mods A vector into which the modifications are appended so
    * that they can be reverted at a later time.
    */
-  void upSqCon_(ConstraintPtr con, VariablePtr x, VariablePtr y, 
-                RelaxationPtr rel, ModVector &r_mods);
+  void upSqCons_(RelaxationPtr rel, ModVector &r_mods);
 
   /**
    * \brief Tighten the bounds on variables of the original (or transformed)
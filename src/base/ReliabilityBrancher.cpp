@@ -17,6 +17,7 @@
 #include "Branch.h"
 #include "BrCand.h"
 #include "BrVarCand.h"
+#include "BrVarCandBuffer.h"
 #include "Engine.h"
 #include "Environment.h"
 #include "Handler.h"
@@ -29,13 +30,32 @@
 #include "ReliabilityBrancher.h"
 #include "Solution.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
+#include "VarBoundMod.h"
 #include "Variable.h"
 
 //#define SPEW 1
 
 using namespace Minotaur;
 
+namespace {
+  /**
+   * Order positions of a candidate buffer by increasing score, ties broken
+   * by the variable index, as CompareScore() does for candidate objects.
+   * Without scores, this orders positions by the variable index.
+   */
+  struct CompareBufScore {
+    const BrVarCandBuffer *buf;
+    bool operator()(UInt k1, UInt k2) const {
+      if (buf->getScore(k1) != buf->getScore(k2)) {
+        return buf->getScore(k1) < buf->getScore(k2);
+      }
+      return buf->getIndex(k1) < buf->getIndex(k2);
+    }
+  };
+}
+
 const std::string ReliabilityBrancher::me_ = "reliability brancher: "; 
 
 ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers) 
@@ -63,6 +83,10 @@ ReliabilityBrancher::ReliabilityBrancher(EnvPtr env, HandlerVector & handlers)
   stats_->bndChange = 0;
   stats_->iters = 0;
   stats_->strTime = 0.0;
+  bndChangeStat_ = env->getStats()->counter("relbr.bound_changes");
+  strBrStat_ = env->getStats()->timer("relbr.strong_branch");
+  bestStrBr_.lbDown = lastStrBr_.lbDown = -INFINITY;
+  bestStrBr_.lbUp = lastStrBr_.lbUp = -INFINITY;
 }
 
 
@@ -79,40 +103,58 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
 {
   double best_score = -INFINITY;
   double score, change_up, change_down, maxchange;
+  double obj_up, obj_down, min_down;
   UInt cnt, maxcnt;
   EngineStatus status_up, status_down;
   BrCandPtr cand, best_cand;
+  int best_k = -1;  // position of best candidate in cands_, if any.
+  bool best_str = false; // true if best candidate was strong-branched upon.
+  BranchDirection best_dir = UpBranch;
 
   best_cand = BrCandPtr(); // NULL
 
-  // first evaluate candidates that have reliable pseudo costs
+  // first evaluate candidates that have reliable pseudo costs. A candidate
+  // object is created only for the one that is finally selected.
+  for (UIntVector::const_iterator it=relVars_.begin(); it!=relVars_.end();
+       ++it) {
+    getPCScore_(*it, &change_down, &change_up, &score);
+    if (score > best_score) {
+      best_score = score;
+      best_k = *it;
+      best_dir = (change_up > change_down) ? DownBranch : UpBranch;
+    }
+  }
   for (BrCandVIter it=relCands_.begin(); it!=relCands_.end(); ++it) {
     getPCScore_(*it, &change_down, &change_up, &score);
     if (score > best_score) {
       best_score = score;
       best_cand = *it;
-      if (change_up > change_down) {
-        best_cand->setDir(DownBranch);
-      } else {
-        best_cand->setDir(UpBranch);
-      }
+      best_k = -1;
+      best_dir = (change_up > change_down) ? DownBranch : UpBranch;
     }
   }
+  best_str = false;
 
   maxchange = cutoff-objval;
   // now do strong branching on unreliable candidates
-  if (unrelCands_.size()>0) {
-    BrCandVIter it;
+  if (unrelVars_.size()>0) {
+    UIntVector::const_iterator it;
     engine_->enableStrBrSetup();
     engine_->setIterationLimit(maxIterations_); // TODO: make limit dynamic.
     cnt = 0;
     maxcnt = (node->getDepth()>maxDepth_) ? 0 : maxStrongCands_;
-    for (it=unrelCands_.begin(); it!=unrelCands_.end() && 
+    for (it=unrelVars_.begin(); it!=unrelVars_.end() && 
         cnt < maxcnt; ++it, ++cnt) {
-      cand = *it;
-      strongBranch_(cand, change_up, change_down, status_up, status_down);
-      change_up    = std::max(change_up - objval, 0.0);
-      change_down  = std::max(change_down - objval, 0.0);
+      cand = getCand_(*it);
+      // the warm-start of the down branch is saved only if this candidate
+      // can still beat best_score, i.e. if getScore_() with the up change
+      // at its largest value, maxchange, exceeds it.
+      min_down = (best_score - 0.2*maxchange)/0.8;
+      min_down = (min_down < 0.0) ? -INFINITY : objval + min_down;
+      strongBranch_(cand, min_down, obj_up, obj_down, status_up,
+                    status_down);
+      change_up    = std::max(obj_up - objval, 0.0);
+      change_down  = std::max(obj_down - objval, 0.0);
       useStrongBranchInfo_(cand, maxchange, change_up, change_down, 
           status_up, status_down);
       score = getScore_(change_up, change_down);
@@ -125,32 +167,40 @@ BrCandPtr ReliabilityBrancher::findBestCandidate_(const double objval,
       }
       if (score > best_score) {
         best_score = score;
-        best_cand = cand;
-        if (change_up > change_down) {
-          best_cand->setDir(DownBranch);
-        } else {
-          best_cand->setDir(UpBranch);
-        }
+        best_k = *it;
+        best_dir = (change_up > change_down) ? DownBranch : UpBranch;
+        best_str = true;
+        // the engine still has the up branch of this candidate.
+        saveChildInfo_(status_up, obj_up, true, lastStrBr_.lbUp,
+                       lastStrBr_.wsUp);
+        bestStrBr_ = lastStrBr_;
       }
     }
     engine_->resetIterationLimit(); 
     engine_->disableStrBrSetup();
     if (NotModifiedByBrancher == status_) {
       // get score of remaining unreliable candidates as well.
-      for (;it!=unrelCands_.end(); ++it) {
+      for (;it!=unrelVars_.end(); ++it) {
         getPCScore_(*it, &change_down, &change_up, &score);
         if (score > best_score) {
           best_score = score;
-          best_cand = *it;
-          if (change_up > change_down) {
-            best_cand->setDir(DownBranch);
-          } else {
-            best_cand->setDir(UpBranch);
-          }
+          best_k = *it;
+          best_dir = (change_up > change_down) ? DownBranch : UpBranch;
+          best_str = false;
         }
       }
     }
   }
+  if (!best_str) {
+    bestStrBr_.wsDown.reset();
+    bestStrBr_.wsUp.reset();
+  }
+  if (best_k>-1) {
+    best_cand = getCand_(best_k);
+  }
+  if (best_cand) {
+    best_cand->setDir(best_dir);
+  }
   return best_cand;
 }
 
@@ -197,6 +247,9 @@ Branches ReliabilityBrancher::findBranches(RelaxationPtr rel, NodePtr node,
         br_iter!=branches->end(); ++br_iter) {
       (*br_iter)->setBrCand(br_can);
     }
+    if (bestStrBr_.wsDown || bestStrBr_.wsUp) {
+      setChildInfo_(br_can, branches);
+    }
 #if SPEW
     logger_->msgStream(LogDebug) << me_ << "best candidate = "
       << br_can->getName() << std::endl;
@@ -236,82 +289,86 @@ void ReliabilityBrancher::findCandidates_()
   int index;
   bool is_inf = false;   // if true, then node can be pruned.
 
-  BrVarCandSet cands;       // candidates from which to choose one.
   BrVarCandSet cands2;      // Temporary set.
-  BrCandVector gencands;
   BrCandVector gencands2;   // Temporary vector.
   double s_wt = 1e-5;
   double i_wt = 1e-6;
   double score;
+  UInt hpos = 0;
+  CompareBufScore comp;
 
-  // first clear the list of candidates
+  // first clear the list of candidates. Variable candidates go into the
+  // buffer cands_, general candidates (that are not variables) are always
+  // reliable.
+  cands_.clear();
   relCands_.clear();
-  unrelCands_.clear();
+  relVars_.clear();
+  unrelVars_.clear();
 
-  for (HandlerIterator h = handlers_.begin(); h != handlers_.end(); ++h) {
+  for (HandlerIterator h = handlers_.begin(); h != handlers_.end();
+       ++h, ++hpos) {
     // ask each handler to give some candidates
-    (*h)->getBranchingCandidates(rel_, x_, mods_, cands2, gencands2, is_inf);
-    for (BrVarCandIter it = cands2.begin(); it != cands2.end(); ++it) {
-      (*it)->setHandler(*h);
-    }
-    for (BrCandVIter it = gencands2.begin(); it != gencands2.end(); ++it) {
-      (*it)->setHandler(*h);
+    cands_.setHandler(hpos);
+    if (false==(*h)->appendBranchingCandidates(rel_, x_, cands_, is_inf)) {
+      (*h)->getBranchingCandidates(rel_, x_, mods_, cands2, gencands2,
+                                   is_inf);
+      for (BrVarCandIter it = cands2.begin(); it != cands2.end(); ++it) {
+        (*it)->setHandler(*h);
+        cands_.add(*it);
+      }
+      for (BrCandVIter it = gencands2.begin(); it != gencands2.end(); ++it) {
+        (*it)->setHandler(*h);
+      }
+      relCands_.insert(relCands_.end(), gencands2.begin(), gencands2.end());
+      cands2.clear();
+      gencands2.clear();
     }
-    cands.insert(cands2.begin(), cands2.end());
-    gencands.insert(gencands.end(), gencands2.begin(), gencands2.end());
     if (is_inf) {
+      cands_.clear();
       relCands_.clear();
-      unrelCands_.clear();
-      cands2.clear();
-      cands.clear();
-      gencands2.clear();
-      gencands.clear();
       status_ = PrunedByBrancher;
       return;
     } else if (mods_.size()>0) {
       status_ = ModifiedByBrancher;
+      cands_.clear();
       relCands_.clear();
-      unrelCands_.clear();
-      cands2.clear();
-      cands.clear();
-      gencands2.clear();
-      gencands.clear();
       return;
     }
-    cands2.clear();
-    gencands2.clear();
   }
 
   // visit each candidate in and check if it has reliable pseudo costs.
-  for (BrVarCandIter it=cands.begin(); it!=cands.end(); ++it) {
-    index = (*it)->getPCostIndex();
+  for (UInt k=0; k<cands_.size(); ++k) {
+    index = cands_.getIndex(k);
     if ((minNodeDist_ > fabs(stats_->calls-lastStrBranched_[index])) ||
         (timesUp_[index] >= thresh_ && timesDown_[index] >= thresh_)) {
-      relCands_.push_back(*it);
+      relVars_.push_back(k);
     } else {
       score = timesUp_[index] + timesDown_[index]
         -s_wt*(pseudoUp_[index]+pseudoDown_[index])
-        -i_wt*std::max((*it)->getDDist(), (*it)->getUDist());
-      (*it)->setScore(score);
-      unrelCands_.push_back(*it);
+        -i_wt*std::max(cands_.getDDist(k), cands_.getUDist(k));
+      cands_.setScore(k, score);
+      unrelVars_.push_back(k);
     }
   }
-  // push all general candidates (that are not variables) as reliable
-  // candidates
-  for (BrCandVIter it=gencands.begin(); it!=gencands.end(); ++it) {
-    relCands_.push_back(*it);
+
+  // visit reliable candidates in the order of variable indices, scores of
+  // reliable candidates are all zero.
+  comp.buf = &cands_;
+  if (!cands_.isSorted()) {
+    std::sort(relVars_.begin(), relVars_.end(), comp);
   }
 
   // sort unreliable candidates in the increasing order of their reliability.
-  std::sort(unrelCands_.begin(), unrelCands_.end(), CompareScore);
+  std::sort(unrelVars_.begin(), unrelVars_.end(), comp);
 
 #if SPEW
   logger_->msgStream(LogDebug) << me_
                                << "number of reliable candidates = " 
-                               << relCands_.size() << std::endl 
+                               << relVars_.size()+relCands_.size()
+                               << std::endl 
                                << me_
                                << "number of unreliable candidates = " 
-                               << unrelCands_.size() << std::endl;
+                               << unrelVars_.size() << std::endl;
   if (logger_->getMaxLevel() == LogDebug2) {
     writeScores_(logger_->msgStream(LogDebug2));
   }
@@ -340,6 +397,32 @@ std::string ReliabilityBrancher::getName() const
 }
 
 
+BrCandPtr ReliabilityBrancher::getCand_(UInt k)
+{
+  BrVarCandPtr cand = cands_.getCand(k);
+  if (!cand) {
+    UInt i = cands_.getIndex(k);
+    cand = (BrVarCandPtr) new BrVarCand(rel_->getVariable(i), i,
+                                        cands_.getDDist(k),
+                                        cands_.getUDist(k));
+    cand->setHandler(handlers_[cands_.getHandler(k)]);
+    cand->setScore(cands_.getScore(k));
+    cands_.setCand(k, cand);
+  }
+  return cand;
+}
+
+
+void ReliabilityBrancher::getPCScore_(UInt k, double *ch_down, double *ch_up,
+                                      double *score) 
+{
+  UInt index = cands_.getIndex(k);
+  *ch_down   = cands_.getDDist(k)*pseudoDown_[index];
+  *ch_up     = cands_.getUDist(k)*pseudoUp_[index];
+  *score     = getScore_(*ch_up, *ch_down);
+}
+
+
 void ReliabilityBrancher::getPCScore_(BrCandPtr cand, double *ch_down, 
                                       double *ch_up, double *score) 
 {
@@ -385,12 +468,68 @@ void ReliabilityBrancher::initialize(RelaxationPtr rel)
   timesDown_ = std::vector<UInt>(n,0); 
 
   // reserve space.
-  relCands_.reserve(n);
-  unrelCands_.reserve(n);
+  relVars_.reserve(n);
+  unrelVars_.reserve(n);
   x_.reserve(n);
 }
 
 
+void ReliabilityBrancher::saveChildInfo_(EngineStatus status, double obj,
+                                         bool copy_ws, double &lb,
+                                         WarmStartPtr &ws)
+{
+  ws.reset();
+  switch (status) {
+   case (ProvenOptimal):
+   case (ProvenLocalOptimal):
+     lb = obj;
+     break;
+   case (EngineIterationLimit):
+     // not a bound, but the basis is still a good start.
+     lb = -INFINITY;
+     break;
+   default:
+     lb = -INFINITY;
+     return;
+  }
+  if (copy_ws) {
+    ws = engine_->getWarmStartCopy();
+  }
+}
+
+
+void ReliabilityBrancher::setChildInfo_(BrCandPtr cand, Branches branches)
+{
+  VariablePtr v;
+  VarBoundModPtr vmod;
+
+  if (cand->getPCostIndex()<0) {
+    return;
+  }
+  v = rel_->getVariable(cand->getPCostIndex());
+  for (BranchConstIterator br_iter=branches->begin(); 
+       br_iter!=branches->end(); ++br_iter) {
+    for (ModificationConstIterator m_iter=(*br_iter)->rModsBegin();
+         m_iter!=(*br_iter)->rModsEnd(); ++m_iter) {
+      vmod = boost::dynamic_pointer_cast <VarBoundMod> (*m_iter);
+      if (vmod && vmod->getVar()==v) {
+        // changing ub of the variable gives the down branch.
+        if (Upper==vmod->getLU()) {
+          (*br_iter)->setLb(bestStrBr_.lbDown);
+          (*br_iter)->setWarmStart(bestStrBr_.wsDown);
+        } else {
+          (*br_iter)->setLb(bestStrBr_.lbUp);
+          (*br_iter)->setWarmStart(bestStrBr_.wsUp);
+        }
+        break;
+      }
+    }
+  }
+  bestStrBr_.wsDown.reset();
+  bestStrBr_.wsUp.reset();
+}
+
+
 void ReliabilityBrancher::setTrustCutoff(bool val)
 {
   trustCutoff_ = val;
@@ -468,13 +607,14 @@ bool ReliabilityBrancher::shouldPrune_(const double &chcutoff,
 }
 
 
-void ReliabilityBrancher::strongBranch_(BrCandPtr cand, double & obj_up, 
-                                        double & obj_down, 
+void ReliabilityBrancher::strongBranch_(BrCandPtr cand, double min_down,
+                                        double & obj_up, double & obj_down,
                                         EngineStatus & status_up, 
                                         EngineStatus & status_down)
 {
   HandlerPtr h = cand->getHandler();
   ModificationPtr mod;
+  double t;
 
   // first do down.
   mod = h->getBrMod(cand, x_, rel_, DownBranch);
@@ -484,10 +624,14 @@ void ReliabilityBrancher::strongBranch_(BrCandPtr cand, double & obj_up,
 
   timer_->start();
   status_down = engine_->solve();
-  stats_->strTime += timer_->query();
+  t = timer_->query();
+  stats_->strTime += t;
+  strBrStat_->add(t);
   timer_->stop();
   ++(stats_->strBrCalls);
   obj_down = engine_->getSolutionValue();
+  saveChildInfo_(status_down, obj_down, obj_down > min_down,
+                 lastStrBr_.lbDown, lastStrBr_.wsDown);
   mod->undoToProblem(rel_);
 
   // now go up.
@@ -498,10 +642,15 @@ void ReliabilityBrancher::strongBranch_(BrCandPtr cand, double & obj_up,
 
   timer_->start();
   status_up = engine_->solve();
-  stats_->strTime += timer_->query();
+  t = timer_->query();
+  stats_->strTime += t;
+  strBrStat_->add(t);
   timer_->stop();
   ++(stats_->strBrCalls);
   obj_up = engine_->getSolutionValue();
+  // the warm-start is copied by the caller if this candidate is the best.
+  saveChildInfo_(status_up, obj_up, false, lastStrBr_.lbUp,
+                 lastStrBr_.wsUp);
   mod->undoToProblem(rel_);
 }
 
@@ -561,14 +710,17 @@ void ReliabilityBrancher::useStrongBranchInfo_(BrCandPtr cand,
   } else if (should_prune_up == true && should_prune_down == true) {
     status_ = PrunedByBrancher;
     stats_->bndChange += 2;
+    bndChangeStat_->add(2);
   } else if (should_prune_up) {
     status_ = ModifiedByBrancher;
     mods_.push_back(cand->getHandler()->getBrMod(cand, x_, rel_, DownBranch));
     ++(stats_->bndChange);
+    bndChangeStat_->add();
   } else if (should_prune_down) {
     status_ = ModifiedByBrancher;
     mods_.push_back(cand->getHandler()->getBrMod(cand, x_, rel_, UpBranch));
     ++(stats_->bndChange);
+    bndChangeStat_->add();
   } else { 
     cost = fabs(change_down)/(fabs(cand->getDDist())+eTol_);
     updatePCost_(index, cost, pseudoDown_, timesDown_);
@@ -582,40 +734,47 @@ void ReliabilityBrancher::useStrongBranchInfo_(BrCandPtr cand,
 void ReliabilityBrancher::writeScore_(BrCandPtr cand, double score, 
                                       double change_up, double change_down)
 {
-  logger_->msgStream(LogDebug2) << me_ << "candidate: " << cand->getName() 
-                                << " down change = " << change_down
-                                << " up change = " << change_up
-                                << " score = " << score
-                                << std::endl;
+  MINOTAUR_LOG(logger_, LogDebug2) << me_ << "candidate: " << cand->getName() 
+                                   << " down change = " << change_down
+                                   << " up change = " << change_up
+                                   << " score = " << score
+                                   << std::endl;
 }
 
 
 void ReliabilityBrancher::writeScores_(std::ostream &out)
 {
+  UInt index;
+
   out << me_ << "unreliable candidates:" << std::endl;
-  for (BrCandVIter it=unrelCands_.begin(); it!=unrelCands_.end(); ++it) {
-    if ((*it)->getPCostIndex()>-1) {
-      out << std::setprecision(6) << (*it)->getName() << "\t" 
-        << timesDown_[(*it)->getPCostIndex()] << "\t"
-        << timesUp_[(*it)->getPCostIndex()] << "\t" 
-        << pseudoDown_[(*it)->getPCostIndex()] << "\t"
-        << pseudoUp_[(*it)->getPCostIndex()] << "\t"
-        << x_[(*it)->getPCostIndex()] << "\t"
-        << rel_->getVariable((*it)->getPCostIndex())->getLb() << "\t"
-        << rel_->getVariable((*it)->getPCostIndex())->getUb() << "\t"
-        << std::endl;
-    } else {
-      out << std::setprecision(6) << (*it)->getName() << "\t" 
-                                  << 0 << "\t" << 0 << "\t"
-                                  << (*it)->getScore() << "\t"
-                                  << (*it)->getScore() << "\t"
-                                  << (*it)->getDDist() << "\t"
-                                  << 0.0 << "\t"
-                                  << 1.0 << "\t" << std::endl;
-    }
+  for (UIntVector::const_iterator it=unrelVars_.begin();
+       it!=unrelVars_.end(); ++it) {
+    index = cands_.getIndex(*it);
+    out << std::setprecision(6) << rel_->getVariable(index)->getName() << "\t" 
+      << timesDown_[index] << "\t"
+      << timesUp_[index] << "\t" 
+      << pseudoDown_[index] << "\t"
+      << pseudoUp_[index] << "\t"
+      << x_[index] << "\t"
+      << rel_->getVariable(index)->getLb() << "\t"
+      << rel_->getVariable(index)->getUb() << "\t"
+      << std::endl;
   }
 
   out << me_ << "reliable candidates:" << std::endl;
+  for (UIntVector::const_iterator it=relVars_.begin(); it!=relVars_.end();
+       ++it) {
+    index = cands_.getIndex(*it);
+    out << rel_->getVariable(index)->getName() << "\t" 
+      << timesDown_[index] << "\t"
+      << timesUp_[index] << "\t" 
+      << pseudoDown_[index] << "\t"
+      << pseudoUp_[index] << "\t"
+      << x_[index] << "\t"
+      << rel_->getVariable(index)->getLb() << "\t"
+      << rel_->getVariable(index)->getUb() << "\t"
+      << std::endl;
+  }
   for (BrCandVIter it=relCands_.begin(); it!=relCands_.end(); ++it) {
     if ((*it)->getPCostIndex()>-1) {
       out << (*it)->getName() << "\t" 
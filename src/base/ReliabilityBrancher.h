@@ -15,12 +15,17 @@
 #define MINOTAURRELIABILITYBRANCHER_H
 
 #include "Brancher.h"
+#include "BrVarCandBuffer.h"
 
 namespace Minotaur {
 
 class Engine;
+class StatCounter;
+class StatTimer;
 class Timer;
+class WarmStart;
 typedef boost::shared_ptr<Engine> EnginePtr;
+typedef boost::shared_ptr<WarmStart> WarmStartPtr;
 
 struct RelBrStats {
   UInt bndChange;  /// Number of times variable bounds were changed.
@@ -32,6 +37,18 @@ struct RelBrStats {
 };
 
 
+/**
+ * Results of strong branching on a candidate that are passed on to the
+ * children if the candidate is selected for branching.
+ */
+struct StrBrChildren {
+  double lbDown;       /// Lower bound in down branch, -INFINITY if unknown.
+  double lbUp;         /// Lower bound in up branch, -INFINITY if unknown.
+  WarmStartPtr wsDown; /// Warm-start of down branch, NULL if unknown.
+  WarmStartPtr wsUp;   /// Warm-start of up branch, NULL if unknown.
+};
+
+
 /// A class to select a variable for branching using reliability branching.
 class ReliabilityBrancher : public Brancher {
 
@@ -144,6 +161,20 @@ private:
    */
   void findCandidates_();
 
+  /**
+   * \brief Return the candidate object at position k of cands_, creating
+   * it if needed.
+   *
+   * \param[in] k Position of the candidate in cands_.
+   */
+  BrCandPtr getCand_(UInt k);
+
+  /**
+   * \brief Find the score of a candidate in cands_ based on its pseudo
+   * costs. Same as the other getPCScore_(), without a candidate object.
+   */
+  void getPCScore_(UInt k, double *ch_down, double *ch_up, double *score);
+
   /**
    * \brief Find the score of a candidate based on its pseudo costs.
    *
@@ -163,6 +194,28 @@ private:
    */
   double getScore_(const double & up_score, const double & down_score);
 
+  /**
+   * \brief Save the result of a strong-branching solve.
+   *
+   * \param[in] status Engine status of the solve.
+   * \param[in] obj Objective value of the solve.
+   * \param[in] copy_ws True if the warm-start should be copied from the
+   * engine, false if it is not needed.
+   * \param[out] lb The lower bound obtained, -INFINITY if none.
+   * \param[out] ws Copy of the warm-start, NULL if not copied or not useful.
+   */
+  void saveChildInfo_(EngineStatus status, double obj, bool copy_ws,
+                      double &lb, WarmStartPtr &ws);
+
+  /**
+   * \brief Pass the strong-branching results of the selected candidate to
+   * its branches.
+   *
+   * \param[in] cand The selected candidate.
+   * \param[in] branches The branches created from cand.
+   */
+  void setChildInfo_(BrCandPtr cand, Branches branches);
+
   /**
    * \brief Check if branch can be pruned on the basis of engine status and
    * objective value.
@@ -183,13 +236,17 @@ private:
   /** 
    * \brief Do strong branching on candidate.
    * \param[in] cand Candidate for strong branching.
+   * \param[in] min_down The warm-start of the down branch is saved only if
+   * its objective value is greater than this value. The warm-start of the up
+   * branch is never saved; it is left in the engine.
    * \param[out] obj_up objective value estimate in up branch.
    * \param[out] obj_down objective value estimate in down branch.
    * \param[out] status_up engine status in up branch.
    * \param[out] status_down engine status in down branch.
    */
-  void strongBranch_(BrCandPtr cand, double & obj_up, double & obj_down, 
-                     EngineStatus & status_up, EngineStatus & status_down);
+  void strongBranch_(BrCandPtr cand, double min_down, double & obj_up,
+                     double & obj_down, EngineStatus & status_up,
+                     EngineStatus & status_down);
 
   /**
    * \brief Update Pseudocost based on the new costs.
@@ -243,6 +300,16 @@ private:
    */
   void writeScores_(std::ostream &out);
 
+  /**
+   * \brief Candidates for branching on variables at the current node. It is
+   * reused at all nodes.
+   */
+  BrVarCandBuffer cands_;
+  /// Strong-branching results of the current best candidate.
+  StrBrChildren bestStrBr_;
+  /// Counter of bound changes in the statistics registry of environment.
+  StatCounter *bndChangeStat_;
+
   /// The engine used for strong branching.
   EnginePtr engine_;
 
@@ -258,6 +325,8 @@ private:
   /// True if data structures initialized. False otherwise.
   bool init_;
 
+  /// Strong-branching results of the last candidate strong-branched upon.
+  StrBrChildren lastStrBr_;
   /// When did we last strong-branch on a candidate.
   UIntVector lastStrBranched_;
 
@@ -297,8 +366,13 @@ private:
   /// The problem that is being solved at this node.
   RelaxationPtr rel_;
 
-  /// A vector of candidates that have reliable pseudocosts.
+  /**
+   * \brief A vector of general candidates, i.e. candidates that are not
+   * variables. They are treated as reliable.
+   */
   std::vector<BrCandPtr> relCands_;
+  /// Positions in cands_ of candidates that have reliable pseudocosts.
+  UIntVector relVars_;
 
   /// Statistics.
   RelBrStats * stats_;
@@ -306,6 +380,12 @@ private:
   /// Status of problem after using this brancher.
   BrancherStatus status_;
 
+  /**
+   * \brief Timer of strong-branching solves in the statistics registry of
+   * environment.
+   */
+  StatTimer *strBrStat_;
+
   /// Timer to track time spent in this class.
   Timer *timer_;
 
@@ -328,10 +408,11 @@ private:
   bool trustCutoff_;
 
   /**
-   * \brief A vector of candidates that will need strong branching. These
-   * candidates will be arranged in some order of preferance.
+   * \brief Positions in cands_ of candidates that will need strong
+   * branching. These candidates will be arranged in some order of
+   * preferance.
    */
-  std::vector<BrCandPtr> unrelCands_;
+  UIntVector unrelVars_;
 
   /// The values of variables in the solution of the current relaxation.
   DoubleVector x_;
@@ -36,6 +36,7 @@
 #include "QuadHandler.h"
 #include "SimpleTransformer.h"
 #include "Solution.h"
+#include "StatsRegistry.h"
 #include "Variable.h"
 #include "YEqCGs.h"
 #include "YEqLFs.h"
@@ -149,6 +150,15 @@ void SimpleTransformer::bilRef_(LinearFunctionPtr lfl, VariablePtr vl,
 }
 
 
+VariablePtr SimpleTransformer::findAux_(const AuxDef &aux)
+{
+  if (AuxBiCG==aux.kind) {
+    return yBiVars_->findY(aux.cg);
+  }
+  return Transformer::findAux_(aux);
+}
+
+
 std::string SimpleTransformer::getName() const
 {
   return "SimpleTransformer";
@@ -169,6 +179,23 @@ SolutionPtr SimpleTransformer::getSolTrans(ConstSolutionPtr, int &err )
 }
 
 
+void SimpleTransformer::initWorker_(Transformer *master)
+{
+  Transformer::initWorker_(master);
+  yBiVars_ = new YEqCGs();
+}
+
+
+void SimpleTransformer::insertAux_(const AuxDef &aux)
+{
+  if (AuxBiCG==aux.kind) {
+    yBiVars_->insert(aux.y, aux.cg);
+  } else {
+    Transformer::insertAux_(aux);
+  }
+}
+
+
 VariablePtr SimpleTransformer::newBilVar_(VariablePtr vl, VariablePtr vr)
 {
   CGraphPtr cg = (CGraphPtr) new CGraph();
@@ -193,6 +220,7 @@ VariablePtr SimpleTransformer::newBilVar_(VariablePtr vl, VariablePtr vr)
   } else {
     ov = yBiVars_->findY(cg);
     if (!ov) {
+      AuxDef aux;
       ov = newp_->newVariable();
       lf = (LinearFunctionPtr) new LinearFunction();
       lf->addTerm(ov, -1.0);
@@ -203,7 +231,10 @@ VariablePtr SimpleTransformer::newBilVar_(VariablePtr vl, VariablePtr vr)
                                    << std::endl;
       cnew->write(logger_->msgStream(LogDebug));
 #endif 
-      qHandler_->addConstraint(cnew);
+      aux.kind = AuxBiCG;
+      aux.cg = cg;
+      aux.y = ov;
+      addCon_(qHandler_, cnew, aux);
       yBiVars_->insert(ov, cg);
     }
   }
@@ -211,6 +242,12 @@ VariablePtr SimpleTransformer::newBilVar_(VariablePtr vl, VariablePtr vr)
 }
 
 
+Transformer* SimpleTransformer::newWorker_()
+{
+  return new SimpleTransformer(env_, p_);
+}
+
+
 void SimpleTransformer::powKRef_(LinearFunctionPtr lfl,
                                  VariablePtr vl, double dl, double k,
                                  LinearFunctionPtr &lf, VariablePtr &v,
@@ -464,77 +501,87 @@ void SimpleTransformer::recursRef_(const CNode *node, LinearFunctionPtr &lf,
 }
 
 
-void SimpleTransformer::refNonlinCons_(ConstProblemPtr oldp)
+void SimpleTransformer::refNonlinCon_(ConstConstraintPtr c)
 {
-  ConstraintPtr c, cnew;
+  ConstraintPtr cnew;
   FunctionPtr f, f2;
   CGraphPtr cg;
   LinearFunctionPtr lf, lf2;
   double d, lb, ub;
   VariablePtr v = VariablePtr();
 
-  assert (oldp && newp_);
-
-  for (ConstraintConstIterator it=oldp->consBegin(); it!=oldp->consEnd();
-       ++it) {
-    c = *it;
-    f = c->getFunction();
-    if (f && f->getType()!=Constant && f->getType()!=Linear) {
-      lf = f->getLinearFunction();
-      if (lf) {
-        lf2 = lf->cloneWithVars(newp_->varsBegin());
+  f = c->getFunction();
+  lf = f->getLinearFunction();
+  if (lf) {
+    lf2 = lf->cloneWithVars(newp_->varsBegin());
+  } else {
+    lf2 = (LinearFunctionPtr) new LinearFunction();
+  }
+  lf.reset(); v.reset(); d = 0.0;
+  cg = boost::dynamic_pointer_cast <CGraph> (f->getNonlinearFunction());
+  assert(cg);
+#if SPEW
+  logger_->msgStream(LogDebug) << me_ << "reformulating the constraint"
+                               << std::endl;
+  c->write(logger_->msgStream(LogDebug));
+#endif
+  recursRef_(cg->getOut(), lf, v, d);
+  if (lf) {
+    lf2->add(lf);
+    if (lf2->getNumTerms()>1) {
+      f2 = (FunctionPtr) new Function(lf2);
+      cnew = newp_->newConstraint(f2, c->getLb()-d, c->getUb()-d);
+      addCon_(lHandler_, cnew);
+    } else if (lf2->getNumTerms()==1) {
+      v = lf->termsBegin()->first;
+      d = lf->termsBegin()->second;
+      if (d>0) {
+        lb = c->getLb()/d;
+        ub = c->getUb()/d;
       } else {
-        lf2 = (LinearFunctionPtr) new LinearFunction();
+        lb = c->getUb()/d;
+        ub = c->getLb()/d;
+      }
+      if (lb>v->getLb()) {
+        newp_->changeBound(v, Lower, lb);
+      }
+      if (ub<v->getUb()) {
+        newp_->changeBound(v, Upper, ub);
       }
-      lf.reset(); v.reset(); d = 0.0;
-      cg = boost::dynamic_pointer_cast <CGraph> (f->getNonlinearFunction());
-      assert(cg);
 #if SPEW
-      logger_->msgStream(LogDebug) << me_ << "reformulating the constraint"
+      logger_->msgStream(LogDebug) << me_ << "new bounds on variable "
                                    << std::endl;
-      c->write(logger_->msgStream(LogDebug));
-#endif
-      recursRef_(cg->getOut(), lf, v, d);
-      if (lf) {
-        lf2->add(lf);
-        if (lf2->getNumTerms()>1) {
-          f2 = (FunctionPtr) new Function(lf2);
-          cnew = newp_->newConstraint(f2, c->getLb()-d, c->getUb()-d);
-          lHandler_->addConstraint(cnew);
-        } else if (lf2->getNumTerms()==1) {
-          v = lf->termsBegin()->first;
-          d = lf->termsBegin()->second;
-          if (d>0) {
-            lb = c->getLb()/d;
-            ub = c->getUb()/d;
-          } else {
-            lb = c->getUb()/d;
-            ub = c->getLb()/d;
-          }
-          if (lb>v->getLb()) {
-            newp_->changeBound(v, Lower, lb);
-          }
-          if (ub<v->getUb()) {
-            newp_->changeBound(v, Upper, ub);
-          }
-#if SPEW
-          logger_->msgStream(LogDebug) << me_ << "new bounds on variable "
-                                       << std::endl;
-          v->write(logger_->msgStream(LogDebug));
+      v->write(logger_->msgStream(LogDebug));
 #endif 
-        } else if ((lf2->getNumTerms()==0) &&
-                   (d > c->getUb()+zTol_ ||
-                    d < c->getLb()-zTol_)) {
-            logger_->msgStream(LogInfo) << me_ << "problem infeasible." << std::endl;
-          }
-      } else if (v) {
-          lf2->incTerm(v, 1.0);
-          f2 = (FunctionPtr) new Function(lf2);
-          cnew = newp_->newConstraint(f2, c->getLb()-d, c->getUb()-d);
-          lHandler_->addConstraint(cnew);
-      } 
+    } else if ((lf2->getNumTerms()==0) &&
+               (d > c->getUb()+zTol_ ||
+                d < c->getLb()-zTol_)) {
+        logger_->msgStream(LogInfo) << me_ << "problem infeasible." << std::endl;
+      }
+  } else if (v) {
+      lf2->incTerm(v, 1.0);
+      f2 = (FunctionPtr) new Function(lf2);
+      cnew = newp_->newConstraint(f2, c->getLb()-d, c->getUb()-d);
+      addCon_(lHandler_, cnew);
+  }
+}
+
+
+void SimpleTransformer::refNonlinCons_(ConstProblemPtr oldp)
+{
+  ConstConstraintVector cons;
+  FunctionPtr f;
+
+  assert (oldp && newp_);
+
+  for (ConstraintConstIterator it=oldp->consBegin(); it!=oldp->consEnd();
+       ++it) {
+    f = (*it)->getFunction();
+    if (f && f->getType()!=Constant && f->getType()!=Linear) {
+      cons.push_back(*it);
     } // other case already dealt with in copyLinear_() 
   }
+  refNonlinConsPar_(cons);
 }
 
 
@@ -605,6 +652,9 @@ void SimpleTransformer::refNonlinObj_(ConstProblemPtr oldp)
 void SimpleTransformer::reformulate(ProblemPtr &newp, HandlerVector &handlers,
                                     int &status)
 {
+  StatTimerScope tscope(env_ ?
+                        env_->getStats()->timer("transformer.reformulate") :
+                        0);
   assert(p_);
 
   newp_ = (ProblemPtr) new Problem();
@@ -708,6 +758,15 @@ void SimpleTransformer::uniVarRef_(const CNode *n0, LinearFunctionPtr lfl,
 }
 
 
+void SimpleTransformer::writeAux(std::ostream &out) const
+{
+  Transformer::writeAux(out);
+  if (yBiVars_) {
+    yBiVars_->write(out);
+  }
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
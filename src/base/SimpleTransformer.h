@@ -72,6 +72,9 @@ namespace Minotaur {
     // base class method.
     void reformulate(ProblemPtr &newp, HandlerVector &handlers, int &status);
 
+    // base class method. Also writes products of two variables.
+    void writeAux(std::ostream &out) const;
+
 
   private:
     static const std::string me_;
@@ -85,13 +88,28 @@ namespace Minotaur {
                  LinearFunctionPtr lfr, VariablePtr vr, double dr,
                  LinearFunctionPtr &lf, VariablePtr &v, double &d);
 
+    // base class method. Also handles AuxBiCG.
+    VariablePtr findAux_(const AuxDef &aux);
+
+    // base class method.
+    void initWorker_(Transformer *master);
+
+    // base class method. Also handles AuxBiCG.
+    void insertAux_(const AuxDef &aux);
+
     VariablePtr newBilVar_(VariablePtr vl, VariablePtr vr);
 
+    // base class method.
+    Transformer* newWorker_();
+
     void powKRef_(LinearFunctionPtr lfl,
                   VariablePtr vl, double dl, double k,
                   LinearFunctionPtr &lf, VariablePtr &v,
                   double &d);
 
+    // base class method.
+    void refNonlinCon_(ConstConstraintPtr c);
+
     /**
      * \brief Reformulate the nonlinear constraints of the problem.
      *
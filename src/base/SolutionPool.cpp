@@ -16,7 +16,9 @@
 #include "MinotaurConfig.h"
 #include "Environment.h"
 #include "SolutionPool.h"
+#include "StatsRegistry.h"
 #include "Timer.h"
+#include "Variable.h"
 
 using namespace Minotaur;
 
@@ -24,55 +26,162 @@ const std::string SolutionPool::me_ = "SolutionPool: ";
 
 SolutionPool::SolutionPool (EnvPtr env, ProblemPtr problem, UInt limit)
 : bestSolution_(SolutionPtr()), // NULL
+  bestObj_(INFINITY),
+  env_(env),
+  n_(0),
+  numDups_(0),
   numSolsFound_(0),
+  numSolsStat_(0),
   problem_(problem),
-  sizeLimit_(limit),
+  sizeLimit_(limit > 0 ? limit : 1),
   timeBest_(-1),
-  timeFirst_(-1)
+  timeFirst_(-1),
+  worstObj_(INFINITY)
 {
+  StatsRegistry *stats = env->getStats();
+
   timer_ = env->getTimer();
+  numSolsStat_ = stats->counter("solpool.solutions_found");
+  stats->setValue("solpool.best_value", 0.0);
+  stats->setValue("solpool.time_best", 0.0);
+  if (problem_) {
+    n_ = problem_->getNumVars();
+    for (VariableConstIterator it=problem_->varsBegin();
+         it!=problem_->varsEnd(); ++it) {
+      switch ((*it)->getType()) {
+      case (Binary):
+      case (Integer):
+      case (ImplBin):
+      case (ImplInt):
+        intIdx_.push_back((*it)->getIndex());
+        break;
+      default:
+        break;
+      }
+    }
+  }
 }
 
-void SolutionPool::addSolution(ConstSolutionPtr solution)
+
+void SolutionPool::add_(const double *x, double obj_value,
+                        ConstSolutionPtr sol)
 {
-  // XXX: for now we save only one solution.
-  SolutionPtr newsol = (SolutionPtr) new Solution(solution);
-  ++numSolsFound_;
-  if (sols_.size() > 0) {
-    if (sols_[0]->getObjValue() > solution->getObjValue()) {
-      sols_[0] = newsol;
-      bestSolution_ = newsol;
-      timeBest_ = timer_->query();
+  UInt h = hash_(x);
+  SolutionPtr newsol;
+  std::vector<SolutionPtr>::iterator it;
+  UInt i;
+
+  // check again, another thread may have improved the pool meanwhile.
+  if (isDominated_(obj_value)) {
+    return;
+  }
+
+  // a solution with the same integer part: keep the better one.
+  for (i=0; i<sols_.size(); ++i) {
+    if (hashes_[i]==h && isSame_(x, sols_[i]->getPrimal())) {
+      if (sols_[i]->getObjValue() <= obj_value) {
+        ++numDups_;
+        return;
+      }
+      sols_.erase(sols_.begin()+i);
+      hashes_.erase(hashes_.begin()+i);
+      break;
     }
+  }
+
+  if (sol) {
+    newsol = (SolutionPtr) new Solution(sol);
   } else {
-    sols_.push_back(newsol);
-    bestSolution_ = newsol;
+    newsol = (SolutionPtr) new Solution(obj_value, x, problem_);
+  }
+
+  // insert after all solutions that are not worse.
+  for (i=0, it=sols_.begin(); it!=sols_.end(); ++it, ++i) {
+    if ((*it)->getObjValue() > obj_value) {
+      break;
+    }
+  }
+  sols_.insert(it, newsol);
+  hashes_.insert(hashes_.begin()+i, h);
+  if (sols_.size() > sizeLimit_) {
+    sols_.pop_back();
+    hashes_.pop_back();
+  }
+
+  if (timeFirst_ < 0) {
     timeFirst_ = timer_->query();
-    timeBest_ = timeFirst_;
+  }
+  if (0==i) {
+    timeBest_ = timer_->query();
+  }
+  updateBounds_();
+}
+
+
+void SolutionPool::addSolution(ConstSolutionPtr solution)
+{
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+  ++numSolsFound_;
+  numSolsStat_->add();
+
+  // reject without locking or copying.
+  if (isDominated_(solution->getObjValue())) {
+    return;
+  }
+#if USE_OPENMP
+#pragma omp critical (SolutionPool)
+#endif
+  {
+    add_(solution->getPrimal(), solution->getObjValue(), solution);
+    env_->getStats()->setValue("solpool.best_value", bestObj_);
+    env_->getStats()->setValue("solpool.time_best", timeBest_);
   }
 }
 
 
 void SolutionPool::addSolution(const double *x, double obj_value)
 {
-  SolutionPtr solution = (SolutionPtr) new Solution(obj_value, x, problem_);
-  addSolution(solution);
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+  ++numSolsFound_;
+  numSolsStat_->add();
+
+  if (isDominated_(obj_value)) {
+    return;
+  }
+#if USE_OPENMP
+#pragma omp critical (SolutionPool)
+#endif
+  {
+    add_(x, obj_value, ConstSolutionPtr());
+    env_->getStats()->setValue("solpool.best_value", bestObj_);
+    env_->getStats()->setValue("solpool.time_best", timeBest_);
+  }
 }
 
 
 SolutionPtr SolutionPool::getBestSolution()
 {
-  return bestSolution_;
+  SolutionPtr sol;
+#if USE_OPENMP
+#pragma omp critical (SolutionPool)
+#endif
+  sol = bestSolution_;
+  return sol;
 }
 
 
 double SolutionPool::getBestSolutionValue() const
 {
-  if (bestSolution_) {
-    return bestSolution_->getObjValue();
-  } else {
-    return INFINITY;
-  }
+  double obj;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  obj = bestObj_;
+  return obj;
 }
 
 
@@ -88,9 +197,106 @@ UInt SolutionPool::getNumSolsFound() const
 }
 
 
+UInt SolutionPool::getSizeLimit() const
+{
+  return sizeLimit_;
+}
+
+
+UInt SolutionPool::hash_(const double *x) const
+{
+  UInt h = 2166136261u;
+  double v;
+  for (UIntVector::const_iterator it=intIdx_.begin(); it!=intIdx_.end();
+       ++it) {
+    // round through a signed type; huge values only need to hash the same,
+    // isSame_ tells them apart.
+    v = floor(x[*it]+0.5);
+    if (v > 1e9) {
+      v = 1e9;
+    } else if (v < -1e9) {
+      v = -1e9;
+    }
+    h = (h ^ (UInt) (long) v) * 16777619u;
+  }
+  return h;
+}
+
+
+bool SolutionPool::isDominated_(double obj_value) const
+{
+  double worst;
+#if USE_OPENMP
+#pragma omp atomic read
+#endif
+  worst = worstObj_;
+  return (obj_value >= worst);
+}
+
+
+bool SolutionPool::isSame_(const double *x, const double *y) const
+{
+  if (intIdx_.empty()) {
+    for (UInt i=0; i<n_; ++i) {
+      if (fabs(x[i]-y[i]) > 1e-9) {
+        return false;
+      }
+    }
+  } else {
+    for (UIntVector::const_iterator it=intIdx_.begin(); it!=intIdx_.end();
+         ++it) {
+      if (fabs(x[*it]-y[*it]) >= 0.5) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+void SolutionPool::setSizeLimit(UInt limit)
+{
+#if USE_OPENMP
+#pragma omp critical (SolutionPool)
+#endif
+  {
+    sizeLimit_ = (limit > 0) ? limit : 1;
+    if (sols_.size() > sizeLimit_) {
+      sols_.resize(sizeLimit_);
+      hashes_.resize(sizeLimit_);
+    }
+    updateBounds_();
+  }
+}
+
+
+void SolutionPool::updateBounds_()
+{
+  double best = INFINITY, worst = INFINITY;
+
+  bestSolution_ = sols_.empty() ? SolutionPtr() : sols_.front();
+  if (bestSolution_) {
+    best = bestSolution_->getObjValue();
+  }
+  if (sols_.size() >= sizeLimit_) {
+    worst = sols_.back()->getObjValue();
+  }
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+  bestObj_ = best;
+#if USE_OPENMP
+#pragma omp atomic write
+#endif
+  worstObj_ = worst;
+}
+
+
 void SolutionPool::writeStats(std::ostream &out) const
 {
   out << me_ << "Number of solutions found = " << numSolsFound_ << std::endl
+      << me_ << "Number of solutions saved = " << sols_.size()  << std::endl
+      << me_ << "Duplicate solutions       = " << numDups_      << std::endl
       << me_ << "Time first solution found = " << timeFirst_    << std::endl
       << me_ << "Time best solution found  = " << timeBest_     << std::endl
       ;
@@ -21,9 +21,24 @@
 namespace Minotaur {
 
   class Environment;
+  class StatCounter;
   class Timer;
   typedef boost::shared_ptr<Environment> EnvPtr;
 
+  /**
+   * \brief A pool of the best solutions found so far.
+   *
+   * The pool keeps up to sizeLimit_ distinct solutions sorted by objective
+   * value, best first. Two solutions are the same if their integer
+   * variables have the same values (all variables if the problem has no
+   * integer variables); of the two, only the better is kept. A solution
+   * that is not better than the worst one in a full pool is rejected before
+   * it is copied.
+   *
+   * Solutions can be added from many threads at the same time. The best
+   * objective value can be read without locking, so that it can be used for
+   * pruning while other threads add solutions.
+   */
   class SolutionPool {
   public:
     /// Default constructor.
@@ -32,28 +47,39 @@ namespace Minotaur {
     /// Construct a solution pool of a given size for a given problem
     SolutionPool(EnvPtr env, ProblemPtr problem, UInt limit=100);
 
-    /// Add Solution to the pool
+    /// Add Solution to the pool. Thread-safe.
     void addSolution(ConstSolutionPtr);
 
     /// Get number of solutions in the pool
     UInt getNumSols() const;
 
-    /// Get number of solutions in the pool
+    /// Get number of solutions offered to the pool, including rejected ones.
     UInt getNumSolsFound() const;
 
     /// Get the limit on the number of solutions in the pool
     UInt getSizeLimit() const;
 
-    /// Put a limit on the number of solutions in the pool
+    /**
+     * \brief Put a limit on the number of solutions in the pool. The worst
+     * solutions are removed if there are more. The limit is at least one.
+     */
     void setSizeLimit(UInt limit);
 
-    /// Get iterator for the first solution ...
+    /**
+     * \brief Get iterator for the first solution ...
+     *
+     * The solutions are sorted by objective value, best first. The iterators
+     * are invalidated when solutions are added.
+     */
     SolutionIterator solsBegin() { return sols_.begin(); }
 
     /// ... and the end.
     SolutionIterator solsEnd() { return sols_.end(); }
 
-    /// Create a solution from a double array and add Solution to the pool.
+    /**
+     * \brief Create a solution from a double array and add Solution to the
+     * pool. The array is copied only if the solution is not rejected.
+     */
     void addSolution(const double *x, double obj_value);
 
     /**
@@ -62,34 +88,56 @@ namespace Minotaur {
      */
     SolutionPtr getBestSolution();
 
-    /// Get the best objective function value
+    /// Get the best objective function value. Does not lock.
     double getBestSolutionValue() const;
 
     /// Write statistics to the outstream.
     void writeStats(std::ostream &out) const; 
 
   private:
-    /// The solutions are stored in a vector. 
+    /// The solutions are stored in a vector, best first.
     std::vector<SolutionPtr> sols_;
 
     /**
      * The best solution in terms of objective function value. In case of tie,
-     * the most recently found one.
+     * the one found first.
      */
     SolutionPtr bestSolution_;
 
+    /// Objective value of bestSolution_, INFINITY if none.
+    double bestObj_;
+
+    /// Environment, for the statistics registry.
+    EnvPtr env_;
+
+    /// Hash of the integer part of each solution in sols_.
+    std::vector<UInt> hashes_;
+
+    /// Indices of integer variables of the problem.
+    UIntVector intIdx_;
+
     /// For logging.
     const static std::string me_;
 
-    /// The number of solutions added to the pool.
+    /// Number of variables in the problem.
+    UInt n_;
+
+    /// Number of solutions rejected because they were a duplicate.
+    UInt numDups_;
+
+    /// The number of solutions offered to the pool.
     UInt numSolsFound_;
 
+    /// Counter "solpool.solutions_found" in the statistics registry.
+    StatCounter *numSolsStat_;
+
     /// Problem for which we are saving solutions
     ProblemPtr problem_;
 
     /// The limit on number of solutions in the pool.
     UInt sizeLimit_;
 
+
     /// Time when the best solution is found.
     double timeBest_;
 
@@ -99,6 +147,37 @@ namespace Minotaur {
     /// Global timer.
     const Timer* timer_;
 
+    /**
+     * Objective value that a new solution must beat to enter the pool:
+     * the worst value in a full pool, INFINITY otherwise.
+     */
+    double worstObj_;
+
+    /**
+     * \brief Add a solution that has not been rejected by isDominated_().
+     * Must be called by one thread at a time.
+     *
+     * \param[in] x The values of variables.
+     * \param[in] obj_value The objective value.
+     * \param[in] sol The solution if it already exists, NULL if a new one
+     * must be created from x.
+     */
+    void add_(const double *x, double obj_value, ConstSolutionPtr sol);
+
+    /// Return hash of the integer part of a point.
+    UInt hash_(const double *x) const;
+
+    /**
+     * \brief Return true if a solution with the given objective value
+     * cannot enter the pool. Does not lock.
+     */
+    bool isDominated_(double obj_value) const;
+
+    /// Return true if two points have the same integer part.
+    bool isSame_(const double *x, const double *y) const;
+
+    /// Update bestObj_ and worstObj_ after the pool is changed.
+    void updateBounds_();
   };
 
   typedef boost::shared_ptr<SolutionPool> SolutionPoolPtr;
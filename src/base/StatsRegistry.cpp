@@ -0,0 +1,387 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file StatsRegistry.cpp
+ * \brief Define the StatsRegistry class for collecting statistics of all
+ * components and writing them in JSON format.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <time.h>
+
+#include "MinotaurConfig.h"
+#include "StatsRegistry.h"
+
+using namespace Minotaur;
+
+namespace {
+// Write a string with quotes, escaping characters that JSON does not allow.
+void writeJSONString(std::ostream &out, const std::string &s)
+{
+  char buf[8];
+
+  out << '"';
+  for (std::string::const_iterator it=s.begin(); it!=s.end(); ++it) {
+    if ('"'==*it || '\\'==*it) {
+      out << '\\' << *it;
+    } else if ((unsigned char) *it < 0x20) {
+      snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char) *it);
+      out << buf;
+    } else {
+      out << *it;
+    }
+  }
+  out << '"';
+}
+
+
+// JSON has no infinity or nan.
+void writeJSONNumber(std::ostream &out, double d)
+{
+  if (std::isfinite(d)) {
+    out << d;
+  } else {
+    out << "null";
+  }
+}
+}
+
+
+StatHistogram::StatHistogram()
+  : count_(0),
+    max_(-INFINITY),
+    min_(INFINITY),
+    sum_(0.0)
+{
+  for (int i=0; i<nBuckets_; ++i) {
+    buckets_[i] = 0;
+  }
+#if USE_OPENMP
+  omp_init_lock(&lock_);
+#endif
+}
+
+
+StatHistogram::~StatHistogram()
+{
+#if USE_OPENMP
+  omp_destroy_lock(&lock_);
+#endif
+}
+
+
+void StatHistogram::add(double v)
+{
+  int e = minExp_;
+  int b;
+
+  if (v > 0.0) {
+    frexp(v, &e);
+  }
+  // v < 2^e
+  b = e - minExp_;
+  if (b < 0) {
+    b = 0;
+  } else if (b >= nBuckets_) {
+    b = nBuckets_-1;
+  }
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+  ++buckets_[b];
+  ++count_;
+  sum_ += v;
+  if (v < min_) {
+    min_ = v;
+  }
+  if (v > max_) {
+    max_ = v;
+  }
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+}
+
+
+void StatHistogram::writeJSON(std::ostream &out) const
+{
+  bool first = true;
+
+#if USE_OPENMP
+  omp_set_lock(&lock_);
+#endif
+  out << "{\"count\": " << count_ << ", \"sum\": ";
+  writeJSONNumber(out, sum_);
+  out << ", \"min\": ";
+  writeJSONNumber(out, (count_ > 0) ? min_ : 0.0);
+  out << ", \"max\": ";
+  writeJSONNumber(out, (count_ > 0) ? max_ : 0.0);
+  out << ", \"buckets\": [";
+  // only non-empty buckets, with their upper limit.
+  for (int i=0; i<nBuckets_; ++i) {
+    if (buckets_[i] > 0) {
+      if (!first) {
+        out << ", ";
+      }
+      first = false;
+      out << "{\"lt\": ";
+      if (i==nBuckets_-1) {
+        out << "null";
+      } else {
+        out << ldexp(1.0, i+minExp_);
+      }
+      out << ", \"count\": " << buckets_[i] << "}";
+    }
+  }
+  out << "]}";
+#if USE_OPENMP
+  omp_unset_lock(&lock_);
+#endif
+}
+
+
+StatsRegistry::StatsRegistry()
+  : interval_(0.0),
+    lastDump_(0.0),
+    t0_(wallTime())
+{
+  lastDump_ = t0_;
+}
+
+
+StatsRegistry::~StatsRegistry()
+{
+  for (CounterMap::iterator it=counters_.begin(); it!=counters_.end();
+       ++it) {
+    delete it->second;
+  }
+  for (HistogramMap::iterator it=histograms_.begin();
+       it!=histograms_.end(); ++it) {
+    delete it->second;
+  }
+  for (TimerMap::iterator it=timers_.begin(); it!=timers_.end(); ++it) {
+    delete it->second;
+  }
+  counters_.clear();
+  histograms_.clear();
+  timers_.clear();
+  values_.clear();
+}
+
+
+StatCounter* StatsRegistry::counter(const std::string &name)
+{
+  StatCounter *c = 0;
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  {
+    CounterMap::iterator it = counters_.find(name);
+    if (it==counters_.end()) {
+      c = new StatCounter();
+      counters_[name] = c;
+    } else {
+      c = it->second;
+    }
+  }
+  return c;
+}
+
+
+int StatsRegistry::dump()
+{
+  std::string tmp = fname_ + ".tmp";
+  std::ofstream out;
+
+  if (fname_.empty()) {
+    return 0;
+  }
+  lastDump_ = wallTime();
+  out.open(tmp.c_str());
+  if (!out.is_open()) {
+    return 1;
+  }
+  writeJSON(out);
+  out.close();
+  if (out.fail() || 0!=rename(tmp.c_str(), fname_.c_str())) {
+    return 1;
+  }
+  return 0;
+}
+
+
+void StatsRegistry::dumpIfDue()
+{
+  if (isDue()) {
+    dump();
+  }
+}
+
+
+StatHistogram* StatsRegistry::histogram(const std::string &name)
+{
+  StatHistogram *h = 0;
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  {
+    HistogramMap::iterator it = histograms_.find(name);
+    if (it==histograms_.end()) {
+      h = new StatHistogram();
+      histograms_[name] = h;
+    } else {
+      h = it->second;
+    }
+  }
+  return h;
+}
+
+
+bool StatsRegistry::isDue() const
+{
+  return (interval_ > 0.0 && false==fname_.empty() &&
+          wallTime() - lastDump_ >= interval_);
+}
+
+
+void StatsRegistry::setDumpFile(std::string fname, double interval)
+{
+  fname_ = fname;
+  interval_ = interval;
+}
+
+
+void StatsRegistry::setValue(const std::string &name, double value)
+{
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  values_[name] = value;
+}
+
+
+StatTimer* StatsRegistry::timer(const std::string &name)
+{
+  StatTimer *t = 0;
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  {
+    TimerMap::iterator it = timers_.find(name);
+    if (it==timers_.end()) {
+      t = new StatTimer();
+      timers_[name] = t;
+    } else {
+      t = it->second;
+    }
+  }
+  return t;
+}
+
+
+double* StatsRegistry::value(const std::string &name)
+{
+  double *v = 0;
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  {
+    ValueMap::iterator it = values_.find(name);
+    if (it==values_.end()) {
+      it = values_.insert(std::make_pair(name, 0.0)).first;
+    }
+    v = &(it->second);
+  }
+  return v;
+}
+
+
+double StatsRegistry::wallTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+void StatsRegistry::writeJSON(std::ostream &out) const
+{
+  std::streamsize prec = out.precision(12);
+  std::ios_base::fmtflags flags = out.flags();
+  const char *sep;
+
+  out.unsetf(std::ios_base::floatfield);
+#if USE_OPENMP
+#pragma omp critical (StatsRegistry)
+#endif
+  {
+    out << "{" << std::endl << "  \"elapsed\": " << wallTime() - t0_;
+
+    out << "," << std::endl << "  \"counters\": {";
+    sep = "";
+    for (CounterMap::const_iterator it=counters_.begin();
+         it!=counters_.end(); ++it, sep=",") {
+      out << sep << std::endl << "    ";
+      writeJSONString(out, it->first);
+      out << ": " << it->second->value();
+    }
+    out << std::endl << "  }";
+
+    out << "," << std::endl << "  \"values\": {";
+    sep = "";
+    for (ValueMap::const_iterator it=values_.begin(); it!=values_.end();
+         ++it, sep=",") {
+      out << sep << std::endl << "    ";
+      writeJSONString(out, it->first);
+      out << ": ";
+      writeJSONNumber(out, it->second);
+    }
+    out << std::endl << "  }";
+
+    out << "," << std::endl << "  \"timers\": {";
+    sep = "";
+    for (TimerMap::const_iterator it=timers_.begin(); it!=timers_.end();
+         ++it, sep=",") {
+      out << sep << std::endl << "    ";
+      writeJSONString(out, it->first);
+      out << ": {\"calls\": " << it->second->calls() << ", \"seconds\": ";
+      writeJSONNumber(out, it->second->seconds());
+      out << "}";
+    }
+    out << std::endl << "  }";
+
+    out << "," << std::endl << "  \"histograms\": {";
+    sep = "";
+    for (HistogramMap::const_iterator it=histograms_.begin();
+         it!=histograms_.end(); ++it, sep=",") {
+      out << sep << std::endl << "    ";
+      writeJSONString(out, it->first);
+      out << ": ";
+      it->second->writeJSON(out);
+    }
+    out << std::endl << "  }" << std::endl << "}" << std::endl;
+  }
+  out.precision(prec);
+  out.flags(flags);
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
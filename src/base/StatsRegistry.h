@@ -0,0 +1,322 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file StatsRegistry.h
+ * \brief Declare the StatsRegistry class for collecting statistics of all
+ * components and writing them in JSON format.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#ifndef MINOTAURSTATSREGISTRY_H
+#define MINOTAURSTATSREGISTRY_H
+
+#include <iosfwd>
+#include <map>
+#include <string>
+
+#include "Types.h"
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace Minotaur {
+
+/**
+ * A counter of events, e.g. nodes processed. Counters can be incremented
+ * from many threads at the same time.
+ */
+class StatCounter {
+public:
+  /// Constructor. Starts at zero.
+  StatCounter() : value_(0) {}
+
+  /// Add n to the counter.
+  void add(long n=1)
+  {
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+    value_ += n;
+  }
+
+  /// Set the value of the counter. Not thread-safe with add().
+  void set(long n) { value_ = n; }
+
+  /// Current value.
+  long value() const { return value_; }
+
+private:
+  /// Value of the counter.
+  long value_;
+};
+
+
+/**
+ * Total time and number of calls of an operation, e.g. solving a
+ * relaxation. Can be used from many threads at the same time.
+ */
+class StatTimer {
+public:
+  /// Constructor. Starts at zero.
+  StatTimer() : calls_(0), secs_(0.0) {}
+
+  /// Add one call that took secs seconds.
+  void add(double secs)
+  {
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+    secs_ += secs;
+#if USE_OPENMP
+#pragma omp atomic
+#endif
+    ++calls_;
+  }
+
+  /// Number of calls.
+  long calls() const { return calls_; }
+
+  /// Total time in seconds.
+  double seconds() const { return secs_; }
+
+private:
+  /// Number of calls.
+  long calls_;
+
+  /// Total time in seconds.
+  double secs_;
+};
+
+
+/**
+ * Distribution of a positive quantity, e.g. time of solving a relaxation or
+ * depth of a node. Values are counted in buckets whose upper limits are
+ * powers of two, and the count, sum, minimum and maximum are also saved.
+ */
+class StatHistogram {
+public:
+  /// Constructor.
+  StatHistogram();
+
+  /// Destroy.
+  ~StatHistogram();
+
+  /**
+   * \brief Add a value. Thread-safe. Each histogram has its own lock, so
+   * threads updating different histograms do not wait for each other.
+   */
+  void add(double v);
+
+  /// Write as a JSON object.
+  void writeJSON(std::ostream &out) const;
+
+private:
+  /// Number of buckets.
+  static const int nBuckets_ = 64;
+
+  /// Exponent of the upper limit of the first bucket.
+  static const int minExp_ = -32;
+
+  /// Count in each bucket.
+  long buckets_[nBuckets_];
+
+  /// Number of values.
+  long count_;
+
+#if USE_OPENMP
+  /// Lock for updating and reading this histogram.
+  mutable omp_lock_t lock_;
+#endif
+
+  /// Largest value.
+  double max_;
+
+  /// Smallest value.
+  double min_;
+
+  /// Sum of values.
+  double sum_;
+
+  /// Copy constructor is not allowed.
+  StatHistogram(const StatHistogram &);
+
+  /// Copy by assignment is not allowed.
+  StatHistogram & operator = (const StatHistogram &);
+};
+
+
+/**
+ * \brief A registry of named statistics.
+ *
+ * Components get counters, timers and histograms from the registry by name
+ * (usually once, in the constructor) and update them while solving. The
+ * same name always gives the same object, so components of different
+ * threads, e.g. in parallel branch-and-bound, update the same statistics.
+ * Names should be of the form "component.quantity", e.g.
+ * "bnb.nodes_processed". Values that are known only at some point, e.g. the
+ * best bound, can be saved with setValue().
+ *
+ * The registry can be written in JSON format at any time. If a file is set
+ * with setDumpFile(), then dumpIfDue() writes the file after every given
+ * interval; algorithms call it when they display their status.
+ */
+class StatsRegistry {
+public:
+  /// Constructor.
+  StatsRegistry();
+
+  /// Destroy.
+  ~StatsRegistry();
+
+  /// Get the counter with the given name. Create if it does not exist.
+  StatCounter* counter(const std::string &name);
+
+  /**
+   * \brief Write the registry to the dump file if the interval since the
+   * last dump has passed. Does nothing if no file or interval is set.
+   */
+  void dumpIfDue();
+
+  /**
+   * \brief Write the registry to the dump file.
+   *
+   * The file is first written under a temporary name and then renamed, so
+   * that a reader never sees a partially written file.
+   * \return 0 if successful or if no file is set, nonzero otherwise.
+   */
+  int dump();
+
+  /// Get the histogram with the given name. Create if it does not exist.
+  StatHistogram* histogram(const std::string &name);
+
+  /**
+   * \brief Return true if a dump file and interval are set and the interval
+   * since the last dump has passed. Components that copy their statistics
+   * into the registry only before a dump use this to avoid the work.
+   */
+  bool isDue() const;
+
+  /// Return true if a dump file has been set.
+  bool isOn() const { return false==fname_.empty(); }
+
+  /**
+   * \brief Set the file where the registry is dumped.
+   *
+   * \param[in] fname Name of the file.
+   * \param[in] interval Seconds between dumps by dumpIfDue(). If 0, the
+   * file is written only when dump() is called.
+   */
+  void setDumpFile(std::string fname, double interval);
+
+  /// Save a value with the given name. Replaces the previous value.
+  void setValue(const std::string &name, double value);
+
+  /// Get the timer with the given name. Create if it does not exist.
+  StatTimer* timer(const std::string &name);
+
+  /**
+   * \brief Get the value with the given name, so that it can be set many
+   * times without looking up the name. Created with value 0 if it does not
+   * exist. Setting it through the pointer is not thread-safe.
+   */
+  double* value(const std::string &name);
+
+  /// Return the current time in seconds of a monotonic clock.
+  static double wallTime();
+
+  /// Write all statistics as one JSON object.
+  void writeJSON(std::ostream &out) const;
+
+private:
+  typedef std::map<std::string, StatCounter *> CounterMap;
+  typedef std::map<std::string, StatHistogram *> HistogramMap;
+  typedef std::map<std::string, StatTimer *> TimerMap;
+  typedef std::map<std::string, double> ValueMap;
+
+  /// Counters.
+  CounterMap counters_;
+
+  /// File where the registry is dumped.
+  std::string fname_;
+
+  /// Histograms.
+  HistogramMap histograms_;
+
+  /// Seconds between dumps by dumpIfDue().
+  double interval_;
+
+  /// Time of the last dump.
+  double lastDump_;
+
+  /// Time when the registry was created.
+  double t0_;
+
+  /// Timers.
+  TimerMap timers_;
+
+  /// Values set by setValue().
+  ValueMap values_;
+
+  /// Copy constructor is not allowed.
+  StatsRegistry(const StatsRegistry &);
+
+  /// Copy by assignment is not allowed.
+  StatsRegistry & operator = (const StatsRegistry &);
+};
+
+
+/**
+ * Measure the wall time of a scope and add it to a timer and a histogram
+ * when the scope is left. Either may be NULL.
+ */
+class StatTimerScope {
+public:
+  /// Start measuring.
+  StatTimerScope(StatTimer *t, StatHistogram *h=0)
+    : h_(h),
+      start_((t || h) ? StatsRegistry::wallTime() : 0.0),
+      t_(t)
+  {}
+
+  /// Stop measuring and add the time.
+  ~StatTimerScope()
+  {
+    if (t_ || h_) {
+      double secs = StatsRegistry::wallTime() - start_;
+      if (t_) {
+        t_->add(secs);
+      }
+      if (h_) {
+        h_->add(secs);
+      }
+    }
+  }
+
+private:
+  /// Histogram of times, may be NULL.
+  StatHistogram *h_;
+
+  /// Time when the scope started.
+  double start_;
+
+  /// Timer, may be NULL.
+  StatTimer *t_;
+};
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
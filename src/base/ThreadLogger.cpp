@@ -0,0 +1,257 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2010 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file ThreadLogger.cpp
+ * \brief Define a logger that buffers messages of each thread separately.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/time.h>
+
+#include "MinotaurConfig.h"
+#include "ThreadLogger.h"
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace Minotaur;
+
+
+ThreadLogger::ThreadLogger(LogLevel max_level, std::ostream &out)
+  : Logger(max_level),
+    out_(out),
+    t0_(wallTime_())
+{
+  int nthreads = 1;
+#if USE_OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  for (int i=0; i<nthreads; ++i) {
+    bufs_.push_back(new LineBuf(this, i));
+    outs_.push_back(new std::ostream(bufs_.back()));
+  }
+}
+
+
+ThreadLogger::~ThreadLogger()
+{
+  flush();
+  for (UInt i=0; i<bufs_.size(); ++i) {
+    delete outs_[i];
+    delete bufs_[i];
+  }
+  bufs_.clear();
+  outs_.clear();
+  for (std::map<int, std::ostream *>::iterator it=extraOuts_.begin();
+       it!=extraOuts_.end(); ++it) {
+    delete it->second;
+    delete extraBufs_[it->first];
+  }
+  extraOuts_.clear();
+  extraBufs_.clear();
+}
+
+
+void ThreadLogger::flush()
+{
+  for (UInt i=0; i<bufs_.size(); ++i) {
+    outs_[i]->flush();
+    bufs_[i]->flush();
+  }
+  for (std::map<int, std::ostream *>::iterator it=extraOuts_.begin();
+       it!=extraOuts_.end(); ++it) {
+    it->second->flush();
+    extraBufs_[it->first]->flush();
+  }
+}
+
+
+std::ostream *ThreadLogger::getExtraStream_(int tid) const
+{
+  std::ostream *out = 0;
+  std::map<int, std::ostream *>::iterator it;
+  LineBuf *buf;
+
+  // the maps are only used by threads without a buffer in bufs_, always
+  // inside this critical section. Elements of a map do not move when
+  // another is inserted, so a thread can use its stream outside it.
+#if USE_OPENMP
+#pragma omp critical (ThreadLoggerExtra)
+#endif
+  {
+    it = extraOuts_.find(tid);
+    if (it==extraOuts_.end()) {
+      buf = new LineBuf(const_cast<ThreadLogger *>(this), tid);
+      out = new std::ostream(buf);
+      extraBufs_[tid] = buf;
+      extraOuts_[tid] = out;
+    } else {
+      out = it->second;
+    }
+  }
+  return out;
+}
+
+
+std::ostream& ThreadLogger::msgStream(LogLevel level) const
+{
+  int tid = 0;
+  if (level > maxLevel_) {
+    return Logger::msgStream(level);
+  }
+#if USE_OPENMP
+  tid = omp_get_thread_num();
+#endif
+  if (tid < (int) outs_.size()) {
+    return *(outs_[tid]);
+  }
+  return *(getExtraStream_(tid));
+}
+
+
+void ThreadLogger::setNode(UInt id)
+{
+  int tid = 0;
+#if USE_OPENMP
+  tid = omp_get_thread_num();
+#endif
+  if (tid < (int) bufs_.size()) {
+    bufs_[tid]->node = id;
+  } else {
+    getExtraStream_(tid);
+#if USE_OPENMP
+#pragma omp critical (ThreadLoggerExtra)
+#endif
+    extraBufs_[tid]->node = id;
+  }
+}
+
+
+double ThreadLogger::wallTime_()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec*1e-6;
+}
+
+
+void ThreadLogger::write_(std::string &s)
+{
+  if (s.empty()) {
+    return;
+  }
+#if USE_OPENMP
+#pragma omp critical (ThreadLoggerOut)
+#endif
+  {
+    out_.write(s.data(), s.size());
+    out_.flush();
+  }
+  s.clear();
+}
+
+
+ThreadLogger::LineBuf::LineBuf(ThreadLogger *logger, int tid)
+  : node(0),
+    lineStart_(true),
+    logger_(logger),
+    tid_(tid)
+{
+  buf_.reserve(flushSize_);
+}
+
+
+void ThreadLogger::LineBuf::addPrefix_()
+{
+  char prefix[64];
+  int n = snprintf(prefix, sizeof(prefix), "[t%d n%u %.4f] ", tid_, node,
+                   wallTime_() - logger_->t0_);
+  buf_.append(prefix, n);
+  lineStart_ = false;
+}
+
+
+void ThreadLogger::LineBuf::flush()
+{
+  logger_->write_(buf_);
+}
+
+
+ThreadLogger::LineBuf::int_type ThreadLogger::LineBuf::overflow(int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof())) {
+    return traits_type::not_eof(c);
+  }
+  if (lineStart_) {
+    addPrefix_();
+  }
+  buf_.push_back(traits_type::to_char_type(c));
+  if ('\n'==c) {
+    lineStart_ = true;
+    if (buf_.size() >= flushSize_) {
+      flush();
+    }
+  }
+  return c;
+}
+
+
+// Called on std::endl or std::flush. Outside parallel regions there is no
+// contention, so write right away.
+int ThreadLogger::LineBuf::sync()
+{
+#if USE_OPENMP
+  if (omp_in_parallel()) {
+    return 0;
+  }
+#endif
+  flush();
+  return 0;
+}
+
+
+std::streamsize ThreadLogger::LineBuf::xsputn(const char *s,
+                                              std::streamsize n)
+{
+  const char *e = s+n;
+  const char *nl;
+
+  while (s<e) {
+    if (lineStart_) {
+      addPrefix_();
+    }
+    nl = (const char *) memchr(s, '\n', e-s);
+    if (nl) {
+      buf_.append(s, nl+1-s);
+      s = nl+1;
+      lineStart_ = true;
+    } else {
+      buf_.append(s, e-s);
+      s = e;
+    }
+  }
+  if (lineStart_ && buf_.size() >= flushSize_) {
+    flush();
+  }
+  return n;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,150 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2010 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file ThreadLogger.h
+ * \brief Declare a logger that buffers messages of each thread separately.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+
+#ifndef MINOTAURTHREADLOGGER_H
+#define MINOTAURTHREADLOGGER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Logger.h"
+
+namespace Minotaur {
+
+/**
+ * A ThreadLogger is a Logger for parallel algorithms. Each thread writes its
+ * messages into its own buffer, without any locks. Every line is prefixed
+ * with the thread number, the node being processed by the thread (as set
+ * by setNode()) and the wall-clock time since the logger was created, e.g.
+ *   [t2 n145 3.0512] branch-and-bound: node pruned
+ *
+ * Inside a parallel region, a buffer is written to the output stream in one
+ * piece, inside a critical section, only when it gets full or when flush()
+ * is called. So lines from different threads are never mixed up and
+ * threads rarely wait for each other. Outside parallel regions, messages
+ * are written at std::endl as usual. The buffers are written in the thread
+ * that fills them; there is no separate writer thread. Buffers are created
+ * for omp_get_max_threads() threads in the constructor. A thread with a
+ * larger number, e.g. after the number of threads is increased, gets its
+ * buffer when it first writes a message.
+ */
+class ThreadLogger : public Logger {
+public:
+  /**
+   * \brief Constructor.
+   *
+   * \param[in] max_level Do not write messages above this level.
+   * \param[in] out The stream where buffers are written.
+   */
+  ThreadLogger(LogLevel max_level=LogInfo, std::ostream &out=std::cout);
+
+  /// Destroy. Pending messages are written.
+  ~ThreadLogger();
+
+  /// Write pending messages of all threads. Call from a serial region.
+  void flush();
+
+  /// Get the stream of the calling thread.
+  std::ostream& msgStream(LogLevel level) const;
+
+  /// Set the id of the node processed by the calling thread.
+  void setNode(UInt id);
+
+private:
+  /// Stream buffer of one thread.
+  class LineBuf : public std::streambuf {
+  public:
+    LineBuf(ThreadLogger *logger, int tid);
+
+    /// Write the buffer to the output stream of the logger.
+    void flush();
+
+    /// Node processed by this thread.
+    UInt node;
+
+  protected:
+    virtual int_type overflow(int_type c);
+    virtual int sync();
+    virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+  private:
+    /// Messages not yet written.
+    std::string buf_;
+
+    /// True if the next character starts a new line.
+    bool lineStart_;
+
+    /// The logger.
+    ThreadLogger *logger_;
+
+    /// Thread number.
+    int tid_;
+
+    /// Add prefix with thread, node and time.
+    void addPrefix_();
+  };
+
+  /// Size of a buffer after which it is written.
+  static const size_t flushSize_ = 1<<16;
+
+  /// Stream where messages are written.
+  std::ostream &out_;
+
+  /// One buffer for each thread.
+  std::vector<LineBuf *> bufs_;
+
+  /// Buffers of threads created after the constructor, by thread number.
+  mutable std::map<int, LineBuf *> extraBufs_;
+
+  /// Streams of threads created after the constructor, by thread number.
+  mutable std::map<int, std::ostream *> extraOuts_;
+
+  /// One stream for each thread.
+  std::vector<std::ostream *> outs_;
+
+  /// Wall-clock time when the logger was created.
+  double t0_;
+
+  /**
+   * \brief Return the stream of a thread that has no buffer in bufs_,
+   * creating the buffer if needed.
+   */
+  std::ostream *getExtraStream_(int tid) const;
+
+  /// Return the current wall-clock time.
+  static double wallTime_();
+
+  /// Write s to out_ in a critical section and clear it.
+  void write_(std::string &s);
+
+  /// Copy constructor is not allowed.
+  ThreadLogger (const ThreadLogger &l);
+
+  /// Copy by assignment is not allowed.
+  ThreadLogger  & operator = (const ThreadLogger &l);
+};
+typedef boost::shared_ptr<ThreadLogger> ThreadLoggerPtr;
+}
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
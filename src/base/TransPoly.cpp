@@ -18,6 +18,7 @@
 #include "CNode.h"
 #include "Constraint.h"
 #include "CxUnivarHandler.h"
+#include "Environment.h"
 #include "Function.h"
 #include "LinearFunction.h"
 #include "LinearHandler.h"
@@ -27,6 +28,7 @@
 #include "Problem.h"
 #include "QuadHandler.h"
 #include "Solution.h"
+#include "StatsRegistry.h"
 #include "TransPoly.h"
 #include "YEqMonomial.h"
 #include "YEqLFs.h"
@@ -54,13 +56,27 @@ TransPoly::~TransPoly()
 }
 
 
-void TransPoly::assignMH_(ConstraintPtr con, VariablePtr v, MonomialFunPtr mf)
+void TransPoly::addToHandler_(HandlerPtr h, ConstraintPtr c)
 {
-  std::set<ConstVariablePtr> vars;
-  for (VarIntMapConstIterator it=mf->termsBegin(); it!=mf->termsEnd(); ++it) {
-    vars.insert(it->first);
+  if (h==mHandler_) {
+    // c is -y + x1.x2.x3... = 0
+    FunctionPtr f = c->getFunction();
+    NonlinearFunctionPtr nlf = f->getNonlinearFunction();
+    std::set<ConstVariablePtr> vars(nlf->varsBegin(), nlf->varsEnd());
+    mHandler_->addConstraint(c, f->getLinearFunction()->termsBegin()->first,
+                             vars);
+  } else {
+    Transformer::addToHandler_(h, c);
+  }
+}
+
+
+VariablePtr TransPoly::findAux_(const AuxDef &aux)
+{
+  if (AuxMonomial==aux.kind) {
+    return yMonoms_->findY(aux.mf);
   }
-  mHandler_->addConstraint(con, v, vars);
+  return Transformer::findAux_(aux);
 }
 
 
@@ -84,6 +100,24 @@ SolutionPtr TransPoly::getSolTrans(ConstSolutionPtr , int &err)
 }
 
 
+void TransPoly::initWorker_(Transformer *master)
+{
+  Transformer::initWorker_(master);
+  mHandler_ = ((TransPoly *) master)->mHandler_;
+  yMonoms_ = new YEqMonomial(2*newp_->getNumVars());
+}
+
+
+void TransPoly::insertAux_(const AuxDef &aux)
+{
+  if (AuxMonomial==aux.kind) {
+    yMonoms_->insert(aux.y, aux.mf);
+  } else {
+    Transformer::insertAux_(aux);
+  }
+}
+
+
 MonomialFunPtr TransPoly::monomToMl_(MonomialFunPtr mf)
 {
   MonomialFunPtr mf2 = (MonomialFunPtr) new MonomialFunction(1.0);
@@ -93,6 +127,7 @@ MonomialFunPtr TransPoly::monomToMl_(MonomialFunPtr mf)
   LinearFunctionPtr lf;
   ConstraintPtr cnew;
   FunctionPtr f;
+  AuxDef aux;
 
   for (VarIntMapConstIterator it=mf->termsBegin(); it!=mf->termsEnd(); ++it) {
     if (1==it->second) {
@@ -128,6 +163,9 @@ MonomialFunPtr TransPoly::monomToMl_(MonomialFunPtr mf)
         ub = pow(ub, double(it->second));
 
         v2 = newp_->newVariable(lb, ub, Continuous); 
+        aux.kind = AuxUniCG;
+        aux.cg = cg;
+        aux.y = v2;
  
 #if defined(DEBUG_TRANSPOLY)
         std::cout << "Transpoly -- Creating a new variable: ";
@@ -146,10 +184,7 @@ MonomialFunPtr TransPoly::monomToMl_(MonomialFunPtr mf)
         //assignHandler_(cg, cnew);
         // XXX JTL.  Currently for TransPoly, we will give the quadratics to
         // uHandler.
-        
-        VariablePtr iv;
-        iv = *(f->getNonlinearFunction()->varsBegin());
-        uHandler_->addConstraint(cnew, iv, v2, 'E');
+        addCon_(uHandler_, cnew, aux);
         v = v2;
       }
     }
@@ -159,6 +194,12 @@ MonomialFunPtr TransPoly::monomToMl_(MonomialFunPtr mf)
 }
 
 
+Transformer* TransPoly::newWorker_()
+{
+  return new TransPoly(env_, p_);
+}
+
+
 VariablePtr TransPoly::newPolyVar_(MonomialFunPtr mf)
 {
   ConstraintPtr newcon;
@@ -168,6 +209,7 @@ VariablePtr TransPoly::newPolyVar_(MonomialFunPtr mf)
   CNode *n0 = 0;
   MonomialFunPtr mf2 = monomToMl_(mf);
   VariablePtr v;
+  AuxDef aux;
 
   if (1<mf2->getDegree()) {
     v = yMonoms_->findY(mf2);
@@ -187,7 +229,10 @@ VariablePtr TransPoly::newPolyVar_(MonomialFunPtr mf)
     lf->addTerm(v, -1.0);
     f = (FunctionPtr) new Function(lf, cg);
     newcon = newp_->newConstraint(f, 0.0, 0.0);
-    assignMH_(newcon, v, mf2);
+    aux.kind = AuxMonomial;
+    aux.mf = mf2;
+    aux.y = v;
+    addCon_(mHandler_, newcon, aux);
   }
   return v;
 }
@@ -201,6 +246,7 @@ VariablePtr TransPoly::newPolyVar_(const CNode* cnode, MonomialFunPtr mf,
   CGraphPtr cg;
   CNode *n1;
   CNode *n2 = 0;
+  AuxDef aux;
 
   if (!v) {
     if (mf) {
@@ -242,7 +288,10 @@ VariablePtr TransPoly::newPolyVar_(const CNode* cnode, MonomialFunPtr mf,
     cnew = newp_->newConstraint(f, 0.0, 0.0);
 
     yUniExprs_->insert(y, cg);
-    assignHandler_(cg, cnew);
+    aux.kind = AuxUniCG;
+    aux.cg = cg;
+    aux.y = y;
+    assignHandler_(cg, cnew, aux);
   }
   return y;
 }
@@ -660,9 +709,9 @@ void TransPoly::refPlus_(MonomialFunPtr mfl, MonomialFunPtr mfr,
 }
 
 
-void TransPoly::refNonlinCons_() 
+void TransPoly::refNonlinCon_(ConstConstraintPtr c)
 {
-  ConstraintPtr c, cnew;
+  ConstraintPtr cnew;
   FunctionPtr f;
   CGraphPtr cg;
   LinearFunctionPtr lf;
@@ -671,34 +720,46 @@ void TransPoly::refNonlinCons_()
   double d;
   double k;
 
+  f = c->getFunction();
+  cg = boost::dynamic_pointer_cast <CGraph> (f->getNonlinearFunction());
+  mf.reset(); lf.reset(); v.reset(); d = 0; k=0;
+  recursPolyRef_(cg->getOut(), mf, lf, v, d, k);
+  if (mf) {
+    lf = (LinearFunctionPtr) new LinearFunction();
+    v = newPolyVar_(mf);
+    lf->addTerm(v, mf->getCoeff());
+  } else if (v) {
+    lf = (LinearFunctionPtr) new LinearFunction();
+    lf->addTerm(v, k);
+  } 
+  if (lf) {
+    if (f->getLinearFunction()) {
+      lf->add(f->getLinearFunction()->cloneWithVars(newp_->varsBegin()));
+    }
+    f = (FunctionPtr) new Function(lf);
+    cnew = newp_->newConstraint(f, c->getLb()-d, c->getUb()-d);
+    addCon_(lHandler_, cnew);
+  } else {
+    assert(!"empty constraint?");
+  }
+}
+
+
+void TransPoly::refNonlinCons_() 
+{
+  ConstConstraintVector cons;
+  FunctionPtr f;
+
   assert (p_ && newp_);
 
   for (ConstraintConstIterator it=p_->consBegin(); it!=p_->consEnd();
        ++it) {
-    c = *it;
-    f = c->getFunction();
+    f = (*it)->getFunction();
     if (f->getType()!=Constant && f->getType()!=Linear) {
-      cg = boost::dynamic_pointer_cast <CGraph> (f->getNonlinearFunction());
-      mf.reset(); lf.reset(); v.reset(); d = 0; k=0;
-      recursPolyRef_(cg->getOut(), mf, lf, v, d, k);
-      if (mf) {
-        lf = (LinearFunctionPtr) new LinearFunction();
-        v = newPolyVar_(mf);
-        lf->addTerm(v, mf->getCoeff());
-      } else if (v) {
-        lf = (LinearFunctionPtr) new LinearFunction();
-        lf->addTerm(v, k);
-      } 
-      if (lf) {
-        lf->add(f->getLinearFunction());
-        f = (FunctionPtr) new Function(lf);
-        cnew = newp_->newConstraint(f, c->getLb()-d, c->getUb()-d);
-        lHandler_->addConstraint(cnew);
-      } else {
-        assert(!"empty constraint?");
-      }
+      cons.push_back(*it);
     }
   }
+  refNonlinConsPar_(cons);
 }
 
 
@@ -748,6 +809,9 @@ void TransPoly::refNonlinObj_()
 void TransPoly::reformulate(ProblemPtr &newp, HandlerVector &handlers,
                             int &status) 
 {
+  StatTimerScope tscope(env_ ?
+                        env_->getStats()->timer("transformer.reformulate") :
+                        0);
   assert(p_);
   newp = (ProblemPtr) new Problem();
   newp_ = newp;
@@ -793,6 +857,15 @@ void TransPoly::refUnivarOpPoly_(const CNode *node, MonomialFunPtr mfl,
 }
 
 
+void TransPoly::writeAux(std::ostream &out) const
+{
+  Transformer::writeAux(out);
+  if (yMonoms_) {
+    yMonoms_->write(out);
+  }
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -53,6 +53,9 @@ public:
   // base class method.
   void reformulate(ProblemPtr &newp, HandlerVector &handlers, int &status);
 
+  // base class method. Also writes monomials.
+  void writeAux(std::ostream &out) const;
+
 private:
 
   /// Handler that takes care of constraints of the form y=u.v.w.x
@@ -62,15 +65,19 @@ private:
   YEqMonomial *yMonoms_;
 
   /**
-   * \brief Assign a constraint to multilinear-terms handler.
-   * \param [in] con Constraint that is to be assigned to the handler. It must be
-   * of the form y = x1.x2.x3...
-   * \param [in] v The auxiliary variable y.
-   * \param [in] mf The multilinear term saved as monomial. Care must be taken
-   * to make sure all variables have power one in the monomial. See monomToMl_
-   * function.
+   * \brief Base class method. Also assigns constraints of the form
+   * y = x1.x2.x3... to the multilinear-terms handler.
    */
-  void assignMH_(ConstraintPtr con, VariablePtr v, MonomialFunPtr mf);
+  void addToHandler_(HandlerPtr h, ConstraintPtr c);
+
+  // base class method. Also handles AuxMonomial.
+  VariablePtr findAux_(const AuxDef &aux);
+
+  // base class method.
+  void initWorker_(Transformer *master);
+
+  // base class method. Also handles AuxMonomial.
+  void insertAux_(const AuxDef &aux);
 
   /**
    * \brief Convert a monomial to another monomial with all powers equal to
@@ -192,6 +199,12 @@ private:
                 VariablePtr &v, double &d, double &k);
 
   
+  // base class method.
+  Transformer* newWorker_();
+
+  // base class method.
+  void refNonlinCon_(ConstConstraintPtr c);
+
   /*
    * \brief Reformulate the constraints of the original problem into new
    * problem.
@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <iostream>
+#include <stack>
 
 #include "MinotaurConfig.h"
 #include "Environment.h"
@@ -37,21 +38,17 @@ using namespace Minotaur;
 const std::string TransSep::me_ = "TransSep: ";
 
 TransSep::TransSep()
-:env_(EnvPtr()), problem_(ProblemPtr()), coeff_(0.0), itnum_(0), sepNodes_(0),
-  sepOps_(0), sepVars_(0), sepConst_(0), sepConId_(0), newCons_(0), newVars_(0),
-  objSep_(false), sepStatus_(false),lf_(LinearFunctionPtr()), ub_(0), lb_(0),
-  f_(0), snodes_(0), sops_(0), svars_(0), sconst_(0), on_(), onop_(),
-  nnode_(0), nvar_(0)
+:env_(EnvPtr()), problem_(ProblemPtr()), cst_(0.0), sepConId_(0),
+  newCons_(0), newVars_(0), objSep_(false), sepStatus_(false),
+  lf_(LinearFunctionPtr()), ub_(0), lb_(0), nnode_(0)
 {
 }
 
 
 TransSep::TransSep(EnvPtr env, ProblemPtr problem)
-:env_(env), problem_(problem), coeff_(0.0), itnum_(0), sepNodes_(0),
-  sepOps_(0), sepVars_(0), sepConst_(0), sepConId_(0),newCons_(0), newVars_(0),
-  objSep_(false), sepStatus_(false), lf_(LinearFunctionPtr()), ub_(0), lb_(0),
-  f_(0), snodes_(0), sops_(0), svars_(0), sconst_(0), on_(), onop_(),
-  nnode_(0), nvar_(0)
+:env_(env), problem_(problem), cst_(0.0), sepConId_(0), newCons_(0),
+  newVars_(0), objSep_(false), sepStatus_(false), lf_(LinearFunctionPtr()),
+  ub_(0), lb_(0), nnode_(0)
 {
   logger_   = (LoggerPtr) new Logger((LogLevel) env_->getOptions()->
                                      findInt("separability_log_level")->
@@ -67,6 +64,29 @@ TransSep::~TransSep()
 }
 
 
+void TransSep::addChild_(const CNode *n, double d, std::vector<double> &wt)
+{
+  VariablePtr v;
+
+  switch (n->getOp()) {
+  case (OpNum):
+  case (OpInt):
+    cst_ += d*n->getVal();
+    break;
+  case (OpVar):
+    v = problem_->getVariable(n->getV()->getId());
+    if (lf_->hasVar(v) == true) {
+      lf_->incTerm(v, d);
+    } else {
+      lf_->addTerm(v, d);
+    }
+    break;
+  default:
+    wt[n->getIndex()] += d;
+  }
+}
+
+
 void TransSep::candCons()
 {
   bool sepStatus;
@@ -77,8 +97,8 @@ void TransSep::candCons()
   std::vector<CGraphPtr > cg;
   std::vector<UInt > nsp; //No. of separable parts in separable constraints
   std::vector<UInt > eqs;// eqs=0 if cons is lb <= f(x), 1 if f(x) <= ub
-  CNodeQ dq; 
-  ConstVariablePtr v;
+  VariablePtr v;
+  UInt first, last;
   std::vector<LinearFunctionPtr > lfnew; //Linear functions of separable cons
   std::vector<LinearFunctionPtr > lfmod; //modified linear fun of cons
   std::vector<CGraphPtr > nlfnew; //Nonlinear function of separable cons
@@ -98,34 +118,20 @@ void TransSep::candCons()
         << " does not have cgraph."<< std::endl;
 #endif
     } else {
-      f_ = true;
-      coeff_ = 1.0;
       ub_ = c_ptr->getUb();
       lb_ = c_ptr->getLb();
       // Perform separability check only if constraint is
       // not in equality form
-      if (ub_ == INFINITY && lb_ != -INFINITY) {
-        eqs.push_back(0);
+      if ((ub_ == INFINITY && lb_ != -INFINITY) ||
+          (ub_ != INFINITY && lb_ == -INFINITY)) {
         if (c_ptr->getLinearFunction()) {
           lf_ = c_ptr->getLinearFunction()->clone();
         } else {
           lf_ = (LinearFunctionPtr) new LinearFunction();
         }
-        nvar_ = f->getNonlinearFunction()->numVars();
-        nnode_ = cgp->getNumNodes();
-        const CNode *o = cgp->getOut();
-        sepStatus = outCheck(o);
-      } else if (ub_ != INFINITY && lb_ == -INFINITY) { 
-        eqs.push_back(1);
-        if (c_ptr->getLinearFunction()) {
-          lf_ = c_ptr->getLinearFunction()->clone();
-        } else {
-          lf_ = (LinearFunctionPtr) new LinearFunction();
-        }
-        nvar_ = f->getNonlinearFunction()->numVars();
-        nnode_ = cgp->getNumNodes();
-        const CNode *o = cgp->getOut();
-        sepStatus = outCheck(o);
+        sepStatus = sepCheck(cgp);
+        lb_ -= cst_;
+        ub_ -= cst_;
       } else {
         sepStatus = false;
       }
@@ -135,14 +141,11 @@ void TransSep::candCons()
     //constraints and add constraints corresponding to the separable parts.
 
     if (sepStatus == true ) {
-      if(sepNodes_.size()>1)  {
-        v = (VariablePtr) new Variable();
-        //Generating cgraph of separable parts
-        //dq contains all the dependent nodes of the cgp
-        dq = cgp->dNodes(); 
+      if (parts_.size()>1)  {
         //vector cg contains cgraph of separable parts.
-        cg = sepCGraph(&dq);
+        cg = sepCGraph();
         nsp.push_back(cg.size());
+        eqs.push_back((lb_ == -INFINITY) ? 1 : 0);
 #if SPEW
         logger_->msgStream(LogDebug) << me_
           <<"No. of separable parts in constraint:" << c_ptr->getName() 
@@ -197,23 +200,21 @@ void TransSep::candCons()
       f.reset();
     }
     //Add new constraints corresponding to separable parts
-    nvar_ = 0; //reusing nvar for counting
-    nnode_ = 0;
+    first = 0;
     for (UInt j=0; j < sepConId_.size() ; j++) {
-      nnode_ = nvar_ + nsp[j];
-      for (UInt i = nvar_; i < nnode_; i++) {
+      last = first + nsp[j];
+      for (UInt i = first; i < last; i++) {
         if (eqs[j] == 0) {
           f = (FunctionPtr) new Function(lfnew[i], nlfnew[i] );
           problem_->newConstraint(f, 0.0, INFINITY);
           f.reset();
-          nvar_++;
         } else {  
           f = (FunctionPtr) new Function(lfnew[i], nlfnew[i] );
           problem_->newConstraint(f, -INFINITY, 0.0);
           f.reset();
-          nvar_++;
         }
       } 
+      first = last;
     }
     lfmod.clear();
     lfnew.clear();
@@ -225,329 +226,85 @@ void TransSep::candCons()
 }
 
 
-void TransSep::clearCont()
-{
-  snodes_.clear();
-  sops_.clear();
-  svars_.clear();
-  sconst_.clear();
-  itnum_.clear(); 
-  sepNodes_.clear();
-  sepOps_.clear();
-  sepVars_.clear();
-  sepConst_.clear();
-  on_=  std::stack<CNode *> ();
-  onop_ = std::stack<int > (); 
-}
-
-
-bool TransSep::clearpopu(UInt *j, std::vector<UInt >*m)
+CNode* TransSep::copyTerm_(CGraphPtr cg, const CNode *n, UInt part,
+                           std::vector<CNode *> &nmap,
+                           std::vector<UInt> &stamp)
 {
-  if (svars_.size() == nvar_) {
-    clearCont(); 
-    return false;  
-  }
-  populate();
-  (*j)++;
-  (*m).push_back(0);
-  return true;
-}
-
-
-void TransSep::createCG(std::vector<CGraphPtr > * cg, CNodeQ * dq)
-{
-  //Generate cgraph of separable parts
-  CNode **childr = 0;
-  UInt k=0, c2=0, f1;
-  CNode *n1, *nl =0;
-
-  for (UInt i=0; i < (*dq).size(); i++) {
-    n1 = (*dq)[i];
-    k = itnum_[n1->getIndex()] ;
-    if (k > 0) { 
-      switch(n1->getOp()) {
-      case (OpAbs):
-      case (OpAcos):
-      case (OpAcosh):
-      case (OpAsin):
-      case (OpAsinh):
-      case (OpAtan):
-      case (OpAtanh):
-      case (OpCeil):
-      case (OpCos):
-      case (OpCosh):
-      case (OpCPow):
-      case (OpExp):
-      case (OpFloor):
-      case (OpLog):
-      case (OpLog10):
-      case (OpRound):
-      case (OpSin):
-      case (OpSinh):
-      case (OpSqr):
-      case (OpTan):
-      case (OpTanh):
-      case (OpUMinus):
-      case (OpSqrt):
-        popuTempN((*cg)[k-1], n1, n1->getOp(),0);
-        break;
-      case (OpDiv):
-      case (OpPowK):
-      case (OpIntDiv):
-      case (OpPlus):
-      case (OpMult):
-      case (OpMinus):
-        popuTempN((*cg)[k-1], n1, n1->getOp(),1);
-        break;
-      case (OpNone):
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-      << std::endl;
-#endif
-        assert(!"warning: encountered node with opcode OpNode.");
-        break; 
-      case (OpNum):
-      case (OpInt):
-      case (OpVar):
-        break;
-      case (OpPow):
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpPow is not implemented."
-      << std::endl;
-#endif 
-        assert(!"not implemented!");
-        break;
-      case (OpSumList):
-        f1 = n1->numChild();
-        childr = new Minotaur::CNode *[f1];
-        c2=0;
-        for (CNode **it=n1->getListL(); it!=n1->getListR(); ++it) {
-          nl = *it;
-          childr[c2]=tempN_[nl->getIndex()];
-          c2++;
-        }
-        tempN_[n1->getIndex()]=(*cg)[k-1]->
-          newNode(Minotaur::OpSumList,childr,f1);
-        delete []childr;
-        break;
-      default:
-#if SPEW
-    logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-      << std::endl;
-#endif
-        assert(!"cannot evaluate!");
-      }
+  std::stack<const CNode *> st;
+  std::vector<CNode *> childr;
+  const CNode *n1;
+  CNode **it;
+  UInt k;
+  bool ready;
+
+  // copy children before their parents.
+  st.push(n);
+  while (!st.empty()) {
+    n1 = st.top();
+    k = n1->getIndex();
+    if (stamp[k] == part) {
+      st.pop();
+      continue;
     }
-  }
-  itnum_.clear();
-  (*dq).clear();
-}
-
-
-void TransSep::depthFS(int j, CNode *n1, std::vector<UInt > *m)
-{
-  std::stack<CNode *> tempNodes;
-  CNode *n=0, *n2=0;
-  int mNum;
-  tempPop(n1, &tempNodes);
-
-  while (tempNodes.size() != 0) {
-    n=tempNodes.top();
-    if (itnum_[n->getIndex()] == 0) {
-      switch(n->getOp()){
-      case (OpAbs):
-      case (OpAcos):
-      case (OpAcosh):
-      case (OpAsin):
-      case (OpAsinh):
-      case (OpAtan):
-      case (OpAtanh):
-      case (OpCeil):
-      case (OpCos):
-      case (OpCosh):
-      case (OpCPow):
-      case (OpExp):
-      case (OpFloor):
-      case (OpLog):
-      case (OpLog10):
-      case (OpRound):
-      case (OpSin):
-      case (OpSinh):
-      case (OpSqr):
-      case (OpTan):
-      case (OpTanh):
-      case (OpUMinus):
-      case (OpSqrt):
-        tempNodes.pop();
-        tempNodes.push(n->getL());
-        itnum_[n->getIndex()]=j+1;
-        break;
-      case (OpDiv):
-      case (OpPowK):
-      case (OpPlus):
-      case (OpMult):
-      case (OpMinus):
-      case (OpIntDiv):
-        tempNodes.pop();
-        tempNodes.push(n->getR());
-        tempNodes.push(n->getL());
-        itnum_[n->getIndex()]=j+1;
-        break;
-      case (OpNum):
-      case (OpInt):
-        tempNodes.pop();
-        sconst_.push_back(n);
-        break;
-      case (OpVar):
-        tempNodes.pop();
-        svars_.push_back(n);
-        itnum_[n->getIndex()]=j+1;
-        break;
-      case (OpPow):
-#if SPEW
-        logger_->msgStream(LogDebug2) << me_ 
-          << "Opcode OpPow is not implemented."<< std::endl;
-#endif
-        assert(!"not implemented!");
-        break;
-      case (OpNone):
-#if SPEW
-      
-        logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-          << std::endl;
-#endif 
-        assert(!"warning: encountered node with opcode OpNode.");
-        break;
-      case (OpSumList):
-        tempNodes.pop();
-        for (CNode **it=n->getListL(); it!=n->getListR(); ++it) {
-          n2 = *it;
-          tempNodes.push(n2);
+    switch (n1->getOp()) {
+    case (OpVar):
+      nmap[k] = cg->newNode(problem_->getVariable(n1->getV()->getId()));
+      break;
+    case (OpNum):
+      nmap[k] = cg->newNode(n1->getVal());
+      break;
+    case (OpInt):
+      nmap[k] = cg->newNode((int) n1->getVal());
+      break;
+    default:
+      ready = true;
+      if (n1->numChild() > 2 || OpSumList == n1->getOp()) {
+        for (it=n1->getListL(); it!=n1->getListR(); ++it) {
+          if (stamp[(*it)->getIndex()] != part) {
+            st.push(*it);
+            ready = false;
+          }
+        }
+        if (ready) {
+          childr.clear();
+          for (it=n1->getListL(); it!=n1->getListR(); ++it) {
+            childr.push_back(nmap[(*it)->getIndex()]);
+          }
+          nmap[k] = cg->newNode(n1->getOp(), &childr[0], n1->numChild());
         }
-        itnum_[n->getIndex()]=j+1;
-        break;
-      default:
-#if SPEW
-      
-        logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-          << std::endl;
-#endif
-        assert(!"cannot evaluate!");
-      }
-    } else {
-      if (itnum_[n->getIndex()] == j+1) {
-        tempNodes.pop();      
       } else {
-        mNum=mergeIt(j, itnum_[n->getIndex()], m);
-        if (mNum > -1) { 
-          //mNum = -1 if a node is encountered twice in an iteration
-          merge(mNum);
+        if (stamp[n1->getL()->getIndex()] != part) {
+          st.push(n1->getL());
+          ready = false;
         }
-        tempNodes.pop();      
+        if (n1->getR() && stamp[n1->getR()->getIndex()] != part) {
+          st.push(n1->getR());
+          ready = false;
+        }
+        if (ready) {
+          nmap[k] = cg->newNode(n1->getOp(), nmap[n1->getL()->getIndex()],
+                                n1->getR() ? nmap[n1->getR()->getIndex()] :
+                                0);
+        }
+      }
+      if (!ready) {
+        continue;
       }
     }
+    stamp[k] = part;
+    st.pop();
   }
+  return nmap[n->getIndex()];
 }
 
 
-void TransSep::explore (int j, CNode *n1, std::vector<UInt > *m, int opc)
+UInt TransSep::find_(std::vector<UInt> &par, UInt i)
 {
-  UInt mNum;
-  if (itnum_[n1->getIndex()]==0) {
-    itnum_[n1->getIndex()]=j+1;
-    snodes_.push_back(n1);
-    sops_.push_back(opc);
-    depthFS(j, n1, m);
-    on_.pop();
-    onop_.pop();
-  } else {
-    snodes_.push_back(n1);
-    sops_.push_back(opc);
-    mNum=mergeIt(j, itnum_[n1->getIndex()], m);
-    merge(mNum);
-    on_.pop();
-    onop_.pop();
+  while (par[i] != i) {
+    par[i] = par[par[i]];
+    i = par[i];
   }
-}
-
-
-void TransSep::finalCG(std::vector<CGraphPtr > * cg)
-{
-  UInt c2=0, c3=0, f1;
-  CNode **childr = 0;
-  CNode * n1=0, *nl =0, *n2=0, *nr=0;
-
-  for (UInt i=0; i < sepNodes_.size(); i++) {
-    f1 = sepNodes_[i].size();
-    if (f1 == 1) {
-      if (sepOps_[i][0] == 1) {
-        nl = sepNodes_[i][0];
-        n1 = tempN_[nl->getIndex()];
-      } else {
-        nl = tempN_[sepNodes_[i][0]->getIndex()];
-        n1 = (*cg)[i]->newNode(Minotaur::OpUMinus, nl, 0);
-      }
-    } else if (f1 == 2) {
-      if (sepOps_[i][0] == sepOps_[i][1] && sepOps_[i][0] == 1) {
-        c2 = sepNodes_[i][0]->getIndex();
-        nl = tempN_[c2];
-        c2 = sepNodes_[i][1]->getIndex();
-        nr = tempN_[c2];
-        n1 = (*cg)[i]->newNode(Minotaur::OpPlus, nl, nr);
-      }
-      if (sepOps_[i][0] == sepOps_[i][1] && sepOps_[i][0] == -1) {
-        c2 = sepNodes_[i][0]->getIndex();
-        n2 = tempN_[c2];
-        nl = (*cg)[i]->newNode(Minotaur::OpUMinus, n2, 0);
-        c2 = sepNodes_[i][1]->getIndex();
-        n2 = tempN_[c2];
-        nr = (*cg)[i]->newNode(Minotaur::OpUMinus, n2, 0);
-        n1 = (*cg)[i]->newNode(Minotaur::OpPlus, nl, nr); 
-      }
-      if (sepOps_[i][0] != sepOps_[i][1] && sepOps_[i][0] == 1) {
-        c2 = sepNodes_[i][0]->getIndex();
-        nl = tempN_[c2];
-        c2 = sepNodes_[i][1]->getIndex();
-        nr = tempN_[c2];
-        n1 = (*cg)[i]->newNode(Minotaur::OpMinus, nl, nr);
-      }
-      if (sepOps_[i][0] != sepOps_[i][1] && sepOps_[i][0] == -1) {
-        c2 = sepNodes_[i][0]->getIndex();
-        nr= tempN_[c2];
-        c2 = sepNodes_[i][1]->getIndex();
-        nl = tempN_[c2];
-        n1 = (*cg)[i]->newNode(Minotaur::OpMinus, nl, nr);       
-      }
-    } else {  
-      childr = new Minotaur::CNode *[f1];
-      c2=0;
-      for(UInt j=0; j<sepNodes_[i].size(); j++) {
-        if (sepOps_[i][j] == 1) {
-          c3 = sepNodes_[i][j]->getIndex();
-          childr[c2]=tempN_[c3];
-          c2++;     
-        } else {
-          c3 = sepNodes_[i][j]->getIndex();
-          n1 = tempN_[c3];
-          childr[c2]=(*cg)[i]->newNode(Minotaur::OpUMinus, n1, 0);     
-          c2++;
-        }
-      }
-      n1 = (*cg)[i]->newNode(Minotaur::OpSumList, childr, f1);          
-      delete []childr;
-    }
-    if (coeff_ != 1.0) {
-      nl = (*cg)[i]->newNode(coeff_);          
-      nr = n1;
-      n1 = (*cg)[i]->newNode(Minotaur::OpMult, nl, nr);          
-    } 
-    (*cg)[i]->setOut(n1);
-    (*cg)[i]->finalize();
-  }
-  sepNodes_.clear();
-  sepVars_.clear();
-  sepOps_.clear();
-  tempN_.clear();
+  return i;
 }
 
 
@@ -582,156 +339,6 @@ bool TransSep::getStatus()
 }
 
 
-void TransSep::markVis(UInt i)
-{
-  CNode *n1=0, *n2=0;
-  std::stack<CNode * > ts;
-
-  for(UInt j=0; j<sepNodes_[i].size(); j++) {
-    n1 = sepNodes_[i][j];
-    ts.push(n1);
-    while (ts.size() != 0) {
-      n1 = ts.top();
-      switch(n1->getOp()){
-      case (OpAbs):
-      case (OpAcos):
-      case (OpAcosh):
-      case (OpAsin):
-      case (OpAsinh):
-      case (OpAtan):
-      case (OpAtanh):
-      case (OpCeil):
-      case (OpCos):
-      case (OpCosh):
-      case (OpCPow):
-      case (OpExp):
-      case (OpFloor):
-      case (OpLog):
-      case (OpLog10):
-      case (OpRound):
-      case (OpSin):
-      case (OpSinh):
-      case (OpSqr):
-      case (OpTan):
-      case (OpTanh):
-      case (OpUMinus):
-      case (OpSqrt):
-        itnum_[n1->getIndex()] = i+1;
-        ts.pop();
-        if (itnum_[n1->getL()->getIndex()] == 0) { 
-          ts.push(n1->getL());
-        }
-        break;
-      case (OpDiv):
-      case (OpPlus):
-      case (OpMult):
-      case (OpMinus):
-        itnum_[n1->getIndex()] = i+1;
-        ts.pop();
-        if (itnum_[n1->getL()->getIndex()] == 0) { 
-          ts.push(n1->getL());
-        }
-        if (itnum_[n1->getR()->getIndex()] == 0) { 
-          ts.push(n1->getR());
-        }
-        break;
-      case (OpPowK):
-      case (OpIntDiv):
-        itnum_[n1->getIndex()] = i+1;
-        ts.pop();
-        if (itnum_[n1->getL()->getIndex()] == 0) { 
-          ts.push(n1->getL());
-        }
-        ts.push(n1->getR());
-        break;
-      case (OpNone):
-#if SPEW
-        logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-          << std::endl;
-#endif
-        assert(!"warning: encountered node with opcode OpNone");
-        break; 
-      case (OpNum):
-      case (OpInt):
-      case (OpVar):
-        ts.pop();
-        break;
-      case (OpPow):
-#if SPEW
-        logger_->msgStream(LogDebug2) << me_ 
-          << "Opcode OpPow is not implemented." << std::endl;
-#endif 
-        assert(!"not implemented!");
-        break;
-      case (OpSumList):
-        itnum_[n1->getIndex()] = i+1;
-        ts.pop();
-        for (CNode **it=n1->getListL(); it!=n1->getListR(); ++it) {
-          n2 = *it;
-          if (itnum_[n2->getIndex()] == 0) { 
-            ts.push(n2);
-          }
-        }           
-        break;
-      default:
-#if SPEW
-        logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-          << std::endl;
-#endif
-        assert(!"cannot evaluate!");
-      }
-    }
-  }
-}
-
-
-void TransSep::merge(int mNum)
-{
-  if (sepNodes_[mNum][0]->getIndex() > snodes_[0]->getIndex()) {
-    snodes_.push_front(sepNodes_[mNum][0]);
-    sops_.push_front(sepOps_[mNum][0]);
-    for(UInt i=1; i<sepNodes_[mNum].size(); i++) {
-      snodes_.push_back(sepNodes_[mNum][i]);
-      sops_.push_back(sepOps_[mNum][i]);
-    }
-  } else {
-    for(UInt i=0; i<sepNodes_[mNum].size(); i++) {
-      snodes_.push_back(sepNodes_[mNum][i]);
-      sops_.push_back(sepOps_[mNum][i]);
-    }
-  }
-
-  sepNodes_[mNum].clear();
-  sepOps_[mNum].clear();
-
-  for(UInt i=0; i<sepVars_[mNum].size(); i++) {
-    svars_.push_back(sepVars_[mNum][i]);
-  }
-  sepVars_[mNum].clear();
-
-  for(UInt i=0; i<sepConst_[mNum].size(); i++) {
-    sconst_.push_back(sepConst_[mNum][i]);
-  }
-  sepConst_[mNum].clear();
-}
-
-
-int TransSep::mergeIt(int j, int a, std::vector<UInt > * m)
-{
-  int b;
-  if ((*m)[a-1] == 0) {
-    (*m)[a-1]=j+1;
-    return (a-1);
-  } else if ((*m)[a-1] == (UInt) j+1) {
-    return -1;
-  } else {
-    b=(*m)[a-1];
-    (*m)[a-1]=j+1;
-    return mergeIt(j, b, m); 
-  }
-}
-
-
 void TransSep::objSepCheck()
 {
   bool sepStatus;
@@ -740,9 +347,7 @@ void TransSep::objSepCheck()
   LinearFunctionPtr lf1;
   CGraphPtr cgp;
   std::vector<CGraphPtr > cg; 
-  std::vector<UInt > nsp;//No. of separable parts in each separable constraints
-  CNodeQ dq; 
-  ConstVariablePtr v;
+  VariablePtr v;
   ObjectivePtr obj;
   obj = problem_->getObjective();
   f = obj->getFunction();
@@ -755,28 +360,18 @@ void TransSep::objSepCheck()
       << " does not have cgraph."<< std::endl;
 #endif
   } else {
-    f_ = false;
-    coeff_ = 1.0;
-    ub_ = 0.0;
     if ( obj->getLinearFunction()) {
-      lf_ = obj->getLinearFunction(); 
+      lf_ = obj->getLinearFunction()->clone(); 
     } else {
       lf_ = (LinearFunctionPtr) new LinearFunction();
     }
-    nvar_ = f->getNonlinearFunction()->numVars();
-    nnode_ = cgp->getNumNodes();
-    const CNode *o = cgp->getOut();
-    sepStatus = outCheck(o);
+    sepStatus = sepCheck(cgp);
   }
   
   if (sepStatus == true ) {
-    if(sepNodes_.size()>1)  {
+    if (parts_.size()>1)  {
       objSep_=true;
-      //Generate cgraph of separable parts
-      dq = cgp->dNodes(); //dq contains all the dependent nodes of the cgp
-      cg = sepCGraph(&dq); //cg contains cgraph of separable parts
-      nsp.push_back(cg.size());
-      v = (VariablePtr) new Variable();
+      cg = sepCGraph(); //cg contains cgraph of separable parts
       for(UInt i=0; i < cg.size(); i++) {
         v = problem_->newVariable(VarTran);
         lf1 = (LinearFunctionPtr) new LinearFunction();
@@ -795,7 +390,7 @@ void TransSep::objSepCheck()
       //Remove old objective and adding a new one
       problem_->removeObjective();
       f = (FunctionPtr) new Function(lf_);
-      problem_->newObjective(f,(obj->getConstant()+ub_),obj->getObjectiveType());
+      problem_->newObjective(f,(obj->getConstant()+cst_),obj->getObjectiveType());
       lf_.reset();
     }  else {
 #if SPEW
@@ -805,7 +400,7 @@ void TransSep::objSepCheck()
       //Remove old objective and adding a new one
       problem_->removeObjective();
       f = (FunctionPtr) new Function(lf_);
-      problem_->newObjective(f,(obj->getConstant()+ub_),obj->getObjectiveType());
+      problem_->newObjective(f,(obj->getConstant()+cst_),obj->getObjectiveType());
       lf_.reset();
     } 
   } else {
@@ -817,536 +412,222 @@ void TransSep::objSepCheck()
 } 
 
 
-bool TransSep::outCheck(const CNode * o)
+std::vector<CGraphPtr> TransSep::sepCGraph()
 {
-  CNode * n1=0;
-
-  switch(o->getOp()){
-  case (OpPlus):
-    on_.push(o->getL());
-    onop_.push(1);
-    on_.push(o->getR());
-    onop_.push(1);
-    return  sepCheck();
-    break;
-  case (OpMinus):
-    on_.push(o->getL());
-    onop_.push(1);  
-    on_.push(o->getR());
-    onop_.push(-1); 
-    return  sepCheck();
-    break;
-  case (OpSumList):
-    for (CNode **it=o->getListL(); it!=o->getListR(); ++it) {
-      n1 = *it;
-      on_.push(n1);
-      onop_.push(1);
-    }  
-    return  sepCheck();
-    break;
-  case (OpUMinus):
-    coeff_ = coeff_*(-1);
-    return  outCheck(o->getL());
-    break;
-  case (OpPowK):
-    if (o->getR()->getVal() == 1.0) {
-      return  outCheck(o->getL());
-      break;
-    } else {
-      return false;
-    }
-  case (OpIntDiv):
-    coeff_ = coeff_ *(1/ (o->getR()->getVal()));
-    return  outCheck(o->getL());
-    break;
-  case (OpAbs):
-  case (OpAcos):
-  case (OpAcosh):
-  case (OpAsin):
-  case (OpAsinh):
-  case (OpAtan):
-  case (OpAtanh):
-  case (OpCeil):
-  case (OpCos):
-  case (OpCosh):
-  case (OpCPow):
-  case (OpExp):
-  case (OpFloor):
-  case (OpLog):
-  case (OpLog10):
-  case (OpRound):
-  case (OpSin):
-  case (OpSinh):
-  case (OpSqr):
-  case (OpTan):
-  case (OpTanh):
-  case (OpSqrt):
-  case (OpNum):
-  case (OpInt):
-  case (OpVar):
-    return false;
-    break;
-  case (OpDiv):
-    if (o->getR()->getOp() == OpNum || o->getR()->getOp() == OpInt) {
-      coeff_ = coeff_ *(1/ (o->getR()->getVal()));
-      return  outCheck(o->getL());
-    } else {
-      return false;    
+  std::vector<CGraphPtr> cgs;
+  std::vector<CNode *> nmap(nnode_, 0);
+  std::vector<UInt> stamp(nnode_, 0);
+  std::vector<CNode *> childr;
+  CGraphPtr cg;
+  CNode *n1 = 0;
+  double d;
+
+  for (UInt i=0; i < parts_.size(); ++i) {
+    cg = (CGraphPtr) new CGraph();
+    childr.clear();
+    for (SepPart::iterator it=parts_[i].begin(); it!=parts_[i].end();
+         ++it) {
+      n1 = copyTerm_(cg, it->first, i+1, nmap, stamp);
+      d = it->second;
+      if (d == 1.0) {
+        childr.push_back(n1);
+      } else if (d == -1.0) {
+        childr.push_back(cg->newNode(Minotaur::OpUMinus, n1, 0));
+      } else {
+        childr.push_back(cg->newNode(Minotaur::OpMult, cg->newNode(d), n1));
+      }
     }
-    break;
-  case (OpMult):
-    if (o->getR()->getOp() == OpNum || o->getR()->getOp() == OpInt) {
-      coeff_ =coeff_ * (o->getR()->getVal());
-      return  outCheck(o->getL());
-    } else if (o->getL()->getOp() == OpNum || o->getL()->getOp() == OpInt) {
-      coeff_ =coeff_*( o->getL()->getVal());
-      return  outCheck(o->getR());
+    if (childr.size() == 1) {
+      n1 = childr[0];
+    } else if (childr.size() == 2) {
+      n1 = cg->newNode(Minotaur::OpPlus, childr[0], childr[1]);
     } else {
-      return false;    
-    }
-    break;
-  case (OpPow):
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpPow is not implemented."
-      << std::endl;
-#endif 
-    assert(!"not implemented!");
-    return false;
-    break;
-  case (OpNone):
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-      << std::endl;
-#endif
-    assert(!"warning: encountered node with opcode OpNode.");
-    return false;
-    break;
-  default:
-#if SPEW
-    logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-      << std::endl;
-#endif
-    assert(!"cannot evaluate!");
-    return false;
-    break;
-  }
-  return false;
-}
-
-
-void TransSep::populate()
-{
-  sepNodes_.push_back(snodes_) ;
-  sepOps_.push_back(sops_) ;
-  sepVars_.push_back(svars_) ;
-  sepConst_.push_back(sconst_) ;
-
-  snodes_.clear();
-  sops_.clear();
-  svars_.clear();
-  sconst_.clear();
-}
-
-
-void TransSep::popuTempN(CGraphPtr c, CNode *n1, OpCode op, bool k)
-{
-  CNode * nl;
-  if (k) {
-    CNode * nr;
-    nl = getLchild(n1);
-    nr = getRchild(n1);
-    tempN_[n1->getIndex()]= c->newNode(op, nl, nr);   
-  } else {
-    nl = getLchild(n1);
-    tempN_[n1->getIndex()] = c->newNode(op, nl, 0);          
-  }
-}
-
-
-void TransSep::popuon(CNode * n1, int opc, int t)
-{
-  on_.pop();
-  onop_.pop();
-  on_.push(n1->getL());
-  onop_.push(opc);
-  on_.push(n1->getR());
-  onop_.push(opc*t); //t takes into account opcode sign
-}
-
-
-std::vector<CGraphPtr> TransSep::sepCGraph(CNodeQ * dq)
-{
-  for(UInt i=0; i < nnode_; i++) {
-    itnum_.push_back(0);
-    tempN_.push_back(NULL);
-  }
-
-  CNode * n1;
-  std::vector<CGraphPtr> cg;
-  UInt k=0;
- 
-  for(UInt i=0; i < sepNodes_.size(); ) {
-    CGraphPtr t =(CGraphPtr) new CGraph();
-    for (UInt j=0; j < sepVars_[i].size(); j++) {
-      k = sepVars_[i][j]->getIndex();
-      tempN_[k] = t->newNode(problem_->
-                             getVariable(sepVars_[i][j]->getV()->getId()));
-      itnum_[k]= i+1; //n1 is in separable part i+1
+      n1 = cg->newNode(Minotaur::OpSumList, &childr[0], childr.size());
     }
-    //Add constant nodes to the cgraph directly
-    for (UInt j=0; j < sepConst_[i].size(); j++) {
-      n1 = sepConst_[i][j];
-      k = n1->getIndex();
-      tempN_[k] = t->newNode(n1->getLb());
-      itnum_[k]= i+1; 
-    } 
-    //Mark the dependent nodes as to which separable part they belong.
-    markVis(i);
-    cg.push_back(t);
-    t.reset();
-    i++;
+    cg->setOut(n1);
+    cg->finalize();
+    cgs.push_back(cg);
   }
-  sepConst_.clear();
-  createCG(&cg, dq);
-  finalCG(&cg);
-  return cg;
+  parts_.clear();
+  return cgs;
 }
 
 
-bool TransSep::sepCheck()
+bool TransSep::sepCheck(CGraphPtr cg)
 {
-  CNode *n1 = 0, *n2 =0;
-  int opc;
-  UInt  j=0; //j is iteration counter
-  std::vector<UInt > m;  //Variable m is used in merge operation
-  m.push_back(0);
-
-  for(UInt i=0; i < nnode_; i++) {
-    itnum_.push_back(0);
-  }
-
-  while (on_.size() != 0) {
-    n1=on_.top();
-    opc=onop_.top();
-    switch (n1->getOp()){ 
-    case (OpNum):
-    case (OpInt):
-      {
-        // Update lower and upper bounds of the constraint
-        // or constant term in case of objective
-        double d1 = n1->getVal();
-        if (f_ == 1) {
-          if (d1 > 0) {
-            ub_ = ub_ - (opc * coeff_ * d1);
-            lb_ = lb_ - (opc * coeff_ * d1); 
-          } else {
-            lb_ = lb_ + (opc * coeff_ * d1); 
-            ub_ = ub_ + (opc * coeff_ * d1);
-          }
-        } else {
-          ub_ = ub_ + (opc * coeff_ * d1);
-        }
-        on_.pop();
-        onop_.pop();
+  CNodeQ dq = cg->dNodes();
+  std::vector<double> wt;
+  std::vector<bool> interm, hasvar;
+  std::vector<UInt> par, pnum;
+  std::vector<const CNode *> terms;
+  SepPart freeterms;
+  const CNode *n1;
+  CNode *nl, *nr;
+  CNode **it;
+  UInt k, r;
+  double d;
+
+  nnode_ = cg->getNumNodes();
+  cst_ = 0.0;
+  parts_.clear();
+  wt.resize(nnode_, 0.0);
+  interm.resize(nnode_, false);
+  hasvar.resize(nnode_, false);
+
+  // Go down the sum: dq has children before parents, so in reverse every
+  // node gets all its weight before it is visited. Nodes that are not sums
+  // or products with constants become terms; nodes below a term are marked.
+  addChild_(cg->getOut(), 1.0, wt);
+  for (CNodeQ::reverse_iterator rit=dq.rbegin(); rit!=dq.rend(); ++rit) {
+    n1 = *rit;
+    k = n1->getIndex();
+    d = wt[k];
+    nl = n1->getL();
+    nr = n1->getR();
+    if (d != 0.0) {
+      switch (n1->getOp()) {
+      case (OpPlus):
+        addChild_(nl, d, wt);
+        addChild_(nr, d, wt);
         break;
-      }
-    case (OpVar):
-      //Update the linear part of the function
-      {
-        VariablePtr v;
-        v = problem_->getVariable(n1->getV()->getId());
-        updateLin(v, opc*coeff_);
+      case (OpMinus):
+        addChild_(nl, d, wt);
+        addChild_(nr, -d, wt);
         break;
-      }
-    case (OpPlus):
-      if (itnum_[n1->getIndex()]==0) {
-        popuon(n1, opc, 1);
-      } else {
-        bool sep = visited(&j, &m, n1, opc);
-        if (!sep)
-          return false;        
-      }
-      break;
-    case (OpMinus):
-      if (itnum_[n1->getIndex()]==0) {
-        popuon(n1, opc, -1);
-      } else {
-        bool sep = visited(&j, &m, n1, opc);
-        if (!sep)
-          return false;        
-      }
-      break;
-    case (OpSumList):
-      if (itnum_[n1->getIndex()]==0) {
-        on_.pop();
-        onop_.pop();
-        for (CNode **it=n1->getListL(); it!=n1->getListR(); ++it) {
-          n2 = *it;
-          on_.push(n2);
-          onop_.push(opc);
-        } 
-      } else {
-        bool sep = visited(&j, &m, n1, opc);
-        if (!sep)
-          return false;        
-      }
-      break; 
-    case (OpUMinus):
-      if (itnum_[n1->getIndex()]==0) {
-        on_.pop();
-        onop_.pop();
-        on_.push(n1->getL());
-        onop_.push(opc*(-1));
-      } else {
-        bool sep = visited(&j, &m, n1, opc);
-        if (!sep)
-          return false;        
-      }
-      break;
-    case (OpAbs):
-    case (OpAcos):
-    case (OpAsin):
-    case (OpAsinh):
-    case (OpAtan):
-    case (OpAtanh):
-    case (OpCeil):
-    case (OpCos):
-    case (OpCosh):
-    case (OpCPow):
-    case (OpExp):
-    case (OpFloor):
-    case (OpLog):
-    case (OpLog10):
-    case (OpRound):
-    case (OpSin):
-    case (OpSinh):
-    case (OpSqr):
-    case (OpTan):
-    case (OpTanh):
-    case (OpSqrt):
-      explore(j, n1, &m, opc);
-      if (clearpopu(&j, &m) == false ){
-        return false;      
-      }
-      //clearpopu(&j, &m);
-      break;
-    case (OpMult):
-      if (n1->getL()->getOp() == OpNum || n1->getL()->getOp() == OpInt) {
-        if (n1->getR()->getOp() == OpVar){
-          VariablePtr v;
-          v = problem_->getVariable(n1->getR()->getV()->getId());
-          updateLin(v, ((n1->getL()->getVal())*opc*coeff_));
-          break;       
+      case (OpUMinus):
+        addChild_(nl, -d, wt);
+        break;
+      case (OpSumList):
+        for (it=n1->getListL(); it!=n1->getListR(); ++it) {
+          addChild_(*it, d, wt);
+        }
+        break;
+      case (OpMult):
+        if (nl->getOp() == OpNum || nl->getOp() == OpInt) {
+          addChild_(nr, d*nl->getVal(), wt);
+        } else if (nr->getOp() == OpNum || nr->getOp() == OpInt) {
+          addChild_(nl, d*nr->getVal(), wt);
         } else {
-          explore(j, n1, &m, opc);
+          interm[k] = true;
+          terms.push_back(n1);
         }
-      } else if (n1->getR()->getOp() == OpNum || n1->getR()->getOp() == OpInt){
-        if (n1->getL()->getOp() == OpVar){
-          VariablePtr v;
-          v = problem_->getVariable(n1->getL()->getV()->getId());
-          updateLin(v, ((n1->getR()->getVal())*opc*coeff_));
-          break;       
+        break;
+      case (OpDiv):
+        if (nr->getOp() == OpNum || nr->getOp() == OpInt) {
+          addChild_(nl, d/nr->getVal(), wt);
         } else {
-          explore(j, n1, &m, opc);
+          interm[k] = true;
+          terms.push_back(n1);
         }
-      } else {
-        explore(j, n1, &m, opc);
-      }
-      if (clearpopu(&j, &m) == false ){
-        return false;      
-      }
-      //clearpopu(&j, &m);
-      break;
-    case (OpDiv):
-      if (n1->getR()->getOp() == OpNum || n1->getR()->getOp() == OpInt){
-        if (n1->getL()->getOp() == OpVar){
-          VariablePtr v;
-          v = problem_->getVariable(n1->getL()->getV()->getId());
-          updateLin(v,  (opc*coeff_)/(n1->getR()->getVal()));
-          break;       
+        break;
+      case (OpPowK):
+        if (nr->getVal() == 1.0) {
+          addChild_(nl, d, wt);
         } else {
-          explore(j, n1, &m, opc);
+          interm[k] = true;
+          terms.push_back(n1);
         }
-      } else {
-        explore(j, n1, &m, opc);
-      }
-      if (clearpopu(&j, &m) == false ){
-        return false;      
-      }
-      //clearpopu(&j, &m);
-      break;
-    case (OpPowK):
-      if (n1->getR()->getVal() == 1.0 || n1->getL()->getOp() == OpVar) {
-        VariablePtr v;
-        v = problem_->getVariable(n1->getL()->getV()->getId());
-        updateLin(v, opc*coeff_);
-        break;      
-      } else {
-        explore(j, n1, &m, opc);
-      }
-      if (clearpopu(&j, &m) == false ){
-        return false;      
-      }
-      //clearpopu(&j, &m);
-      break;
-    case (OpIntDiv):
-      if (n1->getL()->getOp() == OpVar){
-        VariablePtr v;
-        v = problem_->getVariable(n1->getL()->getV()->getId());
-        updateLin(v,  (opc*coeff_)/(n1->getR()->getVal()));
-        break;       
-      } else {
-        explore(j, n1, &m, opc);
-      }
-      
-      if (clearpopu(&j, &m) == false ){
-        return false;      
-      }
-      //clearpopu(&j, &m);
-      break;
-    case (OpNone):
+        break;
+      case (OpNone):
 #if SPEW
-      logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-        << std::endl;
+        logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
+          << std::endl;
 #endif
-      assert(!"warning: encountered a node with opcode OpNone");
-      break;
-    case (OpPow):
-#if SPEW
-      logger_->msgStream(LogDebug2) << me_ 
-        << "Opcode OpPow is not implemented."<< std::endl;
-#endif 
-      assert(!"warning: not implemented node with opcode OpPow");
-      break;
-    default:
+        assert(!"warning: encountered a node with opcode OpNone");
+        return false;
+      case (OpPow):
 #if SPEW
-      logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-        << std::endl;
+        logger_->msgStream(LogDebug2) << me_ 
+          << "Opcode OpPow is not implemented."<< std::endl;
 #endif 
-      assert(!"cannot evaluate!");
-      break;
+        assert(!"warning: not implemented node with opcode OpPow");
+        return false;
+      default:
+        interm[k] = true;
+        terms.push_back(n1);
+        break;
+      }
+    }
+    if (interm[k]) {
+      if (n1->numChild() > 2 || OpSumList == n1->getOp()) {
+        for (it=n1->getListL(); it!=n1->getListR(); ++it) {
+          interm[(*it)->getIndex()] = true;
+        }
+      } else {
+        interm[nl->getIndex()] = true;
+        if (nr) {
+          interm[nr->getIndex()] = true;
+        }
+      }
     }
   }
-  itnum_.clear();
-  m.clear();
 
-  //Clear sepNodes_ by removing zero entries formed during
-  //merge operation
-  for(UInt i=0; i < sepNodes_.size(); ) {
-    if (sepNodes_[i].size() == 0) {
-      sepNodes_.erase(sepNodes_.begin()+i);  
-      sepOps_.erase(sepOps_.begin()+i);  
-      sepVars_.erase(sepVars_.begin()+i);  
-      sepConst_.erase(sepConst_.begin()+i);  
+  // Go up the terms and join each node with its children that have
+  // variables.
+  par.resize(nnode_);
+  for (k=0; k < nnode_; ++k) {
+    par[k] = k;
+  }
+  for (CNodeQ::iterator qit=dq.begin(); qit!=dq.end(); ++qit) {
+    n1 = *qit;
+    k = n1->getIndex();
+    if (!interm[k]) {
+      continue;
+    }
+    if (n1->numChild() > 2 || OpSumList == n1->getOp()) {
+      for (it=n1->getListL(); it!=n1->getListR(); ++it) {
+        r = (*it)->getIndex();
+        if ((*it)->getOp() == OpVar || hasvar[r]) {
+          hasvar[k] = true;
+          par[find_(par, r)] = find_(par, k);
+        }
+      }
     } else {
-      i++;
+      for (UInt i=0; i < n1->numChild(); ++i) {
+        nl = (0 == i) ? n1->getL() : n1->getR();
+        r = nl->getIndex();
+        if (nl->getOp() == OpVar || hasvar[r]) {
+          hasvar[k] = true;
+          par[find_(par, r)] = find_(par, k);
+        }
+      }
     }
   }
-  //Continue separability detection only if searable parts are
+
+  // Terms with the same root are in the same part. Terms without variables
+  // go to the first part.
+  pnum.resize(nnode_, nnode_);
+  for (std::vector<const CNode *>::iterator tit=terms.begin();
+       tit!=terms.end(); ++tit) {
+    k = (*tit)->getIndex();
+    if (!hasvar[k]) {
+      freeterms.push_back(SepTerm(*tit, wt[k]));
+      continue;
+    }
+    r = find_(par, k);
+    if (pnum[r] == nnode_) {
+      pnum[r] = parts_.size();
+      parts_.push_back(SepPart());
+    }
+    parts_[pnum[r]].push_back(SepTerm(*tit, wt[k]));
+  }
+  if (!freeterms.empty()) {
+    if (parts_.empty()) {
+      parts_.push_back(SepPart());
+    }
+    parts_[0].insert(parts_[0].end(), freeterms.begin(), freeterms.end());
+  }
+
+  //Continue separability detection only if separable parts are
   //more than one.
-  if (sepNodes_.size() == 1) {
+  if (parts_.size() == 1) {
     logger_->msgStream(LogDebug2) << me_ << "function under consideration" 
       << " has only one nonlinear term."
       << std::endl;
+    parts_.clear();
     return false;
-  } else
-    return true;
-}
-
-
-void TransSep::tempPop(CNode *n1, std::stack<CNode *> * tempNodes)
-{
-  CNode *n=0;
-  switch(n1->getOp()){
-  case (OpAbs):
-  case (OpAcos):
-  case (OpAcosh):
-  case (OpAsin):
-  case (OpAsinh):
-  case (OpAtan):
-  case (OpAtanh):
-  case (OpCeil):
-  case (OpCos):
-  case (OpCosh):
-  case (OpCPow):
-  case (OpExp):
-  case (OpFloor):
-  case (OpLog):
-  case (OpLog10):
-  case (OpRound):
-  case (OpSin):
-  case (OpSinh):
-  case (OpSqr):
-  case (OpTan):
-  case (OpTanh):
-  case (OpUMinus):
-  case (OpSqrt):
-    (*tempNodes).push(n1->getL());
-    break;
-  case (OpDiv):
-  case (OpPowK):
-  case (OpPlus):
-  case (OpMult):
-  case (OpMinus):
-  case (OpIntDiv):
-    (*tempNodes).push(n1->getR());
-    (*tempNodes).push(n1->getL());
-    break;
-  case (OpNum):
-  case (OpInt):
-  case (OpVar):
-    break;
-  case (OpPow):
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpPow is not implemented."
-      << std::endl;
-#endif
-    assert(!"not implemented!");
-    break;
-  case (OpNone): 
-#if SPEW
-    logger_->msgStream(LogDebug2) << me_ << "Opcode OpNone is found."
-      << std::endl;
-#endif
-    assert(!"warning: encountered node with opcode OpNode.");
-    break;
-  case (OpSumList):
-    for (CNode **it=n1->getListL(); it!=n1->getListR(); ++it) {
-      n = *it;
-      (*tempNodes).push(n);
-    }
-    break;
-  default:
-#if SPEW
-    logger_->msgStream(LogError) << me_ << "Opcode not is not known."
-      << std::endl;
-#endif
-    assert(!"cannot evaluate!");
-  }
-}
-void TransSep::updateLin(VariablePtr v, double d)
-{
-  if (lf_->hasVar(v) == true) {
-    lf_->incTerm(v, d);
-  } else {
-    lf_->addTerm(v, d);
   }
-  on_.pop();
-  onop_.pop();
-}
-
-
-bool TransSep::visited(UInt* j, std::vector<UInt >*m, CNode *n1,
-                       int opc)
-{
-  UInt mNum; //mNum for merge operation
-  snodes_.push_back(n1);
-  sops_.push_back(opc);
-  mNum=mergeIt(*j, itnum_[n1->getIndex()], m);
-  merge(mNum);
-  on_.pop();
-  onop_.pop();
-  return clearpopu(j, m);
+  return true;
 }
 
 
@@ -20,7 +20,8 @@
 #ifndef MINOTAURTRANSSEP_H
 #define MINOTAURTRANSSEP_H
 
-#include <stack>
+#include <utility>
+#include <vector>
 
 #include "Types.h"
 #include "NonlinearFunction.h"
@@ -59,34 +60,9 @@ namespace Minotaur {
      */
     void candCons();
 
-    /// Clear data structures if constraint is not separable
-    void clearCont();
-
-    /// Clear and populates information
-    bool clearpopu(UInt *j, std::vector<UInt > * m);
-
-    /// Generate computation graph 
-    void createCG(std::vector<CGraphPtr> * cg, CNodeQ * dq);
-
- 
-    /// Perform Depth first search rooted at node n1 at iteration number j
-    void depthFS(int j, CNode *n1, std::vector<UInt > * m);
-   
-    /// Explore further from  node n1 at iteration number j
-    void explore(int j, CNode *n1, std::vector<UInt > * m, int opc);
-
-    /// Generate final computation graph
-    void finalCG(std::vector<CGraphPtr> * cg);
-
     /// Find separability of given problem
     void findSep();
 
-    /// Get left child of node n1 
-    CNode* getLchild(CNode * n1) {return tempN_[n1->getL()->getIndex()];}; 
-    
-    /// Get right child of node n1 
-    CNode* getRchild(CNode * n1) {return tempN_[n1->getR()->getIndex()];}; 
-
     /// Return Ids of separable constraints in original problem
     std::vector<UInt > getSepConId() {return sepConId_;}
 
@@ -94,55 +70,41 @@ namespace Minotaur {
     /// 1 if problem is separable, 0 otherwise
     bool getStatus();
 
-    /// Mark nodes visited. Used in generating computation graph of separable
-    /// parts
-    void markVis(UInt i);
-
-    /// Merge current iteration with iteration mNum
-    void merge(int mNum);
-
-    /// Find iteration to merge the current iteration to
-    int mergeIt(int j, int a, std::vector<UInt > * m);
-
     /// Check separability of objective function
     void objSepCheck();
 
-    /// Check whether constraint is separable
-    bool outCheck(const CNode * o);
-
-
-    /// Populate information about separable part
-    void populate();
-
-    /// Populate nodes list
-    void popuon(CNode * n1, int opc, int t);
-
-    /// Populate tempN_ 
-    void popuTempN(CGraphPtr c, CNode *n1, OpCode op, bool k);
-
-    /// Generate computational graph of separable parts
-    std::vector<CGraphPtr> sepCGraph(CNodeQ * dq);
-
     /**
-     * Check if the nonlinear constraint is separable. 1 if separable
-     * 0 if not separable
+     * \brief Generate computational graphs of the separable parts found by
+     * the last call to sepCheck(). Nodes of each part are copied directly
+     * from the graph that was checked.
      */
-    bool sepCheck();
-
-    /// Populate initial list for depth first search rooted at node n1
-    void tempPop(CNode *n1, std::stack<CNode *> * tempNodes);
-
-    /// Update linear part of the constraint function
-    void updateLin(VariablePtr v, double d);
+    std::vector<CGraphPtr> sepCGraph();
 
-    /// Add information of the node already visited
-    bool visited(UInt *j, std::vector<UInt > * m, CNode * n1,
-                 int opc);
+    /**
+     * \brief Split a nonlinear function into separable parts.
+     *
+     * The function is written as a sum of terms by going through sums,
+     * differences, negations and products with constants. Constant and
+     * linear terms are saved in cst_ and lf_. The other terms are grouped
+     * into parts that do not share variables, using union-find over the
+     * nodes of the graph. Each node is visited a constant number of times.
+     *
+     * \param [in] cg The function.
+     * \return 1 if there are no nonlinear terms or more than one separable
+     * part, 0 otherwise.
+     */
+    bool sepCheck(CGraphPtr cg);
 
    /// Write reformulated problem after separability detection 
     void writeProb();
 
   private:
+    /// A nonlinear term and its coefficient in the sum.
+    typedef std::pair<const CNode *, double> SepTerm;
+
+    /// Terms of a separable part.
+    typedef std::vector<SepTerm> SepPart;
+
     /// Environment.
     EnvPtr env_;
 
@@ -155,22 +117,11 @@ namespace Minotaur {
     // Problem whose constraints are to be checked for separability detection.
     ProblemPtr problem_;
 
-    double coeff_;
-  
-    /// Iteration number at which a node of the cgraph is visited first
-    std::vector<int> itnum_;
-
-    // Separable parts
-    std::vector<CNodeQ > sepNodes_;
+    // Constant term of the function checked last.
+    double cst_;
 
-    // Opcodes of nodes in separable parts
-    std::vector< std::deque< int> > sepOps_;
-
-    // Variables in separable parts
-    std::vector< std::vector< CNode *> > sepVars_;
-
-    // Constant nodes in separable parts
-    std::vector< std::vector< CNode *> > sepConst_;
+    // Separable parts of the function checked last.
+    std::vector<SepPart> parts_;
 
     // Ids of the Constraint that are separable
     std::vector<UInt > sepConId_;
@@ -181,9 +132,6 @@ namespace Minotaur {
     // No. of new variable added to the origina problem after sep detection
     UInt newVars_;
 
-    /// Used in generating computational graph of separable parts
-    std::vector<CNode *> tempN_;
-
     // True if objective is separable
     bool objSep_;
 
@@ -194,25 +142,25 @@ namespace Minotaur {
     double  ub_;
     double  lb_;
 
-    // Indicates whether the function under consideration belongs to
-    // consrtaint or objective. True for constraint, false for objective 
-    bool f_; 
- 
-    CNodeQ snodes_;
-
-    std::deque<int > sops_;
-
-    std::vector<CNode *> svars_;
-
-    std::vector<CNode *> sconst_;
+    // No. of nodes in the graph checked last.
+    UInt nnode_;
 
-    std::stack<CNode *> on_;
+    /**
+     * Add a child of a node of the sum with coefficient d. Constants and
+     * variables go to cst_ and lf_, other nodes add d to their weight.
+     */
+    void addChild_(const CNode *n, double d, std::vector<double> &wt);
 
-    std::stack<int > onop_;
+    /**
+     * Copy the subgraph below node n into cg, reusing the nodes already
+     * copied for the same part. nmap and stamp are indexed by nodes of the
+     * graph being checked; nmap is valid only where stamp equals part.
+     */
+    CNode* copyTerm_(CGraphPtr cg, const CNode *n, UInt part,
+                     std::vector<CNode *> &nmap, std::vector<UInt> &stamp);
 
-    UInt nnode_;
- 
-    UInt nvar_;
+    /// Find the root of i in the union-find par, halving paths.
+    UInt find_(std::vector<UInt> &par, UInt i);
 
   };
   typedef boost::shared_ptr<TransSep> TransSepPtr;
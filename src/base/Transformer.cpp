@@ -10,6 +10,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -28,6 +29,7 @@
 #include "NonlinearFunction.h"
 #include "Option.h"
 #include "Objective.h"
+#include "PolynomialFunction.h"
 #include "Problem.h"
 #include "ProblemSize.h"
 #include "QuadraticFunction.h"
@@ -46,7 +48,8 @@ const std::string Transformer::me_ = "Transformer: ";
 
 
 Transformer::Transformer()
-  : env_(EnvPtr()), // NULL
+  : collect_(false),
+    env_(EnvPtr()), // NULL
     logger_(LoggerPtr()),
     yLfs_(0),
     yUniExprs_(0),
@@ -57,7 +60,8 @@ Transformer::Transformer()
 
 
 Transformer::Transformer(EnvPtr env, ConstProblemPtr p)
-  : env_(env),
+  : collect_(false),
+    env_(env),
     p_(p),
     yLfs_(0),
     yUniExprs_(0),
@@ -84,6 +88,53 @@ Transformer::~Transformer()
 }
 
 
+void Transformer::addCon_(HandlerPtr h, ConstraintPtr c, const AuxDef &aux)
+{
+  if (collect_) {
+    WorkerCon wc;
+    wc.c = c;
+    wc.h = h;
+    wc.aux = aux;
+    wCons_.push_back(wc);
+  } else {
+    addToHandler_(h, c);
+  }
+}
+
+
+void Transformer::addToHandler_(HandlerPtr h, ConstraintPtr c)
+{
+  if (h==uHandler_) {
+    VariablePtr iv;
+    VariablePtr ov = VariablePtr();
+    LinearFunctionPtr lf = c->getFunction()->getLinearFunction();
+    if (lf) {
+      assert(lf->getNumTerms()==1);
+      ov = lf->termsBegin()->first;
+    }
+    iv = *(c->getFunction()->getNonlinearFunction()->varsBegin());
+    uHandler_->addConstraint(c, iv, ov, 'E');
+  } else {
+    h->addConstraint(c);
+  }
+}
+
+
+void Transformer::addWorkerCons_(Transformer *w)
+{
+  ConstraintPtr c, cnew;
+
+  for (std::vector<WorkerCon>::iterator it=w->wCons_.begin();
+       it!=w->wCons_.end(); ++it) {
+    c = it->c;
+    if (c) {
+      cnew = newp_->newConstraint(it->f, c->getLb(), c->getUb());
+      addToHandler_(it->h, cnew);
+    }
+  }
+}
+
+
 bool Transformer::allConsAssigned_(ProblemPtr p, HandlerVector &handlers)
 {
   BoolVector asgn(p->getNumCons(), false);
@@ -113,25 +164,16 @@ bool Transformer::allConsAssigned_(ProblemPtr p, HandlerVector &handlers)
 }
 
 
-void Transformer::assignHandler_(CGraphPtr cg, ConstraintPtr c)
+void Transformer::assignHandler_(CGraphPtr cg, ConstraintPtr c,
+                                 const AuxDef &aux)
 {
   switch (cg->getOut()->getOp()) {
   case OpMult:
   case OpSqr:
-    qHandler_->addConstraint(c);
+    addCon_(qHandler_, c, aux);
     break;
   default:
-    {
-    VariablePtr iv;
-    VariablePtr ov = VariablePtr();
-    LinearFunctionPtr lf = c->getFunction()->getLinearFunction();
-    if (lf) {
-      assert(lf->getNumTerms()==1);
-      ov = lf->termsBegin()->first;
-    }
-    iv = *(c->getFunction()->getNonlinearFunction()->varsBegin());
-    uHandler_->addConstraint(c, iv, ov, 'E');
-    }
+    addCon_(uHandler_, c, aux);
   }
 }
 
@@ -148,6 +190,27 @@ void Transformer::clearUnusedHandlers_(HandlerVector &handlers)
 }
 
 
+void Transformer::cloneWorkerFuns_(Transformer *w, const VarVector &vmap)
+  const
+{
+  int err = 0;
+
+  for (std::vector<WorkerCon>::iterator it=w->wCons_.begin();
+       it!=w->wCons_.end(); ++it) {
+    if (!it->c) {
+      continue;
+    } else if (it->aux.cg) {
+      // the graph has been cloned by mapWorker_().
+      it->f = (FunctionPtr) new Function(it->c->getLinearFunction()
+                                         ->cloneWithVars(vmap.begin()),
+                                         it->aux.cg);
+    } else {
+      it->f = it->c->getFunction()->cloneWithVars(vmap.begin(), &err);
+    }
+  }
+}
+
+
 void Transformer::copyVars_(ConstProblemPtr p, ProblemPtr newp)
 {
   // first copy all variables from p to newp
@@ -203,6 +266,58 @@ void Transformer::copyLinear_(ConstProblemPtr p, ProblemPtr newp)
 }
 
 
+VariablePtr Transformer::findAux_(const AuxDef &aux)
+{
+  switch (aux.kind) {
+  case AuxVar:
+    return yVars_->findY(aux.x, aux.k);
+  case AuxLf:
+    return yLfs_->findY(aux.lf, aux.k);
+  case AuxUniCG:
+    // sums are not searched in newVar_().
+    if (OpSumList!=aux.cg->getOut()->getOp()) {
+      return yUniExprs_->findY(aux.cg);
+    }
+    break;
+  default:
+    assert(!"unknown kind of auxiliary variable!");
+  }
+  return VariablePtr();
+}
+
+
+void Transformer::initWorker_(Transformer *master)
+{
+  collect_ = true;
+  newp_ = (ProblemPtr) new Problem();
+  copyVars_(master->newp_, newp_);
+  lHandler_ = master->lHandler_;
+  qHandler_ = master->qHandler_;
+  uHandler_ = master->uHandler_;
+  yLfs_ = new YEqLFs(2*newp_->getNumVars());
+  yUniExprs_ = new YEqUCGs();
+  yVars_ = new YEqVars(newp_->getNumVars()+40);
+}
+
+
+void Transformer::insertAux_(const AuxDef &aux)
+{
+  switch (aux.kind) {
+  case AuxVar:
+    yVars_->insert(aux.y, aux.x, aux.k);
+    break;
+  case AuxLf:
+    yLfs_->insert(aux.y, aux.lf, aux.k);
+    break;
+  case AuxUniCG:
+    yUniExprs_->insert(aux.y, aux.cg);
+    break;
+  default:
+    assert(!"unknown kind of auxiliary variable!");
+  }
+}
+
+
 void Transformer::makeObjLin_()
 {
   ObjectivePtr obj;
@@ -248,6 +363,66 @@ void Transformer::makeObjLin_()
 }
 
     
+void Transformer::mapWorker_(Transformer *w, UInt nvars, VarVector &vmap)
+{
+  ProblemPtr wp = w->newp_;
+  VariablePtr v, wv;
+  int err = 0;
+
+  // variables of the worker's problem are found by their index.
+  vmap.resize(wp->getNumVars());
+  for (UInt i=0; i<nvars; ++i) {
+    vmap[i] = newp_->getVariable(i);
+  }
+
+  for (std::vector<WorkerCon>::iterator it=w->wCons_.begin();
+       it!=w->wCons_.end(); ++it) {
+    AuxDef &aux = it->aux;
+    if (AuxNone==aux.kind) {
+      continue;
+    }
+    // write the relation with the variables of newp_ and look for it.
+    if (aux.x) {
+      aux.x = vmap[aux.x->getIndex()];
+    }
+    if (aux.lf) {
+      aux.lf = aux.lf->cloneWithVars(vmap.begin());
+    }
+    if (aux.mf) {
+      aux.mf = boost::dynamic_pointer_cast <MonomialFunction>
+        (aux.mf->cloneWithVars(vmap.begin(), &err));
+    }
+    if (aux.cg) {
+      aux.cg = boost::dynamic_pointer_cast <CGraph>
+        (aux.cg->cloneWithVars(vmap.begin(), &err));
+    }
+    wv = aux.y;
+    v = findAux_(aux);
+    if (v) {
+      it->c.reset();
+    } else {
+      v = newp_->newVariable(wv->getLb(), wv->getUb(), wv->getType(),
+                             wv->getSrcType());
+      aux.y = v;
+      insertAux_(aux);
+    }
+    vmap[wv->getIndex()] = v;
+  }
+
+  for (UInt i=0; i<wp->getNumVars(); ++i) {
+    wv = wp->getVariable(i);
+    v = vmap[i];
+    assert(v);
+    if (wv->getLb()>v->getLb()) {
+      newp_->changeBound(v, Lower, wv->getLb());
+    }
+    if (wv->getUb()<v->getUb()) {
+      newp_->changeBound(v, Upper, wv->getUb());
+    }
+  }
+}
+
+
 VariablePtr Transformer::newVar_(VariablePtr iv, double d, ProblemPtr newp)
 {
   if (fabs(d)<zTol_) {
@@ -260,6 +435,7 @@ VariablePtr Transformer::newVar_(VariablePtr iv, double d, ProblemPtr newp)
 
     ov = yVars_->findY(iv, d);
     if (!ov) {
+      AuxDef aux;
       ov = newp->newVariable(VarTran);
       yVars_->insert(ov, iv, d);
       lf->addTerm(iv, 1.0);
@@ -271,7 +447,11 @@ VariablePtr Transformer::newVar_(VariablePtr iv, double d, ProblemPtr newp)
                                    << std::endl;
       cnew->write(logger_->msgStream(LogDebug));
 #endif 
-      lHandler_->addConstraint(cnew);
+      aux.kind = AuxVar;
+      aux.k = d;
+      aux.x = iv;
+      aux.y = ov;
+      addCon_(lHandler_, cnew, aux);
     }
     return ov;
   }
@@ -288,6 +468,7 @@ VariablePtr Transformer::newVar_(LinearFunctionPtr lf, double d,
   ov = yLfs_->findY(lf, d);
   if (!ov) {
     LinearFunctionPtr lf2 = lf->clone();
+    AuxDef aux;
     ov = newp->newVariable(VarTran);
     yLfs_->insert(ov, lf2, d);
     lf->addTerm(ov, -1.0);
@@ -299,7 +480,11 @@ VariablePtr Transformer::newVar_(LinearFunctionPtr lf, double d,
     cnew->write(logger_->msgStream(LogDebug));
 #endif 
 
-    lHandler_->addConstraint(cnew);
+    aux.kind = AuxLf;
+    aux.k = d;
+    aux.lf = lf2;
+    aux.y = ov;
+    addCon_(lHandler_, cnew, aux);
   }
   return ov;
 }
@@ -319,6 +504,7 @@ VariablePtr Transformer::newVar_(CGraphPtr cg, ProblemPtr newp)
   } 
 
   if (!ov) {
+    AuxDef aux;
     ov = newp->newVariable(VarTran);
     lf = (LinearFunctionPtr) new LinearFunction();
     lf->addTerm(ov, -1.0);
@@ -329,7 +515,10 @@ VariablePtr Transformer::newVar_(CGraphPtr cg, ProblemPtr newp)
                                    << std::endl;
       cnew->write(logger_->msgStream(LogDebug));
 #endif 
-    assignHandler_(cg, cnew);
+    aux.kind = AuxUniCG;
+    aux.cg = cg;
+    aux.y = ov;
+    assignHandler_(cg, cnew, aux);
 
     yUniExprs_->insert(ov, cg);
   }
@@ -337,6 +526,84 @@ VariablePtr Transformer::newVar_(CGraphPtr cg, ProblemPtr newp)
 }
 
 
+void Transformer::refNonlinConsPar_(const ConstConstraintVector &cons)
+{
+  // a worker copies all variables, so it should get enough constraints.
+  const UInt min_cons = 100;
+  UInt nthreads = 1;
+  UInt nvars = newp_->getNumVars();
+  std::vector<Transformer *> workers;
+  std::vector<VarVector> vmaps;
+
+#if USE_OPENMP
+  if (env_) {
+    nthreads = std::max(1, env_->getOptions()->findInt("threads")->
+                        getValue());
+  }
+#endif
+  nthreads = std::min(nthreads, (UInt) cons.size()/min_cons);
+  if (nthreads<2) {
+    for (ConstConstraintVector::const_iterator it=cons.begin();
+         it!=cons.end(); ++it) {
+      refNonlinCon_(*it);
+    }
+    return;
+  }
+
+  vmaps.resize(nthreads);
+  for (UInt t=0; t<nthreads; ++t) {
+    workers.push_back(newWorker_());
+    workers[t]->initWorker_(this);
+  }
+
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#endif
+  for (int t=0; t<(int) nthreads; ++t) {
+    size_t first = (size_t) t*cons.size()/nthreads;
+    size_t last = (size_t) (t+1)*cons.size()/nthreads;
+    for (size_t i=first; i<last; ++i) {
+      workers[t]->refNonlinCon_(cons[i]);
+    }
+  }
+
+  // auxiliary variables are found or added in order, the rest is done in
+  // parallel.
+  for (UInt t=0; t<nthreads; ++t) {
+    mapWorker_(workers[t], nvars, vmaps[t]);
+  }
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#endif
+  for (int t=0; t<(int) nthreads; ++t) {
+    cloneWorkerFuns_(workers[t], vmaps[t]);
+  }
+  for (UInt t=0; t<nthreads; ++t) {
+    addWorkerCons_(workers[t]);
+  }
+#if USE_OPENMP
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+#endif
+  for (int t=0; t<(int) nthreads; ++t) {
+    delete workers[t];
+  }
+}
+
+
+void Transformer::writeAux(std::ostream &out) const
+{
+  if (yVars_) {
+    yVars_->write(out);
+  }
+  if (yLfs_) {
+    yLfs_->write(out);
+  }
+  if (yUniExprs_) {
+    yUniExprs_->write(out);
+  }
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -21,7 +21,9 @@ class CxUnivarHandler;
 class CGraph;
 class CNode;
 class Environment;
+class LinearFunction;
 class LinearHandler;
+class MonomialFunction;
 class Problem;
 class QuadHandler;
 class Solution;
@@ -31,7 +33,9 @@ class YEqVars;
 typedef boost::shared_ptr<CxUnivarHandler> CxUnivarHandlerPtr;
 typedef boost::shared_ptr<CGraph> CGraphPtr;
 typedef boost::shared_ptr<Environment> EnvPtr;
+typedef boost::shared_ptr<LinearFunction> LinearFunctionPtr;
 typedef boost::shared_ptr<LinearHandler> LinearHandlerPtr;
+typedef boost::shared_ptr<MonomialFunction> MonomialFunPtr;
 typedef boost::shared_ptr<Problem> ProblemPtr;
 typedef boost::shared_ptr<QuadHandler> QuadHandlerPtr;
 typedef boost::shared_ptr<Solution> SolutionPtr;
@@ -94,7 +98,59 @@ public:
   virtual void reformulate(ProblemPtr &newp, HandlerVector &handlers,
                            int &status) = 0;
 
+  /**
+   * \brief Write the auxiliary variables saved for reuse, with their
+   * definitions, in the order in which they were added.
+   *
+   * \param [in] out The output stream.
+   */
+  virtual void writeAux(std::ostream &out) const;
+
 protected:
+  /// Kinds of relations that define an auxiliary variable y.
+  typedef enum {
+    AuxNone,     ///< Not an auxiliary variable.
+    AuxVar,      ///< \f$y = x + k\f$, saved in yVars_.
+    AuxLf,       ///< \f$y = c^Tx + k\f$, saved in yLfs_.
+    AuxUniCG,    ///< \f$y = f(x)\f$, saved in yUniExprs_.
+    AuxBiCG,     ///< \f$y = x_1x_2\f$, saved by SimpleTransformer.
+    AuxMonomial  ///< \f$y = \prod x_i^{a_i}\f$, saved by TransPoly.
+  } AuxKind;
+
+  /**
+   * \brief The relation that defines an auxiliary variable, as it is saved
+   * in the storage of its kind. Only the fields of the kind are used.
+   */
+  struct AuxDef {
+    AuxDef() : kind(AuxNone), k(0.0) {}
+    AuxKind kind;
+    CGraphPtr cg;
+    double k;
+    LinearFunctionPtr lf;
+    MonomialFunPtr mf;
+    VariablePtr x;
+    VariablePtr y;
+  };
+
+  /**
+   * \brief A constraint that a worker added to its problem, with the handler
+   * it should be given to and the auxiliary variable it defines, if any.
+   */
+  struct WorkerCon {
+    ConstraintPtr c;
+    HandlerPtr h;
+    AuxDef aux;
+    /// The function of c with the variables of the master, when merging.
+    FunctionPtr f;
+  };
+
+  /**
+   * \brief If true, this transformer is a worker of another one (see
+   * refNonlinConsPar_()). Constraints are then saved in wCons_ instead of
+   * being given to handlers.
+   */
+  bool collect_;
+
   /// The pointer to environment.
   EnvPtr env_;
 
@@ -134,9 +190,35 @@ protected:
    */
   YEqVars *yVars_;
 
+  /// Constraints added by a worker, in the order they were added.
+  std::vector<WorkerCon> wCons_;
+
   /// Tolerance for checking if a value is zero.
   const double zTol_;
 
+  /**
+   * \brief Give a new constraint to a handler, or save it if this is a
+   * worker.
+   *
+   * \param[in] h The handler.
+   * \param[in] c The constraint.
+   * \param[in] aux The auxiliary variable c defines, if any.
+   */
+  void addCon_(HandlerPtr h, ConstraintPtr c, const AuxDef &aux=AuxDef());
+
+  /**
+   * \brief Give a constraint to a handler, with the arguments that the
+   * handler needs. The linear part of c is \f$-y\f$ for handlers of
+   * auxiliary variables.
+   */
+  virtual void addToHandler_(HandlerPtr h, ConstraintPtr c);
+
+  /**
+   * \brief Add the constraints of a worker to newp_, after its functions
+   * have been set by cloneWorkerFuns_(), and give them to handlers.
+   */
+  void addWorkerCons_(Transformer *w);
+
   /**
    * \brief Check if all constraints in a problem have been assigned to a
    * handler.
@@ -155,7 +237,8 @@ protected:
    * \param[in] c The nonlinear constraint \f$y_i = f(x)\f$ that is being
    * assigned to. 
    */
-  void assignHandler_(CGraphPtr cg, ConstraintPtr c);
+  void assignHandler_(CGraphPtr cg, ConstraintPtr c,
+                      const AuxDef &aux=AuxDef());
 
   /**
    * \brief Delete unused handlers.
@@ -165,6 +248,16 @@ protected:
    */
   void clearUnusedHandlers_(HandlerVector &handlers);
 
+  /**
+   * \brief Write the functions of the constraints of a worker with the
+   * variables of newp_. Does not change this transformer, so it can be
+   * called for many workers at the same time.
+   *
+   * \param[in] w The worker, after mapWorker_().
+   * \param[in] vmap The map set by mapWorker_().
+   */
+  void cloneWorkerFuns_(Transformer *w, const VarVector &vmap) const;
+
   /**
    * \brief Copy all the linear constraints of the problem into the new problem.
    *
@@ -183,15 +276,55 @@ protected:
    */
   void copyVars_(ConstProblemPtr p, ProblemPtr newp);
 
+  /**
+   * \brief Find the auxiliary variable of a relation in the storage of its
+   * kind. Derived classes handle the kinds they store themselves.
+   *
+   * \return The variable, NULL if none is found.
+   */
+  virtual VariablePtr findAux_(const AuxDef &aux);
+
+  /**
+   * \brief Prepare this transformer to work on a part of the constraints of
+   * another one. It gets its own problem with copies of the variables of
+   * the other's problem, and its own storage of auxiliary variables.
+   * Derived classes also set up their own storage.
+   *
+   * \param[in] master The transformer whose work is shared.
+   */
+  virtual void initWorker_(Transformer *master);
+
+  /// Save an auxiliary variable in the storage of its kind.
+  virtual void insertAux_(const AuxDef &aux);
+
   /**
    * Converts the new Problem newp_ into one with a linear objective by adding
    * a new variable if necessary.
    */
   virtual void makeObjLin_();
 
+  /**
+   * \brief Find or add in newp_ the auxiliary variables of a worker.
+   *
+   * Auxiliary variables are looked up in the order in which the worker
+   * created them. A variable that is already in the storage replaces the
+   * worker's one, and its defining constraint is dropped from w->wCons_.
+   * Otherwise, a new variable is added to newp_ and saved. Bounds are then
+   * tightened as in the worker's problem.
+   *
+   * \param[in] w The worker.
+   * \param[in] nvars Number of variables newp_ had when w was created.
+   * \param[out] vmap The variable of newp_ for each variable of the
+   * worker's problem, by index.
+   */
+  void mapWorker_(Transformer *w, UInt nvars, VarVector &vmap);
+
   /// Convert a maximization objective into minimization.
   void minObj_();
 
+  /// Return a new transformer of the same type, to be used as a worker.
+  virtual Transformer* newWorker_() = 0;
+
   /**
    * \brief Find the auxiliary variable associated with \f$y_i = x_j+d\f$ or
    * create a new one.
@@ -234,6 +367,26 @@ protected:
    */
   VariablePtr newVar_(CGraphPtr cg, ProblemPtr newp);
 
+  /**
+   * \brief Reformulate one nonlinear constraint of the original problem and
+   * add the result to newp_.
+   */
+  virtual void refNonlinCon_(ConstConstraintPtr c) = 0;
+
+  /**
+   * \brief Reformulate the given constraints, in parallel if the option
+   * "threads" allows it.
+   *
+   * The constraints are split into contiguous blocks. Each block is
+   * reformulated by a worker into its own problem, and the workers are then
+   * merged into newp_ in the order of the blocks. The new problem is the
+   * same as the one obtained by calling refNonlinCon_() for each constraint
+   * in order, whatever the number of threads.
+   *
+   * \param[in] cons Nonlinear constraints of the original problem.
+   */
+  void refNonlinConsPar_(const ConstConstraintVector &cons);
+
 private:
   static const std::string me_;
     
@@ -10,6 +10,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "MinotaurConfig.h"
@@ -102,26 +103,56 @@ NodePtr TreeManager::branch(Branches branches, NodePtr node, WarmStartPtr ws)
   NodePtr new_cand = NodePtr(); // NULL
   NodePtr child;
   bool is_first = false;
+  std::vector<NodePtr> children;
+  std::vector<bool> prune;
+  UInt nlive = 0;
 
   if (searchType_ == DepthFirst || searchType_ == BestThenDive) {
     is_first = true;
   }
+
+  // create all children first. A branch may know a bound on its child,
+  // e.g. from strong branching, that already exceeds the cutoff.
   for (BranchConstIterator br_iter=branches->begin(); br_iter!=branches->end();
       ++br_iter) {
     branch_p = *br_iter;
     child = (NodePtr) new Node(node, branch_p);
-    child->setLb(node->getLb());
+    child->setLb(std::max(node->getLb(), branch_p->getLb()));
     child->setTbScore(node->getTbScore());
     child->setDepth(node->getDepth()+1);
     node->addChild(child);
-    if (is_first) {
+    children.push_back(child);
+    prune.push_back(shouldPrune_(child));
+    if (!prune.back()) {
+      ++nlive;
+    }
+  }
+
+  for (UInt i=0; i<children.size(); ++i) {
+    child = children[i];
+    branch_p = (*branches)[i];
+    if (prune[i] && nlive>0) {
+      // pruned without being solved. Only done if a sibling survives, so
+      // that the parent is not removed from the tree while branching.
+      insertCandidate_(child, true);
+      pruneNode(child);
+    } else if (is_first) {
+      // warm-start from the branch if it has one, else the engine continues
+      // from the parent.
+      if (branch_p->getWarmStart()) {
+        child->setWarmStart(branch_p->getWarmStart());
+      }
       insertCandidate_(child, true);
       is_first = false;
       new_cand = child;
     } else {
       // We make a copy of the pointer to warm-start, not the full copy of the
       // warm-start.
-      child->setWarmStart(ws);
+      if (branch_p->getWarmStart()) {
+        child->setWarmStart(branch_p->getWarmStart());
+      } else {
+        child->setWarmStart(ws);
+      }
       insertCandidate_(child);
     }
     //std::cout << "inserting candidate\n";
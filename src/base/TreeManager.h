@@ -59,7 +59,10 @@ namespace Minotaur {
      * that are used to create the new nodes after branching.
      * \param[in] node The node that we wish to branch upon.
      * \param[in] ws The warm starting information that should be linked to
-     * in the new nodes.
+     * in the new nodes. A branch that has its own warm-start information
+     * and lower bound (Branch::getWarmStart(), Branch::getLb()) passes them
+     * on to its child instead. Children whose lower bound exceeds the cutoff
+     * are pruned right away, unless all of them do.
      * \returns The first child node.
      */
     NodePtr branch(Branches branches, NodePtr node, WarmStartPtr ws);
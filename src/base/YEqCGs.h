@@ -14,6 +14,8 @@
 #ifndef MINOTAURYEQCG_H
 #define MINOTAURYEQCG_H
 
+#include <boost/unordered_map.hpp>
+
 #include "Types.h"
 #include "OpCode.h"
 
@@ -27,12 +29,23 @@ public:
   VariablePtr findY(CGraphPtr cg);
   void insert(VariablePtr auxvar, CGraphPtr cg);
 
+  /// Write the auxiliary variables and their definitions, in order.
+  void write(std::ostream &out) const;
+
 private:
-  DoubleVector hash_;
-  DoubleVector rand_;
-  VarVector y_;
+  /// Map from the structural hash of a graph to its position in cg_.
+  typedef boost::unordered_multimap<std::size_t, UInt> HashIndex;
+
   std::vector<CGraphPtr> cg_;
-  double evalHash_(const CNode* node, UInt rank);
+  HashIndex index_;
+  VarVector y_;
+
+  /**
+   * Hash of the operations and variables of the graph rooted at node.
+   * Identical graphs have the same hash. Real constants are left out
+   * because isIdenticalTo() compares them with a tolerance.
+   */
+  std::size_t evalHash_(const CNode* node) const;
 };
 }
 #endif
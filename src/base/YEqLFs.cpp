@@ -10,6 +10,7 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
+#include <boost/functional/hash.hpp>
 #include <cmath>
 #include <iostream>
 
@@ -26,20 +27,17 @@ using namespace Minotaur;
 
 
 YEqLFs::YEqLFs(UInt n)
-  :n_(n)
+  : index_(n)
 {
-  for (UInt i=0; i<n; ++i) {
-    rand_.push_back((double) rand()/(RAND_MAX)*10.0);
-  }
 }
 
 
-double YEqLFs::evalHash_(LinearFunctionPtr lf)
+std::size_t YEqLFs::evalHash_(LinearFunctionPtr lf) const
 {
-  double hash = 0.0;
+  std::size_t hash = lf->getNumTerms();
   for (VariableGroupConstIterator it=lf->termsBegin(); it!=lf->termsEnd();
        ++it) {
-    hash += it->second*rand_[it->first->getId()%n_];
+    boost::hash_combine(hash, it->first->getId());
   }
   return hash;
 }
@@ -49,10 +47,17 @@ VariablePtr YEqLFs::findY(LinearFunctionPtr lf, double k)
 {
   bool found;
   VariableGroupConstIterator it, it2;
-  double hash = evalHash_(lf);
-  for (UInt i=0; i<y_.size(); ++i) {
-    if (fabs(k-k_[i])<1e-12 && lf->getNumTerms()==lf_[i]->getNumTerms() && 
-        fabs(hash-hash_[i])<1e-12) {
+  std::pair<HashIndex::const_iterator, HashIndex::const_iterator> range =
+    index_.equal_range(evalHash_(lf));
+  UInt best = y_.size();
+  UInt i;
+
+  // if several match, return the first one inserted.
+  for (HashIndex::const_iterator hit=range.first; hit!=range.second;
+       ++hit) {
+    i = hit->second;
+    if (i<best && fabs(k-k_[i])<1e-12 &&
+        lf->getNumTerms()==lf_[i]->getNumTerms()) {
       found = true;
       it = lf->termsBegin();
       it2 = lf_[i]->termsBegin();
@@ -63,22 +68,35 @@ VariablePtr YEqLFs::findY(LinearFunctionPtr lf, double k)
         }
       }
       if (found) {
-        return y_[i];
+        best = i;
       }
     }
   }
+  if (best<y_.size()) {
+    return y_[best];
+  }
   return VariablePtr();
 }
 
 
 void YEqLFs::insert(VariablePtr auxvar, LinearFunctionPtr lf, double k)
 {
-  hash_.push_back(evalHash_(lf));
+  index_.insert(std::make_pair(evalHash_(lf), (UInt) y_.size()));
   lf_.push_back(lf);
   y_.push_back(auxvar);
   k_.push_back(k);
 }
 
+
+void YEqLFs::write(std::ostream &out) const
+{
+  for (UInt i=0; i<y_.size(); ++i) {
+    out << y_[i]->getName() << " = ";
+    lf_[i]->write(out);
+    out << " + " << k_[i] << std::endl;
+  }
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -14,6 +14,8 @@
 #ifndef MINOTAURYEQLFS_H
 #define MINOTAURYEQLFS_H
 
+#include <boost/unordered_map.hpp>
+
 #include "Types.h"
 
 namespace Minotaur {
@@ -27,14 +29,23 @@ public:
   VariablePtr findY(LinearFunctionPtr lf, double k);
   void insert(VariablePtr auxvar, LinearFunctionPtr lf, double k);
 
+  /// Write the auxiliary variables and their definitions, in order.
+  void write(std::ostream &out) const;
+
 private:
+  /// Map from the hash of a function to its position in y_.
+  typedef boost::unordered_multimap<std::size_t, UInt> HashIndex;
+
+  HashIndex index_;
   DoubleVector k_;
   std::vector<LinearFunctionPtr> lf_;
-  UInt n_;
-  DoubleVector rand_;
-  DoubleVector hash_;
   VarVector y_;
-  double evalHash_(LinearFunctionPtr lf);
+
+  /**
+   * Hash of the variables of lf. Coefficients are left out because they
+   * are compared with a tolerance.
+   */
+  std::size_t evalHash_(LinearFunctionPtr lf) const;
 };
 }
 #endif
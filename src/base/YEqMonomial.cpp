@@ -11,7 +11,9 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory.
  */
 
+#include <boost/functional/hash.hpp>
 #include <cmath>
+#include <iostream>
 
 #include "MinotaurConfig.h"
 
@@ -22,19 +24,17 @@
 using namespace Minotaur;
 
 YEqMonomial::YEqMonomial(UInt n)
+  : index_(n)
 {
-  n_ = n;
-  for (UInt i=0; i<n_; ++i) {
-    rand_.push_back((double) rand()/(RAND_MAX));
-  }
 }
 
 
-double YEqMonomial::evalHash_(MonomialFunPtr mf)
+std::size_t YEqMonomial::evalHash_(MonomialFunPtr mf) const
 {
-  double hash = 0.0;
+  std::size_t hash = 0;
   for (VarIntMapConstIterator it=mf->termsBegin(); it!=mf->termsEnd(); ++it) {
-    hash += ((double) it->second)/(1.0+it->first->getId());
+    boost::hash_combine(hash, it->first->getId());
+    boost::hash_combine(hash, it->second);
   }
   return hash;
 }
@@ -42,12 +42,18 @@ double YEqMonomial::evalHash_(MonomialFunPtr mf)
 
 VariablePtr YEqMonomial::findY(MonomialFunPtr mf)
 {
-  double hash = evalHash_(mf);
+  std::pair<HashIndex::const_iterator, HashIndex::const_iterator> range =
+    index_.equal_range(evalHash_(mf));
   VarIntMapConstIterator it, it2;
+  UInt best = y_.size();
+  UInt i;
   bool found;
 
-  for (UInt i=0; i<y_.size(); ++i) {
-    if (fabs(hash-hash_[i])<1e-12 
+  // if several match, return the first one inserted.
+  for (HashIndex::const_iterator hit=range.first; hit!=range.second;
+       ++hit) {
+    i = hit->second;
+    if (i<best
         && mf->getDegree()==mf_[i]->getDegree()
         && fabs(mf->getCoeff()-mf_[i]->getCoeff())<1e-12) {
       it = mf->termsBegin();
@@ -60,22 +66,35 @@ VariablePtr YEqMonomial::findY(MonomialFunPtr mf)
         }
       }
       if (found) {
-        return y_[i];
+        best = i;
       }
     }
   }
+  if (best<y_.size()) {
+    return y_[best];
+  }
   return VariablePtr();
 }
 
 
 void YEqMonomial::insert(VariablePtr auxvar, MonomialFunPtr mf)
 {
-  hash_.push_back(evalHash_(mf));
+  index_.insert(std::make_pair(evalHash_(mf), (UInt) y_.size()));
   y_.push_back(auxvar);
   mf_.push_back(mf);
 }
 
 
+void YEqMonomial::write(std::ostream &out) const
+{
+  for (UInt i=0; i<y_.size(); ++i) {
+    out << y_[i]->getName() << " = ";
+    mf_[i]->write(out);
+    out << std::endl;
+  }
+}
+
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
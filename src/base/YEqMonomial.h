@@ -14,6 +14,8 @@
 #ifndef MINOTAURYEQMONOMIAL_H
 #define MINOTAURYEQMONOMIAL_H
 
+#include <boost/unordered_map.hpp>
+
 #include "Types.h"
 
 namespace Minotaur {
@@ -33,13 +35,22 @@ public:
   VariablePtr findY(MonomialFunPtr mf);
   void insert(VariablePtr auxvar, MonomialFunPtr mf);
 
+  /// Write the auxiliary variables and their definitions, in order.
+  void write(std::ostream &out) const;
+
 private:
+  /// Map from the hash of a function to its position in y_.
+  typedef boost::unordered_multimap<std::size_t, UInt> HashIndex;
+
+  HashIndex index_;
   std::vector<MonomialFunPtr> mf_;
-  DoubleVector hash_;
-  UInt n_;
-  DoubleVector rand_;
   VarVector y_;
-  double evalHash_(MonomialFunPtr mf_);
+
+  /**
+   * Hash of the variables and powers of mf. The coefficient is left out
+   * because it is compared with a tolerance.
+   */
+  std::size_t evalHash_(MonomialFunPtr mf) const;
 };
 }
 
@@ -11,7 +11,8 @@
  * \author Ashutosh Mahajan, Argonne National Laboratory
  */
 
-#include <cmath>
+#include <boost/functional/hash.hpp>
+#include <iostream>
 
 #include "MinotaurConfig.h"
 #include "CGraph.h"
@@ -27,44 +28,35 @@ using namespace Minotaur;
 
 YEqUCGs::YEqUCGs()
 {
-  UInt numops = 35;
-  for (UInt i=0; i<numops; ++i) {
-    rand_.push_back((double) rand()/(RAND_MAX));
-  }
 }
 
 
 YEqUCGs::~YEqUCGs()
 {
   cg_.clear();
-  hash_.clear();
-  op_.clear();
-  rand_.clear();
-  x_.clear();
+  index_.clear();
   y_.clear();
 }
 
 
-double YEqUCGs::evalHash_(const CNode* node, UInt rank)
+std::size_t YEqUCGs::evalHash_(const CNode* node) const
 {
   OpCode op = node->getOp();
-  double hash = rand_[op]*rank;
+  std::size_t hash = op;
   if (OpVar==op) {
-    hash *= node->getV()->getId();
-  } else if (OpInt==op || OpNum==op) {
-    hash *= node->getVal();
+    boost::hash_combine(hash, node->getV()->getId());
+  } else if (OpInt==op) {
+    boost::hash_combine(hash, node->getVal());
   } else if (1==node->numChild()) {
-    hash += evalHash_(node->getL(), rank+1);
+    boost::hash_combine(hash, evalHash_(node->getL()));
   } else if (2==node->numChild()) {
-    hash += evalHash_(node->getL(), rank+1);
-    hash += evalHash_(node->getR(), rank+2);
+    boost::hash_combine(hash, evalHash_(node->getL()));
+    boost::hash_combine(hash, evalHash_(node->getR()));
   } else if (2<node->numChild()) {
-    UInt i= 0;
     CNode** c1 = node->getListL();
     CNode** c2 = node->getListR();
     while (c1<c2) {
-      hash += evalHash_(*c1, rank+i);
-      ++i;
+      boost::hash_combine(hash, evalHash_(*c1));
       ++c1;
     }
   }
@@ -74,35 +66,41 @@ double YEqUCGs::evalHash_(const CNode* node, UInt rank)
 
 VariablePtr YEqUCGs::findY(CGraphPtr cg)
 {
-  double hash = evalHash_(cg->getOut(), 1);
-  OpCode op = cg->getOut()->getOp();
-  VariablePtr x = *(cg->varsBegin());
-  for (UInt i=0; i<y_.size(); ++i) {
-    if (fabs(hash-hash_[i])<1e-10
-        && op == op_[i]
-        && x == x_[i]
-        && cg->isIdenticalTo(cg_[i])) {
-      return y_[i];
+  std::pair<HashIndex::const_iterator, HashIndex::const_iterator> range =
+    index_.equal_range(evalHash_(cg->getOut()));
+  UInt best = y_.size();
+
+  // if several match, return the first one inserted.
+  for (HashIndex::const_iterator it=range.first; it!=range.second; ++it) {
+    if (it->second<best && cg->isIdenticalTo(cg_[it->second])) {
+      best = it->second;
     }
   }
+  if (best<y_.size()) {
+    return y_[best];
+  }
   return VariablePtr();
 }
 
 
 void YEqUCGs::insert(VariablePtr auxvar, CGraphPtr cg)
 {
-  VariablePtr x;
-
   assert(auxvar && cg);
-
-  x = *(cg->varsBegin());
-  op_.push_back(cg->getOut()->getOp());
-  hash_.push_back(evalHash_(cg->getOut(), 1));
+  index_.insert(std::make_pair(evalHash_(cg->getOut()), (UInt) y_.size()));
   y_.push_back(auxvar);
-  x_.push_back(x);
   cg_.push_back(cg);
 }
 
+
+void YEqUCGs::write(std::ostream &out) const
+{
+  for (UInt i=0; i<y_.size(); ++i) {
+    out << y_[i]->getName() << " = ";
+    cg_[i]->write(out);
+    out << std::endl;
+  }
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -14,6 +14,8 @@
 #ifndef MINOTAURYEQUCGS_H
 #define MINOTAURYEQUCGS_H
 
+#include <boost/unordered_map.hpp>
+
 #include "Types.h"
 #include "OpCode.h"
 
@@ -29,14 +31,23 @@ public:
   VariablePtr findY(CGraphPtr cg);
   void insert(VariablePtr auxvar, CGraphPtr cg);
 
+  /// Write the auxiliary variables and their definitions, in order.
+  void write(std::ostream &out) const;
+
 private:
+  /// Map from the structural hash of a graph to its position in cg_.
+  typedef boost::unordered_multimap<std::size_t, UInt> HashIndex;
+
   std::vector<CGraphPtr> cg_;
-  DoubleVector hash_;
-  std::vector<OpCode> op_;
-  DoubleVector rand_;
-  VarVector x_;
+  HashIndex index_;
   VarVector y_;
-  double evalHash_(const CNode* node, UInt rank);
+
+  /**
+   * Hash of the operations and variables of the graph rooted at node.
+   * Identical graphs have the same hash. Real constants are left out
+   * because isIdenticalTo() compares them with a tolerance.
+   */
+  std::size_t evalHash_(const CNode* node) const;
 };
 }
 #endif
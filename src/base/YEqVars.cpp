@@ -27,30 +27,47 @@ using namespace Minotaur;
 
 
 YEqVars::YEqVars(UInt n)
+  : index_(n)
 {
-  n_ = n;
 }
 
 
 VariablePtr YEqVars::findY(VariablePtr x, double k)
 {
-  UInt key = x->getId();
-  for (UInt i=0; i<x_.size(); ++i){
-    if (hash_[i] == key && fabs(k-k_[i])<1e-12 && x==x_[i]) {
-      return y_[i];
+  std::pair<HashIndex::const_iterator, HashIndex::const_iterator> range =
+    index_.equal_range(x->getId());
+  UInt best = y_.size();
+  UInt i;
+
+  // if several match, return the first one inserted.
+  for (HashIndex::const_iterator it=range.first; it!=range.second; ++it) {
+    i = it->second;
+    if (i<best && fabs(k-k_[i])<1e-12 && x==x_[i]) {
+      best = i;
     }
   }
+  if (best<y_.size()) {
+    return y_[best];
+  }
   return VariablePtr();
 }
 
 
 void YEqVars::insert(VariablePtr auxvar, VariablePtr x, double k)
 {
-  UInt ind = x->getId()%n_;
+  index_.insert(std::make_pair(x->getId(), (UInt) y_.size()));
   k_.push_back(k);
   x_.push_back(x);
   y_.push_back(auxvar);
-  hash_.push_back(ind);
+}
+
+
+void YEqVars::write(std::ostream &out) const
+{
+  for (UInt i=0; i<y_.size(); ++i) {
+    out << y_[i]->getName() << " = " << x_[i]->getName() << " + " << k_[i]
+      << std::endl;
+  }
 }
 
 
@@ -14,6 +14,8 @@
 #ifndef MINOTAURYEQVARS_H
 #define MINOTAURYEQVARS_H
 
+#include <boost/unordered_map.hpp>
+
 #include "Types.h"
 #include "OpCode.h"
 
@@ -27,10 +29,15 @@ public:
   VariablePtr findY(VariablePtr x, double k);
   void insert(VariablePtr auxvar, VariablePtr x, double k);
 
+  /// Write the auxiliary variables and their definitions, in order.
+  void write(std::ostream &out) const;
+
 private:
+  /// Map from the id of x to the positions in y_ of its auxiliary variables.
+  typedef boost::unordered_multimap<UInt, UInt> HashIndex;
+
+  HashIndex index_;
   DoubleVector k_;
-  UIntVector hash_;
-  UInt n_;
   std::vector<VariablePtr> x_;
   VarVector y_;
 };
@@ -25,6 +25,7 @@
 #include "Function.h"
 #include "Logger.h"
 #include "LinearFunction.h"
+#include "NlReader.h"
 #include "Option.h"
 #include "PolynomialFunction.h"
 #include "Problem.h"
@@ -69,6 +70,7 @@ AMPLInterface::AMPLInterface(Minotaur::EnvPtr env, std::string solver)
    nDefVars_(0),
    nDefVarsBco_(0),
    nDefVarsCo1_(0),
+   nlReader_(0),
    nVars_(0),
    zTol_(1e-8)
 {
@@ -88,6 +90,9 @@ AMPLInterface::~AMPLInterface()
   freeASL();
   functionMap_.clear();
   vars_.clear();
+  if (nlReader_) {
+    delete nlReader_;
+  }
 }
 
 
@@ -217,6 +222,11 @@ void AMPLInterface::addOptions_()
      true, false);
   options->insert(b_option);
 
+  b_option = (Minotaur::BoolOptionPtr) new Minotaur::Option<bool>
+    ("use_native_nl_reader", 
+     "If true, read .nl file without building ASL structures: <0/1>", 
+     true, false);
+  options->insert(b_option);
 }
 
 
@@ -1364,7 +1374,9 @@ Minotaur::FunctionType AMPLInterface::getExpressionType_(expr *e_ptr)
 
 const double * AMPLInterface::getInitialPoint() const
 {
-  if (myAsl_->i.X0_) {
+  if (nlReader_) {
+    return nlReader_->getInitialPoint();
+  } else if (myAsl_->i.X0_) {
     return myAsl_->i.X0_;
   } else {
     return NULL;
@@ -1915,6 +1927,9 @@ void AMPLInterface::readFile_(std::string *fname, ReaderType readerType)
 
 Minotaur::ProblemPtr AMPLInterface::readInstance(std::string fname) 
 {
+  if (env_->getOptions()->findBool("use_native_nl_reader")->getValue()) {
+    return readInstanceNl_(fname);
+  }
   if (false==env_->getOptions()->findBool("use_native_cgraph")->getValue()) {
     return readInstanceASL_(fname);
   } 
@@ -2041,6 +2056,40 @@ Minotaur::ProblemPtr AMPLInterface::readInstanceCG_(std::string fname)
 }
 
 
+Minotaur::ProblemPtr AMPLInterface::readInstanceNl_(std::string fname) 
+{
+  Minotaur::ProblemPtr instance;
+  FILE *nl = NULL;
+  char *fname_chars;
+
+  if (nlReader_) {
+    delete nlReader_;
+  }
+  nlReader_ = new NlReader(env_);
+  instance = nlReader_->readInstance(fname);
+  if (!instance) {
+    return instance;
+  }
+
+  // ASL only reads the header of the stub. It is needed for writing the
+  // .sol file. None of the functions or bounds are read by ASL.
+  fname_chars = (char *)malloc((fname.length()+1)*sizeof(char));
+  strcpy(fname_chars, fname.c_str());
+  readerType_ = FReader;
+  myAsl_ = ASL_alloc(ASL_read_f); 
+  nl = jac0dim_ASL(myAsl_, fname_chars, (fint) (fname.length()));
+  free(fname_chars);
+  if (nl) {
+    fclose(nl);
+  }
+
+  nVars_    = myAsl_->i.n_var_;
+  nCons_    = myAsl_->i.n_con_;
+  nDefVars_ = nlReader_->getNumDefs();
+  return instance;
+}
+
+
 void AMPLInterface::saveNlVars_(std::vector<std::set<int> > &vars)
 {
   std::set<int> vset;
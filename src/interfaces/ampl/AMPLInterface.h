@@ -41,6 +41,7 @@ namespace MINOTAUR_AMPL {
 
 class AMPLNonlinearFunction;
 typedef boost::shared_ptr<AMPLNonlinearFunction> AMPLNlfPtr;
+class NlReader;
 
 /// What kind of ASL reader is used to read the .nl file.
 typedef enum {
@@ -142,6 +143,9 @@ private:
   /// ncomo1+ncomc1
   int nDefVarsCo1_;
 
+  /// Native reader, used if option use_native_nl_reader is true.
+  NlReader *nlReader_;
+
   /**
    * Total number of variables. It does not include the number of "defined
    * variables" or common expressions. 
@@ -309,6 +313,9 @@ private:
   Minotaur::ProblemPtr readInstanceASL_(std::string fname);
   Minotaur::ProblemPtr readInstanceCG_(std::string fname);
 
+  /// Read the stub using NlReader instead of ASL.
+  Minotaur::ProblemPtr readInstanceNl_(std::string fname);
+
   void saveNlVars_(std::vector<std::set<int> > &vars);
 
   /**
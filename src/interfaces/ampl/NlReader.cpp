@@ -0,0 +1,1235 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file NlReader.cpp
+ * \brief Define the NlReader class for reading .nl files without ASL.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "NlReader.h"
+#include "Option.h"
+#include "Problem.h"
+#include "Timer.h"
+#include "Variable.h"
+
+using namespace MINOTAUR_AMPL;
+
+const std::string NlReader::me_ = "NlReader: ";
+
+//
+// Opcodes as they appear in .nl files. These are the same as those in
+// opcode.hd of ASL. We do not include opcode.hd here because the reader must
+// not depend on ASL.
+//
+namespace {
+enum NlOpCode {
+  NlPlus    = 0,
+  NlMinus   = 1,
+  NlMult    = 2,
+  NlDiv     = 3,
+  NlPow     = 5,
+  NlFloor   = 13,
+  NlCeil    = 14,
+  NlAbs     = 15,
+  NlUMinus  = 16,
+  NlTanh    = 37,
+  NlTan     = 38,
+  NlSqrt    = 39,
+  NlSinh    = 40,
+  NlSin     = 41,
+  NlLog10   = 42,
+  NlLog     = 43,
+  NlExp     = 44,
+  NlCosh    = 45,
+  NlCos     = 46,
+  NlAtanh   = 47,
+  NlAtan    = 49,
+  NlAsinh   = 50,
+  NlAsin    = 51,
+  NlAcosh   = 52,
+  NlAcos    = 53,
+  NlSumList = 54,
+  NlIntDiv  = 55,
+  NlRound   = 57,
+  NlPow1    = 75,  // expr^constant
+  NlPow2    = 76,  // expr^2
+  NlCPow    = 77   // constant^expr
+};
+
+// Return the Minotaur opcode of a univariate .nl opcode, OpNone if the
+// opcode is not univariate.
+Minotaur::OpCode univarOp(int nlop)
+{
+  switch (nlop) {
+  case (NlFloor):  return Minotaur::OpFloor;
+  case (NlCeil):   return Minotaur::OpCeil;
+  case (NlAbs):    return Minotaur::OpAbs;
+  case (NlUMinus): return Minotaur::OpUMinus;
+  case (NlTanh):   return Minotaur::OpTanh;
+  case (NlTan):    return Minotaur::OpTan;
+  case (NlSqrt):   return Minotaur::OpSqrt;
+  case (NlSinh):   return Minotaur::OpSinh;
+  case (NlSin):    return Minotaur::OpSin;
+  case (NlLog10):  return Minotaur::OpLog10;
+  case (NlLog):    return Minotaur::OpLog;
+  case (NlExp):    return Minotaur::OpExp;
+  case (NlCosh):   return Minotaur::OpCosh;
+  case (NlCos):    return Minotaur::OpCos;
+  case (NlAtanh):  return Minotaur::OpAtanh;
+  case (NlAtan):   return Minotaur::OpAtan;
+  case (NlAsinh):  return Minotaur::OpAsinh;
+  case (NlAsin):   return Minotaur::OpAsin;
+  case (NlAcosh):  return Minotaur::OpAcosh;
+  case (NlAcos):   return Minotaur::OpAcos;
+  case (NlPow2):   return Minotaur::OpSqr;
+  default:         return Minotaur::OpNone;
+  }
+}
+
+// Function type of f^k where k is a constant.
+Minotaur::FunctionType powType(Minotaur::FunctionType f, double k)
+{
+  if (Minotaur::Constant==f || 0.0==k) {
+    return Minotaur::Constant;
+  } else if (1.0==k) {
+    return f;
+  } else if (k>1.0 && floor(k)==k && (Minotaur::Linear==f ||
+                                      Minotaur::Quadratic==f ||
+                                      Minotaur::Polynomial==f)) {
+    return (2.0==k && Minotaur::Linear==f) ? Minotaur::Quadratic :
+      Minotaur::Polynomial;
+  }
+  return Minotaur::Nonlinear;
+}
+
+// Read upto n integers from a header line. Return how many were read.
+int headerInts(const std::string &line, long *vals, int n)
+{
+  const char *s = line.c_str();
+  char *e = 0;
+  int i = 0;
+  while (i<n) {
+    while (' '==*s || '\t'==*s) {
+      ++s;
+    }
+    vals[i] = strtol(s, &e, 10);
+    if (e==s) {
+      break;
+    }
+    s = e;
+    ++i;
+  }
+  for (int j=i; j<n; ++j) {
+    vals[j] = 0;
+  }
+  return i;
+}
+}
+
+
+NlReader::NlReader(Minotaur::EnvPtr env)
+  : buf_(0),
+    bufPos_(0),
+    bufLen_(0),
+    nbv_(0),
+    nCons_(0),
+    nDefs_(0),
+    niv_(0),
+    nObjs_(0),
+    nVars_(0),
+    nlvb_(0),
+    nlvbi_(0),
+    nlvc_(0),
+    nlvci_(0),
+    nlvo_(0),
+    nlvoi_(0),
+    nlc_(0),
+    env_(env),
+    file_(0),
+    isBinary_(false),
+    iniPt_(0),
+    objSense_(Minotaur::Minimize),
+    swap_(false),
+    x_(0),
+    grad_(0)
+{
+  logger_ = (Minotaur::LoggerPtr) new Minotaur::Logger((Minotaur::LogLevel)
+      env_->getOptions()->findInt("ampl_log_level")->getValue());
+}
+
+
+NlReader::~NlReader()
+{
+  clear_();
+  if (iniPt_) {
+    delete [] iniPt_;
+  }
+}
+
+
+void NlReader::addRows_(Minotaur::ProblemPtr p)
+{
+  std::vector<std::string> names;
+  Minotaur::FunctionPtr f;
+  Minotaur::QuadraticFunctionPtr qf = Minotaur::QuadraticFunctionPtr();
+
+  getNames_(".row", nCons_+nObjs_, names);
+
+  // nonlinear constraints first, then those of defined variables and then
+  // linear constraints. This is the same order as AMPLInterface.
+  for (int i=0; i<nlc_; ++i) {
+    NlRow &r = rows_[i];
+    f = (Minotaur::FunctionPtr) new Minotaur::Function(r.lf, qf, r.cg);
+    p->newConstraint(f, r.lb-r.c, r.ub-r.c, names[i]);
+    r.lf.reset();
+    r.cg.reset();
+  }
+  for (int i=nCons_; i<nCons_+nDefs_; ++i) {
+    NlRow &r = rows_[i];
+    f = (Minotaur::FunctionPtr) new Minotaur::Function(r.lf, qf, r.cg);
+    p->newConstraint(f, -r.c, -r.c);
+    r.lf.reset();
+    r.cg.reset();
+  }
+  for (int i=nlc_; i<nCons_; ++i) {
+    NlRow &r = rows_[i];
+    if (r.cg) {
+      f = (Minotaur::FunctionPtr) new Minotaur::Function(r.lf, qf, r.cg);
+    } else {
+      f = (Minotaur::FunctionPtr) new Minotaur::Function(r.lf);
+    }
+    p->newConstraint(f, r.lb-r.c, r.ub-r.c, names[i]);
+    r.lf.reset();
+    r.cg.reset();
+  }
+
+  if (nObjs_>0) {
+    f = (Minotaur::FunctionPtr) new Minotaur::Function(obj_.lf, qf, obj_.cg);
+    p->newObjective(f, obj_.c, objSense_, names[nCons_]);
+    obj_.lf.reset();
+    obj_.cg.reset();
+  }
+}
+
+
+// Each SOS is identified by abs(sosno) of its variables: a positive value
+// means SOS1 and a negative means SOS2. Weights come from 'ref'. This is the
+// convention of suf_sos_ASL() in ASL.
+void NlReader::addSOS_(Minotaur::ProblemPtr p,
+                       const Minotaur::DoubleVector &sosno,
+                       const Minotaur::DoubleVector &ref,
+                       const Minotaur::DoubleVector &pri)
+{
+  typedef std::pair<double, int> RefVar;
+  std::map<int, std::vector<RefVar> > sets;
+  std::map<int, std::vector<RefVar> >::iterator it;
+  std::map<int, int> prio;
+  Minotaur::DoubleVector wts;
+  Minotaur::VarVector vars;
+  int k;
+
+  if (sosno.empty()) {
+    return;
+  }
+  for (int i=0; i<nVars_; ++i) {
+    k = (int) sosno[i];
+    if (0!=k) {
+      sets[k].push_back(RefVar(ref.empty() ? i : ref[i], i));
+      if (!pri.empty()) {
+        prio[k] = std::max(prio[k], (int) pri[i]);
+      }
+    }
+  }
+  for (it=sets.begin(); it!=sets.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+    wts.clear();
+    vars.clear();
+    for (std::vector<RefVar>::iterator vit=it->second.begin();
+         vit!=it->second.end(); ++vit) {
+      wts.push_back(vit->first);
+      vars.push_back(vars_[vit->second]);
+    }
+    p->newSOS(vars.size(), (it->first>0) ? Minotaur::SOS1 : Minotaur::SOS2,
+              &wts[0], vars, prio[it->first]);
+  }
+  logger_->msgStream(Minotaur::LogDebug) << me_ << "number of SOS = "
+                                         << sets.size() << std::endl;
+}
+
+
+// See AMPLInterface::addVariablesFromASL_() for the order in which AMPL
+// writes variables.
+void NlReader::addVars_(Minotaur::ProblemPtr p)
+{
+  std::vector<std::string> names;
+  Minotaur::VariableType vtype;
+  int nlv = std::max(nlvc_, nlvo_);
+  int nlin = nVars_ - (niv_ + nbv_);
+
+  getNames_(".col", nVars_, names);
+  vars_.reserve(nVars_+nDefs_);
+  for (int i=0; i<nVars_; ++i) {
+    if (i<nlvb_) {
+      vtype = (i < nlvb_-nlvbi_) ? Minotaur::Continuous : Minotaur::Integer;
+    } else if (i<nlvc_) {
+      vtype = (i < nlvc_-nlvci_) ? Minotaur::Continuous : Minotaur::Integer;
+    } else if (i<nlv) {
+      vtype = (i < nlvo_-nlvoi_) ? Minotaur::Continuous : Minotaur::Integer;
+    } else if (i<nlin) {
+      vtype = Minotaur::Continuous;
+    } else if (i<nlin+nbv_) {
+      vtype = Minotaur::Binary;
+    } else {
+      vtype = Minotaur::Integer;
+    }
+    vars_.push_back(p->newVariable(-INFINITY, INFINITY, vtype, names[i]));
+  }
+  for (int i=0; i<nDefs_; ++i) {
+    std::stringstream name_stream;
+    name_stream << "defvar" << i;
+    vars_.push_back(p->newVariable(-INFINITY, INFINITY, Minotaur::Continuous,
+                                   name_stream.str()));
+  }
+}
+
+
+void NlReader::clear_()
+{
+  if (file_) {
+    fclose(file_);
+    file_ = 0;
+  }
+  if (buf_) {
+    delete [] buf_;
+    buf_ = 0;
+  }
+  if (x_) {
+    delete [] x_;
+    x_ = 0;
+  }
+  if (grad_) {
+    delete [] grad_;
+    grad_ = 0;
+  }
+  rows_.clear();
+  obj_.cg.reset();
+  obj_.lf.reset();
+  vars_.clear();
+  typeCnt_.clear();
+  bufPos_ = bufLen_ = 0;
+}
+
+
+bool NlReader::fillBuf_()
+{
+  bufPos_ = 0;
+  bufLen_ = fread(buf_, 1, bufSize_, file_);
+  return (bufLen_>0);
+}
+
+
+const double * NlReader::getInitialPoint() const
+{
+  return iniPt_;
+}
+
+
+void NlReader::getNames_(std::string suffix, Minotaur::UInt n,
+                         std::vector<std::string> &names)
+{
+  std::ifstream fin((stub_+suffix).c_str());
+  std::string line;
+  std::string def = (".col"==suffix) ? "_svar[" : "_scon[";
+
+  names.reserve(n);
+  if (fin.is_open()) {
+    while (names.size()<n && std::getline(fin, line)) {
+      names.push_back(line);
+    }
+  }
+  while (names.size()<n) {
+    std::stringstream name_stream;
+    if (".row"==suffix && names.size()>=(Minotaur::UInt) nCons_) {
+      name_stream << "_sobj[" << names.size()-nCons_+1 << "]";
+    } else {
+      name_stream << def << names.size()+1 << "]";
+    }
+    names.push_back(name_stream.str());
+  }
+}
+
+
+Minotaur::UInt NlReader::getNumDefs() const
+{
+  return nDefs_;
+}
+
+
+int NlReader::peekByte_()
+{
+  if (bufPos_>=bufLen_ && !fillBuf_()) {
+    return EOF;
+  }
+  return (unsigned char) buf_[bufPos_];
+}
+
+
+int NlReader::peekChar_()
+{
+  if (!isBinary_) {
+    skipSpace_();
+  }
+  return peekByte_();
+}
+
+
+int NlReader::readByte_()
+{
+  if (bufPos_>=bufLen_ && !fillBuf_()) {
+    return EOF;
+  }
+  return (unsigned char) buf_[bufPos_++];
+}
+
+
+void NlReader::readBounds_(int n, double *lb, double *ub, int *err)
+{
+  int c;
+  for (int i=0; i<n && 0==*err; ++i) {
+    c = readChar_();
+    switch (c) {
+    case ('0'):
+      lb[i] = readDouble_(err);
+      ub[i] = readDouble_(err);
+      break;
+    case ('1'):
+      lb[i] = -INFINITY;
+      ub[i] = readDouble_(err);
+      break;
+    case ('2'):
+      lb[i] = readDouble_(err);
+      ub[i] = INFINITY;
+      break;
+    case ('3'):
+      lb[i] = -INFINITY;
+      ub[i] = INFINITY;
+      break;
+    case ('4'):
+      lb[i] = ub[i] = readDouble_(err);
+      break;
+    case ('5'):
+      logger_->errStream() << me_ << "complementarity constraints are not "
+                           << "supported." << std::endl;
+      *err = 1;
+      break;
+    default:
+      logger_->errStream() << me_ << "bad bound type " << (char) c
+                           << std::endl;
+      *err = 1;
+    }
+  }
+}
+
+
+void NlReader::readBytes_(char *c, size_t n, int *err)
+{
+  size_t k;
+  while (n>0) {
+    if (bufPos_>=bufLen_ && !fillBuf_()) {
+      *err = 1;
+      return;
+    }
+    k = std::min(n, bufLen_-bufPos_);
+    memcpy(c, buf_+bufPos_, k);
+    bufPos_ += k;
+    c += k;
+    n -= k;
+  }
+}
+
+
+int NlReader::readChar_()
+{
+  if (!isBinary_) {
+    skipSpace_();
+  }
+  return readByte_();
+}
+
+
+double NlReader::readDouble_(int *err)
+{
+  double d = 0;
+  if (isBinary_) {
+    readBytes_((char *) &d, sizeof(double), err);
+    if (swap_) {
+      std::reverse((char *) &d, (char *) &d + sizeof(double));
+    }
+  } else {
+    char token[64];
+    char *e = 0;
+    int c;
+    size_t i = 0;
+
+    skipSpace_();
+    c = peekByte_();
+    while (EOF!=c && !isspace(c) && '#'!=c && i<sizeof(token)-1) {
+      token[i++] = (char) c;
+      ++bufPos_;
+      c = peekByte_();
+    }
+    token[i] = '\0';
+    d = strtod(token, &e);
+    if (0==i || *e!='\0') {
+      logger_->errStream() << me_ << "expected a number, found \"" << token
+                           << "\"" << std::endl;
+      *err = 1;
+    }
+  }
+  return d;
+}
+
+
+Minotaur::CNode* NlReader::readExpr_(Minotaur::CGraphPtr cg,
+                                     Minotaur::FunctionType *ftype, int *err)
+{
+  Minotaur::CNode *lchild = 0;
+  Minotaur::CNode *rchild = 0;
+  Minotaur::CNode *n = 0;
+  Minotaur::FunctionType ltype, rtype;
+  Minotaur::OpCode op;
+  int c, i, nlop;
+  double d;
+
+  c = readChar_();
+  switch (c) {
+  case ('n'):
+    *ftype = Minotaur::Constant;
+    return cg->newNode(readDouble_(err));
+  case ('l'):
+  case ('s'):
+    *ftype = Minotaur::Constant;
+    if (isBinary_ && 's'==c) {
+      short s = 0;
+      readBytes_((char *) &s, sizeof(short), err);
+      if (swap_) {
+        std::reverse((char *) &s, (char *) &s + sizeof(short));
+      }
+      return cg->newNode((double) s);
+    }
+    return cg->newNode(isBinary_ ? (double) readInt_(err) : readDouble_(err));
+  case ('v'):
+    i = readInt_(err);
+    if (i<0 || i>=nVars_+nDefs_) {
+      logger_->errStream() << me_ << "bad variable index " << i << std::endl;
+      *err = 1;
+      return 0;
+    }
+    *ftype = Minotaur::Linear;
+    return cg->newNode(vars_[i]);
+  case ('o'):
+    break;
+  case ('f'):
+    logger_->errStream() << me_ << "imported functions are not supported."
+                         << std::endl;
+    *err = 1;
+    return 0;
+  case ('h'):
+    logger_->errStream() << me_ << "string expressions are not supported."
+                         << std::endl;
+    *err = 1;
+    return 0;
+  default:
+    logger_->errStream() << me_ << "unexpected character '" << (char) c
+                         << "' in expression." << std::endl;
+    *err = 1;
+    return 0;
+  }
+
+  nlop = readInt_(err);
+  if (*err) {
+    return 0;
+  }
+  op = univarOp(nlop);
+  if (Minotaur::OpNone!=op) {
+    lchild = readExpr_(cg, &ltype, err);
+    if (*err) {
+      return 0;
+    }
+    if (Minotaur::OpSqr==op) {
+      *ftype = powType(ltype, 2.0);
+    } else if (Minotaur::OpUMinus==op) {
+      *ftype = ltype;
+    } else {
+      *ftype = (Minotaur::Constant==ltype) ? Minotaur::Constant :
+        Minotaur::Nonlinear;
+    }
+    return cg->newNode(op, lchild, 0);
+  }
+
+  switch (nlop) {
+  case (NlPlus):
+  case (NlMinus):
+  case (NlMult):
+  case (NlDiv):
+  case (NlIntDiv):
+    lchild = readExpr_(cg, &ltype, err);
+    if (0==*err) {
+      rchild = readExpr_(cg, &rtype, err);
+    }
+    if (*err) {
+      return 0;
+    }
+    if (NlPlus==nlop) {
+      op = Minotaur::OpPlus;
+      *ftype = Minotaur::funcTypesAdd(ltype, rtype);
+    } else if (NlMinus==nlop) {
+      op = Minotaur::OpMinus;
+      *ftype = Minotaur::funcTypesAdd(ltype, rtype);
+    } else if (NlMult==nlop) {
+      op = Minotaur::OpMult;
+      *ftype = Minotaur::funcTypesMult(ltype, rtype);
+    } else if (NlDiv==nlop) {
+      op = Minotaur::OpDiv;
+      *ftype = (Minotaur::Constant==rtype) ? ltype : Minotaur::Nonlinear;
+    } else {
+      op = Minotaur::OpIntDiv;
+      *ftype = (Minotaur::Constant==ltype && Minotaur::Constant==rtype) ?
+        Minotaur::Constant : Minotaur::Nonlinear;
+    }
+    n = cg->newNode(op, lchild, rchild);
+    break;
+  case (NlSumList):
+    {
+      int nargs = readInt_(err);
+      Minotaur::CNode **childr;
+      if (*err || nargs<1) {
+        *err = 1;
+        return 0;
+      }
+      childr = new Minotaur::CNode *[nargs];
+      *ftype = Minotaur::Constant;
+      for (i=0; i<nargs && 0==*err; ++i) {
+        childr[i] = readExpr_(cg, &ltype, err);
+        *ftype = Minotaur::funcTypesAdd(*ftype, ltype);
+      }
+      if (0==*err) {
+        n = cg->newNode(Minotaur::OpSumList, childr, nargs);
+      }
+      delete [] childr;
+    }
+    break;
+  case (NlPow):
+  case (NlPow1):
+  case (NlCPow):
+    // Look ahead so that constant base or exponent are not added as
+    // unused nodes of the graph.
+    c = peekChar_();
+    if (NlCPow==nlop || 'n'==c) {
+      if ('n'!=readChar_()) {
+        *err = 1;
+        return 0;
+      }
+      d = readDouble_(err);
+      rchild = readExpr_(cg, &rtype, err);
+      if (*err) {
+        return 0;
+      }
+      *ftype = (Minotaur::Constant==rtype) ? Minotaur::Constant :
+        Minotaur::Nonlinear;
+      n = cg->newNode(Minotaur::OpCPow, cg->newNode(d), rchild);
+      break;
+    }
+    lchild = readExpr_(cg, &ltype, err);
+    if (*err) {
+      return 0;
+    }
+    c = peekChar_();
+    if (NlPow1==nlop || 'n'==c) {
+      if ('n'!=readChar_()) {
+        *err = 1;
+        return 0;
+      }
+      d = readDouble_(err);
+      *ftype = powType(ltype, d);
+      if (2.0==d) {
+        n = cg->newNode(Minotaur::OpSqr, lchild, 0);
+      } else {
+        n = cg->newNode(Minotaur::OpPowK, lchild, cg->newNode(d));
+      }
+    } else {
+      rchild = readExpr_(cg, &rtype, err);
+      if (*err) {
+        return 0;
+      }
+      *ftype = (Minotaur::Constant==ltype && Minotaur::Constant==rtype) ?
+        Minotaur::Constant : Minotaur::Nonlinear;
+      n = cg->newNode(Minotaur::OpPow, lchild, rchild);
+    }
+    break;
+  case (NlRound):
+    // round(x, k) is supported only for k = 0.
+    lchild = readExpr_(cg, &ltype, err);
+    if (*err) {
+      return 0;
+    }
+    if ('n'!=readChar_() || 0.0!=readDouble_(err)) {
+      unsupportedOp_(nlop);
+      *err = 1;
+      return 0;
+    }
+    *ftype = (Minotaur::Constant==ltype) ? Minotaur::Constant :
+      Minotaur::Nonlinear;
+    n = cg->newNode(Minotaur::OpRound, lchild, 0);
+    break;
+  default:
+    unsupportedOp_(nlop);
+    *err = 1;
+  }
+  return n;
+}
+
+
+int NlReader::readHeader_()
+{
+  std::string line;
+  long vals[6];
+  int narith, one = 1;
+
+  // line 1: g or b followed by options.
+  readLine_(line);
+  if (line.empty() || ('g'!=line[0] && 'b'!=line[0])) {
+    logger_->errStream() << me_ << stub_ << " is not a .nl file."
+                         << std::endl;
+    return 1;
+  }
+  isBinary_ = ('b'==line[0]);
+
+  // line 2: vars, constraints, objectives, ranges, eqns, logical
+  // constraints.
+  readLine_(line);
+  headerInts(line, vals, 6);
+  nVars_ = vals[0];
+  nCons_ = vals[1];
+  nObjs_ = vals[2];
+  if (vals[5]>0) {
+    logger_->errStream() << me_ << "logical constraints are not supported."
+                         << std::endl;
+    return 1;
+  }
+  if (nObjs_>1) {
+    logger_->errStream() << me_ << "only one objective is supported."
+                         << std::endl;
+    return 1;
+  }
+
+  // line 3: nonlinear constraints, objectives, complementarity
+  readLine_(line);
+  headerInts(line, vals, 3);
+  nlc_ = vals[0];
+  if (vals[2]>0) {
+    logger_->errStream() << me_ << "complementarity constraints are not "
+                         << "supported." << std::endl;
+    return 1;
+  }
+
+  // line 4: network constraints: nonlinear, linear
+  readLine_(line);
+  headerInts(line, vals, 2);
+  if (vals[0]>0 || vals[1]>0) {
+    logger_->errStream() << me_ << "network constraints are not supported."
+                         << std::endl;
+    return 1;
+  }
+
+  // line 5: nonlinear vars in constraints, objectives, both
+  readLine_(line);
+  headerInts(line, vals, 3);
+  nlvc_ = vals[0];
+  nlvo_ = vals[1];
+  nlvb_ = vals[2];
+
+  // line 6: linear network variables; functions; arith, flags
+  readLine_(line);
+  headerInts(line, vals, 3);
+  if (vals[0]>0) {
+    logger_->errStream() << me_ << "network variables are not supported."
+                         << std::endl;
+    return 1;
+  }
+  if (vals[1]>0) {
+    logger_->errStream() << me_ << "imported functions are not supported."
+                         << std::endl;
+    return 1;
+  }
+  // arith is 1 for little-endian and 2 for big-endian IEEE arithmetic.
+  narith = (1==*(char *) &one) ? 1 : 2;
+  swap_ = isBinary_ && vals[2]>0 && vals[2]!=narith;
+
+  // line 7: discrete variables: binary, integer, nonlinear (b,c,o)
+  readLine_(line);
+  headerInts(line, vals, 5);
+  nbv_   = vals[0];
+  niv_   = vals[1];
+  nlvbi_ = vals[2];
+  nlvci_ = vals[3];
+  nlvoi_ = vals[4];
+
+  // line 8: nonzeros in Jacobian, gradients
+  // line 9: max name lengths: constraints, variables
+  readLine_(line);
+  readLine_(line);
+
+  // line 10: common exprs: b,c,o,c1,o1
+  readLine_(line);
+  headerInts(line, vals, 5);
+  nDefs_ = vals[0]+vals[1]+vals[2]+vals[3]+vals[4];
+
+  return 0;
+}
+
+
+Minotaur::ProblemPtr NlReader::readInstance(std::string fname)
+{
+  Minotaur::ProblemPtr p = Minotaur::ProblemPtr(); // NULL
+  Minotaur::Timer *timer = env_->getNewTimer();
+
+  timer->start();
+  clear_();
+  stub_ = fname;
+  file_ = fopen(fname.c_str(), "rb");
+  if (!file_) {
+    file_ = fopen((fname+".nl").c_str(), "rb");
+  } else if (fname.size()>3 && ".nl"==fname.substr(fname.size()-3)) {
+    stub_ = fname.substr(0, fname.size()-3);
+  }
+  if (!file_) {
+    logger_->errStream() << me_ << "can not open file " << fname
+                         << std::endl;
+    delete timer;
+    return p;
+  }
+  buf_ = new char[bufSize_];
+
+  if (0==readHeader_()) {
+    p = (Minotaur::ProblemPtr) new Minotaur::Problem();
+    if (0!=readSegments_(p)) {
+      p->clear();
+      p.reset();
+    }
+  }
+
+  if (p) {
+    logger_->msgStream(Minotaur::LogExtraInfo) << me_ << "functions read: "
+      << "constant = " << typeCnt_[Minotaur::Constant]
+      << ", linear = " << typeCnt_[Minotaur::Linear]
+      << ", quadratic = " << typeCnt_[Minotaur::Quadratic]
+      << ", polynomial = " << typeCnt_[Minotaur::Polynomial]
+      << ", nonlinear = " << typeCnt_[Minotaur::Nonlinear] << std::endl;
+    logger_->msgStream(Minotaur::LogInfo) << me_ << "problem type is "
+      << Minotaur::getProblemTypeString(p->findType()) << std::endl;
+    logger_->msgStream(Minotaur::LogExtraInfo) << me_ << "time used = "
+      << timer->query() << std::endl;
+  }
+  clear_();
+  delete timer;
+  return p;
+}
+
+
+int NlReader::readInt_(int *err)
+{
+  int i = 0;
+  if (isBinary_) {
+    readBytes_((char *) &i, sizeof(int), err);
+    if (swap_) {
+      std::reverse((char *) &i, (char *) &i + sizeof(int));
+    }
+  } else {
+    int c, sign = 1;
+    bool found = false;
+
+    skipSpace_();
+    c = peekByte_();
+    if ('-'==c || '+'==c) {
+      sign = ('-'==c) ? -1 : 1;
+      ++bufPos_;
+      c = peekByte_();
+    }
+    while (c>='0' && c<='9') {
+      i = 10*i + (c-'0');
+      found = true;
+      ++bufPos_;
+      c = peekByte_();
+    }
+    if (!found) {
+      logger_->errStream() << me_ << "expected an integer." << std::endl;
+      *err = 1;
+    }
+    i *= sign;
+  }
+  return i;
+}
+
+
+void NlReader::readLinear_(NlRow &row, int k, int *err)
+{
+  bool has_lf = (row.lf!=0);
+  int j;
+  double a;
+
+  if (!has_lf) {
+    row.lf = (Minotaur::LinearFunctionPtr) new Minotaur::LinearFunction();
+  }
+  for (int i=0; i<k && 0==*err; ++i) {
+    j = readInt_(err);
+    a = readDouble_(err);
+    if (j<0 || j>=nVars_+nDefs_) {
+      *err = 1;
+    } else if (has_lf) {
+      row.lf->incTerm(vars_[j], a);
+    } else {
+      row.lf->addTerm(vars_[j], a);
+    }
+  }
+  if (0==row.lf->getNumTerms()) {
+    row.lf.reset();
+  }
+}
+
+
+void NlReader::readLine_(std::string &str)
+{
+  int c = readByte_();
+  str.clear();
+  while (EOF!=c && '\n'!=c) {
+    str.push_back((char) c);
+    c = readByte_();
+  }
+}
+
+
+void NlReader::readRow_(NlRow &row, int *err)
+{
+  Minotaur::FunctionType ftype = Minotaur::Constant;
+  Minotaur::CGraphPtr cg;
+  Minotaur::CNode *cnode;
+  Minotaur::VariableSet vset;
+  int c = peekChar_();
+
+  // Most rows of large models are linear. Their expression is just a
+  // number and we do not need a graph for it.
+  if ('n'==c) {
+    readChar_();
+    row.c += readDouble_(err);
+    ++typeCnt_[Minotaur::Constant];
+    return;
+  }
+
+  cg = (Minotaur::CGraphPtr) new Minotaur::CGraph();
+  cnode = readExpr_(cg, &ftype, err);
+  if (*err) {
+    return;
+  }
+  ++typeCnt_[ftype];
+  cg->setOut(cnode);
+  cg->finalize();
+  if (Minotaur::Constant==ftype) {
+    row.c += cg->eval(x_, err);
+  } else if (Minotaur::Linear==ftype) {
+    // Convert the graph into a linear function. Only entries of variables
+    // in the graph are touched in grad_, so this is cheap for big models.
+    if (!row.lf) {
+      row.lf = (Minotaur::LinearFunctionPtr) new Minotaur::LinearFunction();
+    }
+    row.c += cg->eval(x_, err);
+    cg->evalGradient(x_, grad_, err);
+    cg->getVars(&vset);
+    for (Minotaur::VarSetConstIterator it=vset.begin(); it!=vset.end();
+         ++it) {
+      row.lf->incTerm(*it, grad_[(*it)->getIndex()]);
+      grad_[(*it)->getIndex()] = 0.0;
+    }
+    if (0==row.lf->getNumTerms()) {
+      row.lf.reset();
+    }
+  } else {
+    row.cg = cg;
+  }
+}
+
+
+int NlReader::readSegments_(Minotaur::ProblemPtr p)
+{
+  Minotaur::DoubleVector sosno, ref, pri;
+  double *lb = 0, *ub = 0;
+  int c, i, j, k, err = 0;
+  double a;
+
+  addVars_(p);
+  x_ = new double[nVars_+nDefs_];
+  grad_ = new double[nVars_+nDefs_];
+  std::fill(x_, x_+nVars_+nDefs_, 0.0);
+  std::fill(grad_, grad_+nVars_+nDefs_, 0.0);
+  if (iniPt_) {
+    delete [] iniPt_;
+  }
+  iniPt_ = new double[nVars_];
+  std::fill(iniPt_, iniPt_+nVars_, 0.0);
+  rows_.resize(nCons_+nDefs_);
+  for (i=0; i<nCons_+nDefs_; ++i) {
+    rows_[i].c = 0.0;
+    rows_[i].lb = -INFINITY;
+    rows_[i].ub = INFINITY;
+  }
+  obj_.c = 0.0;
+  typeCnt_.resize(Minotaur::UnknownFunction+1, 0);
+
+  while (0==err && EOF!=(c=readChar_())) {
+    switch (c) {
+    case ('C'):
+      i = readInt_(&err);
+      if (0==err && i>=0 && i<nCons_) {
+        readRow_(rows_[i], &err);
+      } else {
+        err = 1;
+      }
+      break;
+    case ('O'):
+      i = readInt_(&err);
+      j = readInt_(&err);
+      if (0==err && 0==i) {
+        objSense_ = (1==j) ? Minotaur::Maximize : Minotaur::Minimize;
+        readRow_(obj_, &err);
+      } else {
+        err = 1;
+      }
+      break;
+    case ('V'):
+      // defined variable: index, number of linear terms, where used.
+      i = readInt_(&err);
+      j = readInt_(&err);
+      readInt_(&err);
+      i -= nVars_;
+      if (0==err && i>=0 && i<nDefs_) {
+        NlRow &r = rows_[nCons_+i];
+        readLinear_(r, j, &err);
+        if (0==err) {
+          readRow_(r, &err);
+        }
+        // the constraint is: lf + nlf + c - defvar_[i] = 0
+        if (!r.lf) {
+          r.lf = (Minotaur::LinearFunctionPtr)
+            new Minotaur::LinearFunction();
+        }
+        r.lf->incTerm(vars_[nVars_+i], -1.0);
+      } else {
+        err = 1;
+      }
+      break;
+    case ('J'):
+      i = readInt_(&err);
+      k = readInt_(&err);
+      if (0==err && i>=0 && i<nCons_) {
+        readLinear_(rows_[i], k, &err);
+      } else {
+        err = 1;
+      }
+      break;
+    case ('G'):
+      i = readInt_(&err);
+      k = readInt_(&err);
+      if (0==err && 0==i) {
+        readLinear_(obj_, k, &err);
+      } else {
+        err = 1;
+      }
+      break;
+    case ('r'):
+      lb = new double[nCons_];
+      ub = new double[nCons_];
+      readBounds_(nCons_, lb, ub, &err);
+      for (i=0; i<nCons_; ++i) {
+        rows_[i].lb = lb[i];
+        rows_[i].ub = ub[i];
+      }
+      delete [] lb;
+      delete [] ub;
+      break;
+    case ('b'):
+      lb = new double[nVars_];
+      ub = new double[nVars_];
+      readBounds_(nVars_, lb, ub, &err);
+      for (i=0; i<nVars_ && 0==err; ++i) {
+        p->changeBound(i, lb[i], ub[i]);
+      }
+      delete [] lb;
+      delete [] ub;
+      break;
+    case ('x'):
+    case ('d'):
+      // initial primal or dual values. We save only the primal.
+      k = readInt_(&err);
+      for (int l=0; l<k && 0==err; ++l) {
+        i = readInt_(&err);
+        a = readDouble_(&err);
+        if ('x'==c && i>=0 && i<nVars_) {
+          iniPt_[i] = a;
+        }
+      }
+      break;
+    case ('k'):
+      // cumulative column counts of the Jacobian. Not needed.
+      k = readInt_(&err);
+      for (int l=0; l<k && 0==err; ++l) {
+        readInt_(&err);
+      }
+      break;
+    case ('S'):
+      readSuffix_(sosno, ref, pri, &err);
+      break;
+    case ('F'):
+      logger_->errStream() << me_ << "imported functions are not supported."
+                           << std::endl;
+      err = 1;
+      break;
+    case ('L'):
+      logger_->errStream() << me_ << "logical constraints are not supported."
+                           << std::endl;
+      err = 1;
+      break;
+    default:
+      logger_->errStream() << me_ << "unknown segment '" << (char) c << "'"
+                           << std::endl;
+      err = 1;
+    }
+  }
+  if (err) {
+    logger_->errStream() << me_ << "error reading " << stub_ << std::endl;
+    return err;
+  }
+
+  addRows_(p);
+  addSOS_(p, sosno, ref, pri);
+  return 0;
+}
+
+
+void NlReader::readString_(std::string &str, int *err)
+{
+  str.clear();
+  if (isBinary_) {
+    int n = readInt_(err);
+    if (0==*err && n>0) {
+      str.resize(n);
+      readBytes_(&str[0], n, err);
+    }
+  } else {
+    int c;
+    skipSpace_();
+    c = peekByte_();
+    while (EOF!=c && !isspace(c)) {
+      str.push_back((char) c);
+      ++bufPos_;
+      c = peekByte_();
+    }
+    if (str.empty()) {
+      *err = 1;
+    }
+  }
+}
+
+
+void NlReader::readSuffix_(Minotaur::DoubleVector &sosno,
+                           Minotaur::DoubleVector &ref,
+                           Minotaur::DoubleVector &pri, int *err)
+{
+  // kind: 0 = variables, 1 = constraints, 2 = objectives, 3 = problem.
+  // 4 is added if the values are real.
+  int kind = readInt_(err);
+  int n = readInt_(err);
+  bool is_real = (kind & 4);
+  Minotaur::DoubleVector *vals = 0;
+  std::string name;
+  double a;
+  int i;
+
+  readString_(name, err);
+  if (0==(kind & 3)) {
+    if ("sosno"==name) {
+      vals = &sosno;
+    } else if ("ref"==name) {
+      vals = &ref;
+    } else if ("priority"==name) {
+      vals = &pri;
+    }
+  }
+  if (vals) {
+    vals->resize(nVars_, 0.0);
+  }
+  for (int l=0; l<n && 0==*err; ++l) {
+    i = readInt_(err);
+    a = is_real ? readDouble_(err) : (double) readInt_(err);
+    if (vals && i>=0 && i<nVars_) {
+      (*vals)[i] = a;
+    }
+  }
+}
+
+
+void NlReader::skipSpace_()
+{
+  int c = peekByte_();
+  while (EOF!=c) {
+    if ('#'==c) {
+      while (EOF!=c && '\n'!=c) {
+        ++bufPos_;
+        c = peekByte_();
+      }
+    } else if (isspace(c)) {
+      ++bufPos_;
+      c = peekByte_();
+    } else {
+      break;
+    }
+  }
+}
+
+
+void NlReader::unsupportedOp_(int opcode)
+{
+  logger_->errStream() << me_ << "opcode o" << opcode << " is unsupported!"
+                       << std::endl;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,283 @@
+//
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2008 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file NlReader.h
+ * \brief Declare the NlReader class for reading .nl files without ASL.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ */
+
+#ifndef MINOTAURNLREADER_H
+#define MINOTAURNLREADER_H
+
+#include <cstdio>
+#include <string>
+
+#include "Types.h"
+
+namespace Minotaur {
+class   CGraph;
+class   CNode;
+class   LinearFunction;
+typedef boost::shared_ptr<CGraph> CGraphPtr;
+typedef boost::shared_ptr<LinearFunction> LinearFunctionPtr;
+}
+
+namespace MINOTAUR_AMPL {
+
+/**
+ * \brief Read a .nl file directly into Minotaur data structures.
+ *
+ * NlReader parses the text ('g') and binary ('b') formats of .nl files
+ * written by AMPL in one pass over the file. Variables, linear functions and
+ * computational graphs (CGraph) are created as the segments are read, and
+ * the type of each function is found while its expression is parsed. Unlike
+ * AMPLInterface::readInstance(), no ASL data structures are ever created, so
+ * the peak memory is that of the Minotaur Problem alone.
+ *
+ * Nonlinear functions are always stored as CGraphs. Defined variables
+ * (common expressions) are added as new variables along with constraints
+ * that define them, in the same order as AMPLInterface does it. Imported
+ * functions, logical and complementarity constraints, and network
+ * variables are not supported.
+ */
+class NlReader {
+public:
+  /// Constructor.
+  NlReader(Minotaur::EnvPtr env);
+
+  /// Destroy.
+  ~NlReader();
+
+  /// Get the initial point provided in the .nl file. NULL if not read yet.
+  const double * getInitialPoint() const;
+
+  /// Get the number of defined variables.
+  Minotaur::UInt getNumDefs() const;
+
+  /**
+   * \brief Read an instance from a .nl file.
+   *
+   * \param[in] fname The name of the file. If it does not exist, fname.nl
+   * is tried.
+   * \return The problem read from the file. NULL if the file could not be
+   * read or had something that we do not support.
+   */
+  Minotaur::ProblemPtr readInstance(std::string fname);
+
+private:
+  /// Constraints or objectives that are created after the whole file is read.
+  struct NlRow {
+    Minotaur::CGraphPtr cg;         ///< Nonlinear part, NULL if none.
+    Minotaur::LinearFunctionPtr lf; ///< Linear part, NULL if none.
+    double c;                       ///< Constant in the expression.
+    double lb;                      ///< Lower bound (unused for objective).
+    double ub;                      ///< Upper bound (unused for objective).
+  };
+
+  /// Size of the buffer used to read the file.
+  static const size_t bufSize_ = 1<<16;
+
+  /// Buffer in which the file is read.
+  char *buf_;
+
+  /// Position of the next unread byte in buf_.
+  size_t bufPos_;
+
+  /// Number of bytes in buf_.
+  size_t bufLen_;
+
+  /// Name of the file without .nl
+  std::string stub_;
+
+  /// Number of binary variables that appear only linearly.
+  int nbv_;
+
+  /// Number of constraints.
+  int nCons_;
+
+  /// Number of defined variables (common expressions).
+  int nDefs_;
+
+  /// Number of integer variables that appear only linearly.
+  int niv_;
+
+  /// Number of objectives.
+  int nObjs_;
+
+  /// Number of variables, not including defined variables.
+  int nVars_;
+
+  /// Number of nonlinear variables in both constraints and objectives.
+  int nlvb_;
+
+  /// Number of integer nonlinear variables in both constraints and
+  /// objectives.
+  int nlvbi_;
+
+  /// Number of nonlinear variables in constraints.
+  int nlvc_;
+
+  /// Number of integer nonlinear variables in constraints only.
+  int nlvci_;
+
+  /// Number of nonlinear variables in objectives.
+  int nlvo_;
+
+  /// Number of integer nonlinear variables in objectives only.
+  int nlvoi_;
+
+  /// Number of nonlinear constraints.
+  int nlc_;
+
+  /// Environment.
+  Minotaur::EnvPtr env_;
+
+  /// The file being read.
+  FILE *file_;
+
+  /// True if the file is in binary format, false if text.
+  bool isBinary_;
+
+  /// Initial point read from the file.
+  double *iniPt_;
+
+  /// Log manager.
+  Minotaur::LoggerPtr logger_;
+
+  /// For logging.
+  static const std::string me_;
+
+  /// Constraints (including those of defined variables).
+  std::vector<NlRow> rows_;
+
+  /// Objective.
+  NlRow obj_;
+
+  /// Sense of the objective.
+  Minotaur::ObjectiveType objSense_;
+
+  /// True if bytes in numbers of binary files have to be swapped.
+  bool swap_;
+
+  /// Number of constraints of each function type, for logging.
+  Minotaur::UIntVector typeCnt_;
+
+  /// Variables in the instance, including defined variables.
+  Minotaur::VarVector vars_;
+
+  /// Scratch point for extracting linear functions from CGraphs.
+  double *x_;
+
+  /// Scratch gradient for extracting linear functions from CGraphs.
+  double *grad_;
+
+  /// Add the constraints and objective once all segments are read.
+  void addRows_(Minotaur::ProblemPtr p);
+
+  /// Add SOS constraints using suffixes sosno, ref and priority.
+  void addSOS_(Minotaur::ProblemPtr p, const Minotaur::DoubleVector &sosno,
+               const Minotaur::DoubleVector &ref,
+               const Minotaur::DoubleVector &pri);
+
+  /// Add all variables. Their types are found from the header.
+  void addVars_(Minotaur::ProblemPtr p);
+
+  /// Free memory used while reading.
+  void clear_();
+
+  /// Fill-up the buffer. Return false if nothing more could be read.
+  bool fillBuf_();
+
+  /// Get the name of i-th variable or constraint from .col and .row files.
+  void getNames_(std::string suffix, Minotaur::UInt n,
+                 std::vector<std::string> &names);
+
+  /// Return the next byte without moving ahead. EOF if none.
+  int peekByte_();
+
+  /// Return the next non-whitespace character without moving ahead.
+  int peekChar_();
+
+  /// Read and return the next byte. EOF if none.
+  int readByte_();
+
+  /**
+   * \brief Read bounds on variables ('b' segment) or constraints ('r'
+   * segment) into lb, ub arrays of size n.
+   */
+  void readBounds_(int n, double *lb, double *ub, int *err);
+
+  /// Read 'n' raw bytes from binary file.
+  void readBytes_(char *c, size_t n, int *err);
+
+  /// Read the next non-whitespace character.
+  int readChar_();
+
+  /// Read a real number.
+  double readDouble_(int *err);
+
+  /**
+   * \brief Read an expression recursively and add it to the graph.
+   *
+   * \param[in] cg The graph to which new nodes are added.
+   * \param[out] ftype Type of the function of the expression read.
+   * \param[out] err Set to nonzero if an error occurred.
+   * \return The output node of the expression.
+   */
+  Minotaur::CNode* readExpr_(Minotaur::CGraphPtr cg,
+                             Minotaur::FunctionType *ftype, int *err);
+
+  /// Read the 10 header lines. Return nonzero if not a valid .nl file.
+  int readHeader_();
+
+  /// Read an integer.
+  int readInt_(int *err);
+
+  /// Read the linear part of a row ('J' or 'G' segment) with k terms.
+  void readLinear_(NlRow &row, int k, int *err);
+
+  /// Read a line of text into str (used for header only).
+  void readLine_(std::string &str);
+
+  /// Read a number or an expression for row and update its fields.
+  void readRow_(NlRow &row, int *err);
+
+  /// Read all segments after the header.
+  int readSegments_(Minotaur::ProblemPtr p);
+
+  /// Read a string of length n (used in binary files and 'h' expressions).
+  void readString_(std::string &str, int *err);
+
+  /**
+   * \brief Read a suffix segment. Values of suffixes that we use are saved
+   * in vals, others are read and ignored.
+   */
+  void readSuffix_(Minotaur::DoubleVector &sosno, Minotaur::DoubleVector &ref,
+                   Minotaur::DoubleVector &pri, int *err);
+
+  /// Skip whitespaces and comments in text files.
+  void skipSpace_();
+
+  /// Complain about an unsupported .nl opcode.
+  void unsupportedOp_(int opcode);
+};
+typedef NlReader* NlReaderPtr;
+
+} // namespace MINOTAUR_AMPL
+
+#endif
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End:
@@ -0,0 +1,116 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "BrVarCand.h"
+#include "BrVarCandBuffer.h"
+#include "BrVarCandBufferUT.h"
+#include "Problem.h"
+#include "Variable.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BrVarCandBufferUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(BrVarCandBufferUT, "BrVarCandBufferUT");
+
+using namespace Minotaur;
+
+void BrVarCandBufferUT::testAdd()
+{
+  BrVarCandBuffer buf;
+  ProblemPtr p = (ProblemPtr) new Problem();
+  BrVarCandPtr cand;
+
+  for (UInt i=0; i<4; ++i) {
+    p->newVariable(0.0, 1.0, Binary);
+  }
+
+  buf.setHandler(1);
+  CPPUNIT_ASSERT(0 == buf.add(1, 0.25, 0.75));
+  CPPUNIT_ASSERT(1 == buf.add(3, 0.5, 0.5));
+  CPPUNIT_ASSERT(buf.isSorted());
+  CPPUNIT_ASSERT(2 == buf.size());
+  CPPUNIT_ASSERT(0 == buf.find(1));
+  CPPUNIT_ASSERT(-1 == buf.find(2));
+  CPPUNIT_ASSERT(-1 == buf.find(10));
+  CPPUNIT_ASSERT(0.25 == buf.getDDist(0));
+  CPPUNIT_ASSERT(0.75 == buf.getUDist(0));
+  CPPUNIT_ASSERT(1 == buf.getHandler(1));
+  CPPUNIT_ASSERT(!buf.getCand(0));
+
+  // first candidate of a variable is kept.
+  CPPUNIT_ASSERT(0 == buf.add(1, 0.5, 0.5));
+  CPPUNIT_ASSERT(0.25 == buf.getDDist(0));
+  CPPUNIT_ASSERT(2 == buf.size());
+
+  // candidate objects.
+  buf.setHandler(2);
+  cand = (BrVarCandPtr) new BrVarCand(p->getVariable(2), 2, 0.1, 0.9);
+  CPPUNIT_ASSERT(2 == buf.add(cand));
+  CPPUNIT_ASSERT(cand == buf.getCand(2));
+  CPPUNIT_ASSERT(2 == buf.getIndex(2));
+  CPPUNIT_ASSERT(2 == buf.getHandler(2));
+  CPPUNIT_ASSERT(!buf.isSorted());
+
+  buf.setScore(1, 3.0);
+  CPPUNIT_ASSERT(3.0 == buf.getScore(1));
+}
+
+
+void BrVarCandBufferUT::testAccumulate()
+{
+  BrVarCandBuffer buf;
+  ProblemPtr p = (ProblemPtr) new Problem();
+  BrVarCandPtr cand;
+
+  p->newVariable(0.0, 1.0, Binary);
+  cand = (BrVarCandPtr) new BrVarCand(p->getVariable(0), 0, 0.1, 0.9);
+  buf.setAccumulate(true);
+  CPPUNIT_ASSERT(0 == buf.add(cand));
+  CPPUNIT_ASSERT(0 == buf.add(0, 0.2, 0.3));
+  CPPUNIT_ASSERT(1 == buf.size());
+  CPPUNIT_ASSERT(fabs(buf.getDDist(0)-0.3) < 1e-12);
+  CPPUNIT_ASSERT(fabs(buf.getUDist(0)-1.2) < 1e-12);
+
+  // the stored object follows the buffer.
+  CPPUNIT_ASSERT(0 == buf.add((BrVarCandPtr) 
+                              new BrVarCand(p->getVariable(0), 0, 1.0, 1.0)));
+  CPPUNIT_ASSERT(cand == buf.getCand(0));
+  CPPUNIT_ASSERT(fabs(cand->getDDist()-1.3) < 1e-12);
+  CPPUNIT_ASSERT(fabs(cand->getUDist()-2.2) < 1e-12);
+}
+
+
+void BrVarCandBufferUT::testClear()
+{
+  BrVarCandBuffer buf;
+
+  buf.add(5, 0.5, 0.5);
+  buf.add(2, 0.5, 0.5);
+  CPPUNIT_ASSERT(!buf.isSorted());
+  buf.clear();
+  CPPUNIT_ASSERT(0 == buf.size());
+  CPPUNIT_ASSERT(buf.isSorted());
+  CPPUNIT_ASSERT(-1 == buf.find(5));
+  CPPUNIT_ASSERT(-1 == buf.find(2));
+
+  CPPUNIT_ASSERT(0 == buf.add(2, 0.4, 0.6));
+  CPPUNIT_ASSERT(0.4 == buf.getDDist(0));
+  CPPUNIT_ASSERT(0 == buf.find(2));
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
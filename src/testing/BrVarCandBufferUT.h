@@ -0,0 +1,45 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef BRVARCANDBUFFERUT_H
+#define BRVARCANDBUFFERUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace Minotaur;
+
+class BrVarCandBufferUT : public CppUnit::TestCase {
+  public:
+    BrVarCandBufferUT(std::string name) : TestCase(name) {}
+    BrVarCandBufferUT() {}
+
+    void testAdd();
+    void testAccumulate();
+    void testClear();
+
+    CPPUNIT_TEST_SUITE(BrVarCandBufferUT);
+    CPPUNIT_TEST(testAdd);
+    CPPUNIT_TEST(testAccumulate);
+    CPPUNIT_TEST(testClear);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+#endif     // #define BRVARCANDBUFFERUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,150 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include "MinotaurConfig.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "MultilinearTermsHandler.h"
+#include "Problem.h"
+#include "Variable.h"
+#include "HypergraphUT.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HypergraphUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(HypergraphUT, "HypergraphUT");
+
+using namespace Minotaur;
+
+void HypergraphUT::setUp()
+{
+  // Terms {x0,x1}, {x1,x2}, {x0,x1,x2}, {x3} and again {x0,x1}, with
+  // weights 3, 2 (1 in a constraint, 1 in the objective), 1, 4 and 3.
+  UInt vars[5][3] = {{0, 1, 9}, {1, 2, 9}, {0, 1, 2}, {3, 9, 9}, {0, 1, 9}};
+  double wts[5] = {3.0, 1.0, 1.0, -4.0, 3.0};
+  LinearFunctionPtr olf = (LinearFunctionPtr) new LinearFunction();
+
+  p_ = (ProblemPtr) new Problem();
+  x_.clear();
+  terms_.clear();
+  for (UInt i=0; i<4; ++i) {
+    x_.push_back(p_->newVariable(0.0, 1.0, Continuous));
+  }
+  for (UInt t=0; t<5; ++t) {
+    VariablePtr z = p_->newVariable(0.0, 1.0, Continuous);
+    LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+    SetOfVars s;
+    for (UInt j=0; j<3; ++j) {
+      if (vars[t][j] < 4) {
+        s.insert(x_[vars[t][j]]);
+      }
+    }
+    terms_[z] = s;
+    lf->addTerm(z, wts[t]);
+    p_->newConstraint((FunctionPtr) new Function(lf), -1.0, 1.0);
+    if (1==t) {
+      olf->addTerm(z, 1.0);
+    }
+  }
+  p_->newObjective((FunctionPtr) new Function(olf), 0.0, Minimize);
+}
+
+
+void HypergraphUT::testCreate()
+{
+  Hypergraph h(p_);
+  bool pos = false;
+  SetOfVars e;
+
+  h.create(terms_);
+  // the repeated term is merged with the first one.
+  CPPUNIT_ASSERT(4 == h.numVertices());
+  CPPUNIT_ASSERT(4 == h.numEdges());
+  CPPUNIT_ASSERT(3 == h.incidentEdges(x_[1]).size());
+  CPPUNIT_ASSERT(1 == h.incidentEdges(x_[3]).size());
+  CPPUNIT_ASSERT(6.0 == h.weightedDegree(x_[1]));
+  CPPUNIT_ASSERT(4.0 == h.weightedDegree(x_[0]));
+
+  e = h.heaviestEdge(pos);
+  CPPUNIT_ASSERT(true == pos);
+  CPPUNIT_ASSERT(1 == e.size() && x_[3] == *(e.begin()));
+  CPPUNIT_ASSERT(x_[1] == h.maxWeightedDegreeVertex(pos));
+  CPPUNIT_ASSERT(true == pos);
+}
+
+
+void HypergraphUT::testGrow()
+{
+  Hypergraph h(p_);
+  SetOfVars g;
+  SetOfVars e;
+
+  h.create(terms_);
+  g.insert(x_[0]);
+  g.insert(x_[1]);
+
+  // {x3} alone (4) is heavier than {x1,x2} and {x0,x1,x2} together (3).
+  CPPUNIT_ASSERT(x_[3] == h.heaviestIncidentVertex(g));
+  g.insert(x_[3]);
+  h.adjustEdgeWeightsBetween(x_[3], g, true);
+  e.insert(x_[3]);
+  CPPUNIT_ASSERT(0.0 == h.getWeight(e));
+
+  CPPUNIT_ASSERT(x_[2] == h.heaviestIncidentVertex(g));
+  g.insert(x_[2]);
+  h.adjustEdgeWeightsBetween(x_[2], g, false);
+  e.clear();
+  e.insert(x_[1]);
+  e.insert(x_[2]);
+  CPPUNIT_ASSERT(1.0 == h.getWeight(e));
+  e.insert(x_[0]);
+  CPPUNIT_ASSERT(0.5 == h.getWeight(e));
+
+  // nothing is left outside the group.
+  CPPUNIT_ASSERT(!h.heaviestIncidentVertex(g));
+}
+
+
+void HypergraphUT::testWeights()
+{
+  Hypergraph h(p_);
+  bool pos = false;
+  SetOfVars e;
+  SetOfVars f;
+
+  h.create(terms_);
+  f.insert(x_[3]);
+  h.setWeight(f, 0.0);
+  e = h.heaviestEdge(pos);
+  CPPUNIT_ASSERT(true == pos);
+  CPPUNIT_ASSERT(2 == e.size() && 1 == e.count(x_[0]) &&
+                 1 == e.count(x_[1]));
+  CPPUNIT_ASSERT(3.0 == h.getWeight(e));
+
+  // zero all edges.
+  while (pos) {
+    h.setWeight(e, 0.0);
+    e = h.heaviestEdge(pos);
+  }
+  CPPUNIT_ASSERT(false == pos);
+
+  h.resetWeights();
+  e = h.heaviestEdge(pos);
+  CPPUNIT_ASSERT(true == pos);
+  CPPUNIT_ASSERT(f == e);
+  CPPUNIT_ASSERT(4.0 == h.getWeight(f));
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
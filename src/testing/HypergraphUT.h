@@ -0,0 +1,58 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef HYPERGRAPHUT_H
+#define HYPERGRAPHUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <map>
+#include <vector>
+
+#include "MultilinearTermsHandler.h"
+
+using namespace Minotaur;
+
+class HypergraphUT : public CppUnit::TestCase {
+  public:
+    HypergraphUT(std::string name) : TestCase(name) {}
+    HypergraphUT() {}
+
+    void setUp();
+    void tearDown() {}
+
+    void testCreate();
+    void testGrow();
+    void testWeights();
+
+    CPPUNIT_TEST_SUITE(HypergraphUT);
+    CPPUNIT_TEST(testCreate);
+    CPPUNIT_TEST(testGrow);
+    CPPUNIT_TEST(testWeights);
+    CPPUNIT_TEST_SUITE_END();
+
+  private:
+    ProblemPtr p_;
+    std::map<ConstVariablePtr, SetOfVars> terms_;
+    std::vector<VariablePtr> x_;
+};
+
+#endif     // #define HYPERGRAPHUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,121 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Constraint.h"
+#include "CoverCutGenerator.h"
+#include "Environment.h"
+#include "Function.h"
+#include "KnapsackList.h"
+#include "KnapsackListUT.h"
+#include "LinearFunction.h"
+#include "Relaxation.h"
+#include "Solution.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(KnapsackListUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(KnapsackListUT, "KnapsackListUT");
+
+using namespace Minotaur;
+
+ConstraintPtr KnapsackListUT::addRow_(ProblemPtr p, UInt first, UInt last,
+                                      double a, double ub)
+{
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+  FunctionPtr f;
+
+  for (UInt i=first; i<=last; ++i) {
+    lf->addTerm(p->getVariable(i), a+i-first);
+  }
+  f = (FunctionPtr) new Function(lf);
+  return p->newConstraint(f, -INFINITY, ub);
+}
+
+
+void KnapsackListUT::testCoverDelAppend()
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  RelaxationPtr rel = (RelaxationPtr) new Relaxation();
+  CoverCutGenerator gen(env);
+  ConstraintPtr c;
+  ConstSolutionPtr sol;
+  double x[6] = {0.0, 0.0, 0.0, 0.6, 0.6, 0.6};
+
+  for (UInt i=0; i<6; ++i) {
+    rel->newBinaryVariable();
+  }
+  addRow_(rel, 0, 2, 3.0, 8.0);
+  c = addRow_(rel, 0, 2, -3.0, 0.0);
+  sol = (ConstSolutionPtr) new Solution(0.0, x, rel);
+
+  // The only knapsack has no fractional variable.
+  gen.separate(rel, sol);
+  CPPUNIT_ASSERT(0 == gen.getViolatedCutList().size());
+
+  // Delete a row and append a knapsack. The number of rows is the same as
+  // before, but the new knapsack has a violated cover x4 + x5 <= 1.
+  rel->markDelete(c);
+  rel->delMarkedCons();
+  addRow_(rel, 3, 5, 3.0, 8.0);
+  gen.separate(rel, sol);
+  CPPUNIT_ASSERT(gen.getViolatedCutList().size() > 0);
+}
+
+
+void KnapsackListUT::testDelAppend()
+{
+  ProblemPtr p = (ProblemPtr) new Problem();
+  ConstraintPtr k0, c;
+  UInt dels;
+
+  for (UInt i=0; i<9; ++i) {
+    p->newBinaryVariable();
+  }
+  k0 = addRow_(p, 0, 2, 3.0, 7.0);
+  c = addRow_(p, 0, 2, -3.0, 0.0);
+
+  KnapsackList list(p);
+  CPPUNIT_ASSERT(1 == list.getNumKnaps());
+
+  // Delete the row that is not a knapsack, then append two knapsacks.
+  dels = p->getNumConsDels();
+  p->markDelete(c);
+  p->delMarkedCons();
+  CPPUNIT_ASSERT(dels+1 == p->getNumConsDels());
+  addRow_(p, 3, 5, 3.0, 7.0);
+  addRow_(p, 6, 8, 3.0, 7.0);
+  CPPUNIT_ASSERT(true == list.updateList());
+  CPPUNIT_ASSERT(3 == list.getNumKnaps());
+  CPPUNIT_ASSERT(3 == list.getNumConsChecked());
+
+  // Delete a knapsack and append one. It must leave the list.
+  p->markDelete(k0);
+  p->delMarkedCons();
+  c = addRow_(p, 0, 3, 1.0, 5.0);
+  list.updateList();
+  CPPUNIT_ASSERT(3 == list.getNumKnaps());
+  CPPUNIT_ASSERT(list.getListEnd() ==
+                 std::find(list.getListBegin(), list.getListEnd(), k0));
+  CPPUNIT_ASSERT(list.getListEnd() !=
+                 std::find(list.getListBegin(), list.getListEnd(), c));
+
+  // Nothing changed.
+  CPPUNIT_ASSERT(false == list.updateList());
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
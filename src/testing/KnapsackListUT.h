@@ -0,0 +1,54 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef KNAPSACKLISTUT_H
+#define KNAPSACKLISTUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Read the documentation in KnapsackList.h and CoverCutGenerator.h
+class KnapsackListUT : public CppUnit::TestCase {
+  public:
+    KnapsackListUT(std::string name) : TestCase(name) {}
+    KnapsackListUT() {}
+
+    void setUp() {}
+    void tearDown() {}
+
+    void testCoverDelAppend();
+    void testDelAppend();
+
+    CPPUNIT_TEST_SUITE(KnapsackListUT);
+    CPPUNIT_TEST(testCoverDelAppend);
+    CPPUNIT_TEST(testDelAppend);
+    CPPUNIT_TEST_SUITE_END();
+
+  private:
+    /// Add a x_first + (a+1) x_first+1 + ... <= ub to p, up to x_last.
+    ConstraintPtr addRow_(ProblemPtr p, UInt first, UInt last, double a,
+                          double ub);
+};
+
+#endif     // #define KNAPSACKLISTUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -5,9 +5,16 @@
 // 
 
 
+#include <sstream>
+
 #include "MinotaurConfig.h"
 #include "LoggerUT.h"
 #include "Logger.h"
+#include "ThreadLogger.h"
+
+#if USE_OPENMP
+#include <omp.h>
+#endif
 
 CPPUNIT_TEST_SUITE_REGISTRATION(LoggerUT);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(LoggerUT, "LoggerUT");
@@ -38,6 +45,72 @@ void LoggerUT::testErrStream()
     " should not appear at LogNone level! \n";
 }
 
+namespace {
+int numCalls = 0;
+int countCall() { ++numCalls; return numCalls; }
+}
+
+void LoggerUT::testLogMacro()
+{
+  LoggerPtr lPtr = (LoggerPtr) new Logger(LogInfo);
+
+  // arguments must not be evaluated when the level is off.
+  numCalls = 0;
+  MINOTAUR_LOG(lPtr, LogDebug) << countCall();
+  CPPUNIT_ASSERT(0 == numCalls);
+  if (numCalls > 0)
+    MINOTAUR_LOG(lPtr, LogError) << countCall();
+  else
+    countCall();
+  CPPUNIT_ASSERT(1 == numCalls);
+  CPPUNIT_ASSERT(lPtr->isOn(LogInfo));
+  CPPUNIT_ASSERT(false == lPtr->isOn(LogExtraInfo));
+}
+
+void LoggerUT::testThreadLogger()
+{
+  std::ostringstream out;
+  {
+    ThreadLogger logger(LogInfo, out);
+    logger.setNode(7);
+    logger.msgStream(LogInfo) << "first " << 1 << std::endl << "second\n";
+    logger.msgStream(LogDebug) << "hidden" << std::endl;
+    logger.flush();
+  }
+  CPPUNIT_ASSERT(0 == out.str().find("[t0 n7 "));
+  CPPUNIT_ASSERT(std::string::npos != out.str().find("] first 1\n[t0 n7 "));
+  CPPUNIT_ASSERT(std::string::npos != out.str().find("] second\n"));
+  CPPUNIT_ASSERT(std::string::npos == out.str().find("hidden"));
+}
+
+void LoggerUT::testThreadLoggerExtra()
+{
+  std::ostringstream out;
+#if USE_OPENMP
+  int nthreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  {
+    ThreadLogger logger(LogInfo, out);
+    // more threads than when the logger was created.
+#pragma omp parallel num_threads(4)
+    {
+      logger.setNode(10+omp_get_thread_num());
+      logger.msgStream(LogInfo) << "line" << std::endl;
+    }
+    logger.flush();
+  }
+  omp_set_num_threads(nthreads);
+  CPPUNIT_ASSERT(std::string::npos != out.str().find("[t3 n13 "));
+  CPPUNIT_ASSERT(std::string::npos != out.str().find("[t0 n10 "));
+#else
+  {
+    ThreadLogger logger(LogInfo, out);
+    logger.msgStream(LogInfo) << "line" << std::endl;
+  }
+  CPPUNIT_ASSERT(0 == out.str().find("[t0 n0 "));
+#endif
+}
+
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -29,10 +29,16 @@ public:
   CPPUNIT_TEST_SUITE(LoggerUT);
   CPPUNIT_TEST(testMsgStream);
   CPPUNIT_TEST(testErrStream);
+  CPPUNIT_TEST(testLogMacro);
+  CPPUNIT_TEST(testThreadLogger);
+  CPPUNIT_TEST(testThreadLoggerExtra);
   CPPUNIT_TEST_SUITE_END();
 
   void testMsgStream();
   void testErrStream();
+  void testLogMacro();
+  void testThreadLogger();
+  void testThreadLoggerExtra();
 
 };
 
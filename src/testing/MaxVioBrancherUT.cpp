@@ -0,0 +1,137 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include "MinotaurConfig.h"
+#include "Branch.h"
+#include "BrVarCand.h"
+#include "Environment.h"
+#include "Handler.h"
+#include "MaxVioBrancher.h"
+#include "MaxVioBrancherUT.h"
+#include "Relaxation.h"
+#include "Solution.h"
+#include "Variable.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MaxVioBrancherUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MaxVioBrancherUT, "MaxVioBrancherUT");
+
+using namespace Minotaur;
+
+namespace {
+
+  // A handler that proposes one variable as a branching candidate.
+  class OneCandHandler : public Handler {
+  public:
+    OneCandHandler(UInt i, double ddist, double udist)
+      : i_(i), ddist_(ddist), udist_(udist) {}
+
+    Branches getBranches(BrCandPtr, DoubleVector &, RelaxationPtr,
+                         SolutionPoolPtr)
+    {
+      Branches branches = (Branches) new BranchPtrVector();
+      branches->push_back((BranchPtr) new Branch());
+      return branches;
+    }
+
+    void getBranchingCandidates(RelaxationPtr rel, const DoubleVector &,
+                                ModVector &, BrVarCandSet &cands,
+                                BrCandVector &, bool &is_inf)
+    {
+      is_inf = false;
+      cands.insert((BrVarCandPtr) new BrVarCand(rel->getVariable(i_), i_,
+                                                ddist_, udist_));
+    }
+
+    ModificationPtr getBrMod(BrCandPtr, DoubleVector &, RelaxationPtr,
+                             BranchDirection)
+    { return ModificationPtr(); }
+    std::string getName() const { return "OneCandHandler"; }
+    bool isFeasible(ConstSolutionPtr, RelaxationPtr, bool &, double &)
+    { return false; }
+    SolveStatus presolve(PreModQ *, bool *) { return Finished; }
+    bool presolveNode(RelaxationPtr, NodePtr, SolutionPoolPtr, ModVector &,
+                      ModVector &)
+    { return false; }
+    void relaxInitFull(RelaxationPtr, bool *) {}
+    void relaxInitInc(RelaxationPtr, bool *) {}
+    void relaxNodeFull(NodePtr, RelaxationPtr, bool *) {}
+    void relaxNodeInc(NodePtr, RelaxationPtr, bool *) {}
+    void separate(ConstSolutionPtr, NodePtr, RelaxationPtr, CutManager *,
+                  SolutionPoolPtr, bool *, SeparationStatus *) {}
+
+  private:
+    UInt i_;
+    double ddist_;
+    double udist_;
+  };
+
+}
+
+
+int MaxVioBrancherUT::branch_(UInt i1, double d1, double u1, UInt i2,
+                              double d2, double u2)
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  RelaxationPtr rel = (RelaxationPtr) new Relaxation();
+  HandlerVector handlers;
+  BrancherStatus br_status;
+  ModVector mods;
+  Branches branches;
+  double x[4] = {0.5, 0.5, 0.5, 0.5};
+  ConstSolutionPtr sol;
+  MaxVioBrancher *brancher;
+  int chosen;
+
+  for (UInt i=0; i<4; ++i) {
+    rel->newVariable(0.0, 1.0, Binary);
+  }
+  sol = (ConstSolutionPtr) new Solution(0.0, x, rel);
+  handlers.push_back((HandlerPtr) new OneCandHandler(i1, d1, u1));
+  handlers.push_back((HandlerPtr) new OneCandHandler(i2, d2, u2));
+  brancher = new MaxVioBrancher(env, handlers);
+  branches = brancher->findBranches(rel, NodePtr(), sol, SolutionPoolPtr(),
+                                    br_status, mods);
+  CPPUNIT_ASSERT(NotModifiedByBrancher == br_status);
+  CPPUNIT_ASSERT(1 == branches->size());
+  chosen = branches->front()->getBrCand()->getPCostIndex();
+  delete brancher;
+  return chosen;
+}
+
+
+void MaxVioBrancherUT::testBetterScore()
+{
+  // a larger score wins over a smaller index.
+  CPPUNIT_ASSERT(3 == branch_(3, 0.5, 0.5, 1, 0.4, 0.6));
+}
+
+
+void MaxVioBrancherUT::testTieInOrder()
+{
+  CPPUNIT_ASSERT(1 == branch_(1, 0.5, 0.5, 3, 0.5, 0.5));
+}
+
+
+void MaxVioBrancherUT::testTieOutOfOrder()
+{
+  // the second handler adds a variable with a smaller index. The tie goes
+  // to the smaller index, not to the first candidate added.
+  CPPUNIT_ASSERT(1 == branch_(3, 0.5, 0.5, 1, 0.5, 0.5));
+  CPPUNIT_ASSERT(0 == branch_(2, 0.3, 0.7, 0, 0.7, 0.3));
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
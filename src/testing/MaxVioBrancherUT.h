@@ -0,0 +1,57 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef MAXVIOBRANCHERUT_H
+#define MAXVIOBRANCHERUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+class MaxVioBrancherUT : public CppUnit::TestCase {
+  public:
+    MaxVioBrancherUT(std::string name) : TestCase(name) {}
+    MaxVioBrancherUT() {}
+
+    void testBetterScore();
+    void testTieInOrder();
+    void testTieOutOfOrder();
+
+    CPPUNIT_TEST_SUITE(MaxVioBrancherUT);
+    CPPUNIT_TEST(testBetterScore);
+    CPPUNIT_TEST(testTieInOrder);
+    CPPUNIT_TEST(testTieOutOfOrder);
+    CPPUNIT_TEST_SUITE_END();
+
+  private:
+    /**
+     * Branch with a MaxVioBrancher and two handlers on a relaxation with
+     * four variables. The first handler proposes variable i1 and the second
+     * variable i2, with the given distances. Return the index of the
+     * variable chosen.
+     */
+    int branch_(UInt i1, double d1, double u1, UInt i2, double d2,
+                double u2);
+};
+
+#endif     // #define MAXVIOBRANCHERUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
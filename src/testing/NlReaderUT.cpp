@@ -0,0 +1,129 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+//
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "NlReaderUT.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NlReaderUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(NlReaderUT, "NlReaderUT");
+using namespace MINOTAUR_AMPL;
+
+// See AMPLInstanceUT.cpp for minlp_eg0.mod. AMPL writes the variables in
+// the order x2, x0, x1, x3, x4.
+
+void NlReaderUT::setUp()
+{
+  env_ = (Minotaur::EnvPtr) new Minotaur::Environment();
+  env_->getOptions()->findInt("ampl_log_level")->setValue(Minotaur::LogNone);
+  reader_ = new NlReader(env_);
+  inst_ = reader_->readInstance("instances/minlp_eg0");
+}
+
+
+void NlReaderUT::tearDown()
+{
+  delete reader_;
+  if (inst_) {
+    inst_->clear();
+  }
+}
+
+
+void NlReaderUT::testSize()
+{
+  CPPUNIT_ASSERT(inst_);
+  CPPUNIT_ASSERT(inst_->getNumVars() == 5);
+  CPPUNIT_ASSERT(inst_->getNumCons() == 5);
+  CPPUNIT_ASSERT(reader_->getNumDefs() == 0);
+  CPPUNIT_ASSERT(inst_->findType() == Minotaur::MINLP);
+}
+
+
+void NlReaderUT::testVariables()
+{
+  Minotaur::VariablePtr v;
+
+  v = inst_->getVariable(0);
+  CPPUNIT_ASSERT(v->getName() == "x2");
+  CPPUNIT_ASSERT(v->getType() == Minotaur::Continuous);
+
+  v = inst_->getVariable(1);
+  CPPUNIT_ASSERT(v->getName() == "x0");
+  CPPUNIT_ASSERT(v->getType() == Minotaur::Integer);
+
+  v = inst_->getVariable(3);
+  CPPUNIT_ASSERT(v->getName() == "x3");
+  CPPUNIT_ASSERT(v->getType() == Minotaur::Continuous);
+  CPPUNIT_ASSERT(fabs(v->getLb()-4.0) < 1e-12);
+  CPPUNIT_ASSERT(fabs(v->getUb()-10.0) < 1e-12);
+
+  v = inst_->getVariable(4);
+  CPPUNIT_ASSERT(v->getLb() == 0.0);
+  CPPUNIT_ASSERT(v->getUb() == INFINITY);
+}
+
+
+void NlReaderUT::testFunctions()
+{
+  // x2, x0, x1, x3, x4
+  double x[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+  int err = 0;
+  Minotaur::ObjectivePtr o = inst_->getObjective();
+  Minotaur::ConstraintPtr c;
+
+  // x0*x3 + x1*x2 + x4
+  CPPUNIT_ASSERT(fabs(o->eval(x, &err) - 16.0) < 1e-10);
+  CPPUNIT_ASSERT(0==err);
+
+  // x0^2 + x1^2 + x2^2 = 1
+  c = inst_->getConstraint(0);
+  CPPUNIT_ASSERT(fabs(c->getActivity(x, &err) - 14.0) < 1e-10);
+  CPPUNIT_ASSERT(fabs(c->getLb() - 1.0) < 1e-12);
+  CPPUNIT_ASSERT(fabs(c->getUb() - 1.0) < 1e-12);
+
+  // x0^3 + x0^2 <= 100
+  c = inst_->getConstraint(1);
+  CPPUNIT_ASSERT(fabs(c->getActivity(x, &err) - 12.0) < 1e-10);
+  CPPUNIT_ASSERT(0==err);
+}
+
+
+void NlReaderUT::testAllFuns()
+{
+  NlReader reader(env_);
+  Minotaur::ProblemPtr p = reader.readInstance("instances/allfuns");
+  CPPUNIT_ASSERT(p);
+  CPPUNIT_ASSERT(p->getNumCons() == 23);
+  CPPUNIT_ASSERT(p->findType() == Minotaur::NLP);
+  p->clear();
+}
+
+
+void NlReaderUT::testMissing()
+{
+  NlReader reader(env_);
+  CPPUNIT_ASSERT(!reader.readInstance("instances/no_such_file"));
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
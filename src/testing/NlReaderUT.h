@@ -0,0 +1,71 @@
+/* 
+ *     MINOTAUR -- It's only 1/2 bull
+ *
+ *     (C)opyright 2009 - 2014 The MINOTAUR Team.
+ */
+
+#ifndef NLREADERUT_H
+#define NLREADERUT_H
+
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <NlReader.h>
+#include <Problem.h>
+
+using namespace MINOTAUR_AMPL;
+
+
+// read instances using NlReader and test:
+// Number of variables and their types,
+// Number of constraints,
+// Function evaluations,
+// Errors on missing files.
+
+class NlReaderUT : public CppUnit::TestCase {
+
+public:
+  NlReaderUT(std::string name) : TestCase(name) {}
+  NlReaderUT() {}
+
+  void setUp();
+  void tearDown();
+
+  void testSize();
+  void testVariables();
+  void testFunctions();
+  void testAllFuns();
+  void testMissing();
+
+  CPPUNIT_TEST_SUITE(NlReaderUT);
+  CPPUNIT_TEST(testSize);
+  CPPUNIT_TEST(testVariables);
+  CPPUNIT_TEST(testFunctions);
+  CPPUNIT_TEST(testAllFuns);
+  CPPUNIT_TEST(testMissing);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  Minotaur::EnvPtr env_;
+  NlReaderPtr reader_;
+  Minotaur::ProblemPtr inst_;
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,195 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+// 
+
+#include <cmath>
+#include <cstdio>
+
+#include "MinotaurConfig.h"
+#include "ProblemSnapshotUT.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Problem.h"
+#include "ProblemSnapshot.h"
+#include "QuadraticFunction.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProblemSnapshotUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ProblemSnapshotUT, "ProblemSnapshotUT");
+using namespace Minotaur;
+
+void ProblemSnapshotUT::setUp()
+{
+  VariablePtr x0, x1, x2;
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
+  CGraphPtr cg;
+  FunctionPtr f;
+  CNode *n0, *n1, *n2;
+  VarVector vars;
+  double wts[2] = {1.0, 2.0};
+
+  env_ = (EnvPtr) new Environment();
+  p_ = (ProblemPtr) new Problem();
+  x0 = p_->newVariable(0.0, 1.0, Binary, "x0");
+  x1 = p_->newVariable(-1.0, 4.0, Integer, "x1");
+  x2 = p_->newVariable(-INFINITY, INFINITY, Continuous, "x2");
+
+  // 2x0 + x1^2 + exp(x2*x1) - x2^3 <= 10
+  lf = (LinearFunctionPtr) new LinearFunction();
+  lf->addTerm(x0, 2.0);
+  qf = (QuadraticFunctionPtr) new QuadraticFunction();
+  qf->addTerm(x1, x1, 1.0);
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(x2);
+  n1 = cg->newNode(OpMult, n0, cg->newNode(x1));
+  n1 = cg->newNode(OpExp, n1, 0);
+  n2 = cg->newNode(OpPowK, n0, cg->newNode(3.0));
+  n2 = cg->newNode(OpMinus, n1, n2);
+  cg->setOut(n2);
+  cg->finalize();
+  f = (FunctionPtr) new Function(lf, qf, cg);
+  p_->newConstraint(f, -INFINITY, 10.0, "c0");
+
+  // x0 + x1 + x2 = 1
+  lf = (LinearFunctionPtr) new LinearFunction();
+  lf->addTerm(x0, 1.0);
+  lf->addTerm(x1, 1.0);
+  lf->addTerm(x2, 1.0);
+  f = (FunctionPtr) new Function(lf);
+  p_->newConstraint(f, 1.0, 1.0, "c1");
+
+  lf = (LinearFunctionPtr) new LinearFunction();
+  lf->addTerm(x2, -3.0);
+  f = (FunctionPtr) new Function(lf);
+  p_->newObjective(f, 5.0, Maximize, "obj");
+
+  vars.push_back(x0);
+  vars.push_back(x2);
+  p_->newSOS(2, SOS1, wts, vars, 3, "s0");
+}
+
+
+void ProblemSnapshotUT::tearDown()
+{
+  p_->clear();
+  remove("snapshot_ut.snap");
+}
+
+
+void ProblemSnapshotUT::testRoundTrip()
+{
+  ProblemSnapshot snap(env_);
+  ProblemPtr q;
+  double x[3] = {1.0, 2.0, 0.5};
+  int err = 0;
+
+  CPPUNIT_ASSERT(0==snap.write(p_, "snapshot_ut.snap"));
+  CPPUNIT_ASSERT(0==snap.open("snapshot_ut.snap"));
+  CPPUNIT_ASSERT(3==snap.getNumVars());
+  CPPUNIT_ASSERT(2==snap.getNumCons());
+
+  q = snap.getProblem(&err);
+  CPPUNIT_ASSERT(0==err);
+  CPPUNIT_ASSERT(q);
+  CPPUNIT_ASSERT(q==snap.getProblem(&err));
+  CPPUNIT_ASSERT(3==q->getNumVars());
+  CPPUNIT_ASSERT(2==q->getNumCons());
+  q->calculateSize();
+  CPPUNIT_ASSERT(1==q->getNumSOS1());
+
+  CPPUNIT_ASSERT(q->getVariable(0)->getType()==Binary);
+  CPPUNIT_ASSERT(q->getVariable(1)->getName()=="x1");
+  CPPUNIT_ASSERT(q->getVariable(1)->getLb()==-1.0);
+  CPPUNIT_ASSERT(q->getVariable(2)->getUb()==INFINITY);
+
+  for (UInt i=0; i<2; ++i) {
+    CPPUNIT_ASSERT(q->getConstraint(i)->getName() ==
+                   p_->getConstraint(i)->getName());
+    CPPUNIT_ASSERT(q->getConstraint(i)->getUb() ==
+                   p_->getConstraint(i)->getUb());
+    CPPUNIT_ASSERT(fabs(q->getConstraint(i)->getActivity(x, &err) -
+                        p_->getConstraint(i)->getActivity(x, &err)) < 1e-12);
+  }
+  CPPUNIT_ASSERT(q->getObjective()->getObjectiveType()==Maximize);
+  CPPUNIT_ASSERT(fabs(q->getObjective()->eval(x, &err) - 3.5) < 1e-12);
+  CPPUNIT_ASSERT(0==err);
+  q->clear();
+}
+
+
+void ProblemSnapshotUT::testOptions()
+{
+  ProblemSnapshot snap(env_);
+  OptionDBPtr options = env_->getOptions();
+  ProblemPtr q;
+  double x[3] = {1.0, 2.0, 0.5};
+  int err = 0;
+
+  // nothing is done if the options are empty.
+  CPPUNIT_ASSERT(0==snap.writeByOption(p_));
+  q = snap.readByOption(&err);
+  CPPUNIT_ASSERT(0==err);
+  CPPUNIT_ASSERT(!q);
+
+  options->findString("write_snapshot")->setValue("snapshot_ut.snap");
+  CPPUNIT_ASSERT(0==snap.writeByOption(p_));
+  options->findString("read_snapshot")->setValue("snapshot_ut.snap");
+  q = snap.readByOption(&err);
+  CPPUNIT_ASSERT(0==err);
+  CPPUNIT_ASSERT(q);
+  CPPUNIT_ASSERT(3==q->getNumVars());
+  CPPUNIT_ASSERT(2==q->getNumCons());
+  for (UInt i=0; i<2; ++i) {
+    CPPUNIT_ASSERT(fabs(q->getConstraint(i)->getActivity(x, &err) -
+                        p_->getConstraint(i)->getActivity(x, &err)) < 1e-12);
+  }
+  CPPUNIT_ASSERT(fabs(q->getObjective()->eval(x, &err) - 3.5) < 1e-12);
+  CPPUNIT_ASSERT(0==err);
+  q->clear();
+
+  options->findString("read_snapshot")->setValue("no_such_file.snap");
+  q = snap.readByOption(&err);
+  CPPUNIT_ASSERT(0!=err);
+  CPPUNIT_ASSERT(!q);
+  options->findString("read_snapshot")->setValue("");
+  options->findString("write_snapshot")->setValue("");
+}
+
+
+void ProblemSnapshotUT::testBadFile()
+{
+  ProblemSnapshot snap(env_);
+  FILE *fp;
+  int err = 0;
+
+  CPPUNIT_ASSERT(0!=snap.open("no_such_file.snap"));
+  snap.getProblem(&err);
+  CPPUNIT_ASSERT(0!=err);
+
+  fp = fopen("snapshot_ut.snap", "w");
+  fprintf(fp, "this is not a snapshot, but it is long enough to be one.");
+  fprintf(fp, "this is not a snapshot, but it is long enough to be one.");
+  fclose(fp);
+  CPPUNIT_ASSERT(0!=snap.open("snapshot_ut.snap"));
+}
+
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
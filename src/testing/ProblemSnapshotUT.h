@@ -0,0 +1,56 @@
+// 
+//     MINOTAUR -- It's only 1/2 bull
+// 
+//     (C)opyright 2009 - 2014 The MINOTAUR Team.
+// 
+
+#ifndef PROBLEMSNAPSHOTUT_H
+#define PROBLEMSNAPSHOTUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+// Save a problem in a snapshot, load it back and compare.
+class ProblemSnapshotUT : public CppUnit::TestCase {
+
+public:
+  ProblemSnapshotUT(std::string name) : TestCase(name) {}
+  ProblemSnapshotUT() {}
+
+  void setUp();
+  void tearDown();
+
+  void testRoundTrip();
+  void testBadFile();
+  void testOptions();
+
+  CPPUNIT_TEST_SUITE(ProblemSnapshotUT);
+  CPPUNIT_TEST(testRoundTrip);
+  CPPUNIT_TEST(testBadFile);
+  CPPUNIT_TEST(testOptions);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  EnvPtr env_;
+  ProblemPtr p_;
+};
+
+#endif
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,103 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "MinotaurConfig.h"
+#include "Profiler.h"
+#include "ProfilerUT.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ProfilerUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ProfilerUT, "ProfilerUT");
+
+using namespace Minotaur;
+
+void ProfilerUT::testDisabled()
+{
+  Profiler prof;
+  std::ostringstream out;
+
+  CPPUNIT_ASSERT(false == prof.isOn());
+  {
+    ProfZone pz(&prof, "a");
+    ProfZone pz2(0, "b");
+  }
+  prof.writeStats(out);
+  CPPUNIT_ASSERT(out.str().empty());
+}
+
+
+void ProfilerUT::testNested()
+{
+  Profiler prof;
+  std::ostringstream out;
+  std::string s;
+
+  prof.enable(true);
+  for (int i=0; i<3; ++i) {
+    ProfZone pz(&prof, "outer");
+    {
+      ProfZone pz2(&prof, "inner");
+    }
+  }
+  {
+    ProfZone pz(&prof, "inner");
+  }
+  prof.writeStats(out);
+  s = out.str();
+
+  // outer, its child inner and a separate inner at top level.
+  CPPUNIT_ASSERT(s.find("outer") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("  inner") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\ninner") != std::string::npos);
+  CPPUNIT_ASSERT(s.find(" 3 ") != std::string::npos);
+}
+
+
+void ProfilerUT::testTrace()
+{
+  Profiler prof;
+  std::string fname = "profilerut.json";
+  std::ifstream in;
+  std::string s, line;
+  size_t pos;
+  int cnt = 0;
+
+  prof.enable(true);
+  for (int i=0; i<5; ++i) {
+    ProfZone pz(&prof, "zone");
+  }
+  CPPUNIT_ASSERT(0 == prof.writeTrace(fname));
+
+  in.open(fname.c_str());
+  CPPUNIT_ASSERT(in.is_open());
+  while (getline(in, line)) {
+    s += line;
+  }
+  in.close();
+  remove(fname.c_str());
+
+  CPPUNIT_ASSERT(0 == s.find("{\"traceEvents\":["));
+  for (pos=s.find("\"ph\":\"X\""); pos!=std::string::npos;
+       pos=s.find("\"ph\":\"X\"", pos+1)) {
+    ++cnt;
+  }
+  CPPUNIT_ASSERT(5 == cnt);
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
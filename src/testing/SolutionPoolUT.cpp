@@ -0,0 +1,122 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "Environment.h"
+#include "Problem.h"
+#include "SolutionPool.h"
+#include "SolutionPoolUT.h"
+#include "StatsRegistry.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SolutionPoolUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(SolutionPoolUT, "SolutionPoolUT");
+
+using namespace Minotaur;
+
+void SolutionPoolUT::setUp()
+{
+  int err = 0;
+
+  env_ = (EnvPtr) new Environment();
+  env_->startTimer(err);
+  p_ = (ProblemPtr) new Problem();
+  p_->newVariable(0.0, 1.0, Binary);
+  p_->newVariable(0.0, 5.0, Integer);
+  p_->newVariable(0.0, 1.0, Continuous);
+}
+
+
+void SolutionPoolUT::testDuplicates()
+{
+  SolutionPool pool(env_, p_, 5);
+  double x1[3] = {1.0, 2.0, 0.5};
+  double x2[3] = {1.0, 2.0, 0.7};
+  double x3[3] = {0.0, 2.0, 0.7};
+
+  pool.addSolution(x1, 10.0);
+  // same integer part, worse: rejected.
+  pool.addSolution(x2, 11.0);
+  CPPUNIT_ASSERT(1 == pool.getNumSols());
+  CPPUNIT_ASSERT(0.5 == pool.getBestSolution()->getPrimal()[2]);
+
+  // same integer part, better: replaces.
+  pool.addSolution(x2, 9.0);
+  CPPUNIT_ASSERT(1 == pool.getNumSols());
+  CPPUNIT_ASSERT(0.7 == pool.getBestSolution()->getPrimal()[2]);
+
+  pool.addSolution(x3, 12.0);
+  CPPUNIT_ASSERT(2 == pool.getNumSols());
+  CPPUNIT_ASSERT(9.0 == pool.getBestSolutionValue());
+  CPPUNIT_ASSERT(4 == pool.getNumSolsFound());
+}
+
+
+void SolutionPoolUT::testLimit()
+{
+  SolutionPool pool(env_, p_, 2);
+  double x[3] = {0.0, 0.0, 0.0};
+  SolutionIterator it;
+
+  CPPUNIT_ASSERT(INFINITY == pool.getBestSolutionValue());
+  for (int i=0; i<5; ++i) {
+    x[1] = i;
+    pool.addSolution(x, 5.0-i);
+  }
+  // two best are kept, best first.
+  CPPUNIT_ASSERT(2 == pool.getNumSols());
+  it = pool.solsBegin();
+  CPPUNIT_ASSERT(1.0 == (*it)->getObjValue());
+  ++it;
+  CPPUNIT_ASSERT(2.0 == (*it)->getObjValue());
+
+  // not better than the worst: rejected.
+  x[1] = 5;
+  pool.addSolution(x, 2.0);
+  CPPUNIT_ASSERT(2.0 == (*(++pool.solsBegin()))->getObjValue());
+  CPPUNIT_ASSERT(3.0 == (*(++pool.solsBegin()))->getPrimal()[1]);
+
+  pool.setSizeLimit(1);
+  CPPUNIT_ASSERT(1 == pool.getNumSols());
+  CPPUNIT_ASSERT(1.0 == pool.getBestSolutionValue());
+}
+
+
+void SolutionPoolUT::testNegative()
+{
+  SolutionPool pool(env_, p_, 5);
+  double x1[3] = {0.0, -3.0, 0.5};
+  double x2[3] = {0.0, -3.0, 0.7};
+  double x3[3] = {0.0, -1e20, 0.7};
+  double x4[3] = {0.0, -2e20, 0.7};
+  StatsRegistry *stats;
+
+  // negative and huge integer values are hashed without overflow.
+  pool.addSolution(x1, 10.0);
+  pool.addSolution(x2, 9.0);
+  CPPUNIT_ASSERT(1 == pool.getNumSols());
+  pool.addSolution(x3, 8.0);
+  pool.addSolution(x4, 7.0);
+  CPPUNIT_ASSERT(3 == pool.getNumSols());
+  CPPUNIT_ASSERT(7.0 == pool.getBestSolutionValue());
+
+  stats = env_->getStats();
+  CPPUNIT_ASSERT(4 == stats->counter("solpool.solutions_found")->value());
+  CPPUNIT_ASSERT(7.0 == *(stats->value("solpool.best_value")));
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
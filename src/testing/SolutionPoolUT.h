@@ -0,0 +1,54 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef SOLUTIONPOOLUT_H
+#define SOLUTIONPOOLUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+using namespace Minotaur;
+
+class SolutionPoolUT : public CppUnit::TestCase {
+  public:
+    SolutionPoolUT(std::string name) : TestCase(name) {}
+    SolutionPoolUT() {}
+
+    void setUp();
+    void tearDown() {}
+
+    void testDuplicates();
+    void testLimit();
+    void testNegative();
+
+    CPPUNIT_TEST_SUITE(SolutionPoolUT);
+    CPPUNIT_TEST(testDuplicates);
+    CPPUNIT_TEST(testLimit);
+    CPPUNIT_TEST(testNegative);
+    CPPUNIT_TEST_SUITE_END();
+
+  private:
+    EnvPtr env_;
+    ProblemPtr p_;
+};
+
+#endif     // #define SOLUTIONPOOLUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,140 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "MinotaurConfig.h"
+#include "StatsRegistry.h"
+#include "StatsRegistryUT.h"
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StatsRegistryUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(StatsRegistryUT, "StatsRegistryUT");
+
+using namespace Minotaur;
+
+void StatsRegistryUT::testCounters()
+{
+  StatsRegistry reg;
+  StatCounter *c = reg.counter("a.count");
+  StatTimer *t = reg.timer("a.time");
+  std::ostringstream out;
+  std::string s;
+
+  // same name gives same object.
+  CPPUNIT_ASSERT(c == reg.counter("a.count"));
+  CPPUNIT_ASSERT(t == reg.timer("a.time"));
+
+#if USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int i=0; i<1000; ++i) {
+    c->add();
+    t->add(0.5);
+  }
+  CPPUNIT_ASSERT(1000 == c->value());
+  CPPUNIT_ASSERT(1000 == t->calls());
+  CPPUNIT_ASSERT(500.0 == t->seconds());
+
+  reg.setValue("a.value", 2.5);
+  reg.setValue("a.inf", INFINITY);
+  CPPUNIT_ASSERT(reg.value("a.value") == reg.value("a.value"));
+  CPPUNIT_ASSERT(2.5 == *(reg.value("a.value")));
+  *(reg.value("a.set")) = 1.5;
+  reg.writeJSON(out);
+  s = out.str();
+  CPPUNIT_ASSERT(0 == s.find("{"));
+  CPPUNIT_ASSERT(s.find("\"a.count\": 1000") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"a.time\": {\"calls\": 1000, \"seconds\": 500}")
+                 != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"a.value\": 2.5") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"a.inf\": null") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"a.set\": 1.5") != std::string::npos);
+}
+
+
+void StatsRegistryUT::testDump()
+{
+  StatsRegistry reg;
+  std::string fname = "statsregistryut.json";
+  std::ifstream in;
+  std::string s, line;
+
+  CPPUNIT_ASSERT(false == reg.isOn());
+  CPPUNIT_ASSERT(0 == reg.dump());
+  reg.setDumpFile(fname, 0.0);
+  CPPUNIT_ASSERT(reg.isOn());
+  CPPUNIT_ASSERT(false == reg.isDue());
+
+  reg.counter("b.count")->add(3);
+  CPPUNIT_ASSERT(0 == reg.dump());
+  in.open(fname.c_str());
+  CPPUNIT_ASSERT(in.is_open());
+  while (getline(in, line)) {
+    s += line;
+  }
+  in.close();
+  remove(fname.c_str());
+  CPPUNIT_ASSERT(s.find("\"b.count\": 3") != std::string::npos);
+}
+
+
+void StatsRegistryUT::testHistogram()
+{
+  StatsRegistry reg;
+  StatHistogram *h = reg.histogram("c.hist");
+  std::ostringstream out;
+  std::string s;
+
+  h->add(0.75);
+  h->add(0.5);
+  h->add(3.0);
+  h->writeJSON(out);
+  s = out.str();
+  CPPUNIT_ASSERT(s.find("\"count\": 3") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"sum\": 4.25") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"min\": 0.5") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"max\": 3") != std::string::npos);
+  // 0.5 and 0.75 are below 1, 3 is below 4.
+  CPPUNIT_ASSERT(s.find("{\"lt\": 1, \"count\": 2}") != std::string::npos);
+  CPPUNIT_ASSERT(s.find("{\"lt\": 4, \"count\": 1}") != std::string::npos);
+
+  // two histograms updated from many threads.
+  StatHistogram *h1 = reg.histogram("c.hist1");
+  StatHistogram *h2 = reg.histogram("c.hist2");
+#if USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int i=0; i<1000; ++i) {
+    h1->add(1.5);
+    h2->add(i);
+  }
+  out.str("");
+  h1->writeJSON(out);
+  s = out.str();
+  CPPUNIT_ASSERT(s.find("\"count\": 1000, \"sum\": 1500,") 
+                 != std::string::npos);
+  out.str("");
+  h2->writeJSON(out);
+  s = out.str();
+  CPPUNIT_ASSERT(s.find("\"count\": 1000, \"sum\": 499500,")
+                 != std::string::npos);
+  CPPUNIT_ASSERT(s.find("\"min\": 0, \"max\": 999,") != std::string::npos);
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,45 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef STATSREGISTRYUT_H
+#define STATSREGISTRYUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+using namespace Minotaur;
+
+class StatsRegistryUT : public CppUnit::TestCase {
+  public:
+    StatsRegistryUT(std::string name) : TestCase(name) {}
+    StatsRegistryUT() {}
+
+    void testCounters();
+    void testDump();
+    void testHistogram();
+
+    CPPUNIT_TEST_SUITE(StatsRegistryUT);
+    CPPUNIT_TEST(testCounters);
+    CPPUNIT_TEST(testDump);
+    CPPUNIT_TEST(testHistogram);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+#endif     // #define STATSREGISTRYUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
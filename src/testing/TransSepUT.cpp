@@ -0,0 +1,260 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#include <cmath>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "LinearFunction.h"
+#include "Objective.h"
+#include "Problem.h"
+#include "TransSep.h"
+#include "TransSepUT.h"
+#include "Variable.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TransSepUT);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TransSepUT, "TransSepUT");
+
+using namespace Minotaur;
+
+void TransSepUT::addCons_(CGraphPtr cg, CNode *out, double lb, double ub)
+{
+  FunctionPtr f;
+
+  cg->setOut(out);
+  cg->finalize();
+  f = (FunctionPtr) new Function(cg);
+  p_->newConstraint(f, lb, ub);
+}
+
+
+double TransSepUT::nlSum_(UInt first, const double *x)
+{
+  double s = 0.0;
+  int err = 0;
+
+  for (UInt i=first; i<p_->getNumCons(); ++i) {
+    s += p_->getConstraint(i)->getNonlinearFunction()->eval(x, &err);
+  }
+  CPPUNIT_ASSERT(0 == err);
+  return s;
+}
+
+
+void TransSepUT::setUp()
+{
+  env_ = (EnvPtr) new Environment();
+  p_ = (ProblemPtr) new Problem();
+  p_->newVariable(-5.0, 5.0, Continuous);
+  p_->newVariable(-5.0, 5.0, Continuous);
+  p_->newVariable(-5.0, 5.0, Continuous);
+}
+
+
+void TransSepUT::tearDown()
+{
+  p_.reset();
+  env_.reset();
+}
+
+
+void TransSepUT::testCancel()
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CNode *n0, *n1, *n2;
+  ConstraintPtr c;
+
+  // 2*(x1^2 - x1^2) + x0 <= 1 is x0 <= 1.
+  n0 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(1)), 0);
+  n1 = cg->newNode(OpMinus, n0, n0);
+  n1 = cg->newNode(OpMult, cg->newNode(2.0), n1);
+  n2 = cg->newNode(OpPlus, n1, cg->newNode(p_->getVariable(0)));
+  addCons_(cg, n2, -INFINITY, 1.0);
+
+  TransSep sep(env_, p_);
+  sep.candCons();
+  CPPUNIT_ASSERT(1 == p_->getNumCons());
+  CPPUNIT_ASSERT(0 == sep.getSepConId().size());
+  c = p_->getConstraint(0);
+  CPPUNIT_ASSERT(!c->getNonlinearFunction());
+  CPPUNIT_ASSERT(1 == c->getLinearFunction()->getNumTerms());
+  CPPUNIT_ASSERT(1.0 == c->getLinearFunction()->
+                 getWeight(p_->getVariable(0)));
+  CPPUNIT_ASSERT(1.0 == c->getUb());
+}
+
+
+void TransSepUT::testIntDiv()
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CNode *n0, *n1;
+  LinearFunctionPtr lf;
+
+  // intdiv(x0, 2) + x1^2 <= 3. The quotient is not 0.5*x0.
+  n0 = cg->newNode(OpIntDiv, cg->newNode(p_->getVariable(0)),
+                   cg->newNode(2));
+  n1 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(1)), 0);
+  addCons_(cg, cg->newNode(OpPlus, n0, n1), -INFINITY, 3.0);
+
+  TransSep sep(env_, p_);
+  sep.candCons();
+  CPPUNIT_ASSERT(1 == sep.getSepConId().size());
+  CPPUNIT_ASSERT(3 == p_->getNumCons());
+  lf = p_->getConstraint(0)->getLinearFunction();
+  CPPUNIT_ASSERT(2 == lf->getNumTerms());
+  CPPUNIT_ASSERT(false == lf->hasVar(p_->getVariable(0)));
+  CPPUNIT_ASSERT(p_->getConstraint(1)->getNonlinearFunction());
+  CPPUNIT_ASSERT(p_->getConstraint(2)->getNonlinearFunction());
+}
+
+
+void TransSepUT::testNegConst()
+{
+  CGraphPtr cg;
+  CNode *n0, *n1, *n2;
+  ConstraintPtr c;
+  double x[7] = {1.0, 2.0, 0.5, 0.0, 0.0, 0.0, 0.0};
+
+  // x0^2 + x1^2 - 3 <= 1
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(0)), 0);
+  n1 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(1)), 0);
+  n2 = cg->newNode(OpMinus, cg->newNode(OpPlus, n0, n1), cg->newNode(3));
+  addCons_(cg, n2, -INFINITY, 1.0);
+
+  // exp(x2) <= 4 has one part and stays.
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpExp, cg->newNode(p_->getVariable(2)), 0);
+  addCons_(cg, n0, -INFINITY, 4.0);
+
+  // x0^2 + x2^2 + 5 >= 2
+  cg = (CGraphPtr) new CGraph();
+  n0 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(0)), 0);
+  n1 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(2)), 0);
+  n2 = cg->newNode(OpPlus, cg->newNode(OpPlus, n0, n1), cg->newNode(5.0));
+  addCons_(cg, n2, 2.0, INFINITY);
+
+  TransSep sep(env_, p_);
+  sep.candCons();
+  CPPUNIT_ASSERT(2 == sep.getSepConId().size());
+  CPPUNIT_ASSERT(7 == p_->getNumCons());
+  CPPUNIT_ASSERT(4.0 == p_->getConstraint(0)->getUb());
+  CPPUNIT_ASSERT(p_->getConstraint(0)->getNonlinearFunction());
+
+  c = p_->getConstraint(1);
+  CPPUNIT_ASSERT(!c->getNonlinearFunction());
+  CPPUNIT_ASSERT(-INFINITY == c->getLb());
+  CPPUNIT_ASSERT(4.0 == c->getUb());
+  c = p_->getConstraint(2);
+  CPPUNIT_ASSERT(!c->getNonlinearFunction());
+  CPPUNIT_ASSERT(-3.0 == c->getLb());
+  CPPUNIT_ASSERT(INFINITY == c->getUb());
+
+  // parts of the first constraint are <= 0, of the third >= 0.
+  for (UInt i=3; i<5; ++i) {
+    CPPUNIT_ASSERT(0.0 == p_->getConstraint(i)->getUb());
+    CPPUNIT_ASSERT(0.0 == p_->getConstraint(i+2)->getLb());
+  }
+  CPPUNIT_ASSERT(fabs(nlSum_(3, x) - 6.25) < 1e-12);
+}
+
+
+void TransSepUT::testObjective()
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CNode *n0;
+  LinearFunctionPtr lf = (LinearFunctionPtr) new LinearFunction();
+  FunctionPtr f;
+  ObjectivePtr obj;
+
+  // x0 + exp(x1) has one part and the objective stays as it is.
+  lf->addTerm(p_->getVariable(0), 1.0);
+  n0 = cg->newNode(OpExp, cg->newNode(p_->getVariable(1)), 0);
+  cg->setOut(n0);
+  cg->finalize();
+  f = (FunctionPtr) new Function(lf, cg);
+  p_->newObjective(f, 0.0, Minimize);
+
+  TransSep sep(env_, p_);
+  sep.objSepCheck();
+  obj = p_->getObjective();
+  CPPUNIT_ASSERT(false == sep.getStatus());
+  CPPUNIT_ASSERT(0 == p_->getNumCons());
+  CPPUNIT_ASSERT(obj->getNonlinearFunction());
+  CPPUNIT_ASSERT(1 == obj->getLinearFunction()->getNumTerms());
+  CPPUNIT_ASSERT(1.0 == obj->getLinearFunction()->
+                 getWeight(p_->getVariable(0)));
+}
+
+
+void TransSepUT::testPowK()
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CNode *n0, *n1, *n2;
+  LinearFunctionPtr lf;
+  double x[5] = {2.0, 3.0, 1.0, 0.0, 0.0};
+
+  // x0^3 + x1^2 + x2^1 <= 5 has parts x0^3 and x1^2.
+  n0 = cg->newNode(OpPowK, cg->newNode(p_->getVariable(0)),
+                   cg->newNode(3));
+  n1 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(1)), 0);
+  n2 = cg->newNode(OpPowK, cg->newNode(p_->getVariable(2)),
+                   cg->newNode(1));
+  addCons_(cg, cg->newNode(OpPlus, cg->newNode(OpPlus, n0, n1), n2),
+           -INFINITY, 5.0);
+
+  TransSep sep(env_, p_);
+  sep.candCons();
+  CPPUNIT_ASSERT(1 == sep.getSepConId().size());
+  CPPUNIT_ASSERT(3 == p_->getNumCons());
+  lf = p_->getConstraint(0)->getLinearFunction();
+  CPPUNIT_ASSERT(3 == lf->getNumTerms());
+  CPPUNIT_ASSERT(false == lf->hasVar(p_->getVariable(0)));
+  CPPUNIT_ASSERT(1.0 == lf->getWeight(p_->getVariable(2)));
+  CPPUNIT_ASSERT(fabs(nlSum_(1, x) - 17.0) < 1e-12);
+}
+
+
+void TransSepUT::testShared()
+{
+  CGraphPtr cg = (CGraphPtr) new CGraph();
+  CNode *n0, *n1, *n2, *n3;
+  double x[5] = {1.5, 2.0, 0.5, 0.0, 0.0};
+
+  // t + t + (x1+x2)^2 + exp(x1+x2) <= 10, t = x0^2. Node t is used twice
+  // in one part and x1+x2 is shared by the two terms of the other part.
+  n0 = cg->newNode(OpSqr, cg->newNode(p_->getVariable(0)), 0);
+  n1 = cg->newNode(OpPlus, cg->newNode(p_->getVariable(1)),
+                   cg->newNode(p_->getVariable(2)));
+  n2 = cg->newNode(OpSqr, n1, 0);
+  n3 = cg->newNode(OpExp, n1, 0);
+  n2 = cg->newNode(OpPlus, cg->newNode(OpPlus, n0, n0),
+                   cg->newNode(OpPlus, n2, n3));
+  addCons_(cg, n2, -INFINITY, 10.0);
+
+  TransSep sep(env_, p_);
+  sep.candCons();
+  CPPUNIT_ASSERT(1 == sep.getSepConId().size());
+  CPPUNIT_ASSERT(3 == p_->getNumCons());
+  CPPUNIT_ASSERT(2 == p_->getConstraint(0)->getLinearFunction()->
+                 getNumTerms());
+  CPPUNIT_ASSERT(fabs(nlSum_(1, x) - (4.5 + 6.25 + exp(2.5))) < 1e-12);
+}
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
@@ -0,0 +1,73 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+#ifndef TRANSSEPUT_H
+#define TRANSSEPUT_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "Types.h"
+
+namespace Minotaur {
+  class CGraph;
+  class CNode;
+  typedef boost::shared_ptr<CGraph> CGraphPtr;
+}
+
+using namespace Minotaur;
+
+// Read the documentation in TransSep.h
+class TransSepUT : public CppUnit::TestCase {
+  public:
+    TransSepUT(std::string name) : TestCase(name) {}
+    TransSepUT() {}
+
+    void setUp();
+    void tearDown();
+
+    void testCancel();
+    void testIntDiv();
+    void testNegConst();
+    void testObjective();
+    void testPowK();
+    void testShared();
+
+    CPPUNIT_TEST_SUITE(TransSepUT);
+    CPPUNIT_TEST(testCancel);
+    CPPUNIT_TEST(testIntDiv);
+    CPPUNIT_TEST(testNegConst);
+    CPPUNIT_TEST(testObjective);
+    CPPUNIT_TEST(testPowK);
+    CPPUNIT_TEST(testShared);
+    CPPUNIT_TEST_SUITE_END();
+
+  private:
+    EnvPtr env_;
+    ProblemPtr p_;
+
+    /// Add constraint lb <= cg <= ub to p_ after finalizing cg.
+    void addCons_(CGraphPtr cg, CNode *out, double lb, double ub);
+
+    /// Sum of the nonlinear parts of constraints first, first+1, ... of p_.
+    double nlSum_(UInt first, const double *x);
+};
+
+#endif     // #define TRANSSEPUT_H
+
+// Local Variables: 
+// mode: c++ 
+// eval: (c-set-style "k&r") 
+// eval: (c-set-offset 'innamespace 0) 
+// eval: (setq c-basic-offset 2) 
+// eval: (setq fill-column 78) 
+// eval: (auto-fill-mode 1) 
+// eval: (setq column-number-mode 1) 
+// eval: (setq indent-tabs-mode nil) 
+// End:
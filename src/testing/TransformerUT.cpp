@@ -4,14 +4,21 @@
 //     (C)opyright 2009 - 2014 The MINOTAUR Team.
 //
 
+#include <sstream>
+
 #include "MinotaurConfig.h"
 #include "TransformerUT.h"
 
+#include "CGraph.h"
+#include "CNode.h"
 #include "Environment.h"
+#include "Function.h"
 #include "Handler.h"
 #include "Option.h"
+#include "SimpleTransformer.h"
 #include "Transformer.h"
 #include "Types.h"
+#include "Variable.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TransformerUT);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(TransformerUT, "TransformerUT");
@@ -92,6 +99,82 @@ void TransformerUT::testMakeObjectiveLinear()
   CPPUNIT_ASSERT(inst_->getNumCons() == 5);
   CPPUNIT_ASSERT(inst_->getNumVars() == 5);
 }
+
+
+ProblemPtr TransformerUT::manyCons_()
+{
+  const UInt nvars = 20;
+  const UInt ncons = 400;
+  ProblemPtr p = (ProblemPtr) new Problem();
+  VarVector x;
+  CGraphPtr cg;
+  CNode *n0, *n1, *n2, *n3;
+  FunctionPtr f;
+
+  for (UInt i=0; i<nvars; ++i) {
+    x.push_back(p->newVariable(-1.0, 2.0, Continuous));
+  }
+
+  // x_a*x_b + exp(x_c) + (x_d+1)^2 <= 10. The terms repeat across
+  // constraints, so the threads find the same auxiliary variables.
+  for (UInt i=0; i<ncons; ++i) {
+    cg = (CGraphPtr) new CGraph();
+    n0 = cg->newNode(x[i%nvars]);
+    n1 = cg->newNode(x[(i+1)%nvars]);
+    n0 = cg->newNode(OpMult, n0, n1);
+    n1 = cg->newNode(x[i%7]);
+    n1 = cg->newNode(OpExp, n1, 0);
+    n2 = cg->newNode(x[i%5]);
+    n3 = cg->newNode(1.0);
+    n2 = cg->newNode(OpPlus, n2, n3);
+    n2 = cg->newNode(OpSqr, n2, 0);
+    n0 = cg->newNode(OpPlus, n0, n1);
+    n0 = cg->newNode(OpPlus, n0, n2);
+    cg->setOut(n0);
+    cg->finalize();
+    f = (FunctionPtr) new Function(cg);
+    p->newConstraint(f, -INFINITY, 10.0);
+  }
+  p->calculateSize();
+  return p;
+}
+
+
+void TransformerUT::reformulate_(ProblemPtr p, int threads,
+                                 std::string &prob, std::string &aux)
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  HandlerVector handlers;
+  ProblemPtr newp;
+  std::ostringstream out;
+  int status = 0;
+
+  env->setLogLevel(LogError);
+  env->getOptions()->findInt("threads")->setValue(threads);
+  SimpleTransformer t(env, p);
+  t.reformulate(newp, handlers, status);
+  CPPUNIT_ASSERT(0 == status);
+  newp->write(out);
+  prob = out.str();
+  out.str("");
+  t.writeAux(out);
+  aux = out.str();
+}
+
+
+void TransformerUT::testThreads()
+{
+  ProblemPtr p = manyCons_();
+  std::string prob1, aux1, prob4, aux4;
+
+  // the reformulation must not depend on the number of threads.
+  reformulate_(p, 1, prob1, aux1);
+  reformulate_(p, 4, prob4, aux4);
+  CPPUNIT_ASSERT(!prob1.empty());
+  CPPUNIT_ASSERT(!aux1.empty());
+  CPPUNIT_ASSERT(prob1 == prob4);
+  CPPUNIT_ASSERT(aux1 == aux4);
+}
 // Local Variables: 
 // mode: c++ 
 // eval: (c-set-style "k&r") 
@@ -42,16 +42,26 @@ public:
 
   void testSize();
   void testMakeObjectiveLinear();
+  void testThreads();
   
 
   CPPUNIT_TEST_SUITE(TransformerUT);
   CPPUNIT_TEST(testSize);
   CPPUNIT_TEST(testMakeObjectiveLinear);
   CPPUNIT_TEST(testSize);
+  CPPUNIT_TEST(testThreads);
   CPPUNIT_TEST_SUITE_END();
 
 private:
   Minotaur::EnvPtr env_;
+
+  /// Problem with many nonlinear constraints that share terms.
+  Minotaur::ProblemPtr manyCons_();
+
+  /// Reformulate p with the given threads, write the result and the aux maps.
+  void reformulate_(Minotaur::ProblemPtr p, int threads, std::string &prob,
+                    std::string &aux);
+
   MINOTAUR_AMPL::AMPLInterfacePtr iface_;
   Minotaur::ProblemPtr inst_;
 };
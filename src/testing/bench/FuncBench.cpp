@@ -0,0 +1,554 @@
+//
+//    MINOTAUR -- It's only 1/2 bull
+//
+//    (C)opyright 2009 - 2014 The MINOTAUR Team.
+//
+
+/**
+ * \file FuncBench.cpp
+ * \brief Microbenchmarks for evaluating functions and their derivatives.
+ * \author Ashutosh Mahajan, Argonne National Laboratory
+ *
+ * Times evaluation of CGraphs (values, gradients and hessians), the
+ * Jacobian, the hessian of the Lagrangean, and linear and quadratic
+ * functions. Instances are read from .nl files given on the command line
+ * (using NlReader, so ASL is not needed) and are also generated for a few
+ * sizes. One line of comma-separated values is written for each benchmark:
+ *
+ *   bench,instance,n,m,size,reps,ns_per_op,allocs_per_op,
+ *   alloc_bytes_per_op,bytes_per_op
+ *
+ * An "op" is one pass over all functions of the instance, e.g. evaluating
+ * every CGraph once, or filling all values of the Jacobian once. "size" is
+ * the number of nodes, nonzeros or terms involved in one op. Allocations
+ * are counted by replacing the global operator new. "bytes_per_op" is an
+ * estimate of the data read and written in one op.
+ *
+ * Usage: funcbench [-t seconds] [-g size]... [-o file.csv] [file.nl]...
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <time.h>
+#include <vector>
+
+#include "MinotaurConfig.h"
+#include "CGraph.h"
+#include "CNode.h"
+#include "Constraint.h"
+#include "Environment.h"
+#include "Function.h"
+#include "HessianOfLag.h"
+#include "Jacobian.h"
+#include "LinearFunction.h"
+#include "Logger.h"
+#include "Objective.h"
+#include "Option.h"
+#include "Problem.h"
+#include "QuadraticFunction.h"
+#include "Variable.h"
+
+#include "NlReader.h"
+
+using namespace Minotaur;
+
+// Count all allocations made through operator new.
+static size_t numAllocs = 0;
+static size_t numAllocBytes = 0;
+
+#if __cplusplus < 201103L
+#define FB_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define FB_NO_THROW throw()
+#else
+#define FB_THROW_BAD_ALLOC
+#define FB_NO_THROW noexcept
+#endif
+
+// Not inlined, otherwise gcc warns that memory from new is freed by free().
+#if defined(__GNUC__)
+#define FB_NO_INLINE __attribute__((noinline))
+#else
+#define FB_NO_INLINE
+#endif
+
+FB_NO_INLINE void* operator new(size_t sz) FB_THROW_BAD_ALLOC
+{
+  void *p = malloc(sz ? sz : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  ++numAllocs;
+  numAllocBytes += sz;
+  return p;
+}
+
+
+FB_NO_INLINE void operator delete(void *p) FB_NO_THROW
+{
+  free(p);
+}
+
+
+/// Data of one instance that is needed by the benchmarks.
+struct BenchInst {
+  std::string name;                  ///< Name written in the output.
+  ProblemPtr p;                      ///< The problem.
+  std::vector<CGraphPtr> graphs;     ///< All CGraphs, objective first.
+  std::vector<double> mults;         ///< Multiplier of each graph.
+  std::vector<double> conMults;      ///< Multipliers of constraints.
+  std::vector<LinearFunctionPtr> lfs;     ///< All linear functions.
+  std::vector<QuadraticFunctionPtr> qfs;  ///< All quadratic functions.
+  LTHessStor stor;                   ///< Hessian storage of the problem.
+  std::vector<double> x;             ///< Point of evaluation.
+};
+
+
+/// Options from the command line.
+struct BenchOpts {
+  double minTime;                    ///< Minimum time of each benchmark.
+  std::vector<UInt> sizes;           ///< Sizes of generated instances.
+  std::vector<std::string> files;    ///< .nl files.
+  std::string outFile;               ///< Output file, stdout if empty.
+};
+
+
+/// A benchmark is a function that does one op on an instance.
+typedef void (*BenchOp)(BenchInst *bi, double *work, int *err);
+
+
+static double wallTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+
+static void cgEval(BenchInst *bi, double *work, int *err)
+{
+  for (UInt i=0; i<bi->graphs.size(); ++i) {
+    work[0] += bi->graphs[i]->eval(&(bi->x[0]), err);
+  }
+}
+
+
+static void cgGrad(BenchInst *bi, double *work, int *err)
+{
+  for (UInt i=0; i<bi->graphs.size(); ++i) {
+    bi->graphs[i]->evalGradient(&(bi->x[0]), work, err);
+  }
+}
+
+
+static void cgHess(BenchInst *bi, double *work, int *err)
+{
+  std::fill(work, work+bi->stor.nz, 0.0);
+  for (UInt i=0; i<bi->graphs.size(); ++i) {
+    bi->graphs[i]->evalHessian(bi->mults[i], &(bi->x[0]), &(bi->stor), work,
+                               err);
+  }
+}
+
+
+static void jacValues(BenchInst *bi, double *work, int *err)
+{
+  bi->p->getJacobian()->fillRowColValues(&(bi->x[0]), work, err);
+}
+
+
+static void hessValues(BenchInst *bi, double *work, int *err)
+{
+  bi->p->getHessian()->fillRowColValues(&(bi->x[0]), 1.0,
+                                        &(bi->conMults[0]), work, err);
+}
+
+
+static void lfEval(BenchInst *bi, double *work, int *)
+{
+  for (UInt i=0; i<bi->lfs.size(); ++i) {
+    work[0] += bi->lfs[i]->eval(&(bi->x[0]));
+  }
+}
+
+
+static void qfEval(BenchInst *bi, double *work, int *)
+{
+  for (UInt i=0; i<bi->qfs.size(); ++i) {
+    work[0] += bi->qfs[i]->eval(&(bi->x[0]));
+  }
+}
+
+
+// Run op repeatedly, doubling the number of repetitions until it takes at
+// least min_time seconds. Write one line of output.
+static void runBench(const char *bench, BenchInst *bi, BenchOp op,
+                     UInt size, double bytes, double min_time,
+                     std::vector<double> &work, std::ostream &out)
+{
+  UInt reps = 1;
+  double t = 0.0;
+  size_t allocs = 0;
+  size_t abytes = 0;
+  int err = 0;
+
+  if (0==size) {
+    return;
+  }
+  op(bi, &(work[0]), &err); // warm up
+  if (err) {
+    std::cerr << "funcbench: error in " << bench << " on " << bi->name
+              << ". Skipped." << std::endl;
+    return;
+  }
+  while (true) {
+    allocs = numAllocs;
+    abytes = numAllocBytes;
+    t = wallTime();
+    for (UInt r=0; r<reps; ++r) {
+      op(bi, &(work[0]), &err);
+    }
+    t = wallTime() - t;
+    allocs = numAllocs - allocs;
+    abytes = numAllocBytes - abytes;
+    if (t >= min_time || reps >= (1U<<30)) {
+      break;
+    }
+    reps *= 2;
+  }
+
+  char line[512];
+  snprintf(line, sizeof(line), "%s,%s,%u,%u,%u,%u,%.2f,%.3f,%.1f,%.0f",
+           bench, bi->name.c_str(), bi->p->getNumVars(), bi->p->getNumCons(),
+           size, reps, t*1e9/reps, (double) allocs/reps,
+           (double) abytes/reps, bytes);
+  out << line << std::endl;
+}
+
+
+// Same storage as built by HessianOfLag::setupRowCol, so that offsets saved
+// in the graphs by finalHessStor() remain valid for both.
+static void setupHessStor(BenchInst *bi)
+{
+  ProblemPtr p = bi->p;
+  LTHessStor *stor = &(bi->stor);
+  UInt i, nz;
+  UInt *cols;
+
+  stor->nlVars = 0;
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    if (Linear!=(*it)->getFunType() && Constant!=(*it)->getFunType()) {
+      ++(stor->nlVars);
+    }
+  }
+  stor->rows   = new VariablePtr[stor->nlVars];
+  stor->colQs  = new std::deque<UInt>[stor->nlVars];
+  stor->starts = new UInt[stor->nlVars+1];
+  i = 0;
+  for (VariableConstIterator it=p->varsBegin(); it!=p->varsEnd(); ++it) {
+    if (Linear!=(*it)->getFunType() && Constant!=(*it)->getFunType()) {
+      stor->rows[i] = *it;
+      ++i;
+    }
+  }
+  if (p->getObjective() && p->getObjective()->getFunction()) {
+    p->getObjective()->getFunction()->fillHessStor(stor);
+  }
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    (*it)->getFunction()->fillHessStor(stor);
+  }
+  nz = 0;
+  for (i=0; i<stor->nlVars; ++i) {
+    stor->starts[i] = nz;
+    nz += stor->colQs[i].size();
+  }
+  stor->starts[i] = nz;
+  stor->nz = nz;
+  stor->cols = new UInt[nz];
+  cols = stor->cols;
+  for (i=0; i<stor->nlVars; ++i) {
+    for (std::deque<UInt>::iterator it=stor->colQs[i].begin();
+         it!=stor->colQs[i].end(); ++it, ++cols) {
+      *cols = *it;
+    }
+  }
+  if (p->getObjective() && p->getObjective()->getFunction()) {
+    p->getObjective()->getFunction()->finalHessStor(stor);
+  }
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    (*it)->getFunction()->finalHessStor(stor);
+  }
+  delete [] stor->colQs;
+  stor->colQs = 0;
+}
+
+
+static void addFunction(BenchInst *bi, FunctionPtr f, double mult)
+{
+  CGraphPtr cg;
+
+  if (!f) {
+    return;
+  }
+  if (f->getLinearFunction()) {
+    bi->lfs.push_back(f->getLinearFunction());
+  }
+  if (f->getQuadraticFunction()) {
+    bi->qfs.push_back(f->getQuadraticFunction());
+  }
+  cg = boost::dynamic_pointer_cast<CGraph>(f->getNonlinearFunction());
+  if (cg) {
+    bi->graphs.push_back(cg);
+    bi->mults.push_back(mult);
+  }
+}
+
+
+// Collect functions of the problem, set up derivatives and the point.
+static void prepare(BenchInst *bi, const double *x0)
+{
+  ProblemPtr p = bi->p;
+  double lb, ub;
+
+  p->setNativeDer();
+  if (p->getObjective()) {
+    addFunction(bi, p->getObjective()->getFunction(), 1.0);
+  }
+  for (ConstraintConstIterator it=p->consBegin(); it!=p->consEnd(); ++it) {
+    addFunction(bi, (*it)->getFunction(), 1.0);
+  }
+  setupHessStor(bi);
+  bi->conMults.resize(std::max(p->getNumCons(), (UInt) 1), 1.0);
+
+  // a point inside the bounds, away from zero where log, sqrt etc. break.
+  bi->x.resize(p->getNumVars());
+  for (UInt i=0; i<p->getNumVars(); ++i) {
+    lb = p->getVariable(i)->getLb();
+    ub = p->getVariable(i)->getUb();
+    bi->x[i] = (x0 && x0[i]!=0.0) ? x0[i] : 0.5;
+    bi->x[i] = std::max(lb, std::min(ub, bi->x[i]));
+  }
+}
+
+
+static void freeInst(BenchInst *bi)
+{
+  delete [] bi->stor.rows;
+  delete [] bi->stor.starts;
+  delete [] bi->stor.cols;
+  bi->stor.rows = 0;
+  bi->stor.starts = 0;
+  bi->stor.cols = 0;
+}
+
+
+/**
+ * Generate a chain instance with n variables:
+ *   min  sum_i x_i^2/(1 + x_i)             (CGraph)
+ *   s.t. x_i x_{i+1} + exp(x_i) - log(1 + x_{i+1}^2) + 2x_i <= 10,
+ *                                           (CGraph + linear), i<n-1
+ *        sum_i x_i x_{i+1} <= n             (quadratic)
+ *        sum_i x_i <= n                     (linear)
+ */
+static ProblemPtr genChain(UInt n)
+{
+  ProblemPtr p = (ProblemPtr) new Problem();
+  std::vector<VariablePtr> v;
+  std::vector<CNode *> terms;
+  CGraphPtr cg;
+  CNode *n0, *n1, *n2, *n3;
+  LinearFunctionPtr lf;
+  QuadraticFunctionPtr qf;
+  FunctionPtr f;
+
+  for (UInt i=0; i<n; ++i) {
+    v.push_back(p->newVariable(0.0, 10.0, Continuous));
+  }
+
+  cg = (CGraphPtr) new CGraph();
+  for (UInt i=0; i<n; ++i) {
+    n0 = cg->newNode(v[i]);
+    n1 = cg->newNode(OpSqr, n0, 0);
+    n2 = cg->newNode(OpPlus, cg->newNode(1.0), n0);
+    terms.push_back(cg->newNode(OpDiv, n1, n2));
+  }
+  cg->setOut(cg->newNode(OpSumList, &(terms[0]), n));
+  cg->finalize();
+  f = (FunctionPtr) new Function(LinearFunctionPtr(), QuadraticFunctionPtr(),
+                                 cg);
+  p->newObjective(f, 0.0, Minimize);
+
+  for (UInt i=0; i+1<n; ++i) {
+    cg = (CGraphPtr) new CGraph();
+    n0 = cg->newNode(v[i]);
+    n1 = cg->newNode(v[i+1]);
+    n2 = cg->newNode(OpMult, n0, n1);
+    n3 = cg->newNode(OpExp, n0, 0);
+    n2 = cg->newNode(OpPlus, n2, n3);
+    n3 = cg->newNode(OpPlus, cg->newNode(1.0), cg->newNode(OpSqr, n1, 0));
+    n3 = cg->newNode(OpLog, n3, 0);
+    cg->setOut(cg->newNode(OpMinus, n2, n3));
+    cg->finalize();
+    lf = (LinearFunctionPtr) new LinearFunction();
+    lf->addTerm(v[i], 2.0);
+    f = (FunctionPtr) new Function(lf, QuadraticFunctionPtr(), cg);
+    p->newConstraint(f, -INFINITY, 10.0);
+  }
+
+  qf = (QuadraticFunctionPtr) new QuadraticFunction();
+  lf = (LinearFunctionPtr) new LinearFunction();
+  for (UInt i=0; i<n; ++i) {
+    if (i+1<n) {
+      qf->addTerm(v[i], v[i+1], 1.0);
+    }
+    lf->addTerm(v[i], 1.0);
+  }
+  f = (FunctionPtr) new Function(LinearFunctionPtr(), qf);
+  p->newConstraint(f, -INFINITY, n);
+  f = (FunctionPtr) new Function(lf);
+  p->newConstraint(f, -INFINITY, n);
+  return p;
+}
+
+
+static void benchInst(BenchInst *bi, double min_time, std::ostream &out)
+{
+  std::vector<double> work;
+  UInt nodes = 0, hnz = 0, jnz = 0, lterms = 0, qterms = 0;
+  const double d = sizeof(double);
+  const UInt n = bi->p->getNumVars();
+  const UInt m = bi->p->getNumCons();
+
+  for (UInt i=0; i<bi->graphs.size(); ++i) {
+    nodes += bi->graphs[i]->getNumNodes();
+  }
+  for (UInt i=0; i<bi->lfs.size(); ++i) {
+    lterms += bi->lfs[i]->getNumTerms();
+  }
+  for (UInt i=0; i<bi->qfs.size(); ++i) {
+    qterms += bi->qfs[i]->getNumTerms();
+  }
+  hnz = bi->p->getHessian()->getNumNz();
+  jnz = bi->p->getJacobian()->getNumNz();
+  work.resize(std::max(std::max(n, hnz), std::max(jnz, (UInt) 1)), 0.0);
+
+  runBench("cgraph_eval", bi, cgEval, nodes,
+           nodes*sizeof(CNode) + n*d, min_time, work, out);
+  runBench("cgraph_grad", bi, cgGrad, nodes,
+           nodes*sizeof(CNode) + 2*n*d, min_time, work, out);
+  runBench("cgraph_hess", bi, cgHess, hnz,
+           nodes*sizeof(CNode) + n*d + hnz*d, min_time, work, out);
+  runBench("jacobian_values", bi, jacValues, jnz,
+           nodes*sizeof(CNode) + lterms*2*d + n*d + jnz*d, min_time, work,
+           out);
+  runBench("hessian_lag_values", bi, hessValues, hnz,
+           nodes*sizeof(CNode) + qterms*3*d + (n+m)*d + hnz*d, min_time,
+           work, out);
+  runBench("linear_eval", bi, lfEval, lterms, lterms*3*d, min_time, work,
+           out);
+  runBench("quadratic_eval", bi, qfEval, qterms, qterms*4*d, min_time, work,
+           out);
+}
+
+
+static int readArgs(int argc, char **argv, BenchOpts *opts)
+{
+  bool sizes_given = false;
+
+  opts->minTime = 0.2;
+  for (int i=1; i<argc; ++i) {
+    if (0==strcmp(argv[i], "-t") && i+1<argc) {
+      opts->minTime = atof(argv[++i]);
+    } else if (0==strcmp(argv[i], "-g") && i+1<argc) {
+      if (!sizes_given) {
+        opts->sizes.clear();
+        sizes_given = true;
+      }
+      if (atoi(argv[++i]) > 1) {
+        opts->sizes.push_back(atoi(argv[i]));
+      }
+    } else if (0==strcmp(argv[i], "-o") && i+1<argc) {
+      opts->outFile = argv[++i];
+    } else if ('-'==argv[i][0]) {
+      std::cerr << "Usage: " << argv[0] << " [-t seconds] [-g size]..."
+                << " [-o file.csv] [file.nl]..." << std::endl
+                << "  -g 0 skips generated instances." << std::endl;
+      return 1;
+    } else {
+      opts->files.push_back(argv[i]);
+    }
+  }
+  if (!sizes_given) {
+    opts->sizes.push_back(100);
+    opts->sizes.push_back(1000);
+    opts->sizes.push_back(10000);
+  }
+  return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+  EnvPtr env = (EnvPtr) new Environment();
+  BenchOpts opts;
+  std::ofstream fout;
+  std::ostream *out = &std::cout;
+  char name[64];
+
+  if (0!=readArgs(argc, argv, &opts)) {
+    return 1;
+  }
+  // keep stdout clean for the results.
+  env->setLogLevel(LogNone);
+  env->getOptions()->findInt("ampl_log_level")->setValue(LogNone);
+  if (!opts.outFile.empty()) {
+    fout.open(opts.outFile.c_str());
+    if (!fout.is_open()) {
+      std::cerr << "funcbench: cannot open " << opts.outFile << std::endl;
+      return 1;
+    }
+    out = &fout;
+  }
+
+  *out << "bench,instance,n,m,size,reps,ns_per_op,allocs_per_op,"
+       << "alloc_bytes_per_op,bytes_per_op" << std::endl;
+  for (UInt i=0; i<opts.files.size(); ++i) {
+    MINOTAUR_AMPL::NlReader reader(env);
+    BenchInst bi;
+    bi.p = reader.readInstance(opts.files[i]);
+    if (!bi.p) {
+      std::cerr << "funcbench: cannot read " << opts.files[i] << std::endl;
+      continue;
+    }
+    bi.name = opts.files[i].substr(opts.files[i].find_last_of('/')+1);
+    prepare(&bi, reader.getInitialPoint());
+    benchInst(&bi, opts.minTime, *out);
+    freeInst(&bi);
+  }
+  for (UInt i=0; i<opts.sizes.size(); ++i) {
+    BenchInst bi;
+    snprintf(name, sizeof(name), "gen-chain-%u", opts.sizes[i]);
+    bi.name = name;
+    bi.p = genChain(opts.sizes[i]);
+    prepare(&bi, 0);
+    benchInst(&bi, opts.minTime, *out);
+    freeInst(&bi);
+  }
+  return 0;
+}
+
+
+// Local Variables:
+// mode: c++
+// eval: (c-set-style "k&r")
+// eval: (c-set-offset 'innamespace 0)
+// eval: (setq c-basic-offset 2)
+// eval: (setq fill-column 78)
+// eval: (auto-fill-mode 1)
+// eval: (setq column-number-mode 1)
+// eval: (setq indent-tabs-mode nil)
+// End: